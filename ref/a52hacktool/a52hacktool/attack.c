@@ -29,18 +29,26 @@
   * @brief Implementation of A52 attack
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #28
-  * @date 01/12/2011
+  * @version File Revision #43
+  * @date 19/10/2026
   * */
 
 
+// clock_gettime(), nanosleep() and SIGUSR1 are POSIX extensions of the C99 library
+#define _POSIX_C_SOURCE 200112L
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <pthread.h>
+#include <signal.h>
 #include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 #include "utils.h"
+#include "bitmatrix.h"
 
 #include "attack.h"
 
@@ -51,8 +59,74 @@
 
 
 
-//! RAM Storage for Resolution Matrices
-unsigned int** ALLMATRICES;
+//! Dictionary of initializeRAM(), attack() and attack_batch()
+attackDictionary attack_defaultDictionary = {NULL, DICTIONARY_CIPHERTEXT, NEEDED_ENCRYPTED_MESSAGES,
+                                             {0, NULL, NULL, NULL, 0, PTHREAD_MUTEX_INITIALIZER}, {NULL, NULL, NULL}};
+
+//! Number of workers of the attacks that do not ask for a given one, see attack_setThreads()
+int attack_defaultThreads = PROCESSING_THREADS;
+
+//! Set by SIGUSR1: the running attack has to export its telemetry
+volatile sig_atomic_t attack_statsRequested = 0;
+
+//! Polling period of the attack threads by the main thread, in milliseconds
+#define ATTACK_POLL_MS 100
+
+//! The right-hand sides of the problems are stored as extra columns of the Resolution Matrix, starting
+//! on the word that follows its own columns (column ATTACK_RHS + j for problem #j)
+#define ATTACK_RHS (BITMATRIX_WORDS(REGS_TOTAL_VARS)*BITMATRIX_WORD_BITS)
+
+//! Rows of the first elimination: one per unknown, plus spare rows which reject the wrong candidates
+//! (a wrong candidate passes each of them with probability 1/2). Any REGS_TOTAL_VARS-1 rows of the dictionary
+//! matrices are nearly always independent, so that no row order brings the dependent rows any earlier.
+#define ATTACK_FIRST_ROWS (REGS_TOTAL_VARS-1 + 16)
+
+//! Rows added to the elimination as long as a problem survives the rows already eliminated
+#define ATTACK_ROW_BLOCK BITMATRIX_WORD_BITS
+
+
+
+
+/**
+ * \fn unsigned long long attack_timer()
+ * \brief Reads the timer of the attack telemetry
+ *
+ * \return Time-stamp counter on x86, monotonic clock in nanoseconds elsewhere
+ */
+static inline unsigned long long attack_timer() {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec*1000000000ULL + t.tv_nsec;
+#endif
+}
+
+
+
+
+// Documentation in header file
+const char* attack_timerUnit() {
+#if defined(__x86_64__) || defined(__i386__)
+	return "cycles";
+#else
+	return "ns";
+#endif
+}
+
+
+
+
+/**
+ * \fn void attack_onStatsSignal(int sig)
+ * \brief SIGUSR1 handler: requests a telemetry export (done by the main thread)
+ *
+ * \param[in] sig Received signal
+ */
+void attack_onStatsSignal(int sig) {
+	attack_statsRequested = 1;
+}
 
 
 
@@ -85,280 +159,664 @@ void attack_redispatchLFSRdata(const byte LFSRState[REGS_TOTAL_VARS-1], byte R1[
 
 
 
+//! Product variables involving each simple variable, as bits of a packed LFSR state
+bitword attack_pairMasks[REGS_SIMPLE_VARS][BITMATRIX_WORDS(REGS_TOTAL_VARS-1)];
+
+//! All product variables, as bits of a packed LFSR state
+bitword attack_productMask[BITMATRIX_WORDS(REGS_TOTAL_VARS-1)];
+
+//! Ensures that the masks are computed exactly once
+pthread_once_t attack_pairMasksOnce = PTHREAD_ONCE_INIT;
+
+
+
+
 /**
- * \fn int attack_checkDoubleVars(const byte LFSRState[REGS_TOTAL_VARS-1])
+ * \fn void attack_buildPairMasks()
+ * \brief Computes the masks of the product variables (called once through pthread_once)
+ */
+void attack_buildPairMasks() {
+
+	memset(attack_pairMasks, 0, sizeof(attack_pairMasks));
+	memset(attack_productMask, 0, sizeof(attack_productMask));
+
+	// Products are listed register after register, each pair (v1 < v2) once
+	const int first[3] = {0, R1_SIMPLE_VARS, R1_SIMPLE_VARS+R2_SIMPLE_VARS};
+	const int vars[3]  = {R1_SIMPLE_VARS, R2_SIMPLE_VARS, R3_SIMPLE_VARS};
+	int i=REGS_SIMPLE_VARS;
+	for (int r=0 ; r<3 ; ++r) {
+		for (int v1=first[r] ; v1<first[r]+vars[r] ; ++v1) {
+			for (int v2=v1+1 ; v2<first[r]+vars[r] ; ++v2) {
+				BITVECTOR_SET(attack_pairMasks[v1], i, 1);
+				BITVECTOR_SET(attack_pairMasks[v2], i, 1);
+				BITVECTOR_SET(attack_productMask, i, 1);
+				++i;
+			}
+		}
+	}
+}
+
+
+
+
+/**
+ * \fn int attack_checkDoubleVars(const bitword solution[])
  * \brief Checks that all double variables values are consistent with single variables ones
  *
- * \param[in] LFSRState Compact LFSR representation
+ * A product is expected to be set unless one of its variables is null: the expected products are
+ * obtained by clearing the pair masks of the null variables, then compared to the solution word by word.
+ *
+ * \param[in] solution Packed LFSR representation (REGS_TOTAL_VARS-1 bits)
  * \return 0 if the state is consistent, non-zero otherwise
  */
-int attack_checkDoubleVars(const byte LFSRState[REGS_TOTAL_VARS-1]) {
-	int i=REGS_SIMPLE_VARS;
-	for (int v1=0 ; v1<R1_SIMPLE_VARS ; ++v1)
-		for (int v2=v1+1 ; v2<R1_SIMPLE_VARS ; ++v2)
-			if (LFSRState[i++] != (LFSRState[v1] & LFSRState[v2]))
-				return 1;
-	for (int v1=0 ; v1<R2_SIMPLE_VARS ; ++v1)
-		for (int v2=v1+1 ; v2<R2_SIMPLE_VARS ; ++v2)
-			if (LFSRState[i++] != (LFSRState[v1+R1_SIMPLE_VARS] & LFSRState[v2+R1_SIMPLE_VARS]))
-				return 1;
-	for (int v1=0 ; v1<R3_SIMPLE_VARS ; ++v1)
-		for (int v2=v1+1 ; v2<R3_SIMPLE_VARS ; ++v2)
-			if (LFSRState[i++] != (LFSRState[v1+R1_SIMPLE_VARS+R2_SIMPLE_VARS] & LFSRState[v2+R1_SIMPLE_VARS+R2_SIMPLE_VARS]))
-				return 1;
-	return 0;
+int attack_checkDoubleVars(const bitword solution[]) {
+
+	pthread_once(&attack_pairMasksOnce, attack_buildPairMasks);
+
+	bitword expected[BITMATRIX_WORDS(REGS_TOTAL_VARS-1)];
+	memcpy(expected, attack_productMask, sizeof(expected));
+	for (int v=0 ; v<REGS_SIMPLE_VARS ; ++v) {
+		if (!BITVECTOR_GET(solution, v)) {
+			for (unsigned int w=0 ; w<BITMATRIX_WORDS(REGS_TOTAL_VARS-1) ; ++w)
+				expected[w] &= ~attack_pairMasks[v][w];
+		}
+	}
+
+	bitword mismatch = 0;
+	for (unsigned int w=0 ; w<BITMATRIX_WORDS(REGS_TOTAL_VARS-1) ; ++w) {
+		mismatch |= (solution[w] ^ expected[w]) & attack_productMask[w];
+	}
+	return mismatch != 0;
 }
 
 
 
 
 // Documentation in header file
-void freeRAM() {
-	if (!ALLMATRICES) return;
-	for (int i=0 ; i<TOTAL_MATRICES ; ++i) {
-		free(ALLMATRICES[i]);
-		ALLMATRICES[i] = NULL;
+void* attack_allocate(const attackAllocator* allocator, size_t size) {
+	return allocator->allocate ? allocator->allocate(allocator->context, size) : malloc(size);
+}
+
+
+
+
+// Documentation in header file
+void attack_release(const attackAllocator* allocator, void* block) {
+	if (!block)
+		return;
+	if (allocator->release) {
+		allocator->release(allocator->context, block);
+	} else {
+		free(block);
 	}
-	free(ALLMATRICES);
-	ALLMATRICES = NULL;
 }
 
 
 
 
 // Documentation in header file
-int initializeRAM(const char* filename) {
+void attack_freeDictionary(attackDictionary* dictionary) {
 
-	if (ALLMATRICES) {
-		DEBUG("Dictionary already initialized. Please free it by calling freeRAM(); before reloading data");
-		return 1;
+	if (!dictionary->matrices) return;
+	for (int i=0 ; i<TOTAL_MATRICES ; ++i) {
+		attack_release(&dictionary->allocator, dictionary->matrices[i]);
 	}
+	attack_release(&dictionary->allocator, dictionary->matrices);
+	dictionary->matrices = NULL;
+
+	attack_release(&dictionary->allocator, dictionary->cache.data);
+	attack_release(&dictionary->allocator, dictionary->cache.index);
+	attack_release(&dictionary->allocator, dictionary->cache.lastUse);
+	dictionary->cache.data    = NULL;
+	dictionary->cache.index   = NULL;
+	dictionary->cache.lastUse = NULL;
+	dictionary->cache.slots   = 0;
+	dictionary->cache.clock   = 0;
+	pthread_mutex_destroy(&dictionary->cache.lock);
+}
 
-	DEBUG("Loading matrices dictionary...");
 
-	FILE* sourcefile = fopen(filename, "rb");
-	if (!sourcefile) {
-		DEBUG("Error: failed to open '%s'. Aborting operation", filename);
-		return 1;
+
+
+// Documentation in header file
+AttackStatus attack_loadDictionary(attackDictionary* dictionary, const char* filename, int percent, int cached, \
+                                   DictionaryKind kind, int messages, const attackAllocator* allocator) {
+
+	memset(dictionary, 0, sizeof(attackDictionary));
+	if (allocator)
+		dictionary->allocator = *allocator;
+	pthread_mutex_init(&dictionary->cache.lock, NULL);
+
+	// Without any stored matrix, the dictionary file is not needed
+	FILE* sourcefile = NULL;
+	if (percent > 0) {
+		DEBUG("Loading matrices dictionary...");
+		sourcefile = fopen(filename, "rb");
+		if (!sourcefile) {
+			DEBUG("Error: failed to open '%s'. Aborting operation", filename);
+			pthread_mutex_destroy(&dictionary->cache.lock);
+			return ATTACK_ERROR_IO;
+		}
+		if (readDictionaryHeader(sourcefile, &dictionary->kind, &dictionary->messages)) {
+			DEBUG("Error: '%s' isn't a valid dictionary. Aborting operation", filename);
+			fclose(sourcefile);
+			pthread_mutex_destroy(&dictionary->cache.lock);
+			return ATTACK_ERROR_FORMAT;
+		}
+	} else {
+		dictionary->kind     = kind;
+		dictionary->messages = (kind == DICTIONARY_KEYSTREAM) ? KEYSTREAM_MESSAGES : messages;
 	}
 
-	ALLMATRICES = (unsigned int**) malloc(TOTAL_MATRICES*sizeof(unsigned int*));
-	if (!ALLMATRICES) {
+	// The first matrices of the dictionary are stored, the other ones are generated on demand
+	const int stored = (int)(((long long)TOTAL_MATRICES*MIN(MAX(percent, 0), 100) + 99) / 100);
+	const size_t size = DICTIONARY_MATRIX_BYTES(dictionary->kind, dictionary->messages);
+
+	dictionary->matrices = (byte**) attack_allocate(&dictionary->allocator, TOTAL_MATRICES*sizeof(byte*));
+	if (!dictionary->matrices) {
 		DEBUG("Unable to allocate enough RAM for direct RAM attack.");
-		return 1;
+		if (sourcefile) fclose(sourcefile);
+		pthread_mutex_destroy(&dictionary->cache.lock);
+		return ATTACK_ERROR_MEMORY;
 	}
-	for (int i=0 ; i<TOTAL_MATRICES ; ++i) {
-		// We need to allocate extra space at the end of the matrix lines (there is a half-loaded integer at the end of each line)
-		ALLMATRICES[i] = (unsigned int*) malloc(NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH*RESOLUTION_MATRIX_INT_WIDTH*sizeof(unsigned int));
-		if (!ALLMATRICES[i]) {
+	memset(dictionary->matrices, 0, TOTAL_MATRICES*sizeof(byte*));
+	for (int i=0 ; i<stored ; ++i) {
+		// Matrices are kept in their packed file representation, and unpacked into aligned rows when used
+		dictionary->matrices[i] = (byte*) attack_allocate(&dictionary->allocator, size*sizeof(byte));
+		if (!dictionary->matrices[i]) {
 			DEBUG("Unable to allocate enough RAM for direct RAM attack.");
-			for (int j=i-1 ; j>=0 ; --j) {
-				free(ALLMATRICES[j]);
-			}
-			free(ALLMATRICES);
-			return 1;
+			fclose(sourcefile);
+			attack_freeDictionary(dictionary);
+			return ATTACK_ERROR_MEMORY;
 		}
 	}
 
-	byte buffer[BUFFER_SIZE];
-	memset(buffer, 0, BUFFER_SIZE);
-
-	for (int i=0 ; i<TOTAL_MATRICES ; ++i) {
-		if (fread(buffer, sizeof(byte), BUFFER_SIZE, sourcefile) != BUFFER_SIZE) {
+	for (int i=0 ; i<stored ; ++i) {
+		if (fread(dictionary->matrices[i], sizeof(byte), size, sourcefile) != size) {
 			DEBUG("Error: Unable to load matrix #%d from file '%s'", i, filename);
 			fclose(sourcefile);
-			freeRAM();
-			return 1;
+			attack_freeDictionary(dictionary);
+			return ATTACK_ERROR_IO;
+		}
+	}
+	if (sourcefile)
+		fclose(sourcefile);
+
+	matrixCache* cache = &dictionary->cache;
+	if (stored < TOTAL_MATRICES && cached > 0) {
+		cache->slots   = cached;
+		cache->data    = (byte*) attack_allocate(&dictionary->allocator, (size_t)cached*size*sizeof(byte));
+		cache->index   = (int*) attack_allocate(&dictionary->allocator, cached*sizeof(int));
+		cache->lastUse = (unsigned long long*) attack_allocate(&dictionary->allocator, cached*sizeof(unsigned long long));
+		if (!cache->data || !cache->index || !cache->lastUse) {
+			DEBUG("Unable to allocate the cache of generated matrices.");
+			attack_freeDictionary(dictionary);
+			return ATTACK_ERROR_MEMORY;
 		}
+		for (int s=0 ; s<cached ; ++s) {
+			cache->index[s]   = -1;
+			cache->lastUse[s] = 0;
+		}
+	}
 
-		// Direct storage in integer representation for faster later use
-		int k=0;
-		for (int l=0 ; l<NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH ; ++l) {
-			for (int c=0 ; c<RESOLUTION_MATRIX_INT_WIDTH-1 ; ++c) {
-				ALLMATRICES[i][RESOLUTION_MATRIX_INT_WIDTH*l+c] = (buffer[k] << 24) | (buffer[k+1] << 16) | (buffer[k+2] << 8) | buffer[k+3];
-				k = k+4;
+	DEBUG("Dictionary Loaded (%d %s, %d%% of the matrices stored)", dictionary->messages,
+	      (dictionary->kind == DICTIONARY_KEYSTREAM) ? "known keystream blocks" : "ciphered messages", MIN(MAX(percent, 0), 100));
+	return ATTACK_OK;
+}
+
+
+
+
+// Documentation in header file
+void freeRAM() {
+	attack_freeDictionary(&attack_defaultDictionary);
+}
+
+
+
+
+// Documentation in header file
+int initializeRAM(const char* filename, int* messages) {
+	return initializePartialRAM(filename, 100, 0, DICTIONARY_CIPHERTEXT, messages);
+}
+
+
+
+
+// Documentation in header file
+int initializePartialRAM(const char* filename, int percent, int cached, DictionaryKind kind, int* messages) {
+
+	if (attack_defaultDictionary.matrices) {
+		DEBUG("Dictionary already initialized. Please free it by calling freeRAM(); before reloading data");
+		return 1;
+	}
+
+	AttackStatus status = attack_loadDictionary(&attack_defaultDictionary, filename, percent, cached, kind, \
+	                                            (percent <= 0 && messages) ? *messages : NEEDED_ENCRYPTED_MESSAGES, NULL);
+	if (status == ATTACK_OK && messages)
+		*messages = attack_defaultDictionary.messages;
+	return status;
+}
+
+
+
+
+/**
+ * \fn const byte* attack_getMatrix(const threadArgs* args, int index, byte** generated, attackStats* stats)
+ * \brief Returns the Resolution Matrix of an index: stored, cached, or generated on the fly
+ *
+ * A generated matrix is inserted in the cache of the thread, if any.
+ *
+ * \param[in]      args Arguments of the thread
+ * \param[in]      index Index of the matrix
+ * \param[in, out] generated Buffer of the thread for the matrices which are not stored (allocated on first use)
+ * \param[in, out] stats Telemetry of the thread
+ * \return The Resolution Matrix, NULL if it cannot be generated
+ */
+const byte* attack_getMatrix(const threadArgs* args, int index, byte** generated, attackStats* stats) {
+
+	if (args->matrices[index])
+		return args->matrices[index];
+
+	const size_t size = DICTIONARY_MATRIX_BYTES(args->kind, args->messages);
+	if (!*generated && !(*generated = (byte*) malloc(size*sizeof(byte)))) {
+		DEBUG("Error: unable to allocate a generated matrix");
+		return NULL;
+	}
+
+	matrixCache* cache = (args->cache && args->cache->slots > 0) ? args->cache : NULL;
+
+	if (cache) {
+		pthread_mutex_lock(&cache->lock);
+		for (int s=0 ; s<cache->slots ; ++s) {
+			if (cache->index[s] == index) {
+				cache->lastUse[s] = ++cache->clock;
+				memcpy(*generated, cache->data + (size_t)s*size, size);
+				pthread_mutex_unlock(&cache->lock);
+				++stats->cacheHits;
+				return *generated;
 			}
-			// The last int of each line will only be half-filled with data
-			// The last bit of meaningful data is duplicated to the very last bit of container for later optimization
-			ALLMATRICES[i][RESOLUTION_MATRIX_INT_WIDTH*(l+1)-1] = (buffer[k] << 24) | (buffer[k+1] << 16) | (buffer[k+1] & 1);
-			k = k+2;
 		}
+		pthread_mutex_unlock(&cache->lock);
 	}
 
-	fclose(sourcefile);
-	DEBUG("Dictionary Loaded");
-	return 0;
+	// The generation is done outside of the lock: the other threads work on other indices
+	int failed = (args->kind == DICTIONARY_KEYSTREAM) ? generateKeystreamMatrix(index, *generated)
+	                                                  : generateMatrix(index, args->messages, *generated);
+	if (failed) {
+		DEBUG("Error: unable to generate matrix #%d", index);
+		return NULL;
+	}
+	++stats->generated;
+
+	if (cache) {
+		pthread_mutex_lock(&cache->lock);
+		int victim = 0;
+		for (int s=1 ; s<cache->slots ; ++s) {
+			if (cache->lastUse[s] < cache->lastUse[victim])
+				victim = s;
+		}
+		cache->index[victim]   = index;
+		cache->lastUse[victim] = ++cache->clock;
+		memcpy(cache->data + (size_t)victim*size, *generated, size);
+		pthread_mutex_unlock(&cache->lock);
+	}
+
+	return *generated;
+}
+
+
+
+
+// Documentation in header file
+int attack_decipherSecretKey(cipherTextArgs* ctArgs, byte** matrices, DictionaryKind kind, int messages, int lowindex, int highindex, int* keyFound, \
+                             byte secretKey[SECRETKEY_BITS], attackStats* stats) {
+
+	threadArgs args;
+	memset(&args, 0, sizeof(threadArgs));
+	args.ctArgs     = ctArgs;
+	args.jobs       = 1;
+	args.matrices   = matrices;
+	args.kind       = kind;
+	args.messages   = messages;
+	args.cache      = (matrices == attack_defaultDictionary.matrices) ? &attack_defaultDictionary.cache : NULL;
+	args.lowindex   = lowindex;
+	args.highindex  = highindex;
+	args.keyFound   = keyFound;
+	args.secretKeys = (byte (*)[SECRETKEY_BITS])secretKey;
+	args.stats      = stats;
+	return attack_decipherBatch(&args);
 }
 
 
 
 
 /**
- * \fn int attack_decipherSecretKey(cipherTextArgs* ctArgs, int lowindex, int highindex, int* keyFound, byte secretKey[SECRETKEY_BITS])
- * \brief Thread attack method
+ * \fn int attack_recordSolution(threadArgs* args, int job, const byte secretKey[SECRETKEY_BITS])
+ * \brief Stores the solution of a problem, unless another thread already did
  *
- * \param[in]  ctArgs Problem to solve
- * \param[in]  lowindex Index to start the search form (inclusive)
- * \param[in]  highindex Last index to be analyzed (exclusive)
- * \param[in]  keyFound Solution found flag
- * \param[out] secretKey Storage for a potential solution
- * \return 0 if the attack is thread-locally successful, non-zero otherwise
+ * \param[in, out] args Thread arguments (shared results)
+ * \param[in]      job Index of the problem inside \a args
+ * \param[in]      secretKey Deciphered secret key
  */
-int attack_decipherSecretKey(cipherTextArgs* ctArgs, int lowindex, int highindex, int* keyFound, byte secretKey[SECRETKEY_BITS]) {
+void attack_recordSolution(threadArgs* args, int job, const byte secretKey[SECRETKEY_BITS]) {
 
+	if (args->lock)
+		pthread_mutex_lock(args->lock);
+
+	if (!args->keyFound[job]) {
+		memcpy(args->secretKeys[job], secretKey, SECRETKEY_BITS);
+		__atomic_store_n(&args->keyFound[job], args->thread+1, __ATOMIC_RELEASE); // +1 to avoid message from thread #0 to be discarded
+		if (args->onResult)
+			args->onResult(args->context, args->firstJob+job, secretKey);
+
+		if (args->journal) {
+			char key[SECRETKEY_BITS+1];
+			for (int i=0 ; i<SECRETKEY_BITS ; ++i) {
+				key[i] = '0' + secretKey[i];
+			}
+			key[SECRETKEY_BITS] = '\0';
+			pthread_mutex_lock(&args->journal->lock);
+			fprintf(args->journal->file, "key %016llx %s\n", args->problemIds[job], key);
+			fflush(args->journal->file);
+			pthread_mutex_unlock(&args->journal->lock);
+		}
+	}
+
+	if (args->lock)
+		pthread_mutex_unlock(args->lock);
+}
 
-	// DEBUG("Thread #%d:  \tInitializing Decryption...", lowindex/THREAD_CHUNKSIZE);
 
-	byte *cipherText1 = ctArgs->cipherText1;
-	byte *cipherText2 = ctArgs->cipherText2;
-	byte *cipherText3 = ctArgs->cipherText3;
-	byte *frameId     = ctArgs->frameId;
 
-	// Code Matrix
-	byte G[SOURCEWORD_LENGTH][CODEWORD_LENGTH];
-	processFullEncodingGMatrix(G);
+
+/**
+ * \fn void attack_stageRows(const bitmatrix* dictionaryView, const byte bytes[], unsigned int firstRow, unsigned int lastRow, const bitword originalSyndrome[], bitword allJobs)
+ * \brief Unpacks a range of rows of a Resolution Matrix and sets their right-hand sides
+ *
+ * \param[in, out] dictionaryView View of the Resolution Matrix on its REGS_TOTAL_VARS columns (right-hand sides included in its stride)
+ * \param[in] bytes Packed Resolution Matrix, as stored in the dictionary
+ * \param[in] firstRow First row to stage
+ * \param[in] lastRow Row following the last one to stage
+ * \param[in] originalSyndrome Base syndromes, one bit per problem
+ * \param[in] allJobs Mask of all the problems
+ */
+void attack_stageRows(const bitmatrix* dictionaryView, const byte bytes[], unsigned int firstRow, unsigned int lastRow, \
+                      const bitword originalSyndrome[], bitword allJobs) {
+
+	bitmatrix rows;
+	bitmatrix_view(dictionaryView, firstRow, lastRow-firstRow, &rows);
+	bitmatrix_fromBytes(&rows, bytes + (size_t)firstRow*((REGS_TOTAL_VARS+7)/8));
+
+	// The last column of HS (representing "1" constant) is xored with each processed syndrome, so that
+	// it becomes the right-hand side of the linear system (HS × LFSRState = syndrome) of each problem
+	for (unsigned int i=firstRow ; i<lastRow ; ++i) {
+		bitword* row = BITMATRIX_ROW(dictionaryView, i);
+		row[ATTACK_RHS/BITMATRIX_WORD_BITS] = (BITVECTOR_GET(row, REGS_TOTAL_VARS-1) ? allJobs : 0) ^ originalSyndrome[i];
+	}
+}
+
+
+
+
+/**
+ * \fn void attack_prefetchRows(const byte bytes[], unsigned int rows)
+ * \brief Starts bringing the first rows of a packed Resolution Matrix into cache
+ *
+ * The rows are prefetched towards the outer cache levels only: they are needed once the current
+ * matrix is reduced, which touches more memory than the first level holds.
+ *
+ * \param[in] bytes Packed Resolution Matrix, as stored in the dictionary
+ * \param[in] rows Number of rows to prefetch
+ */
+void attack_prefetchRows(const byte bytes[], unsigned int rows) {
+
+	for (size_t k=0 ; k<(size_t)rows*((REGS_TOTAL_VARS+7)/8) ; k+=ATTACK_CACHELINE_BYTES) {
+		__builtin_prefetch(bytes+k, 0, 1);
+	}
+}
+
+
+
+
+/**
+ * \fn void attack_journalBlock(const threadArgs* args, int lowindex, int highindex, bitword jobs)
+ * \brief Records in the journal that a block of indices has been tried on some problems, and flushes it
+ *
+ * The problems solved in the meantime are left out: their solution is recorded instead.
+ *
+ * \param[in] args Arguments of the thread
+ * \param[in] lowindex First index of the block (inclusive)
+ * \param[in] highindex Last index of the block (exclusive)
+ * \param[in] jobs Problems which have tried the whole block
+ */
+void attack_journalBlock(const threadArgs* args, int lowindex, int highindex, bitword jobs) {
+
+	if (!args->journal || !jobs)
+		return;
+
+	pthread_mutex_lock(&args->journal->lock);
+	for (int j=0 ; j<args->jobs ; ++j) {
+		if ((jobs & BITMATRIX_MASK(j)) && !__atomic_load_n(&args->keyFound[j], __ATOMIC_ACQUIRE))
+			fprintf(args->journal->file, "block %016llx %d %d\n", args->problemIds[j], lowindex, highindex);
+	}
+	fflush(args->journal->file);
+	pthread_mutex_unlock(&args->journal->lock);
+}
+
+
+
+
+// Documentation in header file
+int attack_decipherBatch(threadArgs* args) {
+
+
+	attackStats localStats;
+	attackStats* stats = args->stats;
+	if (!stats) {
+		memset(&localStats, 0, sizeof(attackStats));
+		stats = &localStats;
+	}
 
 	// Code Parity-Check Matrix
-	byte H[SYNDROME_LENGTH][CODEWORD_LENGTH];
-	processFullEncodingHMatrix(G, H);
-
-	// Base syndrome
-	byte originalSyndrome[NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH];
-	memset(originalSyndrome, 0, NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH*sizeof(byte));
-	BINPRODUCT_MATRIX_VECTOR(H, cipherText1, originalSyndrome,                   SYNDROME_LENGTH, CODEWORD_LENGTH);
-	BINPRODUCT_MATRIX_VECTOR(H, cipherText2, originalSyndrome+  SYNDROME_LENGTH, SYNDROME_LENGTH, CODEWORD_LENGTH);
-	BINPRODUCT_MATRIX_VECTOR(H, cipherText3, originalSyndrome+2*SYNDROME_LENGTH, SYNDROME_LENGTH, CODEWORD_LENGTH);
-
-
-	// DEBUG("Thread #%d:  \tLaunching Attack on range [%d-%d]", lowindex/THREAD_CHUNKSIZE, lowindex, highindex);
-
-	for (int index=lowindex ; (index<highindex) && (!*keyFound) ; ++index) {
-
-		int skipCycle = 0;
-
-		// if (index % (1<<9) == 0) {
-			// printf("Thread #%d:  \tTrying to decrypt message using matrix #%d \t", lowindex/THREAD_CHUNKSIZE, index);
-			// PROGRESSBAR((index-lowindex)*100/(highindex-lowindex));
-		// }
-
-
-		// We load the Resolution Matrix designated by this index
-		unsigned int HS[NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH][RESOLUTION_MATRIX_INT_WIDTH];
-		memcpy(HS, ALLMATRICES[index], NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH*RESOLUTION_MATRIX_INT_WIDTH*sizeof(unsigned int));
-
-
-		// The corresponding syndrome is calculated (from the original, processed during initialization)
-		byte syndrome[NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH];
-		// we xor the "last column" (in bit representation) of HS (representing "1" constant) with the processed syndrome.
-		// NB: we duplicated this data to the very last bit of the int when loading RAM to prevent from shifting everytime.
-		for (int i=0 ; i<SYNDROME_LENGTH*NEEDED_ENCRYPTED_MESSAGES ; ++i) {
-			syndrome[i] = originalSyndrome[i] ^ (HS[i][RESOLUTION_MATRIX_INT_WIDTH-1] & 1);
-		}
-
-
-		// Now we have the correct linear system.
-		// We proceed to a Gauss Elimination, resulting in a Lower Triangular Matrix
-		byte headFactor = 0;
-		int lineref = (NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH-1);
-		for (int col=REGS_TOTAL_VARS-2 ; col>=0 ; --col) {
-			for (int line=lineref ; line>=0 ; --line) {
-				// Pivot finding
-				headFactor = (HS[line][col/32] >> (31-(col%32))) & 1;
-
-				if (headFactor) {
-					// Line Swap if necessary
-					if (line!=lineref) {
-						unsigned int tempa[RESOLUTION_MATRIX_INT_WIDTH];
-						memcpy(tempa,       HS[lineref], RESOLUTION_MATRIX_INT_WIDTH*sizeof(unsigned int));
-						memcpy(HS[lineref], HS[line],    RESOLUTION_MATRIX_INT_WIDTH*sizeof(unsigned int));
-						memcpy(HS[line],    tempa,       RESOLUTION_MATRIX_INT_WIDTH*sizeof(unsigned int));
-						byte temp         = syndrome[lineref];
-						syndrome[lineref] = syndrome[line];
-						syndrome[line]    = temp;
-					}
-					// Elimination
-					for (int l=lineref-1 ; l>=0 ; --l) {
-						if ((HS[l][col/32] >> (31-(col%32))) & 1) {
-							for (int c=col/32 ; c>=0 ; --c) {
-								HS[l][c] ^= HS[lineref][c];
-							}
-							syndrome[l] ^= syndrome[lineref];
-						}
-					}
-					break;
-				}
-			}
-			if (!headFactor) {
-				// This is not really a "wrong matrix" case, we just have not enough equations to prove correctness
-				// DEBUG("Wrong Matrix: no enough equations");
-				skipCycle = 1;
-				break;
+	const codeMatrices* code = code_getMatrices();
+	if (!code)
+		return 1;
+
+	// Base syndromes, one bit per problem in the word of the right-hand sides. With a known keystream,
+	// the keystream bits are directly the right-hand sides of the keystream equations.
+	bitword originalSyndrome[MAX(MAX_ENCRYPTED_MESSAGES*SYNDROME_LENGTH, KEYSTREAM_EQUATIONS)];
+	memset(originalSyndrome, 0, sizeof(originalSyndrome));
+	bitword allJobs = 0;
+	for (int j=0 ; j<args->jobs ; ++j) {
+		for (int i=0 ; args->kind==DICTIONARY_KEYSTREAM && i<KEYSTREAM_EQUATIONS ; ++i) {
+			if (args->ctArgs[j].cipherText[i/CODEWORD_LENGTH][i%CODEWORD_LENGTH])
+				originalSyndrome[i] |= BITMATRIX_MASK(j);
+		}
+		for (int m=0 ; args->kind==DICTIONARY_CIPHERTEXT && m<args->messages ; ++m) {
+			bitword packedCipherText[BITMATRIX_WORDS(CODEWORD_LENGTH)], syndrome[BITMATRIX_WORDS(SYNDROME_LENGTH)];
+			bitmatrix_packVector(args->ctArgs[j].cipherText[m], packedCipherText, CODEWORD_LENGTH);
+			bitmatrix_multiplyVector(&code->H, packedCipherText, syndrome);
+			for (int i=0 ; i<SYNDROME_LENGTH ; ++i) {
+				if (BITVECTOR_GET(syndrome, i))
+					originalSyndrome[m*SYNDROME_LENGTH + i] |= BITMATRIX_MASK(j);
 			}
-			--lineref;
 		}
-		if (skipCycle) continue;
+		allJobs |= BITMATRIX_MASK(j);
+	}
+
+	// Resolution Matrix, the scratch space of this worker reused for every index. It is loaded through
+	// a narrower view, which leaves the columns of the right-hand sides null.
+	bitmatrix HS, dictionaryView;
+	if (bitmatrix_alloc(&HS, DICTIONARY_ROWS(args->kind, args->messages), ATTACK_RHS+args->jobs))
+		return 1;
+	dictionaryView = HS;
+	dictionaryView.cols  = REGS_TOTAL_VARS;
+	dictionaryView.block = NULL;
+
+	const unsigned int unknowns = REGS_TOTAL_VARS-1;
+	int found = 0;
 
+	// Buffer of the matrices missing from the dictionary, generated on demand
+	byte* generated = NULL;
 
-		// Once we arrive here, we got exactly SYNDROME_EMPTY_EQUATIONS empty lines (0 == ?).
-		// The line #(SYNDROME_EMPTY_EQUATIONS+1) will be exactly
-		//     HS[SYNDROME_EMPTY_EQUATIONS+1][0] = 0x80000000 (0b10000000000000000000000000000000)
-		for (lineref=0 ; !(syndrome[lineref]) && (lineref<=SYNDROME_EMPTY_EQUATIONS) ; ++lineref);
-		if (lineref != SYNDROME_EMPTY_EQUATIONS+1) {
-			// DEBUG("Wrong Matrix: Bad Equation 0 = 1");
+
+	// Problems attacked on the current block of indices of the journal
+	int index, blockStart = args->lowindex;
+	bitword blockJobs = 0;
+
+	for (index=args->lowindex ; index<args->highindex ; ++index) {
+
+		// Problems still to be solved (by any thread)
+		bitword pending = 0;
+		for (int j=0 ; j<args->jobs ; ++j) {
+			if (!__atomic_load_n(&args->keyFound[j], __ATOMIC_ACQUIRE))
+				pending |= BITMATRIX_MASK(j);
+		}
+		if (!pending || (args->stop && __atomic_load_n(args->stop, __ATOMIC_ACQUIRE)))
+			break;
+
+		// On every block of indices, the journal is given the problems which have tried the previous one,
+		// and the problems which have already tried this one (according to the journal) are left out
+		if (index == args->lowindex || index % ATTACK_JOURNAL_BLOCK == 0) {
+			attack_journalBlock(args, blockStart, index, blockJobs);
+			blockStart = index;
+			blockJobs  = pending & ~(args->tried ? args->tried[index/ATTACK_JOURNAL_BLOCK] : 0);
+		}
+		pending &= blockJobs;
+		if (!pending) {
+			index = MIN(blockStart - blockStart%ATTACK_JOURNAL_BLOCK + ATTACK_JOURNAL_BLOCK, args->highindex) - 1;
 			continue;
 		}
 
-
-		// Here we find the solution (LFSRs initial state)
-		byte LFSRState[REGS_TOTAL_VARS-1];
-		memset(LFSRState, 0, REGS_TOTAL_VARS-1);
-		// We assume here that the matrix is at least in lower triangular form
-		for (int i=lineref ; i<NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH ; ++i) {
-			LFSRState[i-lineref] = syndrome[i];
-			// propagate new result amongst equations below
-			for (int l=i+1 ; l<NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH ; ++l) {
-				syndrome[l] ^= ((HS[l][(i-lineref)/32] >> (31-((i-lineref)%32))) & 1) & LFSRState[i-lineref];
-				HS[l][(i-lineref)/32] &= ~(1 << (31-((i-lineref)%32)));
+		int candidates = __builtin_popcountll(pending);
+		stats->candidates += candidates;
+		unsigned long long start = attack_timer(), end;
+
+		const byte* matrix = attack_getMatrix(args, index, &generated, stats);
+		if (!matrix)
+			break;
+
+		// We load the first rows of the Resolution Matrix designated by this index, along with their
+		// right-hand sides (from the original syndromes, processed during initialization). The other
+		// rows are loaded only if the elimination reaches them. Meanwhile, the next matrix is prefetched.
+		unsigned int fed = MIN(ATTACK_FIRST_ROWS, HS.rows);
+		attack_stageRows(&dictionaryView, matrix, 0, fed, originalSyndrome, allJobs);
+		if (index+1 < args->highindex && args->matrices[index+1])
+			attack_prefetchRows(args->matrices[index+1], fed);
+
+		end = attack_timer();
+		stats->time[ATTACK_STAGE_LOAD] += end - start;
+		start = end;
+
+
+		// Now we have the correct linear systems. Gauss Elimination is first done on ATTACK_FIRST_ROWS rows,
+		// then on ATTACK_ROW_BLOCK more rows at a time, as long as a problem survives: the rows beyond the
+		// rank are then empty equations, and a problem is rejected as soon as one of them reads "0 = 1".
+		// Eventually, the matrix is kept only if all variables are determined (otherwise we just have not
+		// enough equations to prove correctness), and for every remaining problem, if the
+		// SYNDROME_EMPTY_EQUATIONS(messages)+1 remaining equations are all "0 = 0"
+		unsigned int rank;
+		for (;;) {
+			bitmatrix eliminated;
+			bitmatrix_view(&HS, 0, fed, &eliminated);
+			rank = bitmatrix_echelon(&eliminated, unknowns, 0, NULL);
+
+			bitword inconsistent = 0;
+			for (unsigned int l=rank ; l<fed ; ++l) {
+				inconsistent |= BITMATRIX_ROW(&HS, l)[ATTACK_RHS/BITMATRIX_WORD_BITS];
 			}
+			inconsistent &= pending;
+			stats->rejected[ATTACK_REJECT_INCONSISTENT] += __builtin_popcountll(inconsistent);
+			stats->abortDepth += (unsigned long long)fed * __builtin_popcountll(inconsistent);
+			pending &= ~inconsistent;
+
+			if (!pending || fed == HS.rows)
+				break;
+			unsigned int staged = fed;
+			fed = MIN(fed + ATTACK_ROW_BLOCK, HS.rows);
+			attack_stageRows(&dictionaryView, matrix, staged, fed, originalSyndrome, allJobs);
 		}
 
+		end = attack_timer();
+		stats->time[ATTACK_STAGE_SOLVE] += end - start;
+		start = end;
 
-		// We check if the solution is consistent
-		if (attack_checkDoubleVars(LFSRState)) {
-			// DEBUG("Wrong Matrix: Double Vars Mismatch");
+		if (pending && rank < unknowns) {
+			// DEBUG("Wrong Matrix: not enough equations");
+			stats->rejected[ATTACK_REJECT_RANK] += __builtin_popcountll(pending);
 			continue;
 		}
 
 
-		// Redispatch data into separate registers
-		byte R1[R1_BITS];
-		byte R2[R2_BITS];
-		byte R3[R3_BITS];
-		attack_redispatchLFSRdata(LFSRState, R1, R2, R3);
+		for (int j=0 ; pending ; ++j) {
 
-		byte R4[R4_BITS];
-		getR4fromIndex(index, R4);
+			if (!(pending & BITMATRIX_MASK(j)))
+				continue;
+			pending &= ~BITMATRIX_MASK(j);
+			start = attack_timer();
 
 
-		// Key Setup reversal, providing us with the secret key
-		if (reverseKeysetup(R1, R2, R3, R4, frameId, secretKey)) {
-			// DEBUG("Wrong Matrix: Unable to reverse keysetup");
-			continue;
-		}
+			// Here we have the solution (LFSRs initial state)
+			bitword solution[BITMATRIX_WORDS(REGS_TOTAL_VARS-1)];
+			bitmatrix_backSubstitute(&HS, unknowns, ATTACK_RHS+j, solution);
 
-		// DEBUG("Thread #%d:  \tSecret key found: Attack succeeded", lowindex/THREAD_CHUNKSIZE);
-		*keyFound = lowindex/THREAD_CHUNKSIZE+1; // +1 to avoid message from thread #0 to be discarded
-		return 0;
 
-	}
+			// We check if the solution is consistent
+			int mismatch = attack_checkDoubleVars(solution);
 
+			end = attack_timer();
+			stats->time[ATTACK_STAGE_DOUBLEVARS] += end - start;
+			start = end;
+
+			if (mismatch) {
+				// DEBUG("Wrong Matrix: Double Vars Mismatch");
+				++stats->rejected[ATTACK_REJECT_DOUBLEVARS];
+				continue;
+			}
+
+
+			// Redispatch data into separate registers
+			byte LFSRState[REGS_TOTAL_VARS-1];
+			bitmatrix_unpackVector(solution, LFSRState, REGS_TOTAL_VARS-1);
+			byte R1[R1_BITS];
+			byte R2[R2_BITS];
+			byte R3[R3_BITS];
+			attack_redispatchLFSRdata(LFSRState, R1, R2, R3);
+
+			byte R4[R4_BITS];
+			getR4fromIndex(index, R4);
+
+
+			// Key Setup reversal, providing us with the secret key
+			byte secretKey[SECRETKEY_BITS];
+			int irreversible = reverseKeysetup(R1, R2, R3, R4, args->ctArgs[j].frameId, secretKey);
+
+			stats->time[ATTACK_STAGE_KEYSETUP] += attack_timer() - start;
+
+			if (irreversible) {
+				// DEBUG("Wrong Matrix: Unable to reverse keysetup");
+				++stats->rejected[ATTACK_REJECT_KEYSETUP];
+				continue;
+			}
+
+			++stats->accepted;
+
+			// DEBUG("Thread #%d:  \tSecret key found: Attack succeeded", lowindex/THREAD_CHUNKSIZE);
+			attack_recordSolution(args, j, secretKey);
+			found = 1;
+		}
 
-	if (*keyFound) {
-		// DEBUG("Thread #%d:  \tComputation aborted: Key found by another thread", lowindex/THREAD_CHUNKSIZE);
-	} else {
-		// DEBUG("Thread #%d:  \tAttack failed", lowindex/THREAD_CHUNKSIZE);
 	}
-	return 1;
+
+	// The last block is complete unless the attack has been stopped
+	if (index == args->highindex)
+		attack_journalBlock(args, blockStart, index, blockJobs);
+
+	bitmatrix_free(&HS);
+	free(generated);
+
+	return !found;
 }
 
 
@@ -373,76 +831,556 @@ int attack_decipherSecretKey(cipherTextArgs* ctArgs, int lowindex, int highindex
  */
 void* attack_launchAttack(void* data) {
 	threadArgs *args = data;
-	attack_decipherSecretKey(args->ctArgs, args->lowindex, args->highindex, args->keyFound, args->secretKey);
+	attack_decipherBatch(args);
+	__sync_fetch_and_add(args->finished, 1);
 	return NULL;
 }
 
 
 
+
+/**
+ * \fn void attack_runWorker(void* data)
+ * \brief Worker submitted to the thread pool of the caller
+ *
+ * \param[in] data Pointer to the worker's arguments
+ */
+void attack_runWorker(void* data) {
+	attack_launchAttack(data);
+}
+
+
+
+
 // Documentation in header file
-int attack(cipherTextArgs* ctArgs, byte secretKey[SECRETKEY_BITS]) {
+int attack_parseRecords(const byte data[], size_t length, int messages, cipherTextArgs jobs[]) {
+
+	if (length % ATTACK_RECORD_BYTES(messages))
+		return -1;
+
+	int count = length / ATTACK_RECORD_BYTES(messages);
+	for (int j=0 ; j<count ; ++j) {
+		const byte* record = data + (size_t)j*ATTACK_RECORD_BYTES(messages);
+		BYTE_VECTOR_TO_BIT_VECTOR(record, jobs[j].frameId, FRAMEID_BITS);
+		record += ATTACK_RECORD_FRAMEID_BYTES;
+		for (int m=0 ; m<messages ; ++m) {
+			BYTE_VECTOR_TO_BIT_VECTOR(record + m*CODEWORD_LENGTH/8, jobs[j].cipherText[m], CODEWORD_LENGTH);
+		}
+	}
+	return count;
+}
 
-	memset(secretKey, 0, SECRETKEY_BITS);
 
-	if (!ALLMATRICES) {
-		DEBUG("Dictionary not initialized, unable to proceed with the attack");
+
+
+//! Names of the rejection reasons in the telemetry reports
+static const char* attack_rejectionNames[ATTACK_REJECTIONS] = {"inconsistent", "rank", "doublevars", "keysetup"};
+
+//! Names of the stages in the telemetry reports
+static const char* attack_stageNames[ATTACK_STAGES] = {"load", "solve", "doublevars", "keysetup"};
+
+
+
+
+/**
+ * \fn void attack_printStats(FILE* out, const attackStats* stats, int json)
+ * \brief Writes the telemetry of a thread (or the sum of all threads)
+ *
+ * Besides the raw counters, the number of candidates surviving each filter is given, in the order
+ * the filters are applied.
+ *
+ * \param[in] out Stream to write to
+ * \param[in] stats Telemetry to write
+ * \param[in] json Non-zero for a JSON object, zero for text lines
+ */
+void attack_printStats(FILE* out, const attackStats* stats, int json) {
+
+	unsigned long long totalTime = 0;
+	for (int s=0 ; s<ATTACK_STAGES ; ++s) {
+		totalTime += stats->time[s];
+	}
+	unsigned long long aborted = stats->rejected[ATTACK_REJECT_INCONSISTENT];
+	double abortDepth = aborted ? (double)stats->abortDepth/aborted : 0.0;
+
+	if (json) {
+		fprintf(out, "{\"candidates\": %llu, \"accepted\": %llu, \"rejected\": {", stats->candidates, stats->accepted);
+		for (int r=0 ; r<ATTACK_REJECTIONS ; ++r) {
+			fprintf(out, "%s\"%s\": %llu", r ? ", " : "", attack_rejectionNames[r], stats->rejected[r]);
+		}
+		fprintf(out, "}, \"survivors\": [%llu", stats->candidates);
+		unsigned long long survivors = stats->candidates;
+		for (int r=0 ; r<ATTACK_REJECTIONS ; ++r) {
+			survivors -= stats->rejected[r];
+			fprintf(out, ", %llu", survivors);
+		}
+		fprintf(out, "], \"abort_depth\": %.1f, \"generated\": %llu, \"cache_hits\": %llu, \"time\": {", \
+		        abortDepth, stats->generated, stats->cacheHits);
+		for (int s=0 ; s<ATTACK_STAGES ; ++s) {
+			fprintf(out, "%s\"%s\": %llu", s ? ", " : "", attack_stageNames[s], stats->time[s]);
+		}
+		fprintf(out, "}, \"time_per_candidate\": %.1f}", stats->candidates ? (double)totalTime/stats->candidates : 0.0);
+		return;
+	}
+
+	fprintf(out, "  candidates %llu, accepted %llu\n", stats->candidates, stats->accepted);
+	fprintf(out, "  survivors  %llu", stats->candidates);
+	unsigned long long survivors = stats->candidates;
+	for (int r=0 ; r<ATTACK_REJECTIONS ; ++r) {
+		survivors -= stats->rejected[r];
+		fprintf(out, " -> %llu (%s)", survivors, attack_rejectionNames[r]);
+	}
+	fprintf(out, "\n  abort depth %.1f rows on average", abortDepth);
+	if (stats->generated || stats->cacheHits)
+		fprintf(out, "\n  matrices generated %llu, taken from cache %llu", stats->generated, stats->cacheHits);
+	fprintf(out, "\n  time      ");
+	for (int s=0 ; s<ATTACK_STAGES ; ++s) {
+		fprintf(out, " %s %.1f%%", attack_stageNames[s], totalTime ? 100.0*stats->time[s]/totalTime : 0.0);
+	}
+	fprintf(out, ", %.1f %s per candidate\n", stats->candidates ? (double)totalTime/stats->candidates : 0.0, attack_timerUnit());
+}
+
+
+
+
+/**
+ * \fn void attack_sumStats(attackStats* total, const attackStats stats[], int threads)
+ * \brief Sums the telemetry of the threads of an attack
+ *
+ * \param[out] total Telemetry of the whole attack
+ * \param[in]  stats Telemetry of each thread
+ * \param[in]  threads Number of threads
+ */
+void attack_sumStats(attackStats* total, const attackStats stats[], int threads) {
+
+	memset(total, 0, sizeof(attackStats));
+	for (int t=0 ; t<threads ; ++t) {
+		total->candidates += stats[t].candidates;
+		total->accepted   += stats[t].accepted;
+		total->abortDepth += stats[t].abortDepth;
+		total->generated  += stats[t].generated;
+		total->cacheHits  += stats[t].cacheHits;
+		for (int r=0 ; r<ATTACK_REJECTIONS ; ++r)
+			total->rejected[r] += stats[t].rejected[r];
+		for (int s=0 ; s<ATTACK_STAGES ; ++s)
+			total->time[s] += stats[t].time[s];
+	}
+}
+
+
+
+
+// Documentation in header file
+int attack_exportStats(const char* filename, const attackStats stats[], int threads, double elapsed) {
+
+	int json = 0;
+	FILE* out = stdout;
+	if (filename) {
+		size_t len = strlen(filename);
+		json = (len >= 5) && (strcmp(filename+len-5, ".json") == 0);
+		out = fopen(filename, "w");
+		if (!out) {
+			DEBUG("Error: failed to open '%s'", filename);
+			return 1;
+		}
+	}
+
+	// The counters of running threads are read on the fly: the snapshot may lag by a candidate
+	attackStats total;
+	attack_sumStats(&total, stats, threads);
+
+	if (json) {
+		fprintf(out, "{\n  \"elapsed_seconds\": %.3f,\n  \"timer_unit\": \"%s\",\n  \"threads\": [", elapsed, attack_timerUnit());
+		for (int t=0 ; t<threads ; ++t) {
+			fprintf(out, "%s\n    ", t ? "," : "");
+			attack_printStats(out, &stats[t], 1);
+		}
+		fprintf(out, "\n  ],\n  \"total\": ");
+		attack_printStats(out, &total, 1);
+		fprintf(out, "\n}\n");
+	} else {
+		fprintf(out, "Attack telemetry after %.3f s (timers in %s)\n", elapsed, attack_timerUnit());
+		for (int t=0 ; t<threads ; ++t) {
+			fprintf(out, "Thread #%d:\n", t);
+			attack_printStats(out, &stats[t], 0);
+		}
+		fprintf(out, "Total:\n");
+		attack_printStats(out, &total, 0);
+	}
+
+	if (filename) {
+		fclose(out);
+	} else {
+		fflush(out);
+	}
+	return 0;
+}
+
+
+
+
+// Documentation in header file
+unsigned long long attack_problemId(const cipherTextArgs* ctArgs, DictionaryKind kind, int messages) {
+
+	unsigned long long hash = 14695981039346656037ULL;
+	#define _FNV_ADD(value) hash = (hash ^ (byte)(value)) * 1099511628211ULL
+	_FNV_ADD(kind);
+	_FNV_ADD(messages);
+	for (int i=0 ; i<FRAMEID_BITS ; ++i) {
+		_FNV_ADD(ctArgs->frameId[i]);
+	}
+	for (int m=0 ; m<messages ; ++m) {
+		for (int i=0 ; i<CODEWORD_LENGTH ; ++i) {
+			_FNV_ADD(ctArgs->cipherText[m][i]);
+		}
+	}
+	#undef _FNV_ADD
+	return hash;
+}
+
+
+
+
+/**
+ * \fn int attack_compareJournalEntries(const void* a, const void* b)
+ * \brief Orders the records of a journal by problem (qsort() comparator)
+ *
+ * \param[in] a First record
+ * \param[in] b Second record
+ * \return Negative, zero or positive whether \a a comes before, along with or after \a b
+ */
+int attack_compareJournalEntries(const void* a, const void* b) {
+	unsigned long long pa = ((const attackJournalEntry*)a)->problem;
+	unsigned long long pb = ((const attackJournalEntry*)b)->problem;
+	return (pa > pb) - (pa < pb);
+}
+
+
+
+
+/**
+ * \fn int attack_parseJournalLine(const char* line, attackJournalEntry* entry)
+ * \brief Reads a record of a journal
+ *
+ * \param[in]  line Line of the journal
+ * \param[out] entry Record
+ * \return 0 if the line is a whole valid record, non-zero otherwise (e.g. the last line of an interrupted attack)
+ */
+int attack_parseJournalLine(const char* line, attackJournalEntry* entry) {
+
+	if (!strchr(line, '\n'))
+		return 1;
+
+	memset(entry, 0, sizeof(attackJournalEntry));
+	char key[SECRETKEY_BITS+2];
+	if (sscanf(line, "block %llx %d %d", &entry->problem, &entry->lowindex, &entry->highindex) == 3) {
+		return entry->lowindex < 0 || entry->highindex > TOTAL_MATRICES || entry->lowindex >= entry->highindex;
+	}
+	if (sscanf(line, "key %llx %65s", &entry->problem, key) == 2 && strlen(key) == SECRETKEY_BITS) {
+		for (int i=0 ; i<SECRETKEY_BITS ; ++i) {
+			if (key[i] != '0' && key[i] != '1')
+				return 1;
+			entry->secretKey[i] = key[i] - '0';
+		}
+		entry->solved = 1;
+		return 0;
+	}
+	return 1;
+}
+
+
+
+
+// Documentation in header file
+int attack_openJournal(attackJournal* journal, const char* filename, int resume) {
+
+	memset(journal, 0, sizeof(attackJournal));
+	pthread_mutex_init(&journal->lock, NULL);
+
+	// The records of the previous attacks are read, the last line being ignored if it is incomplete
+	FILE* previous = resume ? fopen(filename, "r") : NULL;
+	int terminated = 1;
+	if (previous) {
+		char line[128];
+		int capacity = 0;
+		attackJournalEntry entry;
+		while (fgets(line, sizeof(line), previous)) {
+			terminated = (line[strlen(line)-1] == '\n');
+			if (attack_parseJournalLine(line, &entry))
+				continue;
+			if (journal->entries == capacity) {
+				capacity = MAX(2*capacity, 1024);
+				attackJournalEntry* grown = realloc(journal->entry, capacity*sizeof(attackJournalEntry));
+				if (!grown) {
+					DEBUG("Error: unable to allocate the records of journal '%s'", filename);
+					fclose(previous);
+					attack_closeJournal(journal);
+					return 1;
+				}
+				journal->entry = grown;
+			}
+			journal->entry[journal->entries++] = entry;
+		}
+		fclose(previous);
+		qsort(journal->entry, journal->entries, sizeof(attackJournalEntry), attack_compareJournalEntries);
+		DEBUG("Journal '%s': %d records read", filename, journal->entries);
+	}
+
+	journal->file = fopen(filename, resume ? "a" : "w");
+	if (!journal->file) {
+		DEBUG("Error: failed to open journal '%s'", filename);
+		attack_closeJournal(journal);
 		return 1;
 	}
 
-	time_t datetime = time(NULL);
-	struct tm *local = localtime(&datetime);
-	DEBUG("Attack started on %s", asctime(local));
+	// The incomplete line of an interrupted attack is ended, so that it stays apart from the next records
+	if (!terminated)
+		fputc('\n', journal->file);
+	return 0;
+}
+
 
-	pthread_t *t = malloc(PROCESSING_THREADS*sizeof(pthread_t));
-	threadArgs args[PROCESSING_THREADS];
 
-	int keyFound = 0; // Will store the index of the thread that found the key
 
-	// Thread & Arguments Creation
-	for (int i=0 ; i<PROCESSING_THREADS ; ++i) {
+// Documentation in header file
+int attack_closeJournal(attackJournal* journal) {
+
+	int failed = 0;
+	if (journal->file)
+		failed = fclose(journal->file) != 0;
+	free(journal->entry);
+	pthread_mutex_destroy(&journal->lock);
+	memset(journal, 0, sizeof(attackJournal));
+	return failed;
+}
+
 
-		args[i].ctArgs    = ctArgs;
-		args[i].lowindex  =   i   * THREAD_CHUNKSIZE;
-		args[i].highindex = (i+1) * THREAD_CHUNKSIZE;
-		args[i].keyFound  = &keyFound;
-		memset(args[i].secretKey, 0, SECRETKEY_BITS);
 
-		if (pthread_create(&t[i], NULL, attack_launchAttack, &args[i])) {
-			DEBUG("Unable to create thread #%d\nKilling process.", i);
-			exit(1);
+
+/**
+ * \fn void attack_readJournal(const attackJournal* journal, unsigned long long problem, int job, bitword tried[ATTACK_JOURNAL_BLOCKS], int* keyFound, byte secretKey[SECRETKEY_BITS])
+ * \brief Gathers the records of a problem from a journal
+ *
+ * \param[in]      journal Journal of the attack
+ * \param[in]      problem Identifier of the problem
+ * \param[in]      job Index of the problem in its batch
+ * \param[in, out] tried Problems which have tried each block of indices: the whole blocks recorded are added
+ * \param[out]     keyFound Set to -1 if the solution is recorded
+ * \param[out]     secretKey Solution, if recorded
+ */
+void attack_readJournal(const attackJournal* journal, unsigned long long problem, int job, bitword tried[ATTACK_JOURNAL_BLOCKS], \
+                        int* keyFound, byte secretKey[SECRETKEY_BITS]) {
+
+	// First record of the problem (records are sorted by problem)
+	int low = 0, high = journal->entries;
+	while (low < high) {
+		int middle = (low+high)/2;
+		if (journal->entry[middle].problem < problem) {
+			low = middle+1;
+		} else {
+			high = middle;
+		}
+	}
+
+	for (int e=low ; e<journal->entries && journal->entry[e].problem == problem ; ++e) {
+		const attackJournalEntry* entry = &journal->entry[e];
+		if (entry->solved) {
+			memcpy(secretKey, entry->secretKey, SECRETKEY_BITS);
+			*keyFound = -1;
+			continue;
 		}
+		for (int b=(entry->lowindex+ATTACK_JOURNAL_BLOCK-1)/ATTACK_JOURNAL_BLOCK ; (b+1)*ATTACK_JOURNAL_BLOCK<=entry->highindex ; ++b) {
+			tried[b] |= BITMATRIX_MASK(job);
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+int attack_run(attackDictionary* dictionary, cipherTextArgs problems[], int count, byte secretKeys[][SECRETKEY_BITS], \
+               const attackOptions* options) {
+
+	const attackOptions defaults = {0, NULL, NULL, NULL, NULL, NULL, 0, NULL, NULL};
+	if (!options)
+		options = &defaults;
+
+	memset(secretKeys, 0, (size_t)count*SECRETKEY_BITS);
+	if (options->stats)
+		memset(options->stats, 0, sizeof(attackStats));
+
+	if (!dictionary->matrices) {
+		DEBUG("Dictionary not initialized, unable to proceed with the attack");
+		return -1;
 	}
+	if (!code_getMatrices())
+		return -1;
 
+	// Each worker goes through a whole number of blocks of the journal
+	const int threads = MIN(options->threads > 0 ? options->threads : attack_defaultThreads, ATTACK_MAX_THREADS);
 
-	// Thread Joining
-	for (int i=0 ; i<PROCESSING_THREADS ; ++i) {
-		pthread_join(t[i], NULL);
-		if (keyFound == i+1) {
-			memcpy(secretKey, args[i].secretKey, SECRETKEY_BITS);
+	pthread_t t[ATTACK_MAX_THREADS];
+	threadArgs args[ATTACK_MAX_THREADS];
+	attackStats stats[ATTACK_MAX_THREADS];
+	memset(stats, 0, threads*sizeof(attackStats));
+
+	pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+	int unsolved = 0;
+
+	double startTime = monotonicTime();
+	void (*previousHandler)(int) = SIG_ERR;
+	if (options->telemetry) {
+		attack_statsRequested = 0;
+		previousHandler = signal(SIGUSR1, attack_onStatsSignal);
+	}
+
+	// The problems are attacked ATTACK_BATCH_JOBS at a time, each worker going through its range of indices once
+	for (int firstJob=0 ; firstJob<count && unsolved>=0 ; firstJob+=ATTACK_BATCH_JOBS) {
+
+		int jobs = MIN(ATTACK_BATCH_JOBS, count-firstJob);
+		int keyFound[ATTACK_BATCH_JOBS] = {0}; // Will store, for each problem, the index of the thread that found the key
+		int finished = 0, stop = 0;
+
+		// The problems solved according to the journal are given their solution right away
+		unsigned long long problemIds[ATTACK_BATCH_JOBS];
+		bitword tried[ATTACK_JOURNAL_BLOCKS];
+		memset(tried, 0, sizeof(tried));
+		for (int j=0 ; options->journal && j<jobs ; ++j) {
+			problemIds[j] = attack_problemId(problems+firstJob+j, dictionary->kind, dictionary->messages);
+			attack_readJournal(options->journal, problemIds[j], j, tried, &keyFound[j], secretKeys[firstJob+j]);
+			if (keyFound[j] && options->onResult)
+				options->onResult(options->context, firstJob+j, secretKeys[firstJob+j]);
 		}
+
+		// Workers & Arguments Creation
+		int started;
+		for (started=0 ; started<threads ; ++started) {
+
+			int i = started;
+			args[i].ctArgs     = problems + firstJob;
+			args[i].jobs       = jobs;
+			args[i].firstJob   = firstJob;
+			args[i].matrices   = dictionary->matrices;
+			args[i].kind       = dictionary->kind;
+			args[i].messages   = dictionary->messages;
+			args[i].cache      = &dictionary->cache;
+			args[i].thread     = i;
+			args[i].lowindex   = (  i   * ATTACK_JOURNAL_BLOCKS / threads) * ATTACK_JOURNAL_BLOCK;
+			args[i].highindex  = ((i+1) * ATTACK_JOURNAL_BLOCKS / threads) * ATTACK_JOURNAL_BLOCK;
+			args[i].keyFound   = keyFound;
+			args[i].secretKeys = secretKeys + firstJob;
+			args[i].lock       = &lock;
+			args[i].onResult   = options->onResult;
+			args[i].context    = options->context;
+			args[i].finished   = &finished;
+			args[i].stats      = &stats[i];
+			args[i].journal    = options->journal;
+			args[i].problemIds = problemIds;
+			args[i].tried      = options->journal ? tried : NULL;
+			args[i].stop       = &stop;
+
+			int failed = options->submit ? options->submit(options->pool, attack_runWorker, &args[i])
+			                             : pthread_create(&t[i], NULL, attack_launchAttack, &args[i]);
+			if (failed) {
+				DEBUG("Unable to start worker #%d, giving up the attack", i);
+				__atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+				unsolved = -1;
+				break;
+			}
+		}
+
+
+		// Waiting for the workers, exporting the telemetry whenever it is requested
+		struct timespec pause = {0, ATTACK_POLL_MS*1000000L};
+		while (__sync_fetch_and_add(&finished, 0) < started) {
+			nanosleep(&pause, NULL);
+			if (options->telemetry && attack_statsRequested) {
+				attack_statsRequested = 0;
+				attack_exportStats(options->statsfile, stats, threads, monotonicTime()-startTime);
+			}
+		}
+
+
+		// Thread Joining
+		for (int i=0 ; !options->submit && i<started ; ++i) {
+			pthread_join(t[i], NULL);
+		}
+
+		// The failures are only known once every index has been tried
+		for (int j=0 ; unsolved>=0 && j<jobs ; ++j) {
+			if (!keyFound[j]) {
+				++unsolved;
+				if (options->onResult)
+					options->onResult(options->context, firstJob+j, NULL);
+			}
+		}
+	}
+
+	if (options->telemetry) {
+		signal(SIGUSR1, (previousHandler == SIG_ERR) ? SIG_DFL : previousHandler);
+		attack_exportStats(options->statsfile, stats, threads, monotonicTime()-startTime);
 	}
-	free(t);
+	if (options->stats)
+		attack_sumStats(options->stats, stats, threads);
+
+	return unsolved;
+}
+
+
+
+
+// Documentation in header file
+void attack_setThreads(int threads) {
+	attack_defaultThreads = MIN(threads > 0 ? threads : PROCESSING_THREADS, ATTACK_MAX_THREADS);
+}
+
+
+
+
+// Documentation in header file
+int attack_batch(cipherTextArgs problems[], int count, byte secretKeys[][SECRETKEY_BITS], \
+                 attackResultHandler onResult, void* context, const char* statsfile, attackJournal* journal) {
+
+	if (!attack_defaultDictionary.matrices) {
+		memset(secretKeys, 0, (size_t)count*SECRETKEY_BITS);
+		DEBUG("Dictionary not initialized, unable to proceed with the attack");
+		return -1;
+	}
+
+	time_t datetime = time(NULL);
+	struct tm *local = localtime(&datetime);
+	DEBUG("Attack started on %s", asctime(local));
 
+	const attackOptions options = {0, NULL, NULL, onResult, context, journal, 1, statsfile, NULL};
+	int unsolved = attack_run(&attack_defaultDictionary, problems, count, secretKeys, &options);
 
 	datetime = time(NULL);
 	local = localtime(&datetime);
 	DEBUG("Attack Terminated on %s", asctime(local));
-	if (keyFound) {
-		DEBUG("Secret Key Found:");
-		DUMP_CHAR_VECTOR(secretKey, SECRETKEY_BITS, "Secret Key");
-		return 0;
-	} else {
+	return unsolved;
+}
+
+
+
+
+// Documentation in header file
+int attack(cipherTextArgs* ctArgs, byte secretKey[SECRETKEY_BITS], const char* statsfile, attackJournal* journal) {
+
+	if (attack_batch(ctArgs, 1, (byte (*)[SECRETKEY_BITS])secretKey, NULL, NULL, statsfile, journal)) {
 		DEBUG("Failure");
 		return 1;
 	}
 
-};
+	DEBUG("Secret Key Found:");
+	DUMP_CHAR_VECTOR(secretKey, SECRETKEY_BITS, "Secret Key");
+	return 0;
+}
 
 
 
 
 // Documentation in header file
-int attack_test() {
+int attack_test(const char* filename) {
 
 	// Sample Message
 	byte originalMessage1[SOURCEWORD_LENGTH] = {1,0,0,0,1,0,1,0,0,0,0,1,1,1,1,1,1,0,1,0,1,1,0,0,1,1,0,1,1,0,0,0,1,0,0,0,0,1,0,0,0,0,1,0,0,1,1,0,1,1,0,1,0,0,0,1,0,1,0,1,0,1,1,1,1,1,0,0,1,0,1,0,1,0,0,0,0,0,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,1,1,1,0,1,1,1,1,1,0,0,0,0,0,1,0,0,1,1,0,0,1,0,1,0,0,0,0,1,0,0,1,0,1,0,1,0,1,1,0,0,1,1,0,1,1,1,1,1,1,0,1,1,1,0,0,0,0,0,1,1,0,0,0,1,1,0,1,0,1,1,0,0,1,1,1,1,0,0,0,1,0,1,0,1,0,1,1,1,1,0};
@@ -456,20 +1394,34 @@ int attack_test() {
 	cipherTextArgs ctArgs;
 
 	// Message Coding
-	byte G[SOURCEWORD_LENGTH][CODEWORD_LENGTH];
-	processFullEncodingGMatrix(G);
-
-	byte originalEncodedMessage1[CODEWORD_LENGTH];
-	byte originalEncodedMessage2[CODEWORD_LENGTH];
-	byte originalEncodedMessage3[CODEWORD_LENGTH];
+	const codeMatrices* code = code_getMatrices();
+	if (!code) {
+		DEBUG("Self-check aborted: unable to allocate the code matrices");
+		return 1;
+	}
 
-	BINPRODUCT_VECTOR_MATRIX(originalMessage1, G, originalEncodedMessage1, SOURCEWORD_LENGTH, CODEWORD_LENGTH);
-	BINPRODUCT_VECTOR_MATRIX(originalMessage2, G, originalEncodedMessage2, SOURCEWORD_LENGTH, CODEWORD_LENGTH);
-	BINPRODUCT_VECTOR_MATRIX(originalMessage3, G, originalEncodedMessage3, SOURCEWORD_LENGTH, CODEWORD_LENGTH);
+	// Dictionary Initialization
+	int messages;
+	if (initializeRAM(filename, &messages)) {
+		DEBUG("Self-check aborted: unable to load the dictionary");
+		return 1;
+	}
 
+	srand(time(NULL));
 
-	// Dictionary Initialization
-	initializeRAM("bin/matrices.bin");
+	// The dictionary may be made for more messages than the samples: random ones complete them
+	byte originalEncodedMessages[MAX_ENCRYPTED_MESSAGES][CODEWORD_LENGTH];
+	byte* originalMessages[NEEDED_ENCRYPTED_MESSAGES] = {originalMessage1, originalMessage2, originalMessage3};
+	for (int m=0 ; m<messages ; ++m) {
+		byte randomMessage[SOURCEWORD_LENGTH];
+		for (int k=0 ; m>=NEEDED_ENCRYPTED_MESSAGES && k<SOURCEWORD_LENGTH ; ++k) {
+			randomMessage[k] = rand() & 1;
+		}
+		bitword packedMessage[BITMATRIX_WORDS(SOURCEWORD_LENGTH)], packedCode[BITMATRIX_WORDS(CODEWORD_LENGTH)];
+		bitmatrix_packVector(m<NEEDED_ENCRYPTED_MESSAGES ? originalMessages[m] : randomMessage, packedMessage, SOURCEWORD_LENGTH);
+		bitmatrix_vectorMultiply(packedMessage, &code->G, packedCode);
+		bitmatrix_unpackVector(packedCode, originalEncodedMessages[m], CODEWORD_LENGTH);
+	}
 
 
 	time_t time1, time2;
@@ -477,14 +1429,10 @@ int attack_test() {
 	double totaltime = 0;
 	int totalexecs   = 0;
 
-	srand(time(NULL));
-
 	for (int testcase=0 ; testcase<10 ; ++testcase) {
 
 		// Retrieving Encoded Message
-		memcpy(ctArgs.cipherText1, originalEncodedMessage1, CODEWORD_LENGTH);
-		memcpy(ctArgs.cipherText2, originalEncodedMessage2, CODEWORD_LENGTH);
-		memcpy(ctArgs.cipherText3, originalEncodedMessage3, CODEWORD_LENGTH);
+		memcpy(ctArgs.cipherText, originalEncodedMessages, (size_t)messages*CODEWORD_LENGTH);
 
 		// Generating random secretKey
 		for (int k=0 ; k<SECRETKEY_BITS ; ++k) {
@@ -503,18 +1451,23 @@ int attack_test() {
 
 		// Message Encryption
 		keysetup(secretKey, frameId);
-		byte keystream[CODEWORD_LENGTH*NEEDED_ENCRYPTED_MESSAGES];
-		getKeystream(keystream, CODEWORD_LENGTH*NEEDED_ENCRYPTED_MESSAGES);
-
-		XOR_CHARARRAYS(ctArgs.cipherText1, keystream,                   CODEWORD_LENGTH);
-		XOR_CHARARRAYS(ctArgs.cipherText2, keystream+  CODEWORD_LENGTH, CODEWORD_LENGTH);
-		XOR_CHARARRAYS(ctArgs.cipherText3, keystream+2*CODEWORD_LENGTH, CODEWORD_LENGTH);
+		byte keystream[CODEWORD_LENGTH*MAX_ENCRYPTED_MESSAGES];
+		getKeystream(keystream, CODEWORD_LENGTH*messages);
+
+		// (a known-keystream dictionary is given the keystream itself)
+		for (int m=0 ; m<messages ; ++m) {
+			if (attack_defaultDictionary.kind == DICTIONARY_KEYSTREAM) {
+				memcpy(ctArgs.cipherText[m], keystream+m*CODEWORD_LENGTH, CODEWORD_LENGTH);
+			} else {
+				XOR_CHARARRAYS(ctArgs.cipherText[m], keystream+m*CODEWORD_LENGTH, CODEWORD_LENGTH);
+			}
+		}
 
 		// Decryption Process
 		byte decipheredSecretKey[SECRETKEY_BITS];
 
 		time(&time1);
-		attack(&ctArgs, decipheredSecretKey);
+		attack(&ctArgs, decipheredSecretKey, NULL, NULL);
 		time(&time2);
 		diffsec = difftime(time2,time1);
 		totaltime += diffsec;
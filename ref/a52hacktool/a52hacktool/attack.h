@@ -29,22 +29,53 @@
   * @brief Specification of A52 attack
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #10
-  * @date 01/12/2011
+  * @version File Revision #20
+  * @date 19/10/2026
   * */
 
 
 #ifndef _ATTACK_H_
 #define _ATTACK_H_
 
+#include <stddef.h>
+#include <stdio.h>
+#include <pthread.h>
+
 #include "const_A52.h"
 #include "const_code.h"
+#include "matrices_generation.h"
+#include "bitmatrix.h"
 
 
 // Attack related constants
 
-//! Number of empty equations remaining after proceeding to Gauss Elimination in (HS × ? = Syndrome)
-#define SYNDROME_EMPTY_EQUATIONS (NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH - REGS_TOTAL_VARS)
+//! Number of empty equations remaining after proceeding to Gauss Elimination in (HS × ? = Syndrome),
+//! with \a messages ciphered messages
+#define SYNDROME_EMPTY_EQUATIONS(messages) ((messages)*SYNDROME_LENGTH - REGS_TOTAL_VARS)
+
+//! Size of a cache line: the statistics of each thread are aligned on it, so that no line is shared
+#define ATTACK_CACHELINE_BYTES 64
+
+//! Maximum number of problems attacked together: they share the Gauss elimination of every Resolution Matrix
+#define ATTACK_BATCH_JOBS 64
+
+//! Number of Resolution Matrices generated on demand kept in RAM, when the dictionary is partially stored
+#define ATTACK_CACHED_MATRICES 256
+
+//! Number of consecutive indices recorded at once in the attack journal (THREAD_CHUNKSIZE is a multiple of it)
+#define ATTACK_JOURNAL_BLOCK 1024
+
+//! Number of blocks of indices of the attack journal
+#define ATTACK_JOURNAL_BLOCKS (TOTAL_MATRICES/ATTACK_JOURNAL_BLOCK)
+
+//! Greatest number of workers of an attack (each one goes through a whole number of blocks of the journal)
+#define ATTACK_MAX_THREADS ATTACK_JOURNAL_BLOCKS
+
+//! Size of the Frame Id in a batch attack record (22 bits, MSB first, padded with null bits)
+#define ATTACK_RECORD_FRAMEID_BYTES ((FRAMEID_BITS+7)/8)
+
+//! Size of a batch attack record: the Frame Id followed by \a messages chunks of cipher text (8 bits per byte)
+#define ATTACK_RECORD_BYTES(messages) (ATTACK_RECORD_FRAMEID_BYTES + (size_t)(messages)*CODEWORD_LENGTH/8)
 
 
 
@@ -53,43 +84,282 @@
  * \struct cipherTextArgs
  * \brief Set of arguments to be provided to perform the attack
  *
- * cipherTextArgs contains three chunks of cipher text,
- * along with the Frame Id (which is publicly known)
+ * cipherTextArgs contains consecutive chunks of cipher text (as many as the dictionary is made for),
+ * along with the Frame Id (which is publicly known).
+ * Against a known-keystream dictionary, the chunks are the known keystream instead (KEYSTREAM_MESSAGES chunks).
  */
 typedef struct {
-	byte cipherText1[CODEWORD_LENGTH]; //!< First chunk of cipher text
-	byte cipherText2[CODEWORD_LENGTH]; //!< Second chunk of cipher text
-	byte cipherText3[CODEWORD_LENGTH]; //!< Third chunk of cipher text
-	byte frameId[FRAMEID_BITS];        //!< Frame Id
+	byte cipherText[MAX_ENCRYPTED_MESSAGES][CODEWORD_LENGTH]; //!< Chunks of cipher text (or of keystream)
+	byte frameId[FRAMEID_BITS];                               //!< Frame Id
 } cipherTextArgs;
 
 
 
 
+/**
+ * \enum AttackRejection
+ * \brief Reasons for which a candidate (dictionary index) is rejected, in the order of the filters
+ */
+typedef enum {
+	ATTACK_REJECT_INCONSISTENT, //!< The linear system has no solution (an equation reads "0 = 1")
+	ATTACK_REJECT_RANK,         //!< Not enough independent equations to determine every variable
+	ATTACK_REJECT_DOUBLEVARS,   //!< The product variables mismatch the simple ones
+	ATTACK_REJECT_KEYSETUP,     //!< The keysetup cannot be reversed from the LFSRs state
+	ATTACK_REJECTIONS           //!< Number of rejection reasons
+} AttackRejection;
+
+
+/**
+ * \enum AttackStage
+ * \brief Timed stages of the processing of a candidate
+ */
+typedef enum {
+	ATTACK_STAGE_LOAD,       //!< Resolution Matrix unpacking and right-hand side setup
+	ATTACK_STAGE_SOLVE,      //!< Gauss elimination and back-substitution
+	ATTACK_STAGE_DOUBLEVARS, //!< Consistency check of the product variables
+	ATTACK_STAGE_KEYSETUP,   //!< Keysetup reversal
+	ATTACK_STAGES            //!< Number of stages
+} AttackStage;
+
+
+/**
+ * \struct attackStats
+ * \brief Telemetry of the candidates processed by one thread
+ *
+ * Each thread only updates its own instance, which is aligned on a cache line.
+ * The timers count CPU cycles on x86 (time-stamp counter), nanoseconds elsewhere (see attack_timerUnit()).
+ */
+typedef struct {
+	unsigned long long candidates;                  //!< Number of candidates processed
+	unsigned long long rejected[ATTACK_REJECTIONS]; //!< Number of candidates rejected, per reason
+	unsigned long long accepted;                    //!< Number of candidates that passed every filter
+	unsigned long long abortDepth;                  //!< Rows eliminated before the inconsistent candidates were rejected, summed
+	unsigned long long generated;                   //!< Number of Resolution Matrices generated on demand
+	unsigned long long cacheHits;                   //!< Number of Resolution Matrices found in the cache of the generated ones
+	unsigned long long time[ATTACK_STAGES];         //!< Time spent in each stage
+} __attribute__((aligned(ATTACK_CACHELINE_BYTES))) attackStats;
+
+
+
+
+/**
+ * \fn typedef void (*attackResultHandler)(void* context, int job, const byte secretKey[SECRETKEY_BITS])
+ * \brief Receives the outcome of a problem of a batch attack, as soon as it is known
+ *
+ * \param[in] context Data given along with the handler
+ * \param[in] job Index of the problem
+ * \param[in] secretKey Deciphered secret key, NULL if the attack failed
+ */
+typedef void (*attackResultHandler)(void* context, int job, const byte secretKey[SECRETKEY_BITS]);
+
+
+
+
+/**
+ * \enum AttackStatus
+ * \brief Outcome of the loading of a dictionary
+ */
+typedef enum {
+	ATTACK_OK,           //!< Success
+	ATTACK_ERROR_MEMORY, //!< Not enough memory
+	ATTACK_ERROR_IO,     //!< The dictionary file cannot be opened or read
+	ATTACK_ERROR_FORMAT  //!< The file is not a dictionary
+} AttackStatus;
+
+
+
+
+/**
+ * \struct attackAllocator
+ * \brief Memory allocator of a dictionary (the standard allocator when the functions are NULL)
+ */
+typedef struct {
+	void* (*allocate)(void* context, size_t size); //!< Allocates a block, returns NULL on failure
+	void (*release)(void* context, void* block);    //!< Frees a block given by \a allocate
+	void* context;                                  //!< Data given to both functions
+} attackAllocator;
+
+
+/**
+ * \struct matrixCache
+ * \brief Resolution Matrices generated on demand, kept for the next attacks (least recently used one replaced first)
+ */
+typedef struct {
+	int slots;                   //!< Number of matrices the cache can hold
+	byte* data;                  //!< Matrices, DICTIONARY_MATRIX_BYTES(kind, messages) bytes each
+	int* index;                  //!< Index of the matrix held by each slot, -1 if empty
+	unsigned long long* lastUse; //!< Last lookup of the matrix held by each slot
+	unsigned long long clock;    //!< Number of lookups so far
+	pthread_mutex_t lock;        //!< Serializes the accesses of the threads
+} matrixCache;
+
+
+/**
+ * \struct attackDictionary
+ * \brief Resolution Matrices of an attack, stored in RAM or generated on demand
+ */
+typedef struct {
+	byte** matrices;           //!< Resolution Matrices, indexed from 0 to TOTAL_MATRICES-1, as stored in the dictionary file (NULL ones are generated)
+	DictionaryKind kind;       //!< Attack the matrices are made for
+	int messages;              //!< Number of ciphered messages the matrices are made for
+	matrixCache cache;         //!< Generated matrices, kept for the next attacks
+	attackAllocator allocator; //!< Allocator of the stored matrices and of the cache
+} attackDictionary;
+
+
+
+
+/**
+ * \struct attackJournalEntry
+ * \brief Record of an attack journal: a range of indices tried on a problem, or its solution
+ */
+typedef struct {
+	unsigned long long problem;     //!< Identifier of the problem (see attack_problemId())
+	int solved;                     //!< 1 for a solution, 0 for a range of indices
+	int lowindex;                   //!< First index of the range (inclusive)
+	int highindex;                  //!< Last index of the range (exclusive)
+	byte secretKey[SECRETKEY_BITS]; //!< Solution of the problem
+} attackJournalEntry;
+
+
+/**
+ * \struct attackJournal
+ * \brief Journal of an attack, allowing an interrupted attack to be resumed
+ *
+ * The journal is a text file, to which a line is appended every time a block of ATTACK_JOURNAL_BLOCK indices
+ * has been tried on a problem ("block <problem> <lowindex> <highindex>") and every time a problem is solved
+ * ("key <problem> <secret key>"). Problems are identified by a hash of their data, and the ranges of indices
+ * are absolute: the order of the lines does not matter, so that the processes attacking the same problems
+ * (one after the other, or each on its share of the problems) may use the same journal.
+ */
+typedef struct {
+	FILE* file;                 //!< Journal, opened for appending
+	pthread_mutex_t lock;       //!< Serializes the writing of the threads
+	int entries;                //!< Number of records read when the journal was opened
+	attackJournalEntry* entry;  //!< Records read when the journal was opened
+} attackJournal;
+
+
+
+
 /**
  * \struct threadArgs
  * \brief Set of arguments related to a thread in a multithreaded attack context
  *
- * threadArgs contains a pointer to the problem to solve,
+ * threadArgs contains a pointer to the problems to solve (up to ATTACK_BATCH_JOBS),
  * along with the bounds of the subset of solutions to explore.
- * It also points to a volatile flag indicating if the solution has been found by another thread.
- * Each set of parameters also contains a potential sorage for a result (to prevent from getting
- * problems with multiple accesses)
+ * It also points to the volatile flags indicating which solutions have been found by another thread,
+ * and to the storage of the results, shared between the threads (writes are serialized by \a lock).
  */
 typedef struct {
-	cipherTextArgs* ctArgs;         //!< Problem to solve
-	int lowindex;                   //!< Index to start the search form (inclusive)
-	int highindex;                  //!< Last index to be analyzed (exclusive)
-	int *keyFound;                  //!< Solution found flag
-	byte secretKey[SECRETKEY_BITS]; //!< Local storage for a potential solution
+	cipherTextArgs* ctArgs;                 //!< Problems to solve
+	int jobs;                               //!< Number of problems
+	int firstJob;                           //!< Index of the first problem, as given to \a onResult
+	byte** matrices;                        //!< Resolution Matrices, indexed from 0 to TOTAL_MATRICES-1 (NULL ones are generated)
+	DictionaryKind kind;                    //!< Attack the matrices are made for
+	int messages;                           //!< Number of ciphered messages the matrices are made for
+	matrixCache* cache;                     //!< Cache of the generated matrices (may be NULL)
+	int thread;                             //!< Index of the thread
+	int lowindex;                           //!< Index to start the search form (inclusive)
+	int highindex;                          //!< Last index to be analyzed (exclusive)
+	int *keyFound;                          //!< Solution found flags, one per problem
+	byte (*secretKeys)[SECRETKEY_BITS];     //!< Storage for the solutions, one per problem
+	pthread_mutex_t* lock;                  //!< Serializes the writing of the solutions (NULL with a single thread)
+	attackResultHandler onResult;           //!< Called whenever a solution is found (may be NULL)
+	void* context;                          //!< Data given to \a onResult
+	int *finished;                          //!< Number of threads that have returned
+	attackStats* stats;                     //!< Telemetry of the thread
+	attackJournal* journal;                 //!< Journal of the attack (may be NULL)
+	const unsigned long long* problemIds;   //!< Identifiers of the problems in the journal
+	const bitword* tried;                   //!< Problems already tried on each block of indices, as read from the journal
+	int* stop;                              //!< Set when the attack is given up (may be NULL)
 } threadArgs;
 
 
 
 
+/**
+ * \struct attackOptions
+ * \brief Optional parameters of attack_run()
+ *
+ * A zero-initialized instance runs the default number of threads of its own (see attack_setThreads()), quietly.
+ */
+typedef struct {
+	int threads;                                                   //!< Number of workers (0 for the default number, at most ATTACK_MAX_THREADS)
+	int (*submit)(void* pool, void (*task)(void* arg), void* arg); //!< Runs a worker on a thread of the caller's pool, returns non-zero if it cannot (NULL: a thread is created per worker)
+	void* pool;                                                    //!< Pool given to \a submit
+	attackResultHandler onResult;                                  //!< Receives the outcome of every problem (may be NULL)
+	void* context;                                                 //!< Data given to \a onResult
+	attackJournal* journal;                                        //!< Journal of the attack (may be NULL)
+	int telemetry;                                                 //!< Non-zero to write the telemetry at the end of the attack, and on SIGUSR1 while it runs
+	const char* statsfile;                                         //!< File receiving the telemetry, NULL for a summary on the standard output
+	attackStats* stats;                                            //!< Receives the telemetry summed over the workers (may be NULL)
+} attackOptions;
+
+
+
+
+/**
+ * \fn void* attack_allocate(const attackAllocator* allocator, size_t size)
+ * \brief Allocates a block of memory with a given allocator
+ *
+ * \param[in] allocator Allocator
+ * \param[in] size Size of the block, in bytes
+ * \return The block, NULL on failure
+ */
+void* attack_allocate(const attackAllocator* allocator, size_t size);
+
+
+
+
+/**
+ * \fn void attack_release(const attackAllocator* allocator, void* block)
+ * \brief Frees a block of memory given by attack_allocate()
+ *
+ * \param[in] allocator Allocator
+ * \param[in] block Block to free (may be NULL)
+ */
+void attack_release(const attackAllocator* allocator, void* block);
+
+
+
+
+/**
+ * \fn AttackStatus attack_loadDictionary(attackDictionary* dictionary, const char* filename, int percent, int cached, DictionaryKind kind, int messages, const attackAllocator* allocator)
+ * \brief Loads a dictionary in RAM, the matrices which are not stored being generated on demand
+ *
+ * The first \a percent % of the matrices of the file are stored. The attack threads generate the missing ones,
+ * keeping the last \a cached generated matrices for the next attacks (least recently used one replaced first).
+ *
+ * \param[out] dictionary Dictionary to load
+ * \param[in]  filename Path of the file containing resolution matrices (not read when \a percent is 0)
+ * \param[in]  percent Percentage of the resolution matrices to store (0 to 100)
+ * \param[in]  cached Number of generated matrices to keep
+ * \param[in]  kind Attack the matrices are made for, when \a percent is 0 (otherwise given by the file)
+ * \param[in]  messages Number of ciphered messages the matrices are made for, when \a percent is 0 and \a kind is DICTIONARY_CIPHERTEXT
+ * \param[in]  allocator Allocator of the matrices (NULL for the standard one)
+ * \return ATTACK_OK if the dictionary is loaded, the reason of the failure otherwise
+ */
+AttackStatus attack_loadDictionary(attackDictionary* dictionary, const char* filename, int percent, int cached, \
+                                   DictionaryKind kind, int messages, const attackAllocator* allocator);
+
+
+
+
+/**
+ * \fn void attack_freeDictionary(attackDictionary* dictionary)
+ * \brief Frees the RAM used by a dictionary loaded by attack_loadDictionary()
+ *
+ * \param[in, out] dictionary Dictionary to free
+ */
+void attack_freeDictionary(attackDictionary* dictionary);
+
+
+
+
 /**
  * \fn void freeRAM()
- * \brief Frees the RAM used to store resolution matrices.
+ * \brief Frees the RAM used to store resolution matrices (dictionary of attack() and attack_batch()).
  */
 void freeRAM();
 
@@ -97,37 +367,236 @@ void freeRAM();
 
 
 /**
- * \fn int initializeRAM(const char* filename)
- * \brief Initializes the RAM storage of resolution matrices from a given binary file
+ * \fn int initializeRAM(const char* filename, int* messages)
+ * \brief Initializes the RAM storage of resolution matrices from a given binary file (dictionary of attack() and attack_batch())
  *
- * \param[in] filename Path of the file containing resolution matrices
+ * \param[in]  filename Path of the file containing resolution matrices
+ * \param[out] messages Number of chunks of cipher text (or of known keystream) each problem must give (may be NULL)
  * \return 0 if the initialization is successfull, non-zero otherwise
  */
-int initializeRAM(const char* filename);
+int initializeRAM(const char* filename, int* messages);
 
 
 
 
 /**
- * \fn int attack(cipherTextArgs* ctArgs, byte secretKey[SECRETKEY_BITS])
+ * \fn int initializePartialRAM(const char* filename, int percent, int cached, DictionaryKind kind, int* messages)
+ * \brief Initializes the RAM storage with a fraction of the resolution matrices, the other ones being generated on demand
+ *
+ * This is attack_loadDictionary() on the dictionary of attack() and attack_batch().
+ *
+ * \param[in]      filename Path of the file containing resolution matrices (not read when \a percent is 0)
+ * \param[in]      percent Percentage of the resolution matrices to store (0 to 100)
+ * \param[in]      cached Number of generated matrices to keep
+ * \param[in]      kind Attack the matrices are made for, when \a percent is 0 (otherwise given by the dictionary)
+ * \param[in, out] messages Number of chunks of cipher text (or of known keystream) each problem must give:
+ *                 read when \a percent is 0 and \a kind is DICTIONARY_CIPHERTEXT, set otherwise (may then be NULL)
+ * \return 0 (ATTACK_OK) if the initialization is successfull, the reason of the failure otherwise
+ */
+int initializePartialRAM(const char* filename, int percent, int cached, DictionaryKind kind, int* messages);
+
+
+
+
+/**
+ * \fn int attack_decipherSecretKey(cipherTextArgs* ctArgs, byte** matrices, DictionaryKind kind, int messages, int lowindex, int highindex, int* keyFound, byte secretKey[SECRETKEY_BITS], attackStats* stats)
+ * \brief Thread attack method: tries every Resolution Matrix of a range of indices
+ *
+ * \param[in]      ctArgs Problem to solve
+ * \param[in]      matrices Resolution Matrices (DICTIONARY_MATRIX_BYTES(kind, messages) bytes each), only the range [lowindex-highindex[ is read
+ * \param[in]      kind Attack the matrices are made for
+ * \param[in]      messages Number of ciphered messages the matrices are made for
+ * \param[in]      lowindex Index to start the search form (inclusive)
+ * \param[in]      highindex Last index to be analyzed (exclusive)
+ * \param[in]      keyFound Solution found flag
+ * \param[out]     secretKey Storage for a potential solution
+ * \param[in, out] stats Telemetry, incremented with the processed candidates (may be NULL)
+ * \return 0 if the attack is thread-locally successful, non-zero otherwise
+ */
+int attack_decipherSecretKey(cipherTextArgs* ctArgs, byte** matrices, DictionaryKind kind, int messages, int lowindex, int highindex, int* keyFound, \
+                             byte secretKey[SECRETKEY_BITS], attackStats* stats);
+
+
+
+
+/**
+ * \fn int attack_decipherBatch(threadArgs* args)
+ * \brief Thread attack method for several problems: tries every Resolution Matrix of a range of indices on each of them
+ *
+ * The problems share the loading and the Gauss elimination of every matrix: their right-hand sides are
+ * processed together, as extra columns. The search stops once every problem is solved.
+ *
+ * \param[in, out] args Problems, range of indices and shared results
+ * \return 0 if at least one solution has been found by this thread, non-zero otherwise
+ */
+int attack_decipherBatch(threadArgs* args);
+
+
+
+
+/**
+ * \fn int attack_parseRecords(const byte data[], size_t length, int messages, cipherTextArgs jobs[])
+ * \brief Unpacks batch attack records (see ATTACK_RECORD_BYTES)
+ *
+ * \param[in]  data Records
+ * \param[in]  length Length of \a data, in bytes
+ * \param[in]  messages Number of chunks of cipher text per record
+ * \param[out] jobs Problems to solve, one per record
+ * \return Number of records, or -1 if \a length isn't a multiple of ATTACK_RECORD_BYTES(messages)
+ */
+int attack_parseRecords(const byte data[], size_t length, int messages, cipherTextArgs jobs[]);
+
+
+
+
+/**
+ * \fn const char* attack_timerUnit()
+ * \brief Gives the unit of the attackStats timers
+ *
+ * \return "cycles" or "ns"
+ */
+const char* attack_timerUnit();
+
+
+
+
+/**
+ * \fn int attack_exportStats(const char* filename, const attackStats stats[], int threads, double elapsed)
+ * \brief Writes the telemetry of an attack, thread by thread and summed up
+ *
+ * The report is written as JSON if \a filename ends with ".json", as text otherwise.
+ *
+ * \param[in] filename Path of the file to write, or NULL for a text report on the standard output
+ * \param[in] stats Telemetry of every thread
+ * \param[in] threads Number of threads
+ * \param[in] elapsed Wall-clock duration of the attack so far, in seconds
+ * \return 0 if the report has been written, non-zero otherwise
+ */
+int attack_exportStats(const char* filename, const attackStats stats[], int threads, double elapsed);
+
+
+
+
+/**
+ * \fn unsigned long long attack_problemId(const cipherTextArgs* ctArgs, DictionaryKind kind, int messages)
+ * \brief Identifies a problem in the attack journals (64-bit FNV-1a hash of its data)
+ *
+ * \param[in] ctArgs Problem to identify
+ * \param[in] kind Attack the problem is given to
+ * \param[in] messages Number of chunks of cipher text (or of known keystream) of the problem
+ * \return Identifier of the problem
+ */
+unsigned long long attack_problemId(const cipherTextArgs* ctArgs, DictionaryKind kind, int messages);
+
+
+
+
+/**
+ * \fn int attack_openJournal(attackJournal* journal, const char* filename, int resume)
+ * \brief Opens the journal of an attack
+ *
+ * \param[out] journal Journal to open
+ * \param[in]  filename Path of the journal
+ * \param[in]  resume Non-zero to read the records of the journal and append the next ones, zero to start a new journal
+ * \return 0 if the journal is opened, non-zero otherwise
+ */
+int attack_openJournal(attackJournal* journal, const char* filename, int resume);
+
+
+
+
+/**
+ * \fn int attack_closeJournal(attackJournal* journal)
+ * \brief Closes the journal of an attack
+ *
+ * \param[in, out] journal Journal to close
+ * \return 0 if every record has been written, non-zero otherwise
+ */
+int attack_closeJournal(attackJournal* journal);
+
+
+
+
+/**
+ * \fn int attack_run(attackDictionary* dictionary, cipherTextArgs problems[], int count, byte secretKeys[][SECRETKEY_BITS], const attackOptions* options)
+ * \brief Performs the attack on a batch of problems with a given dictionary, ATTACK_BATCH_JOBS at a time
+ *
+ * The solutions are handed to the result handler as soon as they are found; the failures once every
+ * Resolution Matrix has been tried. With a journal, the problems solved and the blocks of indices tried
+ * according to it are skipped.
+ *
+ * \param[in, out] dictionary Resolution Matrices (its cache receives the generated ones)
+ * \param[in]      problems Problems to be solved, with as many chunks of cipher text as the dictionary is made for
+ * \param[in]      count Number of problems
+ * \param[out]     secretKeys Deciphered secret key of every problem, all zeros for the unsolved ones
+ * \param[in]      options Optional parameters (NULL for the default ones)
+ * \return Number of unsolved problems (0 if the attack is successful), -1 if the workers couldn't be started
+ */
+int attack_run(attackDictionary* dictionary, cipherTextArgs problems[], int count, byte secretKeys[][SECRETKEY_BITS], \
+               const attackOptions* options);
+
+
+
+
+/**
+ * \fn void attack_setThreads(int threads)
+ * \brief Sets the number of workers of the attacks that do not ask for a given one (PROCESSING_THREADS until set)
+ *
+ * \param[in] threads Number of workers (0 to restore PROCESSING_THREADS, at most ATTACK_MAX_THREADS)
+ */
+void attack_setThreads(int threads);
+
+
+
+
+/**
+ * \fn int attack_batch(cipherTextArgs problems[], int count, byte secretKeys[][SECRETKEY_BITS], attackResultHandler onResult, void* context, const char* statsfile, attackJournal* journal)
+ * \brief Performs the attack on a batch of problems, ATTACK_BATCH_JOBS at a time
+ *
+ * The solutions are handed to \a onResult as soon as they are found; the failures once every
+ * Resolution Matrix has been tried. While the attack runs, SIGUSR1 makes it write its telemetry so far.
+ * With a journal, the problems solved and the blocks of indices tried according to it are skipped.
+ *
+ * \param[in]  problems Problems to be solved, with as many chunks of cipher text as the dictionary is made for
+ * \param[in]  count Number of problems
+ * \param[out] secretKeys Deciphered secret key of every problem, all zeros for the unsolved ones
+ * \param[in]  onResult Receives the outcome of every problem (may be NULL)
+ * \param[in]  context Data given to \a onResult
+ * \param[in]  statsfile File receiving the telemetry of the attack, or NULL for a summary on the standard output
+ * \param[in]  journal Journal of the attack, opened by attack_openJournal() (may be NULL)
+ * \return Number of unsolved problems (0 if the attack is successful), -1 if it couldn't be performed
+ */
+int attack_batch(cipherTextArgs problems[], int count, byte secretKeys[][SECRETKEY_BITS], \
+                 attackResultHandler onResult, void* context, const char* statsfile, attackJournal* journal);
+
+
+
+
+/**
+ * \fn int attack(cipherTextArgs* ctArgs, byte secretKey[SECRETKEY_BITS], const char* statsfile, attackJournal* journal)
  * \brief Performs the attack on a given problem, then writes back the solution
  *
+ * While the attack runs, SIGUSR1 makes it write its telemetry so far (see attack_exportStats()).
+ *
  * \param[in]  ctArgs Problem to be solved
  * \param[out] secretKey Deciphered secret key if the attack succeeded, all zeros otherwise
+ * \param[in]  statsfile File receiving the telemetry of the attack, or NULL for a summary on the standard output
+ * \param[in]  journal Journal of the attack, opened by attack_openJournal() (may be NULL)
  * \return 0 if the attack is successfull, non-zero otherwise
  */
-int attack(cipherTextArgs* ctArgs, byte secretKey[SECRETKEY_BITS]);
+int attack(cipherTextArgs* ctArgs, byte secretKey[SECRETKEY_BITS], const char* statsfile, attackJournal* journal);
 
 
 
 
 /**
- * \fn int attack_test()
+ * \fn int attack_test(const char* filename)
  * \brief Autotests the attack on a verified set of problem/solution
  *
+ * \param[in] filename Path of the dictionary to attack with
  * \return 0 if the test is successfull, non-zero otherwise
  */
-int attack_test();
+int attack_test(const char* filename);
 
 
 
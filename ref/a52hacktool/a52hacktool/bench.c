@@ -0,0 +1,723 @@
+/*============================================================================*
+ *                                                                            *
+ *                                   bench.c                                  *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file bench.c
+  * @brief Benchmark suite: times the main processing steps with a monotonic clock and reports them as JSON
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #8
+  * @date 19/10/2026
+  * */
+
+
+
+
+// dup() and fdopen() are POSIX extensions of the C99 library
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+
+#include "const_A52.h"
+#include "const_code.h"
+#include "utils.h"
+#include "bitmatrix.h"
+
+#include "code.h"
+#include "keygen.h"
+#include "keysetup_reverse.h"
+#include "matrices_generation.h"
+#include "attack.h"
+
+
+
+
+//! Default seed of the pseudo-random inputs
+#define BENCH_DEFAULT_SEED 0xA52
+
+//! Default number of timed repetitions of every benchmark (each is preceded by an untimed warmup run)
+#define BENCH_DEFAULT_REPS 5
+
+//! Keystream bits generated per repetition
+#define BENCH_KEYSTREAM_BITS (1<<20)
+
+//! Messages encoded or decoded per repetition
+#define BENCH_CODE_BLOCKS CODE_BATCH_BLOCKS
+
+//! Secret keys recovered per repetition of the keysetup reversal
+#define BENCH_KEYSETUP_CALLS 256
+
+//! Resolution Matrices generated per repetition
+#define BENCH_GENERATED_MATRICES 2
+
+//! Dictionary indices tried per repetition of the attack
+#define BENCH_ATTACK_CANDIDATES 64
+
+//! Distinct Resolution Matrices backing the attacked dictionary indices
+#define BENCH_ATTACK_MATRICES 4
+
+
+
+
+/**
+ * \struct benchReport
+ * \brief Output of the benchmark suite
+ */
+typedef struct {
+	FILE* out;          //!< Stream receiving the JSON report
+	unsigned int reps;  //!< Number of timed repetitions
+	int entries;        //!< Number of benchmarks already reported
+} benchReport;
+
+
+
+
+/**
+ * \fn int bench_compareDurations(const void* a, const void* b)
+ * \brief Orders durations for qsort()
+ *
+ * \param[in] a First duration
+ * \param[in] b Second duration
+ * \return Negative, zero or positive as \a a is shorter, equal or longer than \a b
+ */
+int bench_compareDurations(const void* a, const void* b) {
+	double da = *(const double*)a;
+	double db = *(const double*)b;
+	return (da > db) - (da < db);
+}
+
+
+
+
+/**
+ * \fn void bench_openEntry(benchReport* report, const char* name)
+ * \brief Starts the JSON object of a benchmark
+ *
+ * \param[in, out] report Report to write to
+ * \param[in]      name Identifier of the benchmark
+ */
+void bench_openEntry(benchReport* report, const char* name) {
+	fprintf(report->out, "%s\n    {\"name\": \"%s\"", report->entries ? "," : "", name);
+	++report->entries;
+}
+
+
+
+
+/**
+ * \fn void bench_run(benchReport* report, const char* name, const char* unit, double work, void (*step)(void*), void* data)
+ * \brief Times a benchmark: one warmup run, then report->reps timed runs, and reports their statistics
+ *
+ * The rates are given in \a unit per second, the cost in seconds per \a unit.
+ *
+ * \param[in, out] report Report to write to
+ * \param[in]      name Identifier of the benchmark
+ * \param[in]      unit Unit of work
+ * \param[in]      work Amount of work done by a single run, in \a unit
+ * \param[in]      step Single run of the benchmark
+ * \param[in]      data Argument of \a step
+ */
+void bench_run(benchReport* report, const char* name, const char* unit, double work, void (*step)(void*), void* data) {
+
+	double* durations = malloc(report->reps*sizeof(double));
+	if (!durations) {
+		DEBUG("Error: unable to allocate the durations of '%s'", name);
+		return;
+	}
+
+	step(data);
+	for (unsigned int r=0 ; r<report->reps ; ++r) {
+		double start = monotonicTime();
+		step(data);
+		durations[r] = monotonicTime() - start;
+	}
+	qsort(durations, report->reps, sizeof(double), bench_compareDurations);
+
+	double median = (report->reps%2) ? durations[report->reps/2]
+	                                 : (durations[report->reps/2-1] + durations[report->reps/2]) / 2;
+
+	bench_openEntry(report, name);
+	fprintf(report->out, ", \"unit\": \"%s\", \"work\": %.6g, \"reps\": %u, "
+	                     "\"median_rate\": %.6g, \"best_rate\": %.6g, \"worst_rate\": %.6g, "
+	                     "\"median_seconds_per_unit\": %.6g}",
+	        unit, work, report->reps,
+	        work/median, work/durations[0], work/durations[report->reps-1],
+	        median/work);
+	fflush(report->out);
+
+	free(durations);
+}
+
+
+
+
+/**
+ * \fn void bench_skip(benchReport* report, const char* name, const char* reason)
+ * \brief Reports a benchmark that could not be run
+ *
+ * \param[in, out] report Report to write to
+ * \param[in]      name Identifier of the benchmark
+ * \param[in]      reason Short explanation
+ */
+void bench_skip(benchReport* report, const char* name, const char* reason) {
+	bench_openEntry(report, name);
+	fprintf(report->out, ", \"skipped\": true, \"reason\": \"%s\"}", reason);
+	fflush(report->out);
+}
+
+
+
+
+/**
+ * \fn void bench_randomBits(byte bits[], unsigned int len)
+ * \brief Fills an array with random bits, one per byte
+ *
+ * \param[out] bits Array to fill
+ * \param[in]  len Number of bits
+ */
+void bench_randomBits(byte bits[], unsigned int len) {
+	for (unsigned int i=0 ; i<len ; ++i) {
+		bits[i] = rand() & 1;
+	}
+}
+
+
+
+
+/**
+ * \struct benchKeystream
+ * \brief Data of the keystream generation benchmark
+ */
+typedef struct {
+	byte secretKey[SECRETKEY_BITS]; //!< Secret Key
+	byte frameId[FRAMEID_BITS];     //!< Frame Id
+	byte* keystream;                //!< Generated keystream, BENCH_KEYSTREAM_BITS bits (1 per byte)
+} benchKeystream;
+
+
+/**
+ * \fn void bench_keystream(void* data)
+ * \brief Keysetup, then generation of BENCH_KEYSTREAM_BITS keystream bits
+ *
+ * \param[in, out] data Benchmark data (benchKeystream)
+ */
+void bench_keystream(void* data) {
+	benchKeystream* b = data;
+	keysetup(b->secretKey, b->frameId);
+	getKeystream(b->keystream, BENCH_KEYSTREAM_BITS);
+}
+
+
+
+
+/**
+ * \struct benchCode
+ * \brief Data of the encoding and decoding benchmarks
+ */
+typedef struct {
+	byte* sourcewords;        //!< Messages, SOURCEWORD_LENGTH/8 bytes each
+	byte* codewords;          //!< Encoded messages, CODEWORD_LENGTH/8 bytes each
+	byte* codewordBits;       //!< Encoded messages, CODEWORD_LENGTH bits each (1 per byte)
+	signed char* softBits;    //!< Encoded messages, CODEWORD_LENGTH soft bits each
+	byte* bursts;             //!< Interleaved bursts, INTERLEAVING_BURSTS*INTERLEAVING_BURST_BYTES bytes per message
+	byte* deinterleaved;      //!< Deinterleaved messages, CODEWORD_LENGTH bytes each (bits or packed)
+	byte* decoded;            //!< Decoded messages, SOURCEWORD_LENGTH bytes each (bits or packed)
+} benchCode;
+
+
+/**
+ * \fn void bench_encode(void* data)
+ * \brief Packed encoding of BENCH_CODE_BLOCKS messages
+ *
+ * \param[in, out] data Benchmark data (benchCode)
+ */
+void bench_encode(void* data) {
+	benchCode* b = data;
+	processPackedEncoding(b->sourcewords, b->codewords, BENCH_CODE_BLOCKS);
+}
+
+
+/**
+ * \fn void bench_decode(void* data)
+ * \brief Packed algebraic decoding of BENCH_CODE_BLOCKS messages
+ *
+ * \param[in, out] data Benchmark data (benchCode)
+ */
+void bench_decode(void* data) {
+	benchCode* b = data;
+	processPackedDecoding(b->codewords, b->decoded, NULL, BENCH_CODE_BLOCKS);
+}
+
+
+/**
+ * \fn void bench_decodeViterbi(void* data)
+ * \brief Soft-decision Viterbi decoding of BENCH_CODE_BLOCKS messages
+ *
+ * \param[in, out] data Benchmark data (benchCode)
+ */
+void bench_decodeViterbi(void* data) {
+	benchCode* b = data;
+	processFullViterbiDecoding(b->softBits, b->decoded, NULL, BENCH_CODE_BLOCKS);
+}
+
+
+/**
+ * \fn void bench_interleave(void* data)
+ * \brief Interleaving of BENCH_CODE_BLOCKS packed messages into their bursts
+ *
+ * \param[in, out] data Benchmark data (benchCode)
+ */
+void bench_interleave(void* data) {
+	benchCode* b = data;
+	interleaveBursts(b->codewords, b->bursts, BENCH_CODE_BLOCKS);
+}
+
+
+/**
+ * \fn void bench_deinterleave(void* data)
+ * \brief Deinterleaving of the bursts of BENCH_CODE_BLOCKS messages into packed messages
+ *
+ * \param[in, out] data Benchmark data (benchCode)
+ */
+void bench_deinterleave(void* data) {
+	benchCode* b = data;
+	deinterleaveBursts(b->bursts, b->deinterleaved, BENCH_CODE_BLOCKS);
+}
+
+
+/**
+ * \fn void bench_deinterleaveBitwise(void* data)
+ * \brief Bit-by-bit deinterleaving of BENCH_CODE_BLOCKS messages (1 bit per byte), the reference of bench_deinterleave()
+ *
+ * \param[in, out] data Benchmark data (benchCode)
+ */
+void bench_deinterleaveBitwise(void* data) {
+	benchCode* b = data;
+	for (unsigned int m=0 ; m<BENCH_CODE_BLOCKS ; ++m) {
+		reverseInterleaving(b->codewordBits + m*CODEWORD_LENGTH, b->deinterleaved + m*CODEWORD_LENGTH);
+	}
+}
+
+
+
+
+/**
+ * \struct benchKeysetup
+ * \brief Data of the keysetup reversal benchmark
+ */
+typedef struct {
+	byte secretKey[BENCH_KEYSETUP_CALLS][SECRETKEY_BITS]; //!< Secret Keys to recover
+	byte frameId[BENCH_KEYSETUP_CALLS][FRAMEID_BITS];     //!< Frame Ids
+	byte R1[BENCH_KEYSETUP_CALLS][R1_BITS];               //!< R1 after keysetup
+	byte R2[BENCH_KEYSETUP_CALLS][R2_BITS];               //!< R2 after keysetup
+	byte R3[BENCH_KEYSETUP_CALLS][R3_BITS];               //!< R3 after keysetup
+	byte R4[BENCH_KEYSETUP_CALLS][R4_BITS];               //!< R4 after keysetup
+	unsigned int errors;                                  //!< Number of keys not recovered
+} benchKeysetup;
+
+
+/**
+ * \fn void bench_prepareKeysetup(benchKeysetup* b)
+ * \brief Draws the secret keys and frame Ids, and processes the LFSRs state reached after their keysetup
+ *
+ * \param[out] b Benchmark data
+ */
+void bench_prepareKeysetup(benchKeysetup* b) {
+
+	for (int c=0 ; c<BENCH_KEYSETUP_CALLS ; ++c) {
+
+		bench_randomBits(b->secretKey[c], SECRETKEY_BITS);
+		bench_randomBits(b->frameId[c], FRAMEID_BITS);
+
+		// The state is linear in the frame Id until the constant bits are forced
+		keygen_frameSchedule schedule;
+		keygen_prepareFrameSchedule(b->secretKey[c], &schedule);
+		keygen_packedState state = schedule.keyState;
+		unsigned int count = keygen_frameIdToCount(b->frameId[c]);
+		for (int i=0 ; i<FRAMEID_BITS ; ++i) {
+			if ((count >> i) & 1) {
+				state.R1 ^= schedule.frameBits[i].R1;
+				state.R2 ^= schedule.frameBits[i].R2;
+				state.R3 ^= schedule.frameBits[i].R3;
+				state.R4 ^= schedule.frameBits[i].R4;
+			}
+		}
+
+		for (int i=0 ; i<R1_BITS ; ++i) b->R1[c][i] = (state.R1 >> i) & 1;
+		for (int i=0 ; i<R2_BITS ; ++i) b->R2[c][i] = (state.R2 >> i) & 1;
+		for (int i=0 ; i<R3_BITS ; ++i) b->R3[c][i] = (state.R3 >> i) & 1;
+		for (int i=0 ; i<R4_BITS ; ++i) b->R4[c][i] = (state.R4 >> i) & 1;
+		b->R1[c][R1_INITIAL_CONST_POS] = 1;
+		b->R2[c][R2_INITIAL_CONST_POS] = 1;
+		b->R3[c][R3_INITIAL_CONST_POS] = 1;
+		b->R4[c][R4_INITIAL_CONST_POS] = 1;
+	}
+	b->errors = 0;
+}
+
+
+/**
+ * \fn void bench_keysetupReversal(void* data)
+ * \brief Recovers BENCH_KEYSETUP_CALLS secret keys from their LFSRs state
+ *
+ * \param[in, out] data Benchmark data (benchKeysetup)
+ */
+void bench_keysetupReversal(void* data) {
+	benchKeysetup* b = data;
+	for (int c=0 ; c<BENCH_KEYSETUP_CALLS ; ++c) {
+		byte secretKey[SECRETKEY_BITS];
+		if (reverseKeysetup(b->R1[c], b->R2[c], b->R3[c], b->R4[c], b->frameId[c], secretKey)
+		 || memcmp(secretKey, b->secretKey[c], SECRETKEY_BITS)) {
+			++b->errors;
+		}
+	}
+}
+
+
+
+
+/**
+ * \fn void bench_generation(void* data)
+ * \brief Generation of BENCH_GENERATED_MATRICES Resolution Matrices
+ *
+ * \param[out] data Storage for one matrix (BUFFER_SIZE(NEEDED_ENCRYPTED_MESSAGES) bytes)
+ */
+void bench_generation(void* data) {
+	for (int i=0 ; i<BENCH_GENERATED_MATRICES ; ++i) {
+		generateMatrix(i, NEEDED_ENCRYPTED_MESSAGES, data);
+	}
+}
+
+
+/**
+ * \fn void bench_keystreamGeneration(void* data)
+ * \brief Generation of the keystream equations of BENCH_GENERATED_MATRICES indices (known-keystream dictionary)
+ *
+ * \param[out] data Storage for one matrix (KEYSTREAM_BUFFER_SIZE bytes)
+ */
+void bench_keystreamGeneration(void* data) {
+	for (int i=0 ; i<BENCH_GENERATED_MATRICES ; ++i) {
+		generateKeystreamMatrix(i, data);
+	}
+}
+
+
+
+
+/**
+ * \struct benchAttack
+ * \brief Data of the attack benchmark
+ */
+typedef struct {
+	cipherTextArgs ctArgs;                    //!< Problem to solve (random, so that every candidate is rejected)
+	byte* matrices[BENCH_ATTACK_CANDIDATES];  //!< Dictionary entries of the candidates
+	DictionaryKind kind;                      //!< Attack the dictionary entries are made for
+	int messages;                             //!< Number of chunks of the problem
+	int keyFound;                             //!< Solution found flag
+} benchAttack;
+
+
+/**
+ * \fn void bench_attack(void* data)
+ * \brief Tries BENCH_ATTACK_CANDIDATES dictionary indices on a single thread
+ *
+ * \param[in, out] data Benchmark data (benchAttack)
+ */
+void bench_attack(void* data) {
+	benchAttack* b = data;
+	byte secretKey[SECRETKEY_BITS];
+	b->keyFound = 0;
+	attack_decipherSecretKey(&b->ctArgs, b->matrices, b->kind, b->messages, 0, BENCH_ATTACK_CANDIDATES, &b->keyFound, secretKey, NULL);
+}
+
+
+
+
+/**
+ * \fn void bench_dictionaryLoad(void* data)
+ * \brief Loads then frees the whole dictionary
+ *
+ * \param[in] data Path of the dictionary
+ */
+void bench_dictionaryLoad(void* data) {
+	if (initializeRAM(data, NULL)) {
+		DEBUG("Error: unable to load the dictionary '%s'", (const char*)data);
+		return;
+	}
+	freeRAM();
+}
+
+
+
+
+/**
+ * \fn void bench_displayHelp()
+ * \brief Displays the available options
+ */
+void bench_displayHelp() {
+	printf("A52HackTool benchmark suite: the report is written as JSON\n");
+	printf(" -r [repetitions] : timed repetitions of every benchmark (default %d)\n", BENCH_DEFAULT_REPS);
+	printf(" -s [seed]        : seed of the random inputs (default %d)\n", BENCH_DEFAULT_SEED);
+	printf(" -d [dictionary]  : also time the loading of this dictionary file\n");
+	printf(" -o [report]      : file to write the report to (default: standard output)\n");
+}
+
+
+
+
+/**
+ * \fn int main(int argc, char* argv[])
+ * \brief Benchmark entry point
+ *
+ * \param[in] argc Arguments count
+ * \param[in] argv Arguments values
+ * \return 0 if every benchmark has been run, non-zero otherwise
+ */
+int main(int argc, char* argv[]) {
+
+	unsigned int param_reps = BENCH_DEFAULT_REPS;
+	unsigned int param_seed = BENCH_DEFAULT_SEED;
+	const char*  param_dictionary = NULL;
+	const char*  param_report     = NULL;
+
+	for (int argi=1 ; argi<argc ; ++argi) {
+		if (strcmp(argv[argi],"-r")==0 && argi+1<argc && atoi(argv[argi+1])>0) {
+			param_reps = atoi(argv[++argi]);
+		} else if (strcmp(argv[argi],"-s")==0 && argi+1<argc) {
+			param_seed = strtoul(argv[++argi], NULL, 0);
+		} else if (strcmp(argv[argi],"-d")==0 && argi+1<argc) {
+			param_dictionary = argv[++argi];
+		} else if (strcmp(argv[argi],"-o")==0 && argi+1<argc) {
+			param_report = argv[++argi];
+		} else if (strcmp(argv[argi],"-h")==0 || strcmp(argv[argi],"--help")==0) {
+			bench_displayHelp();
+			return 0;
+		} else {
+			printf("Invalid parameter '%s'\n", argv[argi]);
+			bench_displayHelp();
+			return 1;
+		}
+	}
+
+	// The library displays its progress on the standard output: it is sent to the standard error
+	// instead, so that the standard output only carries the report
+	benchReport report = {NULL, param_reps, 0};
+	fflush(stdout);
+	if (param_report) {
+		report.out = fopen(param_report, "w");
+	} else {
+		int reportfd = dup(STDOUT_FILENO);
+		if (reportfd >= 0 && dup2(STDERR_FILENO, STDOUT_FILENO) >= 0)
+			report.out = fdopen(reportfd, "w");
+	}
+	if (!report.out) {
+		DEBUG("Error: unable to open the report");
+		return 1;
+	}
+
+	// Shared matrices are built before any timing
+	if (!code_getMatrices()) {
+		printf("Error: unable to allocate the code matrices\n");
+		return 1;
+	}
+
+	fprintf(report.out, "{\n  \"tool\": \"a52bench\",\n  \"seed\": %u,\n  \"reps\": %u,\n  \"warmup_runs\": 1,\n"
+	                    "  \"processing_threads\": %d,\n  \"simd\": \"%s\",\n  \"benchmarks\": [",
+	        param_seed, param_reps, PROCESSING_THREADS, bitmatrix_kernel());
+
+	int res = 0;
+
+
+	// Keystream generation
+	benchKeystream keystream;
+	srand(param_seed);
+	bench_randomBits(keystream.secretKey, SECRETKEY_BITS);
+	bench_randomBits(keystream.frameId, FRAMEID_BITS);
+	keystream.keystream = malloc(BENCH_KEYSTREAM_BITS);
+	if (keystream.keystream) {
+		bench_run(&report, "keystream", "bit", BENCH_KEYSTREAM_BITS, bench_keystream, &keystream);
+		free(keystream.keystream);
+	} else {
+		bench_skip(&report, "keystream", "out of memory");
+		res = 1;
+	}
+
+
+	// Encoding and decoding (the amount of work is the size of the messages, in MB)
+	benchCode code;
+	code.sourcewords   = malloc(BENCH_CODE_BLOCKS*SOURCEWORD_LENGTH/8);
+	code.codewords     = malloc(BENCH_CODE_BLOCKS*CODEWORD_LENGTH/8);
+	code.codewordBits  = malloc(BENCH_CODE_BLOCKS*CODEWORD_LENGTH);
+	code.softBits      = malloc(BENCH_CODE_BLOCKS*CODEWORD_LENGTH);
+	code.bursts        = malloc(BENCH_CODE_BLOCKS*INTERLEAVING_BURSTS*INTERLEAVING_BURST_BYTES);
+	code.deinterleaved = malloc(BENCH_CODE_BLOCKS*CODEWORD_LENGTH);
+	code.decoded       = malloc(BENCH_CODE_BLOCKS*SOURCEWORD_LENGTH);
+	if (code.sourcewords && code.codewords && code.codewordBits && code.softBits && code.bursts && code.deinterleaved && code.decoded) {
+		srand(param_seed);
+		for (unsigned int i=0 ; i<BENCH_CODE_BLOCKS*SOURCEWORD_LENGTH/8 ; ++i) {
+			code.sourcewords[i] = rand() & 0xFF;
+		}
+		processPackedEncoding(code.sourcewords, code.codewords, BENCH_CODE_BLOCKS);
+		BYTE_VECTOR_TO_BIT_VECTOR(code.codewords, code.codewordBits, BENCH_CODE_BLOCKS*CODEWORD_LENGTH);
+		for (unsigned int i=0 ; i<BENCH_CODE_BLOCKS*CODEWORD_LENGTH ; ++i) {
+			code.softBits[i] = HARD_TO_SOFTBIT(code.codewordBits[i]);
+		}
+
+		double megabytes = BENCH_CODE_BLOCKS*(SOURCEWORD_LENGTH/8) / 1e6;
+		bench_run(&report, "encode",         "MB", megabytes, bench_encode,        &code);
+		bench_run(&report, "decode",         "MB", megabytes, bench_decode,        &code);
+		bench_run(&report, "decode_viterbi", "MB", megabytes, bench_decodeViterbi, &code);
+
+		// Interleaving alone, on the encoded messages
+		megabytes = BENCH_CODE_BLOCKS*(CODEWORD_LENGTH/8) / 1e6;
+		bench_run(&report, "interleave",           "MB", megabytes, bench_interleave,          &code);
+		bench_run(&report, "deinterleave",         "MB", megabytes, bench_deinterleave,        &code);
+		bench_run(&report, "deinterleave_bitwise", "MB", megabytes, bench_deinterleaveBitwise, &code);
+	} else {
+		bench_skip(&report, "encode",               "out of memory");
+		bench_skip(&report, "decode",               "out of memory");
+		bench_skip(&report, "decode_viterbi",       "out of memory");
+		bench_skip(&report, "interleave",           "out of memory");
+		bench_skip(&report, "deinterleave",         "out of memory");
+		bench_skip(&report, "deinterleave_bitwise", "out of memory");
+		res = 1;
+	}
+	free(code.sourcewords);
+	free(code.codewords);
+	free(code.codewordBits);
+	free(code.softBits);
+	free(code.bursts);
+	free(code.deinterleaved);
+	free(code.decoded);
+
+
+	// Keysetup reversal
+	benchKeysetup* keysetupData = malloc(sizeof(benchKeysetup));
+	if (keysetupData) {
+		srand(param_seed);
+		bench_prepareKeysetup(keysetupData);
+		bench_run(&report, "keysetup_reversal", "call", BENCH_KEYSETUP_CALLS, bench_keysetupReversal, keysetupData);
+		if (keysetupData->errors) {
+			DEBUG("Error: %u secret keys were not recovered", keysetupData->errors);
+			res = 1;
+		}
+		free(keysetupData);
+	} else {
+		bench_skip(&report, "keysetup_reversal", "out of memory");
+		res = 1;
+	}
+
+
+	// Resolution Matrices generation, then attack on matrices that are all wrong for the problem
+	byte* matrices[BENCH_ATTACK_MATRICES] = {NULL};
+	int generated = 1;
+	for (int i=0 ; i<BENCH_ATTACK_MATRICES && generated ; ++i) {
+		matrices[i] = malloc(BUFFER_SIZE(NEEDED_ENCRYPTED_MESSAGES));
+		generated = matrices[i] && !generateMatrix(i, NEEDED_ENCRYPTED_MESSAGES, matrices[i]);
+	}
+	if (generated) {
+		bench_run(&report, "matrices_generation", "matrix", BENCH_GENERATED_MATRICES, bench_generation, matrices[0]);
+
+		benchAttack attackData;
+		attackData.kind     = DICTIONARY_CIPHERTEXT;
+		attackData.messages = NEEDED_ENCRYPTED_MESSAGES;
+		srand(param_seed);
+		for (int m=0 ; m<NEEDED_ENCRYPTED_MESSAGES ; ++m) {
+			bench_randomBits(attackData.ctArgs.cipherText[m], CODEWORD_LENGTH);
+		}
+		bench_randomBits(attackData.ctArgs.frameId, FRAMEID_BITS);
+		for (int i=0 ; i<BENCH_ATTACK_CANDIDATES ; ++i) {
+			attackData.matrices[i] = matrices[i%BENCH_ATTACK_MATRICES];
+		}
+		bench_run(&report, "attack_per_thread", "candidate", BENCH_ATTACK_CANDIDATES, bench_attack, &attackData);
+	} else {
+		bench_skip(&report, "matrices_generation", "out of memory");
+		bench_skip(&report, "attack_per_thread",   "out of memory");
+		res = 1;
+	}
+	for (int i=0 ; i<BENCH_ATTACK_MATRICES ; ++i) {
+		free(matrices[i]);
+		matrices[i] = NULL;
+	}
+
+
+	// Same benchmarks with a known keystream: both attacks go through every index, so that their
+	// times-to-key compare as their times per candidate
+	generated = 1;
+	for (int i=0 ; i<BENCH_ATTACK_MATRICES && generated ; ++i) {
+		matrices[i] = malloc(KEYSTREAM_BUFFER_SIZE);
+		generated = matrices[i] && !generateKeystreamMatrix(i, matrices[i]);
+	}
+	if (generated) {
+		bench_run(&report, "keystream_generation", "matrix", BENCH_GENERATED_MATRICES, bench_keystreamGeneration, matrices[0]);
+
+		benchAttack attackData;
+		attackData.kind     = DICTIONARY_KEYSTREAM;
+		attackData.messages = KEYSTREAM_MESSAGES;
+		srand(param_seed);
+		for (int m=0 ; m<KEYSTREAM_MESSAGES ; ++m) {
+			bench_randomBits(attackData.ctArgs.cipherText[m], CODEWORD_LENGTH);
+		}
+		bench_randomBits(attackData.ctArgs.frameId, FRAMEID_BITS);
+		for (int i=0 ; i<BENCH_ATTACK_CANDIDATES ; ++i) {
+			attackData.matrices[i] = matrices[i%BENCH_ATTACK_MATRICES];
+		}
+		bench_run(&report, "keystream_attack_per_thread", "candidate", BENCH_ATTACK_CANDIDATES, bench_attack, &attackData);
+	} else {
+		bench_skip(&report, "keystream_generation",        "out of memory");
+		bench_skip(&report, "keystream_attack_per_thread", "out of memory");
+		res = 1;
+	}
+	for (int i=0 ; i<BENCH_ATTACK_MATRICES ; ++i) {
+		free(matrices[i]);
+	}
+
+
+	// Dictionary loading (the amount of work is the size of the file, in MB)
+	struct stat dictionaryInfo;
+	if (!param_dictionary) {
+		bench_skip(&report, "dictionary_load", "no dictionary given (-d)");
+	} else if (!fileExists(param_dictionary) || stat(param_dictionary, &dictionaryInfo)) {
+		bench_skip(&report, "dictionary_load", "dictionary not found");
+		res = 1;
+	} else {
+		bench_run(&report, "dictionary_load", "MB", (double)dictionaryInfo.st_size / 1e6,
+		          bench_dictionaryLoad, (void*)param_dictionary);
+	}
+
+
+	fprintf(report.out, "\n  ]\n}\n");
+	fclose(report.out);
+
+	return res;
+}
@@ -0,0 +1,973 @@
+/*============================================================================*
+ *                                                                            *
+ *                                 bitmatrix.c                                *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file bitmatrix.c
+  * @brief Implementation of packed GF(2) matrices
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #4
+  * @date 19/10/2026
+  * */
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "utils.h"
+#include "bitmatrix.h"
+
+
+
+
+//! Alignment of the allocated rows, in bytes
+#define BITMATRIX_BYTE_ALIGNMENT (BITMATRIX_ROW_ALIGNMENT*sizeof(bitword))
+
+//! Block widths of the table-driven kernels, set by bitmatrix_setTuning()
+bitmatrixTuning bitmatrix_tuning = {BITMATRIX_MAX_BLOCK_BITS, BITMATRIX_MAX_BLOCK_BITS};
+
+
+
+
+// Documentation in header file
+int bitmatrix_alloc(bitmatrix* M, unsigned int rows, unsigned int cols) {
+
+	M->rows   = rows;
+	M->cols   = cols;
+	M->stride = BITMATRIX_STRIDE(cols);
+
+	size_t size = (size_t)rows*M->stride*sizeof(bitword);
+	M->block = malloc(size + BITMATRIX_BYTE_ALIGNMENT);
+	if (!M->block) {
+		DEBUG("Error: unable to allocate a %ux%u matrix", rows, cols);
+		M->data = NULL;
+		return 1;
+	}
+	M->data = (bitword*)(((uintptr_t)M->block + BITMATRIX_BYTE_ALIGNMENT-1) & ~(uintptr_t)(BITMATRIX_BYTE_ALIGNMENT-1));
+	memset(M->data, 0, size);
+	return 0;
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_free(bitmatrix* M) {
+	free(M->block);
+	M->block = NULL;
+	M->data  = NULL;
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_view(const bitmatrix* M, unsigned int firstRow, unsigned int rows, bitmatrix* view) {
+	view->rows   = rows;
+	view->cols   = M->cols;
+	view->stride = M->stride;
+	view->data   = BITMATRIX_ROW(M, firstRow);
+	view->block  = NULL;
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_zero(bitmatrix* M) {
+	memset(M->data, 0, (size_t)M->rows*M->stride*sizeof(bitword));
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_identity(bitmatrix* M) {
+	bitmatrix_zero(M);
+	for (unsigned int i=0 ; i<M->rows && i<M->cols ; ++i) {
+		BITMATRIX_FLIP(M, i, i);
+	}
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_copy(bitmatrix* dest, const bitmatrix* src) {
+	memcpy(dest->data, src->data, (size_t)src->rows*src->stride*sizeof(bitword));
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_fromBits(bitmatrix* M, const byte bits[]) {
+	for (unsigned int r=0 ; r<M->rows ; ++r) {
+		memset(BITMATRIX_ROW(M, r), 0, M->stride*sizeof(bitword));
+		bitmatrix_packVector(bits + (size_t)r*M->cols, BITMATRIX_ROW(M, r), M->cols);
+	}
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_toBits(const bitmatrix* M, byte bits[]) {
+	for (unsigned int r=0 ; r<M->rows ; ++r) {
+		bitmatrix_unpackVector(BITMATRIX_ROW(M, r), bits + (size_t)r*M->cols, M->cols);
+	}
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_fromBytes(bitmatrix* M, const byte bytes[]) {
+
+	unsigned int rowBytes = (M->cols+7)/8;
+
+	for (unsigned int r=0 ; r<M->rows ; ++r) {
+
+		const byte* src = bytes + (size_t)r*rowBytes;
+		bitword* row = BITMATRIX_ROW(M, r);
+		memset(row, 0, M->stride*sizeof(bitword));
+
+		// Whole words are loaded at once (packed data is big-endian)
+		unsigned int k=0;
+		for ( ; k+8<=rowBytes ; k+=8) {
+			bitword w;
+			memcpy(&w, src+k, sizeof(bitword));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+			w = __builtin_bswap64(w);
+#endif
+			row[k/8] = w;
+		}
+		for ( ; k<rowBytes ; ++k) {
+			row[k/8] |= (bitword)src[k] << (56 - 8*(k%8));
+		}
+
+		// Padding bits are kept null
+		if (M->cols % BITMATRIX_WORD_BITS)
+			row[M->cols/BITMATRIX_WORD_BITS] &= ~0ULL << (BITMATRIX_WORD_BITS - M->cols%BITMATRIX_WORD_BITS);
+	}
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_toBytes(const bitmatrix* M, byte bytes[]) {
+
+	unsigned int rowBytes = (M->cols+7)/8;
+
+	for (unsigned int r=0 ; r<M->rows ; ++r) {
+
+		byte* dest = bytes + (size_t)r*rowBytes;
+		const bitword* row = BITMATRIX_ROW(M, r);
+
+		unsigned int k=0;
+		for ( ; k+8<=rowBytes ; k+=8) {
+			bitword w = row[k/8];
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+			w = __builtin_bswap64(w);
+#endif
+			memcpy(dest+k, &w, sizeof(bitword));
+		}
+		for ( ; k<rowBytes ; ++k) {
+			dest[k] = (byte)(row[k/8] >> (56 - 8*(k%8)));
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_packVector(const byte bits[], bitword v[], unsigned int len) {
+	memset(v, 0, BITMATRIX_WORDS(len)*sizeof(bitword));
+	for (unsigned int i=0 ; i<len ; ++i) {
+		if (bits[i] & 1)
+			BITVECTOR_FLIP(v, i);
+	}
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_unpackVector(const bitword v[], byte bits[], unsigned int len) {
+	for (unsigned int i=0 ; i<len ; ++i) {
+		bits[i] = BITVECTOR_GET(v, i);
+	}
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_xorWords(bitword dest[], const bitword src[], unsigned int words) {
+
+	unsigned int w=0;
+
+#if defined(__AVX2__)
+	for ( ; w+4<=words ; w+=4) {
+		__m256i a = _mm256_loadu_si256((const __m256i*)(dest+w));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(src+w));
+		_mm256_storeu_si256((__m256i*)(dest+w), _mm256_xor_si256(a, b));
+	}
+#elif defined(__SSE2__)
+	for ( ; w+2<=words ; w+=2) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(dest+w));
+		__m128i b = _mm_loadu_si128((const __m128i*)(src+w));
+		_mm_storeu_si128((__m128i*)(dest+w), _mm_xor_si128(a, b));
+	}
+#endif
+
+	for ( ; w<words ; ++w) {
+		dest[w] ^= src[w];
+	}
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_swapRows(bitmatrix* M, unsigned int r1, unsigned int r2) {
+	bitword* row1 = BITMATRIX_ROW(M, r1);
+	bitword* row2 = BITMATRIX_ROW(M, r2);
+	for (unsigned int w=0 ; w<M->stride ; ++w) {
+		bitword temp = row1[w];
+		row1[w] = row2[w];
+		row2[w] = temp;
+	}
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_swapColumns(bitmatrix* M, unsigned int c1, unsigned int c2) {
+
+	unsigned int w1 = c1/BITMATRIX_WORD_BITS, w2 = c2/BITMATRIX_WORD_BITS;
+	bitword m1 = BITMATRIX_MASK(c1), m2 = BITMATRIX_MASK(c2);
+
+	for (unsigned int r=0 ; r<M->rows ; ++r) {
+		bitword* row = BITMATRIX_ROW(M, r);
+		if (!(row[w1] & m1) != !(row[w2] & m2)) {
+			row[w1] ^= m1;
+			row[w2] ^= m2;
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+int bitmatrix_setTuning(const bitmatrixTuning* tuning) {
+
+	const bitmatrixTuning defaults = {BITMATRIX_MAX_BLOCK_BITS, BITMATRIX_MAX_BLOCK_BITS};
+	if (!tuning)
+		tuning = &defaults;
+
+	// Powers of two, so that the blocks never straddle two words
+	unsigned int echelonBits = tuning->echelonBits, multiplyBits = tuning->multiplyBits;
+	if (!echelonBits || echelonBits > BITMATRIX_MAX_BLOCK_BITS || (echelonBits & (echelonBits-1))
+	 || !multiplyBits || multiplyBits > BITMATRIX_MAX_BLOCK_BITS || (multiplyBits & (multiplyBits-1)))
+		return 1;
+
+	bitmatrix_tuning = *tuning;
+	return 0;
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_getTuning(bitmatrixTuning* tuning) {
+	*tuning = bitmatrix_tuning;
+}
+
+
+
+
+// Documentation in header file
+const char* bitmatrix_kernel() {
+#if defined(__AVX2__)
+	return "avx2";
+#elif defined(__SSE2__)
+	return "sse2";
+#else
+	return "none";
+#endif
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_multiply(const bitmatrix* A, const bitmatrix* B, bitmatrix* C) {
+
+	bitmatrix_zero(C);
+
+	// All combinations of \a bits consecutive rows of B
+	const unsigned int bits = bitmatrix_tuning.multiplyBits;
+	bitmatrix table;
+	if (bitmatrix_alloc(&table, 1<<bits, B->cols))
+		return;
+
+	for (unsigned int k=0 ; k<A->cols ; k+=bits) {
+
+		// Row k weighs 2^(bits-1) and row k+bits-1 weighs 1, as columns k to k+bits-1 of A (MSB first).
+		// Each combination is obtained from a previous one by adding a single row of B.
+		for (unsigned int value=1 ; value<(1u<<bits) ; ++value) {
+			unsigned int r = k + bits-1 - __builtin_ctz(value);
+			bitword* entry = BITMATRIX_ROW(&table, value);
+			memcpy(entry, BITMATRIX_ROW(&table, value & (value-1)), table.stride*sizeof(bitword));
+			if (r < B->rows)
+				bitmatrix_xorWords(entry, BITMATRIX_ROW(B, r), table.stride);
+		}
+
+		for (unsigned int i=0 ; i<A->rows ; ++i) {
+			unsigned int value = (BITMATRIX_ROW(A, i)[k/BITMATRIX_WORD_BITS] >> (BITMATRIX_WORD_BITS - bits - k%BITMATRIX_WORD_BITS)) & ((1<<bits)-1);
+			if (value)
+				bitmatrix_xorWords(BITMATRIX_ROW(C, i), BITMATRIX_ROW(&table, value), C->stride);
+		}
+	}
+
+	bitmatrix_free(&table);
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_multiplyVector(const bitmatrix* M, const bitword v[], bitword out[]) {
+
+	memset(out, 0, BITMATRIX_WORDS(M->rows)*sizeof(bitword));
+
+	for (unsigned int r=0 ; r<M->rows ; ++r) {
+		const bitword* row = BITMATRIX_ROW(M, r);
+		bitword acc = 0;
+		for (unsigned int w=0 ; w<BITMATRIX_WORDS(M->cols) ; ++w) {
+			acc ^= row[w] & v[w];
+		}
+		if (__builtin_parityll(acc))
+			BITVECTOR_FLIP(out, r);
+	}
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_vectorMultiply(const bitword v[], const bitmatrix* M, bitword out[]) {
+
+	memset(out, 0, BITMATRIX_WORDS(M->cols)*sizeof(bitword));
+
+	for (unsigned int r=0 ; r<M->rows ; ++r) {
+		if (BITVECTOR_GET(v, r))
+			bitmatrix_xorWords(out, BITMATRIX_ROW(M, r), BITMATRIX_WORDS(M->cols));
+	}
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_transpose64(bitword block[BITMATRIX_WORD_BITS]) {
+
+	// The off-diagonal sub-blocks of size j are exchanged, from 32×32 sub-blocks down to single bits:
+	// the right half (mask m) of row k is swapped with the left half of row k+j
+	bitword m = 0x00000000FFFFFFFFULL;
+	for (unsigned int j=BITMATRIX_WORD_BITS/2 ; j ; j>>=1, m^=m<<j) {
+		for (unsigned int k=0 ; k<BITMATRIX_WORD_BITS ; k+=2*j) {
+
+			unsigned int i=0;
+
+#if defined(__AVX2__)
+			__m256i mask256 = _mm256_set1_epi64x(m);
+			__m128i shift256 = _mm_cvtsi32_si128(j);
+			for ( ; i+4<=j ; i+=4) {
+				__m256i a = _mm256_loadu_si256((const __m256i*)(block+k+i));
+				__m256i b = _mm256_loadu_si256((const __m256i*)(block+k+i+j));
+				__m256i t = _mm256_and_si256(_mm256_xor_si256(a, _mm256_srl_epi64(b, shift256)), mask256);
+				_mm256_storeu_si256((__m256i*)(block+k+i),   _mm256_xor_si256(a, t));
+				_mm256_storeu_si256((__m256i*)(block+k+i+j), _mm256_xor_si256(b, _mm256_sll_epi64(t, shift256)));
+			}
+#endif
+#if defined(__SSE2__)
+			__m128i mask128 = _mm_set1_epi64x(m);
+			__m128i shift128 = _mm_cvtsi32_si128(j);
+			for ( ; i+2<=j ; i+=2) {
+				__m128i a = _mm_loadu_si128((const __m128i*)(block+k+i));
+				__m128i b = _mm_loadu_si128((const __m128i*)(block+k+i+j));
+				__m128i t = _mm_and_si128(_mm_xor_si128(a, _mm_srl_epi64(b, shift128)), mask128);
+				_mm_storeu_si128((__m128i*)(block+k+i),   _mm_xor_si128(a, t));
+				_mm_storeu_si128((__m128i*)(block+k+i+j), _mm_xor_si128(b, _mm_sll_epi64(t, shift128)));
+			}
+#endif
+
+			for ( ; i<j ; ++i) {
+				bitword t = (block[k+i] ^ (block[k+i+j] >> j)) & m;
+				block[k+i]   ^= t;
+				block[k+i+j] ^= t << j;
+			}
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_transpose(const bitmatrix* M, bitmatrix* T) {
+
+	bitword block[BITMATRIX_WORD_BITS];
+
+	// Block (rb, cb) of 64×64 bits of M becomes block (cb, rb) of T. The rows missing at the bottom
+	// of M are null, and the padding columns of M give the rows missing at the bottom of T.
+	for (unsigned int rb=0 ; rb<BITMATRIX_WORDS(M->rows) ; ++rb) {
+		for (unsigned int cb=0 ; cb<BITMATRIX_WORDS(M->cols) ; ++cb) {
+
+			for (unsigned int i=0 ; i<BITMATRIX_WORD_BITS ; ++i) {
+				unsigned int r = rb*BITMATRIX_WORD_BITS + i;
+				block[i] = (r < M->rows) ? BITMATRIX_ROW(M, r)[cb] : 0;
+			}
+
+			bitmatrix_transpose64(block);
+
+			for (unsigned int i=0 ; i<BITMATRIX_WORD_BITS && cb*BITMATRIX_WORD_BITS+i<T->rows ; ++i) {
+				BITMATRIX_ROW(T, cb*BITMATRIX_WORD_BITS + i)[rb] = block[i];
+			}
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+unsigned int bitmatrix_echelon(bitmatrix* M, unsigned int cols, int reduced, unsigned int pivots[]) {
+
+	// Combinations of the pivot rows found in a block of \a bits columns. Without it,
+	// every row is cleared pivot by pivot, which gives the same result.
+	const unsigned int bits = bitmatrix_tuning.echelonBits;
+	bitmatrix table;
+	int useTable = !bitmatrix_alloc(&table, 1<<bits, M->cols);
+
+	unsigned int rank = 0;
+
+	for (unsigned int c=0 ; c<cols && rank<M->rows ; c+=bits) {
+
+		// The pivot rows are null before column c, so the words on their left are skipped
+		// (starting on a vector boundary)
+		unsigned int first = c/BITMATRIX_WORD_BITS - (c/BITMATRIX_WORD_BITS)%BITMATRIX_ROW_ALIGNMENT;
+		unsigned int words = M->stride - first;
+
+		// Pivot finding, column by column inside the block. Candidate rows are cleared on the pivots
+		// already found, and the pivot rows are kept null on each other's pivot columns.
+		unsigned int blockPivots[BITMATRIX_MAX_BLOCK_BITS];
+		unsigned int found = 0;
+		for (unsigned int col=c ; col<MIN(c+bits, cols) && rank+found<M->rows ; ++col) {
+
+			unsigned int line;
+			for (line=rank+found ; line<M->rows ; ++line) {
+				bitword* row = BITMATRIX_ROW(M, line);
+				for (unsigned int p=0 ; p<found ; ++p) {
+					if (BITVECTOR_GET(row, blockPivots[p]))
+						bitmatrix_xorWords(row+first, BITMATRIX_ROW(M, rank+p)+first, words);
+				}
+				if (BITVECTOR_GET(row, col))
+					break;
+			}
+			if (line == M->rows)
+				continue;
+
+			// Line Swap if necessary
+			if (line != rank+found)
+				bitmatrix_swapRows(M, line, rank+found);
+
+			const bitword* pivot = BITMATRIX_ROW(M, rank+found);
+			for (unsigned int p=0 ; p<found ; ++p) {
+				bitword* row = BITMATRIX_ROW(M, rank+p);
+				if (BITVECTOR_GET(row, col))
+					bitmatrix_xorWords(row+first, pivot+first, words);
+			}
+
+			if (pivots)
+				pivots[rank+found] = col;
+			blockPivots[found++] = col;
+		}
+
+		if (!found)
+			continue;
+
+		// Elimination of the block from the other rows
+		unsigned int shift = BITMATRIX_WORD_BITS - bits - c%BITMATRIX_WORD_BITS;
+		if (useTable) {
+
+			// Entry #v adds up the pivot rows #p for which bit #p of v is set; each entry is obtained
+			// from a previous one by adding a single row. The entry to use for a row is selected by
+			// the bits found in its block.
+			unsigned int entries[1<<BITMATRIX_MAX_BLOCK_BITS];
+			for (unsigned int block=0 ; block<(1u<<bits) ; ++block) {
+				entries[block] = 0;
+				for (unsigned int p=0 ; p<found ; ++p) {
+					entries[block] |= ((block >> (c+bits-1-blockPivots[p])) & 1) << p;
+				}
+			}
+			for (unsigned int value=1 ; value<(1u<<found) ; ++value) {
+				bitword* entry = BITMATRIX_ROW(&table, value) + first;
+				memcpy(entry, BITMATRIX_ROW(&table, value & (value-1)) + first, words*sizeof(bitword));
+				bitmatrix_xorWords(entry, BITMATRIX_ROW(M, rank+__builtin_ctz(value)) + first, words);
+			}
+
+			for (unsigned int l=(reduced ? 0 : rank+found) ; l<M->rows ; ++l) {
+				if (l == rank)
+					l += found;
+				if (l >= M->rows)
+					break;
+				bitword* row = BITMATRIX_ROW(M, l);
+				unsigned int value = entries[(row[c/BITMATRIX_WORD_BITS] >> shift) & ((1<<bits)-1)];
+				if (value)
+					bitmatrix_xorWords(row+first, BITMATRIX_ROW(&table, value)+first, words);
+			}
+
+		} else {
+
+			for (unsigned int l=(reduced ? 0 : rank+found) ; l<M->rows ; ++l) {
+				if (l == rank)
+					l += found;
+				if (l >= M->rows)
+					break;
+				bitword* row = BITMATRIX_ROW(M, l);
+				for (unsigned int p=0 ; p<found ; ++p) {
+					if (BITVECTOR_GET(row, blockPivots[p]))
+						bitmatrix_xorWords(row+first, BITMATRIX_ROW(M, rank+p)+first, words);
+				}
+			}
+		}
+
+		rank += found;
+	}
+
+	if (useTable)
+		bitmatrix_free(&table);
+
+	return rank;
+}
+
+
+
+
+// Documentation in header file
+unsigned int bitmatrix_rank(const bitmatrix* M) {
+	bitmatrix work;
+	if (bitmatrix_alloc(&work, M->rows, M->cols))
+		return 0;
+	bitmatrix_copy(&work, M);
+	unsigned int rank = bitmatrix_echelon(&work, work.cols, 0, NULL);
+	bitmatrix_free(&work);
+	return rank;
+}
+
+
+
+
+// Documentation in header file
+int bitmatrix_inverse(const bitmatrix* M, bitmatrix* I) {
+
+	if (M->rows != M->cols) {
+		DEBUG("Error: unable to invert a non-square matrix (%ux%u)", M->rows, M->cols);
+		return 1;
+	}
+
+	bitmatrix work;
+	if (bitmatrix_alloc(&work, M->rows, M->cols))
+		return 1;
+	bitmatrix_copy(&work, M);
+	bitmatrix_identity(I);
+
+	// Gauss-Jordan elimination, every row operation being applied to the identity as well
+	for (unsigned int c=0 ; c<work.cols ; ++c) {
+
+		unsigned int w = c/BITMATRIX_WORD_BITS;
+		bitword mask = BITMATRIX_MASK(c);
+
+		unsigned int line = c;
+		while (line<work.rows && !(BITMATRIX_ROW(&work, line)[w] & mask))
+			++line;
+		if (line == work.rows) {
+			bitmatrix_free(&work);
+			return 1;
+		}
+		if (line != c) {
+			bitmatrix_swapRows(&work, line, c);
+			bitmatrix_swapRows(I, line, c);
+		}
+
+		unsigned int first = w - w%BITMATRIX_ROW_ALIGNMENT;
+		for (unsigned int l=0 ; l<work.rows ; ++l) {
+			if (l!=c && (BITMATRIX_ROW(&work, l)[w] & mask)) {
+				bitmatrix_xorWords(BITMATRIX_ROW(&work, l)+first, BITMATRIX_ROW(&work, c)+first, work.stride-first);
+				bitmatrix_xorWords(BITMATRIX_ROW(I, l), BITMATRIX_ROW(I, c), I->stride);
+			}
+		}
+	}
+
+	bitmatrix_free(&work);
+	return 0;
+}
+
+
+
+
+// Documentation in header file
+unsigned int bitmatrix_nullspace(const bitmatrix* M, bitmatrix* N) {
+
+	bitmatrix work;
+	unsigned int* pivots = malloc((M->cols+1)*sizeof(unsigned int));
+	if (!pivots || bitmatrix_alloc(&work, M->rows, M->cols)) {
+		free(pivots);
+		return (unsigned int)-1;
+	}
+	bitmatrix_copy(&work, M);
+
+	unsigned int rank = bitmatrix_echelon(&work, work.cols, 1, pivots);
+	if (bitmatrix_alloc(N, M->cols-rank, M->cols)) {
+		bitmatrix_free(&work);
+		free(pivots);
+		return (unsigned int)-1;
+	}
+
+	// The columns of the reduced matrix are read as rows of its transpose
+	bitmatrix view, columns;
+	bitmatrix_view(&work, 0, rank, &view);
+	if (bitmatrix_alloc(&columns, M->cols, rank)) {
+		bitmatrix_free(&work);
+		bitmatrix_free(N);
+		free(pivots);
+		return (unsigned int)-1;
+	}
+	bitmatrix_transpose(&view, &columns);
+
+	// One vector per free column f: x[f] = 1, and each pivot variable cancels its row
+	unsigned int p=0, n=0;
+	for (unsigned int f=0 ; f<M->cols ; ++f) {
+		if (p<rank && pivots[p]==f) {
+			++p;
+			continue;
+		}
+		BITMATRIX_FLIP(N, n, f);
+		const bitword* column = BITMATRIX_ROW(&columns, f);
+		for (unsigned int w=0 ; w<BITMATRIX_WORDS(rank) ; ++w) {
+			// Only the non-zero coefficients are visited
+			for (bitword bits=column[w] ; bits ; bits &= bits-1) {
+				BITMATRIX_FLIP(N, n, pivots[w*BITMATRIX_WORD_BITS + 63 - __builtin_ctzll(bits)]);
+			}
+		}
+		++n;
+	}
+
+	bitmatrix_free(&columns);
+	bitmatrix_free(&work);
+	free(pivots);
+	return n;
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_backSubstitute(const bitmatrix* M, unsigned int unknowns, unsigned int rhs, bitword solution[]) {
+
+	// Starting from the last unknown, whose row only holds its pivot
+	unsigned int words = BITMATRIX_WORDS(unknowns);
+	memset(solution, 0, words*sizeof(bitword));
+	for (int i=unknowns-1 ; i>=0 ; --i) {
+		const bitword* row = BITMATRIX_ROW(M, i);
+		bitword acc = 0;
+		for (unsigned int w=i/BITMATRIX_WORD_BITS ; w<words ; ++w) {
+			acc ^= row[w] & solution[w];
+		}
+		if (__builtin_parityll(acc) ^ BITVECTOR_GET(row, rhs))
+			BITVECTOR_FLIP(solution, i);
+	}
+}
+
+
+
+
+// Documentation in header file
+BitmatrixSolveStatus bitmatrix_solve(bitmatrix* system, bitword solution[]) {
+
+	unsigned int unknowns = system->cols-1;
+
+	// Once in echelon form, a system with a unique solution has its pivots on the diagonal
+	if (bitmatrix_echelon(system, unknowns, 0, NULL) < unknowns)
+		return BITMATRIX_UNDERDETERMINED;
+
+	// The remaining rows are null on the unknowns (0 = right-hand side)
+	for (unsigned int l=unknowns ; l<system->rows ; ++l) {
+		if (BITMATRIX_GET(system, l, unknowns))
+			return BITMATRIX_INCONSISTENT;
+	}
+
+	bitmatrix_backSubstitute(system, unknowns, unknowns, solution);
+	return BITMATRIX_SOLVED;
+}
+
+
+
+
+// Documentation in header file
+void bitmatrix_random(bitmatrix* M) {
+	bitmatrix_zero(M);
+	for (unsigned int r=0 ; r<M->rows ; ++r) {
+		for (unsigned int c=0 ; c<M->cols ; ++c) {
+			if (rand() & 1)
+				BITMATRIX_FLIP(M, r, c);
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+int bitmatrix_test() {
+
+	int res = 0;
+	bitmatrix A, B, C, T, I, N, S;
+	bitmatrix_alloc(&A, 100, 150);
+	bitmatrix_alloc(&B, 150, 91);
+	bitmatrix_alloc(&C, 100, 91);
+	bitmatrix_alloc(&T, 150, 100);
+	bitmatrix_alloc(&I, 100, 100);
+	bitmatrix_alloc(&S, 200, 151);
+	N.block = NULL;
+
+	// Product and transposition, against their definitions
+	bitmatrix_random(&A);
+	bitmatrix_random(&B);
+	bitmatrix_multiply(&A, &B, &C);
+	bitmatrix_transpose(&A, &T);
+	for (unsigned int i=0 ; i<A.rows && !res ; ++i) {
+		for (unsigned int j=0 ; j<B.cols ; ++j) {
+			byte sum = 0;
+			for (unsigned int k=0 ; k<A.cols ; ++k) {
+				sum ^= BITMATRIX_GET(&A, i, k) & BITMATRIX_GET(&B, k, j);
+			}
+			if (BITMATRIX_GET(&C, i, j) != sum) {
+				DEBUG("Self-check aborted: wrong coefficient (%u, %u) in the matrix product", i, j);
+				res = 1;
+				break;
+			}
+		}
+		for (unsigned int k=0 ; k<A.cols ; ++k) {
+			if (BITMATRIX_GET(&T, k, i) != BITMATRIX_GET(&A, i, k)) {
+				DEBUG("Self-check aborted: wrong coefficient (%u, %u) in the transposed matrix", k, i);
+				res = 1;
+				break;
+			}
+		}
+	}
+
+	// Matrix vector products, against the matrix product
+	bitword v[BITMATRIX_WORDS(150)], out[BITMATRIX_WORDS(150)];
+	for (unsigned int j=0 ; j<B.cols && !res ; ++j) {
+		for (unsigned int k=0 ; k<B.rows ; ++k) {
+			BITVECTOR_SET(v, k, BITMATRIX_GET(&B, k, j));
+		}
+		bitmatrix_multiplyVector(&A, v, out);
+		for (unsigned int i=0 ; i<A.rows ; ++i) {
+			if (BITVECTOR_GET(out, i) != BITMATRIX_GET(&C, i, j)) {
+				DEBUG("Self-check aborted: wrong matrix vector product (column %u)", j);
+				res = 1;
+				break;
+			}
+		}
+	}
+	for (unsigned int i=0 ; i<A.rows && !res ; ++i) {
+		bitmatrix_vectorMultiply(BITMATRIX_ROW(&A, i), &B, out);
+		if (memcmp(out, BITMATRIX_ROW(&C, i), BITMATRIX_WORDS(C.cols)*sizeof(bitword))) {
+			DEBUG("Self-check aborted: wrong vector matrix product (row %u)", i);
+			res = 1;
+		}
+	}
+
+	// Inverse of a random invertible matrix
+	bitmatrix square, product;
+	bitmatrix_alloc(&square, 100, 100);
+	bitmatrix_alloc(&product, 100, 100);
+	do {
+		bitmatrix_random(&square);
+	} while (bitmatrix_inverse(&square, &I));
+	bitmatrix_multiply(&square, &I, &product);
+	for (unsigned int i=0 ; i<product.rows && !res ; ++i) {
+		for (unsigned int j=0 ; j<product.cols ; ++j) {
+			if (BITMATRIX_GET(&product, i, j) != (i==j)) {
+				DEBUG("Self-check aborted: M × M^-1 isn't the identity");
+				res = 1;
+				break;
+			}
+		}
+	}
+	bitmatrix_free(&square);
+	bitmatrix_free(&product);
+
+	// Null space: its dimension completes the rank, and M vanishes on it
+	bitmatrix_random(&A);
+	for (unsigned int r=50 ; r<A.rows ; ++r) { // rank at most 50
+		memcpy(BITMATRIX_ROW(&A, r), BITMATRIX_ROW(&A, r-50), A.stride*sizeof(bitword));
+		bitmatrix_xorWords(BITMATRIX_ROW(&A, r), BITMATRIX_ROW(&A, r%7), A.stride);
+	}
+	unsigned int rank = bitmatrix_rank(&A);
+	unsigned int dim  = bitmatrix_nullspace(&A, &N);
+	if (!res && (rank > 50 || rank+dim != A.cols || bitmatrix_rank(&N) != dim)) {
+		DEBUG("Self-check aborted: inconsistent rank (%u) and null space dimension (%u)", rank, dim);
+		res = 1;
+	}
+	for (unsigned int n=0 ; n<dim && !res ; ++n) {
+		bitmatrix_multiplyVector(&A, BITMATRIX_ROW(&N, n), out);
+		for (unsigned int w=0 ; w<BITMATRIX_WORDS(A.rows) ; ++w) {
+			if (out[w]) {
+				DEBUG("Self-check aborted: a vector of the null space isn't mapped to 0");
+				res = 1;
+				break;
+			}
+		}
+	}
+
+	// Overdetermined system with a known solution, then the same system with a wrong equation
+	bitword x[BITMATRIX_WORDS(150)], solution[BITMATRIX_WORDS(150)];
+	memset(x, 0, sizeof(x));
+	for (unsigned int k=0 ; k<150 ; ++k) {
+		BITVECTOR_SET(x, k, rand());
+	}
+	bitmatrix_random(&S);
+	for (unsigned int l=0 ; l<S.rows ; ++l) {
+		bitword acc = 0;
+		for (unsigned int w=0 ; w<BITMATRIX_WORDS(150) ; ++w) {
+			acc ^= BITMATRIX_ROW(&S, l)[w] & x[w];
+		}
+		BITMATRIX_SET(&S, l, 150, __builtin_parityll(acc));
+	}
+	bitmatrix system;
+	bitmatrix_alloc(&system, S.rows, S.cols);
+	bitmatrix_copy(&system, &S);
+	if (!res && (bitmatrix_solve(&system, solution) != BITMATRIX_SOLVED || memcmp(solution, x, sizeof(x)))) {
+		DEBUG("Self-check aborted: the linear system wasn't solved");
+		res = 1;
+	}
+	bitmatrix_copy(&system, &S);
+	BITMATRIX_FLIP(&system, 17, 150);
+	if (!res && bitmatrix_solve(&system, solution) != BITMATRIX_INCONSISTENT) {
+		DEBUG("Self-check aborted: an inconsistent linear system wasn't detected");
+		res = 1;
+	}
+
+	// Two systems sharing their unknowns, solved with a single elimination (second right-hand side: S × y)
+	bitmatrix shared;
+	bitword y[BITMATRIX_WORDS(150)];
+	memset(y, 0, sizeof(y));
+	for (unsigned int k=0 ; k<150 ; ++k) {
+		BITVECTOR_SET(y, k, rand());
+	}
+	bitmatrix_alloc(&shared, S.rows, 152);
+	for (unsigned int l=0 ; l<S.rows ; ++l) {
+		bitword acc = 0;
+		for (unsigned int w=0 ; w<BITMATRIX_WORDS(150) ; ++w) {
+			acc ^= BITMATRIX_ROW(&S, l)[w] & y[w];
+		}
+		memcpy(BITMATRIX_ROW(&shared, l), BITMATRIX_ROW(&S, l), BITMATRIX_WORDS(151)*sizeof(bitword));
+		BITMATRIX_SET(&shared, l, 151, __builtin_parityll(acc));
+	}
+	bitmatrix_echelon(&shared, 150, 0, NULL);
+	bitmatrix_backSubstitute(&shared, 150, 150, solution);
+	int mismatch = memcmp(solution, x, sizeof(x));
+	bitmatrix_backSubstitute(&shared, 150, 151, solution);
+	if (!res && (mismatch || memcmp(solution, y, sizeof(y)))) {
+		DEBUG("Self-check aborted: the linear systems sharing their unknowns weren't solved");
+		res = 1;
+	}
+	bitmatrix_free(&shared);
+
+	// Full-byte representation
+	byte bytes[200*19];
+	bitmatrix_toBytes(&S, bytes);
+	bitmatrix_fromBytes(&system, bytes);
+	if (!res && memcmp(system.data, S.data, S.rows*S.stride*sizeof(bitword))) {
+		DEBUG("Self-check aborted: the full-byte representation doesn't give the matrix back");
+		res = 1;
+	}
+
+	// Every block width of the table-driven kernels gives the same product and the same echelon form
+	bitmatrixTuning previous, narrow;
+	bitmatrix_getTuning(&previous);
+	bitmatrix_multiply(&A, &B, &C);
+	bitmatrix_copy(&system, &S);
+	bitmatrix_echelon(&system, 150, 1, NULL);
+	bitmatrix D, E;
+	bitmatrix_alloc(&D, C.rows, C.cols);
+	bitmatrix_alloc(&E, S.rows, S.cols);
+	for (unsigned int bits=1 ; bits<BITMATRIX_MAX_BLOCK_BITS && !res ; bits*=2) {
+		narrow.echelonBits  = bits;
+		narrow.multiplyBits = bits;
+		bitmatrix_setTuning(&narrow);
+		bitmatrix_multiply(&A, &B, &D);
+		bitmatrix_copy(&E, &S);
+		bitmatrix_echelon(&E, 150, 1, NULL);
+		if (memcmp(D.data, C.data, C.rows*C.stride*sizeof(bitword))
+		 || memcmp(E.data, system.data, S.rows*S.stride*sizeof(bitword))) {
+			DEBUG("Self-check aborted: the kernels don't give the same results with %u-bit blocks", bits);
+			res = 1;
+		}
+	}
+	bitmatrix_setTuning(&previous);
+	bitmatrix_free(&D);
+	bitmatrix_free(&E);
+	bitmatrix_free(&system);
+
+	bitmatrix_free(&A);
+	bitmatrix_free(&B);
+	bitmatrix_free(&C);
+	bitmatrix_free(&T);
+	bitmatrix_free(&I);
+	bitmatrix_free(&N);
+	bitmatrix_free(&S);
+
+	if (!res)
+		DEBUG("Self-check succeeded: packed products, inverse, null space and linear systems are all right");
+	return res;
+}
@@ -0,0 +1,535 @@
+/*============================================================================*
+ *                                                                            *
+ *                                 bitmatrix.h                                *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file bitmatrix.h
+  * @brief Packed GF(2) matrices: storage, products, transposition and Gauss elimination
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #4
+  * @date 19/10/2026
+  * */
+
+
+
+#ifndef _BITMATRIX_H_
+#define _BITMATRIX_H_
+
+#include <stddef.h>
+
+#include "utils.h"
+
+
+// Packed matrices are stored row by row, 64 columns per word, MSB first (as every packed data in the tool):
+// column c of a row is bit #(63 - c%64) of its word #(c/64). Rows are padded with zeroes up to a whole number
+// of 256-bit vectors, and start on 32-byte boundaries, so that row operations never deal with partial vectors.
+
+//! Storage unit of packed matrices and vectors
+typedef unsigned long long bitword;
+
+//! Number of bits per storage word
+#define BITMATRIX_WORD_BITS 64
+
+//! Row length granularity (in words): rows are made of whole 256-bit vectors
+#define BITMATRIX_ROW_ALIGNMENT 4
+
+//! Number of words needed to store \a bits bits
+#define BITMATRIX_WORDS(bits) (((bits)+BITMATRIX_WORD_BITS-1)/BITMATRIX_WORD_BITS)
+
+//! Number of words of a matrix row of \a cols columns (including padding)
+#define BITMATRIX_STRIDE(cols) ((BITMATRIX_WORDS(cols)+BITMATRIX_ROW_ALIGNMENT-1)/BITMATRIX_ROW_ALIGNMENT*BITMATRIX_ROW_ALIGNMENT)
+
+//! Mask of bit #\a i inside its word
+#define BITMATRIX_MASK(i) (1ULL << (BITMATRIX_WORD_BITS-1-((i)%BITMATRIX_WORD_BITS)))
+
+//! Greatest width of the blocks of the table-driven kernels (see bitmatrixTuning)
+#define BITMATRIX_MAX_BLOCK_BITS 8
+
+
+//! Gets the \a i-th bit of the packed vector \a v
+#define BITVECTOR_GET(v, i)                                                                   \
+		(((v)[(i)/BITMATRIX_WORD_BITS] >> (BITMATRIX_WORD_BITS-1-((i)%BITMATRIX_WORD_BITS))) & 1)
+//! Sets the \a i-th bit of the packed vector \a v to the value \a bit
+#define BITVECTOR_SET(v, i, bit)                                                              \
+        do {                                                                                  \
+            unsigned int __i__ = (i);                                                         \
+            (v)[__i__/BITMATRIX_WORD_BITS] &= ~BITMATRIX_MASK(__i__);                         \
+            if ((bit)&1)                                                                      \
+                (v)[__i__/BITMATRIX_WORD_BITS] |= BITMATRIX_MASK(__i__);                      \
+        } while (0)
+//! Flips the \a i-th bit of the packed vector \a v
+#define BITVECTOR_FLIP(v, i)                                                                  \
+		((v)[(i)/BITMATRIX_WORD_BITS] ^= BITMATRIX_MASK(i))
+
+
+//! Points to row \a r of the packed matrix \a M
+#define BITMATRIX_ROW(M, r)            ((M)->data + (size_t)(r)*(M)->stride)
+//! Gets the coefficient (\a r, \a c) of the packed matrix \a M
+#define BITMATRIX_GET(M, r, c)         BITVECTOR_GET(BITMATRIX_ROW(M, r), c)
+//! Sets the coefficient (\a r, \a c) of the packed matrix \a M to the value \a bit
+#define BITMATRIX_SET(M, r, c, bit)    BITVECTOR_SET(BITMATRIX_ROW(M, r), c, bit)
+//! Flips the coefficient (\a r, \a c) of the packed matrix \a M
+#define BITMATRIX_FLIP(M, r, c)        BITVECTOR_FLIP(BITMATRIX_ROW(M, r), c)
+
+
+
+
+/**
+ * \struct bitmatrix
+ * \brief Packed GF(2) matrix (see the storage layout above)
+ */
+typedef struct {
+	unsigned int rows;   //!< Number of rows
+	unsigned int cols;   //!< Number of columns
+	unsigned int stride; //!< Number of words per row, padding included
+	bitword* data;       //!< Coefficients, row after row
+	void* block;         //!< Allocated memory block (NULL for views on another matrix)
+} bitmatrix;
+
+
+
+
+/**
+ * \struct bitmatrixTuning
+ * \brief Block widths of the table-driven kernels, each one a power of two up to BITMATRIX_MAX_BLOCK_BITS
+ *
+ * The results don't depend on them, only the speed: wider blocks mean fewer passes over the rows,
+ * but larger tables to build and to keep in cache.
+ */
+typedef struct {
+	unsigned int echelonBits;  //!< Number of columns eliminated together by bitmatrix_echelon()
+	unsigned int multiplyBits; //!< Number of rows of B combined in each table of bitmatrix_multiply()
+} bitmatrixTuning;
+
+
+
+
+//! Outcomes of bitmatrix_solve()
+typedef enum {
+	BITMATRIX_SOLVED,          //!< The system has exactly one solution
+	BITMATRIX_UNDERDETERMINED, //!< The unknowns are not all determined by the system
+	BITMATRIX_INCONSISTENT     //!< The system has no solution
+} BitmatrixSolveStatus;
+
+
+
+
+/**
+ * \fn int bitmatrix_alloc(bitmatrix* M, unsigned int rows, unsigned int cols)
+ * \brief Allocates a zero matrix
+ *
+ * \param[out] M Matrix to allocate
+ * \param[in]  rows Number of rows
+ * \param[in]  cols Number of columns
+ * \return 0 if the allocation is successful, non-zero otherwise
+ */
+int bitmatrix_alloc(bitmatrix* M, unsigned int rows, unsigned int cols);
+
+
+
+
+/**
+ * \fn void bitmatrix_free(bitmatrix* M)
+ * \brief Frees a matrix allocated by bitmatrix_alloc() (does nothing on views)
+ *
+ * \param[in, out] M Matrix to free
+ */
+void bitmatrix_free(bitmatrix* M);
+
+
+
+
+/**
+ * \fn void bitmatrix_view(const bitmatrix* M, unsigned int firstRow, unsigned int rows, bitmatrix* view)
+ * \brief Gives access to a range of rows of a matrix as a matrix on its own (no copy is made)
+ *
+ * \param[in]  M Viewed matrix
+ * \param[in]  firstRow First row of the view
+ * \param[in]  rows Number of rows of the view
+ * \param[out] view Resulting view, valid as long as \a M is
+ */
+void bitmatrix_view(const bitmatrix* M, unsigned int firstRow, unsigned int rows, bitmatrix* view);
+
+
+
+
+/**
+ * \fn void bitmatrix_zero(bitmatrix* M)
+ * \brief Sets all coefficients of a matrix to 0
+ *
+ * \param[out] M Matrix to clear
+ */
+void bitmatrix_zero(bitmatrix* M);
+
+
+
+
+/**
+ * \fn void bitmatrix_identity(bitmatrix* M)
+ * \brief Sets a matrix to the identity (ones on the diagonal, even for non-square matrices)
+ *
+ * \param[out] M Matrix to set
+ */
+void bitmatrix_identity(bitmatrix* M);
+
+
+
+
+/**
+ * \fn void bitmatrix_copy(bitmatrix* dest, const bitmatrix* src)
+ * \brief Copies a matrix into another one of the same size
+ *
+ * \param[out] dest Destination matrix
+ * \param[in]  src Source matrix
+ */
+void bitmatrix_copy(bitmatrix* dest, const bitmatrix* src);
+
+
+
+
+/**
+ * \fn void bitmatrix_fromBits(bitmatrix* M, const byte bits[])
+ * \brief Fills a matrix from a sparse-byte matrix (1 bit per byte, row after row)
+ *
+ * \param[out] M Matrix to fill
+ * \param[in]  bits M->rows × M->cols coefficients
+ */
+void bitmatrix_fromBits(bitmatrix* M, const byte bits[]);
+
+
+
+
+/**
+ * \fn void bitmatrix_toBits(const bitmatrix* M, byte bits[])
+ * \brief Exports a matrix as a sparse-byte matrix (1 bit per byte, row after row)
+ *
+ * \param[in]  M Matrix to export
+ * \param[out] bits M->rows × M->cols coefficients
+ */
+void bitmatrix_toBits(const bitmatrix* M, byte bits[]);
+
+
+
+
+/**
+ * \fn void bitmatrix_fromBytes(bitmatrix* M, const byte bytes[])
+ * \brief Fills a matrix from a full-byte matrix (8 bits per byte, MSB first, every row starting on a new byte)
+ *
+ * \param[out] M Matrix to fill
+ * \param[in]  bytes M->rows × ((M->cols+7)/8) bytes
+ */
+void bitmatrix_fromBytes(bitmatrix* M, const byte bytes[]);
+
+
+
+
+/**
+ * \fn void bitmatrix_toBytes(const bitmatrix* M, byte bytes[])
+ * \brief Exports a matrix as a full-byte matrix (8 bits per byte, MSB first, every row starting on a new byte)
+ *
+ * \param[in]  M Matrix to export
+ * \param[out] bytes M->rows × ((M->cols+7)/8) bytes
+ */
+void bitmatrix_toBytes(const bitmatrix* M, byte bytes[]);
+
+
+
+
+/**
+ * \fn void bitmatrix_packVector(const byte bits[], bitword v[], unsigned int len)
+ * \brief Translates a sparse-byte vector (1 bit per byte) into a packed one
+ *
+ * \param[in]  bits Sparse-byte vector
+ * \param[out] v Packed vector, BITMATRIX_WORDS(len) words
+ * \param[in]  len Length of the vector
+ */
+void bitmatrix_packVector(const byte bits[], bitword v[], unsigned int len);
+
+
+
+
+/**
+ * \fn void bitmatrix_unpackVector(const bitword v[], byte bits[], unsigned int len)
+ * \brief Translates a packed vector into a sparse-byte one (1 bit per byte)
+ *
+ * \param[in]  v Packed vector
+ * \param[out] bits Sparse-byte vector
+ * \param[in]  len Length of the vector
+ */
+void bitmatrix_unpackVector(const bitword v[], byte bits[], unsigned int len);
+
+
+
+
+/**
+ * \fn void bitmatrix_xorWords(bitword dest[], const bitword src[], unsigned int words)
+ * \brief Adds (XOR) a packed vector to another one, using the widest vector instructions available
+ *
+ * \param[in, out] dest Vector to add to
+ * \param[in]      src Vector to add
+ * \param[in]      words Length of the vectors, in words
+ */
+void bitmatrix_xorWords(bitword dest[], const bitword src[], unsigned int words);
+
+
+
+
+/**
+ * \fn void bitmatrix_swapRows(bitmatrix* M, unsigned int r1, unsigned int r2)
+ * \brief Swaps two rows of a matrix
+ *
+ * \param[in, out] M Matrix to process
+ * \param[in]      r1 First row
+ * \param[in]      r2 Second row
+ */
+void bitmatrix_swapRows(bitmatrix* M, unsigned int r1, unsigned int r2);
+
+
+
+
+/**
+ * \fn void bitmatrix_swapColumns(bitmatrix* M, unsigned int c1, unsigned int c2)
+ * \brief Swaps two columns of a matrix
+ *
+ * \param[in, out] M Matrix to process
+ * \param[in]      c1 First column
+ * \param[in]      c2 Second column
+ */
+void bitmatrix_swapColumns(bitmatrix* M, unsigned int c1, unsigned int c2);
+
+
+
+
+/**
+ * \fn int bitmatrix_setTuning(const bitmatrixTuning* tuning)
+ * \brief Sets the block widths of the table-driven kernels (to be called before any thread uses them)
+ *
+ * \param[in] tuning Block widths, NULL for the default ones (8 and 8)
+ * \return 0 if the widths are valid, non-zero otherwise (the current ones are then kept)
+ */
+int bitmatrix_setTuning(const bitmatrixTuning* tuning);
+
+
+
+
+/**
+ * \fn void bitmatrix_getTuning(bitmatrixTuning* tuning)
+ * \brief Gives the block widths of the table-driven kernels
+ *
+ * \param[out] tuning Block widths in use
+ */
+void bitmatrix_getTuning(bitmatrixTuning* tuning);
+
+
+
+
+/**
+ * \fn const char* bitmatrix_kernel()
+ * \brief Gives the instruction set of the row operations, chosen when the tool is built
+ *
+ * \return "avx2", "sse2" or "none"
+ */
+const char* bitmatrix_kernel();
+
+
+
+
+/**
+ * \fn void bitmatrix_random(bitmatrix* M)
+ * \brief Fills a matrix with random coefficients (for test and benchmark purpose)
+ *
+ * \param[out] M Matrix to fill
+ */
+void bitmatrix_random(bitmatrix* M);
+
+
+
+
+/**
+ * \fn void bitmatrix_multiply(const bitmatrix* A, const bitmatrix* B, bitmatrix* C)
+ * \brief Processes the matrix product C = A × B (method of the Four Russians, bitmatrixTuning::multiplyBits rows of B at a time)
+ *
+ * \param[in]  A Left operand (A->cols must equal B->rows)
+ * \param[in]  B Right operand
+ * \param[out] C Product, A->rows × B->cols (must not overlap the operands)
+ */
+void bitmatrix_multiply(const bitmatrix* A, const bitmatrix* B, bitmatrix* C);
+
+
+
+
+/**
+ * \fn void bitmatrix_multiplyVector(const bitmatrix* M, const bitword v[], bitword out[])
+ * \brief Processes the matrix vector product out = M × v
+ *
+ * \param[in]  M Matrix
+ * \param[in]  v Packed vector of M->cols bits
+ * \param[out] out Packed vector of M->rows bits
+ */
+void bitmatrix_multiplyVector(const bitmatrix* M, const bitword v[], bitword out[]);
+
+
+
+
+/**
+ * \fn void bitmatrix_vectorMultiply(const bitword v[], const bitmatrix* M, bitword out[])
+ * \brief Processes the vector matrix product out = v × M
+ *
+ * \param[in]  v Packed vector of M->rows bits
+ * \param[in]  M Matrix
+ * \param[out] out Packed vector of M->cols bits
+ */
+void bitmatrix_vectorMultiply(const bitword v[], const bitmatrix* M, bitword out[]);
+
+
+
+
+/**
+ * \fn void bitmatrix_transpose64(bitword block[BITMATRIX_WORD_BITS])
+ * \brief Transposes in place a 64×64 bit block, given as 64 rows of one word each
+ *
+ * The off-diagonal halves are exchanged recursively (6 rounds of masked shifts), several rows at a time
+ * when SSE2 or AVX2 is available.
+ *
+ * \param[in, out] block Block to transpose
+ */
+void bitmatrix_transpose64(bitword block[BITMATRIX_WORD_BITS]);
+
+
+
+
+/**
+ * \fn void bitmatrix_transpose(const bitmatrix* M, bitmatrix* T)
+ * \brief Transposes a matrix, 64×64 block by 64×64 block
+ *
+ * Code needing column access to a matrix should read the rows of its transpose.
+ *
+ * \param[in]  M Matrix to transpose
+ * \param[out] T Transposed matrix, M->cols × M->rows (must not overlap \a M)
+ */
+void bitmatrix_transpose(const bitmatrix* M, bitmatrix* T);
+
+
+
+
+/**
+ * \fn unsigned int bitmatrix_echelon(bitmatrix* M, unsigned int cols, int reduced, unsigned int pivots[])
+ * \brief Brings a matrix to row echelon form by Gauss elimination, pivoting on its first columns only
+ *
+ * Row #i of the result has its leading coefficient in column pivots[i], for every i lower than the rank.
+ * The remaining columns (from \a cols on) simply undergo the same row operations, which allows to process
+ * augmented matrices.
+ *
+ * \param[in, out] M Matrix to process
+ * \param[in]      cols Number of columns eligible for pivoting (M->cols for a plain matrix)
+ * \param[in]      reduced When non-zero, the pivots are also eliminated from the rows above (reduced echelon form)
+ * \param[out]     pivots Pivot column of every non-zero row (may be NULL)
+ * \return Rank of the first \a cols columns
+ */
+unsigned int bitmatrix_echelon(bitmatrix* M, unsigned int cols, int reduced, unsigned int pivots[]);
+
+
+
+
+/**
+ * \fn unsigned int bitmatrix_rank(const bitmatrix* M)
+ * \brief Processes the rank of a matrix
+ *
+ * \param[in] M Matrix
+ * \return Rank of the matrix
+ */
+unsigned int bitmatrix_rank(const bitmatrix* M);
+
+
+
+
+/**
+ * \fn int bitmatrix_inverse(const bitmatrix* M, bitmatrix* I)
+ * \brief Inverts a square matrix (Gauss-Jordan elimination)
+ *
+ * \param[in]  M Matrix to invert
+ * \param[out] I Inverse of \a M, same size
+ * \return 0 if the matrix is invertible, non-zero otherwise
+ */
+int bitmatrix_inverse(const bitmatrix* M, bitmatrix* I);
+
+
+
+
+/**
+ * \fn unsigned int bitmatrix_nullspace(const bitmatrix* M, bitmatrix* N)
+ * \brief Processes a basis of the null space of a matrix: the vectors x such that M × x = 0
+ *
+ * \param[in]  M Matrix
+ * \param[out] N Basis, one vector per row (allocated by the function: free it with bitmatrix_free())
+ * \return Dimension of the null space, or (unsigned int)-1 if \a N couldn't be allocated
+ */
+unsigned int bitmatrix_nullspace(const bitmatrix* M, bitmatrix* N);
+
+
+
+
+/**
+ * \fn void bitmatrix_backSubstitute(const bitmatrix* M, unsigned int unknowns, unsigned int rhs, bitword solution[])
+ * \brief Solves a triangular system: the rows of the first unknowns have their pivot on the diagonal (see bitmatrix_echelon())
+ *
+ * Several systems sharing the same unknowns can be brought to echelon form together, one right-hand side per column.
+ *
+ * \param[in]  M System in row echelon form, with a full rank on its first \a unknowns columns
+ * \param[in]  unknowns Number of unknowns
+ * \param[in]  rhs Column holding the right-hand side
+ * \param[out] solution Packed vector of the unknowns
+ */
+void bitmatrix_backSubstitute(const bitmatrix* M, unsigned int unknowns, unsigned int rhs, bitword solution[]);
+
+
+
+
+/**
+ * \fn BitmatrixSolveStatus bitmatrix_solve(bitmatrix* system, bitword solution[])
+ * \brief Solves a linear system given as an augmented matrix: the last column holds the right-hand side
+ *
+ * \param[in, out] system Linear system of system->cols-1 unknowns, left in row echelon form
+ * \param[out]     solution Packed vector of the system->cols-1 unknowns (meaningful if the system is solved)
+ * \return BITMATRIX_SOLVED if the system has exactly one solution
+ */
+BitmatrixSolveStatus bitmatrix_solve(bitmatrix* system, bitword solution[]);
+
+
+
+
+/**
+ * \fn int bitmatrix_test()
+ * \brief Autotests the packed matrix operations against their definitions on random matrices
+ *
+ * \return 0 if the test is successfull, non-zero otherwise
+ */
+int bitmatrix_test();
+
+
+
+
+#endif
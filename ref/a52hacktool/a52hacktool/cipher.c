@@ -0,0 +1,298 @@
+/*============================================================================*
+ *                                                                            *
+ *                                   cipher.c                                 *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file cipher.c
+  * @brief Implementation of frame-keyed stream ciphering (the cipher is re-keyed for every TDMA frame)
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #5
+  * @date 19/10/2026
+  * */
+
+
+
+// fileno() is a POSIX extension of the C99 library
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "utils.h"
+
+#include "cipher.h"
+#include "keygen.h"
+#include "pipeline.h"
+
+//! Error code of the pipeline processing: the batch does not contain a whole number of blocks
+#define CIPHER_PARTIAL_BLOCK 1
+
+
+
+
+/**
+ * \fn void cipher_xorBits(byte dest[], unsigned int offset, const byte src[], unsigned int len)
+ * \brief XORs \a len bits of \a src (8 bits per byte) into \a dest, starting at bit #offset of \a dest
+ *
+ * \param[in, out] dest Destination bit array (8 bits per byte)
+ * \param[in]      offset Location of the first bit to process inside \a dest
+ * \param[in]      src Source bit array (8 bits per byte), with null padding bits
+ * \param[in]      len Number of bits to process
+ */
+void cipher_xorBits(byte dest[], unsigned int offset, const byte src[], unsigned int len) {
+
+	unsigned int shift = offset % 8;
+	byte* d = dest + offset/8;
+
+	if (!shift) {
+		XOR_CHARARRAYS(d, src, (len+7)/8);
+		return;
+	}
+
+	unsigned int destBytes = (shift+len+7)/8;
+	for (unsigned int k=0 ; k<(len+7)/8 ; ++k) {
+		d[k] ^= src[k] >> shift;
+		if (k+1 < destBytes)
+			d[k+1] ^= (byte)(src[k] << (8-shift));
+	}
+}
+
+
+
+
+// Documentation in header file
+int cipher_initStream(cipherStreamArgs* args, const byte Kc[SECRETKEY_BITS], const byte frameId[FRAMEID_BITS], \
+                      CipherFraming framing, CipherLink link) {
+
+	memset(args, 0, sizeof(cipherStreamArgs));
+
+	if (keygen_countToFrameNumber(keygen_frameIdToCount(frameId), &args->firstFrame))
+		return 1;
+
+	keygen_prepareFrameSchedule(Kc, &args->schedule);
+	args->framing = framing;
+	args->link    = link;
+	return 0;
+}
+
+
+
+
+// Documentation in header file
+void cipherBlocks(const cipherStreamArgs* args, unsigned long long firstBlock, byte data[], unsigned int blocks) {
+
+	// Frames are generated KEYGEN_SLICED_FRAMES at a time, i.e. one block per frame or one burst per frame
+	const unsigned int bursts = (args->framing == CIPHER_PER_BURST) ? CODEWORD_LENGTH/BURST_KEYSTREAM_BITS : 1;
+	const unsigned int frameBits = CODEWORD_LENGTH / bursts;
+	const unsigned int frameBytes = (frameBits+7)/8;
+	const unsigned int groupBlocks = KEYGEN_SLICED_FRAMES / bursts;
+
+	// The downlink burst keystream comes first and is discarded when ciphering the uplink
+	const int skip = (args->framing == CIPHER_PER_BURST && args->link == CIPHER_UPLINK) ? BURST_KEYSTREAM_BITS : 0;
+
+	unsigned int counts[KEYGEN_SLICED_FRAMES];
+	byte keystream[KEYGEN_SLICED_FRAMES*CIPHER_BLOCK_BYTES];
+
+	for (unsigned int b=0 ; b<blocks ; b+=groupBlocks) {
+
+		unsigned int groupSize = (blocks-b < groupBlocks) ? blocks-b : groupBlocks;
+		unsigned long long frame = args->firstFrame + (firstBlock+b)*bursts;
+		for (unsigned int f=0 ; f<groupSize*bursts ; ++f)
+			counts[f] = keygen_frameNumberToCount((frame + f) % HYPERFRAME_LENGTH);
+
+		keygen_slicedKeystream(&args->schedule, counts, groupSize*bursts, skip, keystream, frameBits);
+
+		for (unsigned int f=0 ; f<groupSize*bursts ; ++f) {
+			byte* block = data + (b + f/bursts)*CIPHER_BLOCK_BYTES;
+			cipher_xorBits(block, (f%bursts)*frameBits, keystream + f*frameBytes, frameBits);
+		}
+	}
+}
+
+
+
+
+/**
+ * \fn int cipher_processBatch(void* context, void* scratch, unsigned long long offset, const byte input[], size_t length, byte output[], size_t* produced)
+ * \brief Pipeline processing: ciphers a batch of blocks, located by its offset in the stream
+ *
+ * \param[in]  context Stream parameters
+ * \param[in]  scratch Unused
+ * \param[in]  offset Position of the batch in the stream, in bytes
+ * \param[in]  input Blocks to process
+ * \param[in]  length Length of the batch, in bytes
+ * \param[out] output Processed blocks
+ * \param[out] produced Number of bytes produced (the whole blocks before an incomplete one are still processed)
+ * \return 0 on success, CIPHER_PARTIAL_BLOCK if the batch ends with an incomplete block
+ */
+static int cipher_processBatch(void* context, void* scratch, unsigned long long offset,
+                               const byte input[], size_t length, byte output[], size_t* produced) {
+
+	// The blocks are ciphered in place, so that the source (possibly mapped read-only) is left untouched
+	size_t blocks = length / CIPHER_BLOCK_BYTES;
+	memcpy(output, input, blocks*CIPHER_BLOCK_BYTES);
+	cipherBlocks(context, offset/CIPHER_BLOCK_BYTES, output, blocks);
+	*produced = blocks*CIPHER_BLOCK_BYTES;
+	return (length % CIPHER_BLOCK_BYTES) ? CIPHER_PARTIAL_BLOCK : 0;
+}
+
+
+
+
+// Documentation in header file
+int cipherStream(const cipherStreamArgs* args, fileio* source, fileio* dest, int threads) {
+
+	pipelineCodec codec = {"Applying cipher", CIPHER_BATCH_BLOCKS*CIPHER_BLOCK_BYTES, CIPHER_BATCH_BLOCKS*CIPHER_BLOCK_BYTES,
+	                       0, (void*)args, cipher_processBatch};
+
+	int res = pipeline_run(&codec, source, dest, threads);
+	if (res == CIPHER_PARTIAL_BLOCK) {
+		CLEARLINE; printf("Error: The file size isn't a multiple of 456bits: Unable to process             \n");
+	} else if (res) {
+		CLEARLINE; printf("Error: Unable to read or write the processed data                               \n");
+	}
+	return res != 0;
+}
+
+
+
+
+//! Number of blocks ciphered against the reference keystream by the autotest
+#define CIPHER_TEST_BLOCKS 4
+
+//! Number of blocks of the autotest stream (every thread gets a batch, the last one is incomplete)
+#define CIPHER_TEST_STREAM_BLOCKS (PROCESSING_THREADS*CIPHER_BATCH_BLOCKS + 3)
+
+
+// Documentation in header file
+int cipher_test() {
+
+	byte Kc[SECRETKEY_BITS];
+	byte frameId[FRAMEID_BITS];
+	for (int k=0 ; k<SECRETKEY_BITS ; ++k)
+		Kc[k] = rand() & 1;
+
+	// Start a few frames before the end of the hyperframe, to check the wrap around
+	unsigned int firstFrame = HYPERFRAME_LENGTH - 5;
+	unsigned int count = keygen_frameNumberToCount(firstFrame);
+	for (int k=0 ; k<FRAMEID_BITS ; ++k)
+		frameId[k] = (count >> k) & 1;
+
+	byte plain[CIPHER_TEST_BLOCKS*CIPHER_BLOCK_BYTES];
+	byte ciphered[CIPHER_TEST_BLOCKS*CIPHER_BLOCK_BYTES];
+	for (int k=0 ; k<CIPHER_TEST_BLOCKS*CIPHER_BLOCK_BYTES ; ++k)
+		plain[k] = rand() & 0xFF;
+
+	cipherStreamArgs args;
+	byte keystream[CODEWORD_LENGTH];
+
+	// Every block (resp. burst) must be ciphered with the keystream of a dedicated frame, processed the reference way
+	for (int mode=0 ; mode<3 ; ++mode) {
+
+		CipherFraming framing = (mode==0) ? CIPHER_PER_BLOCK : CIPHER_PER_BURST;
+		CipherLink    link    = (mode==2) ? CIPHER_UPLINK    : CIPHER_DOWNLINK;
+
+		if (cipher_initStream(&args, Kc, frameId, framing, link)) {
+			DEBUG("Self-check aborted: a valid frame Id has been rejected");
+			return 1;
+		}
+		memcpy(ciphered, plain, CIPHER_TEST_BLOCKS*CIPHER_BLOCK_BYTES);
+		cipherBlocks(&args, 0, ciphered, CIPHER_TEST_BLOCKS);
+
+		for (unsigned int i=0 ; i<CIPHER_TEST_BLOCKS*CODEWORD_LENGTH ; ++i) {
+			unsigned int frame = (framing==CIPHER_PER_BLOCK) ? firstFrame + i/CODEWORD_LENGTH : firstFrame + i/BURST_KEYSTREAM_BITS;
+			unsigned int bit   = (framing==CIPHER_PER_BLOCK) ? i%CODEWORD_LENGTH : i%BURST_KEYSTREAM_BITS + link*BURST_KEYSTREAM_BITS;
+			byte frameBits[FRAMEID_BITS];
+			unsigned int frameCount = keygen_frameNumberToCount(frame % HYPERFRAME_LENGTH);
+			for (int k=0 ; k<FRAMEID_BITS ; ++k)
+				frameBits[k] = (frameCount >> k) & 1;
+			keysetup(Kc, frameBits);
+			getKeystream(keystream, bit+1);
+			if ((GET_CHARARRAY_BIT(plain, i) ^ keystream[bit]) != GET_CHARARRAY_BIT(ciphered, i)) {
+				DEBUG("Self-check aborted: bit #%u is not ciphered with the keystream of frame #%u (mode %d)", i, frame, mode);
+				return 1;
+			}
+		}
+	}
+
+	// The multithreaded stream processing must match the sequential one, and deciphering must restore the data
+	byte* stream    = malloc(CIPHER_TEST_STREAM_BLOCKS*CIPHER_BLOCK_BYTES);
+	byte* reference = malloc(CIPHER_TEST_STREAM_BLOCKS*CIPHER_BLOCK_BYTES);
+	FILE* sourcefile = tmpfile();
+	FILE* destfile   = tmpfile();
+	byte* processed  = NULL;
+	int res = 1;
+	if (!stream || !reference || !sourcefile || !destfile) {
+		DEBUG("Self-check aborted: unable to allocate test resources");
+	} else {
+		for (int k=0 ; k<CIPHER_TEST_STREAM_BLOCKS*CIPHER_BLOCK_BYTES ; ++k)
+			stream[k] = rand() & 0xFF;
+		memcpy(reference, stream, CIPHER_TEST_STREAM_BLOCKS*CIPHER_BLOCK_BYTES);
+		cipherBlocks(&args, 0, reference, CIPHER_TEST_STREAM_BLOCKS);
+
+		fwrite(stream, sizeof(byte), CIPHER_TEST_STREAM_BLOCKS*CIPHER_BLOCK_BYTES, sourcefile);
+		fflush(sourcefile);
+		rewind(sourcefile);
+		fileio source, dest;
+		res = fileio_attach(&source, fileno(sourcefile), 0);
+		if (!res) {
+			res = fileio_attach(&dest, fileno(destfile), 1);
+			if (!res) {
+				res |= cipherStream(&args, &source, &dest, PROCESSING_THREADS);
+				res |= fileio_close(&dest);
+			}
+			res |= fileio_close(&source);
+		}
+		printf("\n");
+		rewind(destfile);
+		processed = malloc(CIPHER_TEST_STREAM_BLOCKS*CIPHER_BLOCK_BYTES);
+		if (res || !processed
+		 || fread(processed, sizeof(byte), CIPHER_TEST_STREAM_BLOCKS*CIPHER_BLOCK_BYTES, destfile) != CIPHER_TEST_STREAM_BLOCKS*CIPHER_BLOCK_BYTES
+		 || memcmp(processed, reference, CIPHER_TEST_STREAM_BLOCKS*CIPHER_BLOCK_BYTES)) {
+			DEBUG("Self-check aborted: the multithreaded stream differs from the sequential one");
+			res = 1;
+		} else {
+			cipherBlocks(&args, 0, processed, CIPHER_TEST_STREAM_BLOCKS);
+			if (memcmp(processed, stream, CIPHER_TEST_STREAM_BLOCKS*CIPHER_BLOCK_BYTES)) {
+				DEBUG("Self-check aborted: deciphering did not restore the original stream");
+				res = 1;
+			}
+		}
+	}
+
+	free(processed);
+	free(reference);
+	free(stream);
+	if (destfile)
+		fclose(destfile);
+	if (sourcefile)
+		fclose(sourcefile);
+
+	if (!res)
+		DEBUG("Self-check succeeded: every frame is ciphered with its own keystream");
+	return res;
+}
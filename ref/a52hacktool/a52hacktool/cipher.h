@@ -0,0 +1,150 @@
+/*============================================================================*
+ *                                                                            *
+ *                                   cipher.h                                 *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file cipher.h
+  * @brief Specification of frame-keyed stream ciphering (the cipher is re-keyed for every TDMA frame)
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #3
+  * @date 19/10/2026
+  * */
+
+
+
+#ifndef _CIPHER_H_
+#define _CIPHER_H_
+
+#include "utils.h"
+#include "const_A52.h"
+#include "const_code.h"
+#include "keygen.h"
+#include "fileio.h"
+
+
+//! Size of a ciphered block (in bytes): one 456-bit codeword, or four 114-bit bursts
+#define CIPHER_BLOCK_BYTES   (CODEWORD_LENGTH/8)
+
+//! Number of blocks per batch of the ciphering pipeline
+#define CIPHER_BATCH_BLOCKS 2048
+
+
+
+
+/**
+ * \enum CipherFraming
+ * \brief Rule used to advance the TDMA frame number along a ciphered stream
+ */
+typedef enum {
+	CIPHER_PER_BLOCK, //!< One frame per 456-bit block, ciphered with the first 456 keystream bits of that frame
+	CIPHER_PER_BURST  //!< One frame per 114-bit burst, ciphered with the downlink or uplink burst keystream
+} CipherFraming;
+
+
+/**
+ * \enum CipherLink
+ * \brief Half of the frame keystream used when ciphering bursts
+ */
+typedef enum {
+	CIPHER_DOWNLINK, //!< First 114 keystream bits of the frame (network to mobile)
+	CIPHER_UPLINK    //!< Next 114 keystream bits of the frame (mobile to network)
+} CipherLink;
+
+
+
+
+/**
+ * \struct cipherStreamArgs
+ * \brief Set of parameters describing a frame-keyed ciphered stream
+ */
+typedef struct {
+	keygen_frameSchedule schedule; //!< Frame-independent part of the keysetup
+	CipherFraming framing;         //!< Frame advance rule
+	CipherLink link;               //!< Burst keystream used (CIPHER_PER_BURST framing only)
+	unsigned int firstFrame;       //!< TDMA frame number of the first block of the stream
+} cipherStreamArgs;
+
+
+
+
+/**
+ * \fn int cipher_initStream(cipherStreamArgs* args, const byte Kc[SECRETKEY_BITS], const byte frameId[FRAMEID_BITS], CipherFraming framing, CipherLink link)
+ * \brief Prepares the ciphering of a stream starting at a given frame
+ *
+ * \param[out] args Stream parameters to initialize
+ * \param[in]  Kc Secret Key
+ * \param[in]  frameId Frame Id (COUNT) of the first frame of the stream
+ * \param[in]  framing Frame advance rule
+ * \param[in]  link Burst keystream used (CIPHER_PER_BURST framing only)
+ * \return 0 if the initialization is successful, non-zero if the frame Id is not a valid COUNT value
+ */
+int cipher_initStream(cipherStreamArgs* args, const byte Kc[SECRETKEY_BITS], const byte frameId[FRAMEID_BITS], \
+                      CipherFraming framing, CipherLink link);
+
+
+
+
+/**
+ * \fn void cipherBlocks(const cipherStreamArgs* args, unsigned long long firstBlock, byte data[], unsigned int blocks)
+ * \brief Ciphers (or deciphers) in place a set of consecutive blocks of a stream
+ *
+ * \param[in]      args Stream parameters
+ * \param[in]      firstBlock Index of the first block inside the stream
+ * \param[in, out] data Blocks to process (CIPHER_BLOCK_BYTES bytes each, 8 bits per byte)
+ * \param[in]      blocks Number of blocks to process
+ */
+void cipherBlocks(const cipherStreamArgs* args, unsigned long long firstBlock, byte data[], unsigned int blocks);
+
+
+
+
+/**
+ * \fn int cipherStream(const cipherStreamArgs* args, fileio* source, fileio* dest, int threads)
+ * \brief Ciphers (or deciphers) a whole file, dispatching batches of blocks amongst a pool of workers
+ *
+ * \param[in]      args Stream parameters
+ * \param[in, out] source File to read data from
+ * \param[in, out] dest File to write the processed data to (in the original order)
+ * \param[in]      threads Number of workers
+ * \return 0 if the whole file has been processed, non-zero otherwise (the error is displayed)
+ */
+int cipherStream(const cipherStreamArgs* args, fileio* source, fileio* dest, int threads);
+
+
+
+
+/**
+ * \fn int cipher_test()
+ * \brief Autotests the frame-keyed ciphering against per-frame keysetups
+ *
+ * \return 0 if the test is successfull, non-zero otherwise
+ */
+int cipher_test();
+
+
+
+
+#endif
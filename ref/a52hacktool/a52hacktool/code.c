@@ -29,14 +29,15 @@
   * @brief Implementation of full coding & decoding process
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #17
-  * @date 01/12/2011
+  * @version File Revision #27
+  * @date 19/10/2026
   * */
 
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "utils.h"
 
@@ -49,77 +50,97 @@
 
 
 
-// Documentation in header file
-void processFullEncodingGMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH]) {
+//! Messages going through the burst interleaving engine at a time (their bursts stay in L1 cache)
+#define CODE_INTERLEAVING_CHUNK 64
+
+//! Shared G & H matrices, filled in once by code_buildMatrices()
+codeMatrices code_matrices;
+
+//! Ensures that the shared matrices are computed exactly once
+pthread_once_t code_matricesOnce = PTHREAD_ONCE_INIT;
 
-	memset(G, 0, FIRE_SOURCE_LENGTH*INTERLEAVING_LENGTH*sizeof(byte));
+//! Set when the shared matrices couldn't be allocated
+int code_matricesFailed = 0;
 
-	byte FireG[FIRE_SOURCE_LENGTH][FIRE_CODE_LENGTH];
-	processFireGMatrix(FireG);
 
-	byte ConvolutionG[CONVOLUTION_SOURCE_LENGTH][CONVOLUTION_CODE_LENGTH];
-	processConvolutionGMatrix(ConvolutionG);
 
-	byte InterleavingG[INTERLEAVING_LENGTH][INTERLEAVING_LENGTH];
-	processInterleavingGMatrix(InterleavingG);
 
-	byte FireConvolution[FIRE_SOURCE_LENGTH][CONVOLUTION_CODE_LENGTH];
-	memset(FireConvolution, 0, FIRE_SOURCE_LENGTH*CONVOLUTION_CODE_LENGTH*sizeof(byte));
+/**
+ * \fn void code_buildMatrices()
+ * \brief Computes the shared G & H matrices (called once through pthread_once)
+ */
+void code_buildMatrices() {
+	if (bitmatrix_alloc(&code_matrices.G, SOURCEWORD_LENGTH, CODEWORD_LENGTH)
+	 || bitmatrix_alloc(&code_matrices.H, SYNDROME_LENGTH, CODEWORD_LENGTH)) {
+		DEBUG("Error: unable to allocate the code matrices.");
+		bitmatrix_free(&code_matrices.G);
+		bitmatrix_free(&code_matrices.H);
+		code_matricesFailed = 1;
+		return;
+	}
+	processFullEncodingGMatrix(&code_matrices.G);
+	processFullEncodingHMatrix(&code_matrices.G, &code_matrices.H);
+}
+
 
-	for (int line=0 ; line<FIRE_SOURCE_LENGTH ; ++line)
-		for (int col=0 ; col<CONVOLUTION_CODE_LENGTH ; ++col)
-			for (int i=0 ; i<CONVOLUTION_SOURCE_LENGTH ; ++i)
-				if (i<FIRE_CODE_LENGTH)
-					FireConvolution[line][col] ^= ((FireG[line][i]) & (ConvolutionG[i][col]));
 
-	for (int line=0 ; line<FIRE_SOURCE_LENGTH ; ++line)
-		for (int col=0 ; col<INTERLEAVING_LENGTH ; ++col)
-			for (int i=0 ; i<INTERLEAVING_LENGTH ; ++i)
-				G[line][col] ^= ((FireConvolution[line][i]) & (InterleavingG[i][col]));
 
+// Documentation in header file
+const codeMatrices* code_getMatrices() {
+	pthread_once(&code_matricesOnce, code_buildMatrices);
+	return code_matricesFailed ? NULL : &code_matrices;
 }
 
 
 
 
 // Documentation in header file
-void processFullEncodingGSystematicMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH],  \
-										  byte L[FIRE_SOURCE_LENGTH][FIRE_SOURCE_LENGTH],   \
-										  byte P[INTERLEAVING_LENGTH][INTERLEAVING_LENGTH]) {
+void processFullEncodingGMatrix(bitmatrix* G) {
+
+	// The factors are built packed, straight on the heap (this may run on a small-stack thread)
+	bitmatrix fire, convolution, interleaving, fireConvolution, truncated;
+	bitmatrix_alloc(&fire,            FIRE_SOURCE_LENGTH,        FIRE_CODE_LENGTH);
+	bitmatrix_alloc(&convolution,     CONVOLUTION_SOURCE_LENGTH, CONVOLUTION_CODE_LENGTH);
+	bitmatrix_alloc(&interleaving,    INTERLEAVING_LENGTH,       INTERLEAVING_LENGTH);
+	bitmatrix_alloc(&fireConvolution, FIRE_SOURCE_LENGTH,        CONVOLUTION_CODE_LENGTH);
+
+	processFireGMatrix(&fire);
+	processConvolutionGMatrix(&convolution);
+	processInterleavingGMatrix(&interleaving);
+
+	// The last 4 rows of the convolution matrix are dropped: they stand for the additional zeroes
+	bitmatrix_view(&convolution, 0, FIRE_CODE_LENGTH, &truncated);
+	bitmatrix_multiply(&fire, &truncated, &fireConvolution);
+	bitmatrix_multiply(&fireConvolution, &interleaving, G);
+
+	bitmatrix_free(&fire);
+	bitmatrix_free(&convolution);
+	bitmatrix_free(&interleaving);
+	bitmatrix_free(&fireConvolution);
+}
+
 
-	byte headFactor = 0;
-	CHAR_IDENTITY(L, FIRE_SOURCE_LENGTH);
-	CHAR_IDENTITY(P, INTERLEAVING_LENGTH);
+
+
+// Documentation in header file
+void processFullEncodingGSystematicMatrix(bitmatrix* G, bitmatrix* L, bitmatrix* P) {
+
+	bitmatrix_identity(L);
+	bitmatrix_identity(P);
 
 	for (int line=0; line<FIRE_SOURCE_LENGTH; ++line) {
 		for (int col=line; col<INTERLEAVING_LENGTH; ++col) {
 
-			headFactor = G[line][col];
-			if (headFactor) {
+			if (BITMATRIX_GET(G, line, col)) {
 				if (line!=col) {
-					byte temp;
-					for (int l=0; l<FIRE_SOURCE_LENGTH; ++l) {
-						temp = G[l][line];
-						G[l][line]  = G[l][col];
-						G[l][col] = temp;
-					}
-
-					for (int l=0; l<INTERLEAVING_LENGTH; ++l) {
-						temp = P[l][line];
-						P[l][line]  = P[l][col];
-						P[l][col] = temp;
-					}
+					bitmatrix_swapColumns(G, line, col);
+					bitmatrix_swapColumns(P, line, col);
 				}
 
 				for (int l=line+1; l<FIRE_SOURCE_LENGTH; ++l) {
-					if (G[l][line]) {
-						for (int c=0; c<INTERLEAVING_LENGTH; ++c) {
-							G[l][c] ^= G[line][c];
-						}
-
-						for (int c=0; c<FIRE_SOURCE_LENGTH; ++c) {
-							L[l][c] ^= L[line][c];
-						}
+					if (BITMATRIX_GET(G, l, line)) {
+						bitmatrix_xorWords(BITMATRIX_ROW(G, l), BITMATRIX_ROW(G, line), G->stride);
+						bitmatrix_xorWords(BITMATRIX_ROW(L, l), BITMATRIX_ROW(L, line), L->stride);
 					}
 				}
 
@@ -129,138 +150,133 @@ void processFullEncodingGSystematicMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVIN
 		}
 	}
 
+	// Row #col is null before column #col at this point: whole rows can be added
 	for (int line=0; line<FIRE_SOURCE_LENGTH; ++line) {
 		for (int col=line+1; col<FIRE_SOURCE_LENGTH; ++col) {
-			if(G[line][col]){
-				for (int c=line+1; c<INTERLEAVING_LENGTH; ++c) {
-						G[line][c] ^= G[col][c];
-				}
-				for (int c=0; c<FIRE_SOURCE_LENGTH; ++c) {
-						L[line][c] ^= L[col][c];
-				}
+			if (BITMATRIX_GET(G, line, col)) {
+				bitmatrix_xorWords(BITMATRIX_ROW(G, line), BITMATRIX_ROW(G, col), G->stride);
+				bitmatrix_xorWords(BITMATRIX_ROW(L, line), BITMATRIX_ROW(L, col), L->stride);
 			}
 		}
 	}
 
-
 }
 
 
 
 
 // Documentation in header file
-void processFullEncodingHSystematicMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH],                       \
-										  byte H[INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH]) {
+void processFullEncodingHSystematicMatrix(const bitmatrix* G, bitmatrix* H) {
 
-	memset(H, 0, (INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH)*INTERLEAVING_LENGTH*sizeof(byte));
+	// G = [I | A] gives H = [A^T | I]: the rows of A^T are the last rows of G^T
+	bitmatrix transposed;
+	bitmatrix_alloc(&transposed, INTERLEAVING_LENGTH, FIRE_SOURCE_LENGTH);
+	bitmatrix_transpose(G, &transposed);
 
+	bitmatrix_zero(H);
 	for (int i=0 ; i<INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH ; ++i) {
-		for (int j=0; j<FIRE_SOURCE_LENGTH; ++j) {
-			H[i][j] = G[j][i+FIRE_SOURCE_LENGTH];
-		}
-		H[i][FIRE_SOURCE_LENGTH+i] = 1;
+		memcpy(BITMATRIX_ROW(H, i), BITMATRIX_ROW(&transposed, i+FIRE_SOURCE_LENGTH), BITMATRIX_WORDS(FIRE_SOURCE_LENGTH)*sizeof(bitword));
+		BITMATRIX_FLIP(H, i, FIRE_SOURCE_LENGTH+i);
 	}
+
+	bitmatrix_free(&transposed);
 }
 
 
 
 
 // Documentation in header file
-void processFullEncodingHMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH],                       \
-								byte H[INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH]) {
-
-	byte HP_I[INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH];
-	byte L[FIRE_SOURCE_LENGTH][FIRE_SOURCE_LENGTH];
-	byte P[INTERLEAVING_LENGTH][INTERLEAVING_LENGTH];
-	byte P_I[INTERLEAVING_LENGTH][INTERLEAVING_LENGTH];
-	byte temp_G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH];
-
-	memcpy(temp_G, G, FIRE_SOURCE_LENGTH*INTERLEAVING_LENGTH*sizeof(byte));
-
-	processFullEncodingGSystematicMatrix(temp_G, L, P);
-	processFullEncodingHSystematicMatrix(temp_G, H);
-	//Invert permutation matrix P into P_I
-	for (int line=0 ; line<INTERLEAVING_LENGTH; ++line) {
-		for (int col=0 ; col<INTERLEAVING_LENGTH; ++col) {
-				P_I[line][col] = P[col][line];
-			}
-	}
-	BINPRODUCT_MATRIX_MATRIX(H, P_I, HP_I, (INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH), INTERLEAVING_LENGTH, INTERLEAVING_LENGTH);
+void processFullEncodingHMatrix(const bitmatrix* G, bitmatrix* H) {
+
+	bitmatrix temp_G, L, P, P_I, HS;
+	bitmatrix_alloc(&temp_G, FIRE_SOURCE_LENGTH, INTERLEAVING_LENGTH);
+	bitmatrix_alloc(&L,      FIRE_SOURCE_LENGTH, FIRE_SOURCE_LENGTH);
+	bitmatrix_alloc(&P,      INTERLEAVING_LENGTH, INTERLEAVING_LENGTH);
+	bitmatrix_alloc(&P_I,    INTERLEAVING_LENGTH, INTERLEAVING_LENGTH);
+	bitmatrix_alloc(&HS,     INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH, INTERLEAVING_LENGTH);
+
+	bitmatrix_copy(&temp_G, G);
+
+	processFullEncodingGSystematicMatrix(&temp_G, &L, &P);
+	processFullEncodingHSystematicMatrix(&temp_G, &HS);
 
-	memcpy(H, HP_I, (INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH)*INTERLEAVING_LENGTH);
+	// Invert permutation matrix P into P_I
+	bitmatrix_transpose(&P, &P_I);
+	bitmatrix_multiply(&HS, &P_I, H);
 
+	bitmatrix_free(&temp_G);
+	bitmatrix_free(&L);
+	bitmatrix_free(&P);
+	bitmatrix_free(&P_I);
+	bitmatrix_free(&HS);
 }
 
 
 
 
 // Documentation in header file
-void InvertMatrixL( byte L  [FIRE_SOURCE_LENGTH][FIRE_SOURCE_LENGTH], \
-					byte L_I[FIRE_SOURCE_LENGTH][FIRE_SOURCE_LENGTH]) {
+int InvertMatrixL(const bitmatrix* L, bitmatrix* L_I) {
+	return bitmatrix_inverse(L, L_I);
+}
 
-	byte headFactor = 0;
-	CHAR_IDENTITY(L_I, FIRE_SOURCE_LENGTH);
 
-	for (int col=0; col<FIRE_SOURCE_LENGTH; ++col) {
-		for (int line=col; line<FIRE_SOURCE_LENGTH; ++line) {
 
 
-			headFactor = L[line][col];
-			if (headFactor) {
-				if (line!=col) {
-					byte temp;
-					for (int c=0; c<FIRE_SOURCE_LENGTH; ++c) {
-						temp = L[line][c];
-						L[line][c]  = L[col][c];
-						L[col][c] = temp;
-					}
-					for (int c=0; c<FIRE_SOURCE_LENGTH; ++c) {
-						temp = L_I[line][c];
-						L_I[line][c]  = L_I[col][c];
-						L_I[col][c] = temp;
-					}
-				}
+// Documentation in header file
+void processPackedEncoding(const byte sourcewords[], byte codewords[], unsigned int blocks) {
 
-				for (int l=line+1; l<FIRE_SOURCE_LENGTH; ++l) {
-					if (L[l][col]) {
-						for (int c=0; c<FIRE_SOURCE_LENGTH; ++c) {
-							L[l][c] ^= L[col][c];
-						}
-						for (int c=0; c<FIRE_SOURCE_LENGTH; ++c) {
-							L_I[l][c] ^= L_I[col][c];
-						}
-					}
-				}
-				break;
-			}
-		}
-	}
+	byte fired[FIRE_CODE_LENGTH/8];
+	byte convoluted[CODE_INTERLEAVING_CHUNK][CONVOLUTION_CODE_LENGTH/8];
+	byte bursts[CODE_INTERLEAVING_CHUNK][INTERLEAVING_BURSTS*INTERLEAVING_BURST_BYTES];
 
-	for (int line=0; line<FIRE_SOURCE_LENGTH; ++line) {
-		for (int col=line+1; col<FIRE_SOURCE_LENGTH; ++col) {
-			if(L[line][col]){
-				for (int c=line+1; c<FIRE_SOURCE_LENGTH; ++c) {
-						L[line][c] ^= L[col][c];
-				}
-				for (int c=0; c<FIRE_SOURCE_LENGTH; ++c) {
-						L_I[line][c] ^= L_I[col][c];
-				}
-			}
+	for (unsigned int first=0 ; first<blocks ; first+=CODE_INTERLEAVING_CHUNK) {
+
+		unsigned int count = (blocks-first < CODE_INTERLEAVING_CHUNK) ? blocks-first : CODE_INTERLEAVING_CHUNK;
+		for (unsigned int b=0 ; b<count ; ++b) {
+			processPackedFire(sourcewords + (first+b)*(SOURCEWORD_LENGTH/8), fired);
+			processPackedConvolution(fired, convoluted[b]);
 		}
+
+		// The whole chunk is interleaved at once, then its bursts are laid out back to back
+		interleaveBursts(convoluted[0], bursts[0], count);
+		joinBursts(bursts[0], codewords + first*(CODEWORD_LENGTH/8), count);
 	}
 }
 
 
 
 
-// Documentation in header file
-void processFullDecoding(byte codeword[CODEWORD_LENGTH], byte sourceword[SOURCEWORD_LENGTH]) {
+/**
+ * \fn void code_deinterleave(const byte codewords[], byte blocks[], unsigned int count)
+ * \brief Deinterleaves packed messages through the burst engine
+ *
+ * \param[in]  codewords Messages to deinterleave, CODEWORD_LENGTH/8 bytes each (8 bits per byte)
+ * \param[out] blocks Deinterleaved messages, INTERLEAVING_LENGTH/8 bytes each (8 bits per byte)
+ * \param[in]  count Number of messages, at most CODE_INTERLEAVING_CHUNK
+ */
+void code_deinterleave(const byte codewords[], byte blocks[], unsigned int count) {
+	byte bursts[CODE_INTERLEAVING_CHUNK][INTERLEAVING_BURSTS*INTERLEAVING_BURST_BYTES];
+	splitBursts(codewords, bursts[0], count);
+	deinterleaveBursts(bursts[0], blocks, count);
+}
+
+
+
+
+/**
+ * \fn FireStatus code_decodeDeinterleaved(const byte deinterleaved[INTERLEAVING_LENGTH/8], byte sourceword[SOURCEWORD_LENGTH])
+ * \brief Convolutional and Fire decoding of a deinterleaved message
+ *
+ * \param[in]  deinterleaved Deinterleaved message (8 bits per byte)
+ * \param[out] sourceword Decoded data (1 bit per byte)
+ * \return Outcome of the Fire decoding step
+ */
+FireStatus code_decodeDeinterleaved(const byte deinterleaved[INTERLEAVING_LENGTH/8], byte sourceword[SOURCEWORD_LENGTH]) {
 
 	memset(sourceword, 0, SOURCEWORD_LENGTH*sizeof(byte));
 
-	// Interleave decoder
-	byte deinterleavedMessage[INTERLEAVING_LENGTH]; // right padding of 24 bits
-	reverseInterleaving(codeword, deinterleavedMessage);
+	byte deinterleavedMessage[INTERLEAVING_LENGTH];
+	BYTE_VECTOR_TO_BIT_VECTOR(deinterleaved, deinterleavedMessage, INTERLEAVING_LENGTH);
 
 	// Convolutional decoder
 	byte deconvolutedMessage[CONVOLUTION_SOURCE_LENGTH]; // right padding of 28 bits
@@ -271,8 +287,138 @@ void processFullDecoding(byte codeword[CODEWORD_LENGTH], byte sourceword[SOURCEW
 	memcpy(predeFiredMessage, deconvolutedMessage, FIRE_CODE_LENGTH*sizeof(byte));
 
 	// Fire decoder
-	reverseFire(predeFiredMessage, sourceword);
+	return reverseFire(predeFiredMessage, sourceword);
+}
+
+
+
+
+// Documentation in header file
+FireStatus processFullDecoding(byte codeword[CODEWORD_LENGTH], byte sourceword[SOURCEWORD_LENGTH]) {
+
+	// Interleave decoder, on the packed message
+	byte packed[CODEWORD_LENGTH/8], deinterleaved[INTERLEAVING_LENGTH/8];
+	BIT_VECTOR_TO_BYTE_VECTOR(codeword, packed, CODEWORD_LENGTH);
+	code_deinterleave(packed, deinterleaved, 1);
+
+	return code_decodeDeinterleaved(deinterleaved, sourceword);
+}
+
+
+
+
+// Documentation in header file
+void processPackedDecoding(const byte codewords[], byte sourcewords[], FireStatus status[], unsigned int blocks) {
+
+	byte deinterleaved[CODE_INTERLEAVING_CHUNK][INTERLEAVING_LENGTH/8];
+	byte sourceword[SOURCEWORD_LENGTH];
+
+	for (unsigned int first=0 ; first<blocks ; first+=CODE_INTERLEAVING_CHUNK) {
+
+		unsigned int count = (blocks-first < CODE_INTERLEAVING_CHUNK) ? blocks-first : CODE_INTERLEAVING_CHUNK;
+		code_deinterleave(codewords + first*(CODEWORD_LENGTH/8), deinterleaved[0], count);
+
+		for (unsigned int b=0 ; b<count ; ++b) {
+			FireStatus fireStatus = code_decodeDeinterleaved(deinterleaved[b], sourceword);
+			BIT_VECTOR_TO_BYTE_VECTOR(sourceword, sourcewords + (first+b)*(SOURCEWORD_LENGTH/8), SOURCEWORD_LENGTH);
+			if (status)
+				status[first+b] = fireStatus;
+		}
+	}
+}
+
+
+
+
+/**
+ * \fn void code_viterbiLanes(signed char deinterleaved[][INTERLEAVING_LENGTH], byte sourcewords[], FireStatus status[], unsigned int count)
+ * \brief Convolutional and Fire decoding of deinterleaved soft bits, a batch of VITERBI_LANES messages at most
+ *
+ * \param[in]  deinterleaved Deinterleaved soft bits of every message
+ * \param[out] sourcewords Decoded data, SOURCEWORD_LENGTH bits per message
+ * \param[out] status Outcome of the Fire decoding step of every message (may be NULL)
+ * \param[in]  count Number of messages
+ */
+void code_viterbiLanes(signed char deinterleaved[][INTERLEAVING_LENGTH], byte sourcewords[], FireStatus status[], unsigned int count) {
+
+	// Convolutional decoder, including the 4 additional zeroes
+	byte deconvolutedMessages[VITERBI_LANES][CONVOLUTION_SOURCE_LENGTH];
+	reverseConvolutionViterbi(deinterleaved[0], deconvolutedMessages[0], count);
+
+	// Fire decoder
+	for (unsigned int b=0 ; b<count ; ++b) {
+		FireStatus fireStatus = reverseFire(deconvolutedMessages[b], sourcewords + b*SOURCEWORD_LENGTH);
+		if (status)
+			status[b] = fireStatus;
+	}
+}
 
+
+
+
+// Documentation in header file
+void processFullViterbiDecoding(const signed char codewords[], byte sourcewords[], FireStatus status[], unsigned int blocks) {
+
+	signed char deinterleavedMessages[VITERBI_LANES][INTERLEAVING_LENGTH];
+
+	for (unsigned int first=0 ; first<blocks ; first+=VITERBI_LANES) {
+
+		unsigned int count = (blocks-first < VITERBI_LANES) ? blocks-first : VITERBI_LANES;
+
+		// Interleave decoder: soft bits take a byte each and can't go through the burst engine,
+		// they are permuted one by one the same way as hard ones
+		for (unsigned int b=0 ; b<count ; ++b) {
+			reverseInterleaving((byte*)(codewords + (first+b)*CODEWORD_LENGTH), (byte*)deinterleavedMessages[b]);
+		}
+
+		code_viterbiLanes(deinterleavedMessages, sourcewords + first*SOURCEWORD_LENGTH, status ? status + first : NULL, count);
+	}
+}
+
+
+
+
+// Documentation in header file
+void processPackedViterbiDecoding(const byte codewords[], byte sourcewords[], FireStatus status[], unsigned int blocks) {
+
+	byte deinterleaved[VITERBI_LANES][INTERLEAVING_LENGTH/8];
+	signed char deinterleavedMessages[VITERBI_LANES][INTERLEAVING_LENGTH];
+	byte decoded[VITERBI_LANES][SOURCEWORD_LENGTH];
+
+	for (unsigned int first=0 ; first<blocks ; first+=VITERBI_LANES) {
+
+		unsigned int count = (blocks-first < VITERBI_LANES) ? blocks-first : VITERBI_LANES;
+
+		// Hard bits are deinterleaved while still packed, then turned into soft bits
+		code_deinterleave(codewords + first*(CODEWORD_LENGTH/8), deinterleaved[0], count);
+		for (unsigned int b=0 ; b<count ; ++b) {
+			for (int i=0 ; i<INTERLEAVING_LENGTH ; ++i) {
+				deinterleavedMessages[b][i] = HARD_TO_SOFTBIT(GET_CHARARRAY_BIT(deinterleaved[b], i));
+			}
+		}
+
+		code_viterbiLanes(deinterleavedMessages, decoded[0], status ? status + first : NULL, count);
+		for (unsigned int b=0 ; b<count ; ++b) {
+			BIT_VECTOR_TO_BYTE_VECTOR(decoded[b], sourcewords + (first+b)*(SOURCEWORD_LENGTH/8), SOURCEWORD_LENGTH);
+		}
+	}
+}
+
+
+
+
+/**
+ * \fn void code_encodeWithG(const byte sourceword[SOURCEWORD_LENGTH], byte codeword[CODEWORD_LENGTH])
+ * \brief Encodes a message with the shared encoding matrix (for test purpose)
+ *
+ * \param[in]  sourceword Message to encode (1 bit per byte)
+ * \param[out] codeword Encoded message (1 bit per byte)
+ */
+void code_encodeWithG(const byte sourceword[SOURCEWORD_LENGTH], byte codeword[CODEWORD_LENGTH]) {
+	bitword packedSource[BITMATRIX_WORDS(SOURCEWORD_LENGTH)], packedCode[BITMATRIX_WORDS(CODEWORD_LENGTH)];
+	bitmatrix_packVector(sourceword, packedSource, SOURCEWORD_LENGTH);
+	bitmatrix_vectorMultiply(packedSource, &code_getMatrices()->G, packedCode);
+	bitmatrix_unpackVector(packedCode, codeword, CODEWORD_LENGTH);
 }
 
 
@@ -281,7 +427,6 @@ void processFullDecoding(byte codeword[CODEWORD_LENGTH], byte sourceword[SOURCEW
 // Documentation in header file
 int code_test() {
 
-	byte G[SOURCEWORD_LENGTH][CODEWORD_LENGTH];
 	byte originalMessage[SOURCEWORD_LENGTH];
 	byte encodedMessage[CODEWORD_LENGTH];
 	byte decodedMessage[SOURCEWORD_LENGTH];
@@ -296,11 +441,13 @@ int code_test() {
 	memset(decodedMessage, 0, SOURCEWORD_LENGTH*sizeof(byte));
 
 	// Encoding
-	processFullEncodingGMatrix(G);
-	BINPRODUCT_VECTOR_MATRIX(originalMessage, G, encodedMessage, SOURCEWORD_LENGTH, CODEWORD_LENGTH);
+	code_encodeWithG(originalMessage, encodedMessage);
 
 	// Decoding
-	processFullDecoding(encodedMessage, decodedMessage);
+	if (processFullDecoding(encodedMessage, decodedMessage) != FIRE_VALID) {
+		DEBUG("Self-check aborted: the CRC of a valid codeword doesn't match");
+		return 1;
+	}
 
 	// We check that the message was recovered correctly:
 	for (int i=0 ; i<SOURCEWORD_LENGTH ; ++i) {
@@ -311,6 +458,169 @@ int code_test() {
 			return 1;
 		}
 	}
+
+	// The shared parity-check matrix must vanish on every codeword
+	bitword packedCode[BITMATRIX_WORDS(CODEWORD_LENGTH)], syndrome[BITMATRIX_WORDS(SYNDROME_LENGTH)];
+	bitmatrix_packVector(encodedMessage, packedCode, CODEWORD_LENGTH);
+	bitmatrix_multiplyVector(&code_getMatrices()->H, packedCode, syndrome);
+	for (int w=0 ; w<BITMATRIX_WORDS(SYNDROME_LENGTH) ; ++w) {
+		if (syndrome[w]) {
+			DEBUG("Self-check aborted: the syndrome of a valid codeword isn't null");
+			return 1;
+		}
+	}
+
+	// The Viterbi decoder must correct transmission errors the algebraic decoder can't deal with:
+	// every message is sent with a few flipped bits, then with erased bits (unknown soft value)
+	signed char noisyMessages[2*VITERBI_LANES][CODEWORD_LENGTH];
+	byte viterbiMessages[2*VITERBI_LANES][SOURCEWORD_LENGTH];
+	byte noisySources[2*VITERBI_LANES][SOURCEWORD_LENGTH];
+	for (int b=0 ; b<2*VITERBI_LANES ; ++b) {
+		for (int k=0 ; k<SOURCEWORD_LENGTH ; ++k) {
+			noisySources[b][k] = rand() & 1;
+		}
+		code_encodeWithG(noisySources[b], encodedMessage);
+		for (int i=0 ; i<CODEWORD_LENGTH ; ++i) {
+			noisyMessages[b][i] = HARD_TO_SOFTBIT(encodedMessage[i]);
+		}
+		for (int e=0 ; e<((b<VITERBI_LANES) ? 3 : 6) ; ++e) {
+			int i = rand() % CODEWORD_LENGTH;
+			noisyMessages[b][i] = (b<VITERBI_LANES) ? -noisyMessages[b][i] : 0;
+		}
+	}
+	processFullViterbiDecoding(noisyMessages[0], viterbiMessages[0], NULL, 2*VITERBI_LANES);
+	for (int b=0 ; b<2*VITERBI_LANES ; ++b) {
+		if (memcmp(viterbiMessages[b], noisySources[b], SOURCEWORD_LENGTH*sizeof(byte))) {
+			DEBUG("Self-check aborted: the Viterbi decoder didn't recover the noisy message #%d", b);
+			return 1;
+		}
+	}
+
+	// The Fire decoder must correct any burst of errors up to FIRE_CORRECTABLE_BURST bits long,
+	// and report scattered errors as uncorrectable
+	for (int testcase=0 ; testcase<64 ; ++testcase) {
+
+		byte packedSource[FIRE_SOURCE_LENGTH/8], packedFired[FIRE_CODE_LENGTH/8];
+		byte fired[FIRE_CODE_LENGTH], unfired[FIRE_SOURCE_LENGTH];
+		for (int k=0 ; k<FIRE_SOURCE_LENGTH/8 ; ++k) {
+			packedSource[k] = rand() & 0xFF;
+		}
+		processPackedFire(packedSource, packedFired);
+		BYTE_VECTOR_TO_BIT_VECTOR(packedFired, fired, FIRE_CODE_LENGTH);
+
+		int length = 1 + rand() % FIRE_CORRECTABLE_BURST;
+		int start  = rand() % (FIRE_CODE_LENGTH - length + 1);
+		for (int d=0 ; d<length ; ++d) {
+			fired[start+d] ^= (d==0 || d==length-1) ? 1 : (rand() & 1);
+		}
+		FireStatus status = reverseFire(fired, unfired);
+		BYTE_VECTOR_TO_BIT_VECTOR(packedSource, originalMessage, SOURCEWORD_LENGTH);
+		if (status != FIRE_CORRECTED || memcmp(unfired, originalMessage, SOURCEWORD_LENGTH*sizeof(byte))) {
+			DEBUG("Self-check aborted: a burst of %d errors at bit #%d wasn't corrected by the Fire decoder", length, start);
+			return 1;
+		}
+
+		for (int e=0 ; e<20 ; ++e) {
+			fired[rand() % FIRE_CODE_LENGTH] ^= 1;
+		}
+		if (reverseFire(fired, unfired) != FIRE_UNCORRECTABLE) {
+			DEBUG("Self-check aborted: scattered errors weren't detected by the Fire decoder");
+			return 1;
+		}
+	}
+
+	// The packed encoder must match the G matrix on random messages, processed as one batch
+	byte packedSources[64][SOURCEWORD_LENGTH/8];
+	byte packedCodes[64][CODEWORD_LENGTH/8];
+	for (int b=0 ; b<64 ; ++b) {
+		for (int k=0 ; k<SOURCEWORD_LENGTH/8 ; ++k) {
+			packedSources[b][k] = rand() & 0xFF;
+		}
+	}
+	processPackedEncoding(packedSources[0], packedCodes[0], 64);
+
+	for (int b=0 ; b<64 ; ++b) {
+		BYTE_VECTOR_TO_BIT_VECTOR(packedSources[b], originalMessage, SOURCEWORD_LENGTH);
+		code_encodeWithG(originalMessage, encodedMessage);
+		for (int i=0 ; i<CODEWORD_LENGTH ; ++i) {
+			if (GET_CHARARRAY_BIT(packedCodes[b], i) != encodedMessage[i]) {
+				DEBUG("Self-check aborted: the packed encoder differs from the G matrix (message #%d, bit #%d)", b, i);
+				return 1;
+			}
+		}
+	}
+
+	// Bursts must hold the interleaved bits in order, and give the packed blocks back
+	byte bursts[64][INTERLEAVING_BURSTS*INTERLEAVING_BURST_BYTES];
+	byte deinterleaved[64][CODEWORD_LENGTH/8];
+	interleaveBursts(packedCodes[0], bursts[0], 64);
+	deinterleaveBursts(bursts[0], deinterleaved[0], 64);
+	for (int b=0 ; b<64 ; ++b) {
+		byte interleaved[INTERLEAVING_LENGTH/8];
+		processPackedInterleaving(packedCodes[b], interleaved);
+		for (int i=0 ; i<INTERLEAVING_LENGTH ; ++i) {
+			byte* burst = bursts[b] + (i/INTERLEAVING_BURST_LENGTH)*INTERLEAVING_BURST_BYTES;
+			if (GET_CHARARRAY_BIT(burst, i%INTERLEAVING_BURST_LENGTH) != GET_CHARARRAY_BIT(interleaved, i)) {
+				DEBUG("Self-check aborted: the bursts don't match the interleaved block (block #%d, bit #%d)", b, i);
+				return 1;
+			}
+		}
+		if (memcmp(deinterleaved[b], packedCodes[b], CODEWORD_LENGTH/8)) {
+			DEBUG("Self-check aborted: deinterleaving the bursts doesn't give the original block back (block #%d)", b);
+			return 1;
+		}
+	}
+
+	// Both packed decoders must give the messages back, through the burst engine
+	byte packedDecoded[64][SOURCEWORD_LENGTH/8];
+	FireStatus packedStatus[64];
+	for (int decoder=0 ; decoder<2 ; ++decoder) {
+		if (decoder)
+			processPackedViterbiDecoding(packedCodes[0], packedDecoded[0], packedStatus, 64);
+		else
+			processPackedDecoding(packedCodes[0], packedDecoded[0], packedStatus, 64);
+		for (int b=0 ; b<64 ; ++b) {
+			if (packedStatus[b] != FIRE_VALID || memcmp(packedDecoded[b], packedSources[b], SOURCEWORD_LENGTH/8)) {
+				DEBUG("Self-check aborted: the packed %s decoder didn't give message #%d back", decoder ? "Viterbi" : "algebraic", b);
+				return 1;
+			}
+		}
+	}
+
+	// A batch cut short must have its whole messages decoded, counted in the unit of the decoder
+	// (CODEWORD_LENGTH/8 bytes per packed codeword, CODEWORD_LENGTH soft bits per soft one), and nothing past them
+	const size_t truncation = 10;
+	signed char softCodes[3][CODEWORD_LENGTH];
+	byte softDecoded[3][SOURCEWORD_LENGTH];
+	for (int b=0 ; b<3 ; ++b) {
+		for (int i=0 ; i<CODEWORD_LENGTH ; ++i) {
+			softCodes[b][i] = HARD_TO_SOFTBIT(GET_CHARARRAY_BIT(packedCodes[b], i));
+		}
+	}
+	for (int decoder=0 ; decoder<3 ; ++decoder) {
+		size_t unit = (decoder == 2) ? CODEWORD_LENGTH : CODEWORD_LENGTH/8;
+		unsigned int blocks = (3*unit - truncation) / unit;
+		memset(packedDecoded, 0xA5, sizeof(packedDecoded));
+		memset(softDecoded, 0xA5, sizeof(softDecoded));
+		switch (decoder) {
+			case 0: processPackedDecoding(packedCodes[0], packedDecoded[0], packedStatus, blocks); break;
+			case 1: processPackedViterbiDecoding(packedCodes[0], packedDecoded[0], packedStatus, blocks); break;
+			default:
+				processFullViterbiDecoding(softCodes[0], softDecoded[0], packedStatus, blocks);
+				for (unsigned int b=0 ; b<blocks ; ++b) {
+					BIT_VECTOR_TO_BYTE_VECTOR(softDecoded[b], packedDecoded[b], SOURCEWORD_LENGTH);
+				}
+		}
+		int overrun = 0;
+		for (int i=0 ; i<SOURCEWORD_LENGTH ; ++i) {
+			overrun |= (softDecoded[2][i] != 0xA5) || (i < SOURCEWORD_LENGTH/8 && packedDecoded[2][i] != 0xA5);
+		}
+		if (blocks != 2 || overrun || memcmp(packedDecoded[0], packedSources[0], 2*(SOURCEWORD_LENGTH/8))) {
+			DEBUG("Self-check aborted: decoder #%d didn't decode only the whole messages of a truncated batch", decoder);
+			return 1;
+		}
+	}
+
 	DEBUG("Self-check succeeded: the decoded message matches the original one");
 	return 0;
 }
@@ -29,8 +29,8 @@
   * @brief Specification of full coding & decoding process
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #13
-  * @date 01/12/2011
+  * @version File Revision #20
+  * @date 19/10/2026
   * */
 
 
@@ -38,6 +38,7 @@
 #define _CODE_H_
 
 #include "utils.h"
+#include "bitmatrix.h"
 
 #include "firecode.h"
 #include "const_code.h"
@@ -48,72 +49,165 @@
 
 
 /**
- * \fn void processFullEncodingGMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH])
+ * \struct codeMatrices
+ * \brief Full encoding matrix and its parity-check matrix, shared by all modules
+ */
+typedef struct {
+	bitmatrix G; //!< Full encoding matrix, SOURCEWORD_LENGTH × CODEWORD_LENGTH
+	bitmatrix H; //!< Parity-check matrix, SYNDROME_LENGTH × CODEWORD_LENGTH: H×g=0 iff g is a codeword
+} codeMatrices;
+
+
+
+
+/**
+ * \fn const codeMatrices* code_getMatrices()
+ * \brief Provides the full encoding matrix G and its parity-check matrix H
+ *
+ * Both matrices are computed once, on the first call (whichever the calling thread is), and then shared
+ * read-only by every caller. This is the preferred way to obtain G and H: the processFullEncoding*Matrix()
+ * functions below rebuild them from scratch.
+ *
+ * The entry points (attack, generation of the dictionary) check once that the matrices could be allocated;
+ * the functions they call then rely on it.
+ *
+ * \return Pointer to the shared matrices, NULL if they couldn't be allocated
+ */
+const codeMatrices* code_getMatrices();
+
+
+
+
+/**
+ * \fn void processFullEncodingGMatrix(bitmatrix* G)
  * \brief Calculates the encoding matrix corresponding to all encoding steps (Fire code, Convolution and Interleaving)
  *
- * \param[out] G Full encoding matrix
+ * \param[out] G Full encoding matrix, FIRE_SOURCE_LENGTH × INTERLEAVING_LENGTH
  */
-void processFullEncodingGMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH]);
+void processFullEncodingGMatrix(bitmatrix* G);
 
 
 
 
 /**
- * \fn void processFullEncodingGSystematicMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH], byte L[FIRE_SOURCE_LENGTH][FIRE_SOURCE_LENGTH], byte P[INTERLEAVING_LENGTH][INTERLEAVING_LENGTH])
+ * \fn void processFullEncodingGSystematicMatrix(bitmatrix* G, bitmatrix* L, bitmatrix* P)
  * \brief Calculates the encoding matrix corresponding to all encoding steps (Fire code, Convolution and Interleaving) in systematic form
  *
- * \param[out] G Full encoding matrix in systematic form
- * \param[out] L Invertible matrix
- * \param[out] P Permutation matrix
+ * \param[in, out] G Full encoding matrix, brought to systematic form
+ * \param[out]     L Invertible matrix, FIRE_SOURCE_LENGTH × FIRE_SOURCE_LENGTH
+ * \param[out]     P Permutation matrix, INTERLEAVING_LENGTH × INTERLEAVING_LENGTH
  */
-void processFullEncodingGSystematicMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH], byte L[FIRE_SOURCE_LENGTH][FIRE_SOURCE_LENGTH], byte P[INTERLEAVING_LENGTH][INTERLEAVING_LENGTH]);
+void processFullEncodingGSystematicMatrix(bitmatrix* G, bitmatrix* L, bitmatrix* P);
 
 
 
 /**
- * \fn void processFullEncodingHSystematicMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH], byte H[INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH])
+ * \fn void processFullEncodingHSystematicMatrix(const bitmatrix* G, bitmatrix* H)
  * \brief Calculates the systematic parity-check matrix H associated to the code matrix G in systematic form.
  *
  * \param[in]  G Full encoding matrix in systematic form
- * \param[out] H Parity-check matrix in systematic form
+ * \param[out] H Parity-check matrix in systematic form, (INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH) × INTERLEAVING_LENGTH
  */
-void processFullEncodingHSystematicMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH], byte H[INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH]);
+void processFullEncodingHSystematicMatrix(const bitmatrix* G, bitmatrix* H);
 
 
 
 
 /**
- * \fn void processFullEncodingHMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH], byte H[INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH])
+ * \fn void processFullEncodingHMatrix(const bitmatrix* G, bitmatrix* H)
  * \brief Calculates the real parity-check matrix H associated to the code matrix G. Thus, H×g=0 iff g is a codeword.
  *
  * \param[in]  G Full encoding matrix
- * \param[out] H Parity-check matrix
+ * \param[out] H Parity-check matrix, (INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH) × INTERLEAVING_LENGTH
  */
-void processFullEncodingHMatrix(byte G[FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH], byte H[INTERLEAVING_LENGTH - FIRE_SOURCE_LENGTH][INTERLEAVING_LENGTH]);
+void processFullEncodingHMatrix(const bitmatrix* G, bitmatrix* H);
 
 
 
 
 /**
- * \fn void InvertMatrixL(byte L[FIRE_SOURCE_LENGTH][FIRE_SOURCE_LENGTH], byte L_I[FIRE_SOURCE_LENGTH][FIRE_SOURCE_LENGTH])
+ * \fn int InvertMatrixL(const bitmatrix* L, bitmatrix* L_I)
  * \brief Inverts the provided L matrix (peculiar case of Gauss elimination when L is a square matrix of size FIRE_SOURCE_LENGTH)
  *
- * \param[in,out] L Invertible matrix, modified by the function to become Identity Matrix
- * \param[out]    L_I inverse of the initial L matrix
+ * \param[in]  L Invertible matrix
+ * \param[out] L_I inverse of the L matrix
+ * \return 0 if L is invertible, non-zero otherwise
  */
-void InvertMatrixL(byte L[FIRE_SOURCE_LENGTH][FIRE_SOURCE_LENGTH], byte L_I[FIRE_SOURCE_LENGTH][FIRE_SOURCE_LENGTH]);
+int InvertMatrixL(const bitmatrix* L, bitmatrix* L_I);
+
+
+
+
+//! Number of messages encoded per batch when processing a stream
+#define CODE_BATCH_BLOCKS 4096
 
 
 
 
 /**
- * \fn void processFullDecoding(byte codeword[CODEWORD_LENGTH], byte sourceword[SOURCEWORD_LENGTH])
+ * \fn void processPackedEncoding(const byte sourcewords[], byte codewords[], unsigned int blocks)
+ * \brief Encodes a batch of messages on packed data (Fire code, Convolution and Interleaving), bit-exact with the G matrix
+ *
+ * \param[in]  sourcewords Messages to encode, SOURCEWORD_LENGTH/8 bytes each (8 bits per byte)
+ * \param[out] codewords Encoded messages, CODEWORD_LENGTH/8 bytes each (8 bits per byte)
+ * \param[in]  blocks Number of messages to encode
+ */
+void processPackedEncoding(const byte sourcewords[], byte codewords[], unsigned int blocks);
+
+
+
+
+/**
+ * \fn FireStatus processFullDecoding(byte codeword[CODEWORD_LENGTH], byte sourceword[SOURCEWORD_LENGTH])
  * \brief Decodes a previously encoded message
  *
  * \param[in]  codeword Data to decode
  * \param[out] sourceword Decoded data
+ * \return Outcome of the Fire decoding step (CRC check and burst error correction)
+ */
+FireStatus processFullDecoding(byte codeword[CODEWORD_LENGTH], byte sourceword[SOURCEWORD_LENGTH]);
+
+
+
+
+/**
+ * \fn void processPackedDecoding(const byte codewords[], byte sourcewords[], FireStatus status[], unsigned int blocks)
+ * \brief Decodes a batch of messages on packed data, deinterleaving them with the burst engine (same outcome as processFullDecoding())
+ *
+ * \param[in]  codewords Data to decode, CODEWORD_LENGTH/8 bytes per message (8 bits per byte)
+ * \param[out] sourcewords Decoded data, SOURCEWORD_LENGTH/8 bytes per message (8 bits per byte)
+ * \param[out] status Outcome of the Fire decoding step of every message (may be NULL)
+ * \param[in]  blocks Number of messages to decode
+ */
+void processPackedDecoding(const byte codewords[], byte sourcewords[], FireStatus status[], unsigned int blocks);
+
+
+
+
+/**
+ * \fn void processFullViterbiDecoding(const signed char codewords[], byte sourcewords[], FireStatus status[], unsigned int blocks)
+ * \brief Decodes a batch of previously encoded messages, correcting transmission errors with a Viterbi decoder
+ *
+ * \param[in]  codewords Data to decode, CODEWORD_LENGTH soft bits per message (see HARD_TO_SOFTBIT() for hard-decided data)
+ * \param[out] sourcewords Decoded data, SOURCEWORD_LENGTH bits per message
+ * \param[out] status Outcome of the Fire decoding step of every message (may be NULL)
+ * \param[in]  blocks Number of messages to decode
+ */
+void processFullViterbiDecoding(const signed char codewords[], byte sourcewords[], FireStatus status[], unsigned int blocks);
+
+
+
+
+/**
+ * \fn void processPackedViterbiDecoding(const byte codewords[], byte sourcewords[], FireStatus status[], unsigned int blocks)
+ * \brief Decodes a batch of hard-decided messages on packed data with the Viterbi decoder, deinterleaving them with the burst engine
+ *
+ * \param[in]  codewords Data to decode, CODEWORD_LENGTH/8 bytes per message (8 bits per byte)
+ * \param[out] sourcewords Decoded data, SOURCEWORD_LENGTH/8 bytes per message (8 bits per byte)
+ * \param[out] status Outcome of the Fire decoding step of every message (may be NULL)
+ * \param[in]  blocks Number of messages to decode
  */
-void processFullDecoding(byte codeword[CODEWORD_LENGTH], byte sourceword[SOURCEWORD_LENGTH]);
+void processPackedViterbiDecoding(const byte codewords[], byte sourcewords[], FireStatus status[], unsigned int blocks);
 
 
 
@@ -30,8 +30,8 @@
   * as one single change could have desastrous consequences on the global process
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #8
-  * @date 24/06/2011
+  * @version File Revision #11
+  * @date 19/10/2026
   * */
 
 #ifndef _CONST_A52_H_
@@ -101,6 +101,17 @@
 #define FRAMEID_BITS   22
 
 
+//@{
+//! TDMA framing: every frame provides 2 bursts of keystream (downlink first, then uplink)
+#define BURST_KEYSTREAM_BITS  114
+#define BURST_KEYSTREAM_BYTES ((BURST_KEYSTREAM_BITS+7)/8)
+#define FRAME_KEYSTREAM_BITS  (2*BURST_KEYSTREAM_BITS)
+//@}
+
+//! Number of TDMA frames in a hyperframe (26 × 51 × 2048), after which frame numbers wrap around
+#define HYPERFRAME_LENGTH 2715648
+
+
 //@{
 //! Simple Variables (exactly one location of each register is set to constant "1" at the beginning, thus reducing the number of variables to R{1,2,3}_SIMPLE_VARS = (R{1,2,3}_BITS-1))
 #define R1_SIMPLE_VARS   (R1_BITS - 1)
@@ -129,15 +140,11 @@
 
 //! Number of possible values of the fourth LFSR (R4)
 #define TOTAL_MATRICES     (1<<(R4_BITS-1))
-//! Number of threads used for both matrices generation and attack (must be a power of 2)
+//! Default number of threads used for both matrices generation and attack (must be a power of 2)
 #define PROCESSING_THREADS 4 //(1<<5)
 //! Amount of data that will be processed by each thread
 #define THREAD_CHUNKSIZE   (TOTAL_MATRICES/PROCESSING_THREADS)
 
 
-//! A matrix of integers will be used for faster decryption. The last integer of the line will be half-loaded with two bytes
-#define RESOLUTION_MATRIX_INT_WIDTH ((REGS_TOTAL_VARS+31)/32)
-
-
 
 #endif
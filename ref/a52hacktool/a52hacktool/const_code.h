@@ -30,8 +30,8 @@
   * as one single change could have desastrous consequences on the global process
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #7
-  * @date 24/06/2011
+  * @version File Revision #10
+  * @date 19/10/2026
   * */
 
 #ifndef _CONST_CODE_H_
@@ -62,6 +62,10 @@
 #define LOWER_POLYNOMIAL  ((unsigned int)0x800000);          //!< Lower polynomial representation
 
 #define FIRE_POLYNOMIAL_LENGTH 41                            //!< Meaningful length (in bits)
+
+// Fed MSB-first (first source bit = highest degree), the codewords are multiples of the reciprocal
+// polynomial D^40 + D^37 + D^23 + D^17 + D^14 + D^0, whose low 40 bits are used by the packed encoder
+#define FIRE_PACKED_POLYNOMIAL ((unsigned long long)0x2000824001ULL) //!< Packed CRC polynomial (D^40 implicit)
 #define LOWER_PADDINGBITS   (32*2 - FIRE_POLYNOMIAL_LENGTH)  //!< Number of padding bits
 
 //! Fire code input length (in bits)
@@ -70,6 +74,8 @@
 #define FIRE_CODE_LENGTH    (FIRE_SOURCE_LENGTH + FIRE_POLYNOMIAL_LENGTH - 1) // 224
 //! Fire code CRC length (in bits)
 #define FIRE_CRC_LENGTH     (FIRE_CODE_LENGTH - FIRE_SOURCE_LENGTH)           // 40
+//! Longest burst of errors corrected by the Fire decoder (in bits)
+#define FIRE_CORRECTABLE_BURST 11
 
 
 // Convolution - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -85,6 +91,14 @@
 
 //! Convolution input length (in bits)
 #define INTERLEAVING_LENGTH CONVOLUTION_CODE_LENGTH                           // 456
+//! Number of bursts an interleaved block is spread over
+#define INTERLEAVING_BURSTS 4
+//! Length of a burst (in bits)
+#define INTERLEAVING_BURST_LENGTH (INTERLEAVING_LENGTH / INTERLEAVING_BURSTS) // 114
+//! Size of a packed burst (in bytes, 8 bits per byte, null padding bits)
+#define INTERLEAVING_BURST_BYTES ((INTERLEAVING_BURST_LENGTH + 7) / 8)        // 15
+//! Length of each of the 8 streams a block is split into (bits k with the same k%8, in bits)
+#define INTERLEAVING_STREAM_LENGTH (INTERLEAVING_LENGTH / 8)                  // 57
 
 
 
@@ -29,13 +29,14 @@
   * @brief Implementation of second encoding & decoding phase: convolution
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #10
-  * @date 24/06/2011
+  * @version File Revision #13
+  * @date 19/10/2026
   * */
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
 
 #include "utils.h"
 
@@ -47,9 +48,9 @@
 
 
 // Documentation in header file
-void processConvolutionGMatrix(byte G[CONVOLUTION_SOURCE_LENGTH][CONVOLUTION_CODE_LENGTH]) {
+void processConvolutionGMatrix(bitmatrix* G) {
 
-	memset(G, 0, CONVOLUTION_SOURCE_LENGTH*CONVOLUTION_CODE_LENGTH*sizeof(byte));
+	bitmatrix_zero(G);
 
 	byte pattern[10] = {1,1,0,1,0,0,1,1,1,1};
 
@@ -70,7 +71,11 @@ void processConvolutionGMatrix(byte G[CONVOLUTION_SOURCE_LENGTH][CONVOLUTION_COD
 	//  |..........11
 	//  |
 	for (int i=0 ; i<CONVOLUTION_SOURCE_LENGTH ; ++i) {
-		memcpy(G[i]+2*i, pattern, ((i<CONVOLUTION_SOURCE_LENGTH-4)? 10 : CONVOLUTION_CODE_LENGTH - 2*i)*sizeof(byte));
+		int length = (i<CONVOLUTION_SOURCE_LENGTH-4)? 10 : CONVOLUTION_CODE_LENGTH - 2*i;
+		for (int k=0 ; k<length ; ++k) {
+			if (pattern[k])
+				BITMATRIX_SET(G, i, 2*i+k, 1);
+		}
 	}
 
 }
@@ -78,6 +83,63 @@ void processConvolutionGMatrix(byte G[CONVOLUTION_SOURCE_LENGTH][CONVOLUTION_COD
 
 
 
+//! 16 output bits for every 4-bit history u(k-4)..u(k-1) and 8 input bits u(k)..u(k+7), filled in by convolution_buildTable()
+unsigned short convolution_table[16][256];
+
+//! Ensures that the convolution table is computed exactly once
+pthread_once_t convolution_tableOnce = PTHREAD_ONCE_INIT;
+
+
+
+
+/**
+ * \fn void convolution_buildTable()
+ * \brief Computes the convolution table (called once through pthread_once)
+ */
+void convolution_buildTable() {
+
+	for (int history=0 ; history<16 ; ++history) {
+		for (int value=0 ; value<256 ; ++value) {
+
+			// u[0..3] = u(k-4)..u(k-1), u[4..11] = u(k)..u(k+7)
+			byte u[12];
+			for (int i=0 ; i<4 ; ++i) u[i]   = (history >> (3-i)) & 1;
+			for (int i=0 ; i<8 ; ++i) u[4+i] = (value   >> (7-i)) & 1;
+
+			unsigned short out = 0;
+			for (int i=0 ; i<8 ; ++i) {
+				// c(2k) = u(k)^u(k-3)^u(k-4) and c(2k+1) = u(k)^u(k-1)^u(k-3)^u(k-4)
+				out |= (u[4+i] ^ u[1+i] ^ u[i])          << (15-2*i);
+				out |= (u[4+i] ^ u[3+i] ^ u[1+i] ^ u[i]) << (14-2*i);
+			}
+			convolution_table[history][value] = out;
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+void processPackedConvolution(const byte in[FIRE_CODE_LENGTH/8], byte out[CONVOLUTION_CODE_LENGTH/8]) {
+
+	pthread_once(&convolution_tableOnce, convolution_buildTable);
+
+	unsigned int history = 0;
+	for (int i=0 ; i<FIRE_CODE_LENGTH/8 ; ++i) {
+		unsigned short w = convolution_table[history][in[i]];
+		out[2*i]   = (byte)(w >> 8);
+		out[2*i+1] = (byte)w;
+		history = in[i] & 0xF;
+	}
+
+	// The 4 additional zeroes only produce 8 more bits
+	out[CONVOLUTION_CODE_LENGTH/8 - 1] = (byte)(convolution_table[history][0] >> 8);
+}
+
+
+
+
 // Documentation in header file
 void reverseConvolution(byte in[CONVOLUTION_CODE_LENGTH], byte out[CONVOLUTION_SOURCE_LENGTH]) {
 
@@ -99,3 +161,87 @@ void reverseConvolution(byte in[CONVOLUTION_CODE_LENGTH], byte out[CONVOLUTION_S
 }
 
 
+
+
+// Documentation in header file
+void reverseConvolutionViterbi(const signed char in[], byte out[], unsigned int blocks) {
+
+	// Branch symbol c(2k)c(2k+1) from state 2j (even predecessor) to state j, for each j<8: since
+	// state s = u(k)u(k-1)u(k-2)u(k-3), c(2k) = s3^s0^u(k-4) and c(2k+1) = s3^s2^s0^u(k-4).
+	// Reaching j from 2j+1 or reaching j+8 from 2j complements both bits.
+	byte symbol[CONVOLUTION_STATES/2];
+	for (int j=0 ; j<CONVOLUTION_STATES/2 ; ++j) {
+		symbol[j] = ((j & 1) << 1) | (((j >> 2) ^ j) & 1);
+	}
+
+	// Messages are decoded VITERBI_LANES at a time, each one in its own lane of the innermost loops,
+	// so that the compiler turns every Add-Compare-Select step into a few SIMD instructions
+	short soft[CONVOLUTION_CODE_LENGTH][VITERBI_LANES];
+	short metric[CONVOLUTION_STATES][VITERBI_LANES];
+	short next[CONVOLUTION_STATES][VITERBI_LANES];
+	short cost[4][VITERBI_LANES];
+	// decision[k][s][l] tells whether the survivor path of state s comes from the odd predecessor
+	byte decision[CONVOLUTION_SOURCE_LENGTH][CONVOLUTION_STATES][VITERBI_LANES];
+
+	for (unsigned int first=0 ; first<blocks ; first+=VITERBI_LANES) {
+
+		unsigned int lanes = (blocks-first < VITERBI_LANES) ? blocks-first : VITERBI_LANES;
+		for (int i=0 ; i<CONVOLUTION_CODE_LENGTH ; ++i) {
+			for (unsigned int l=0 ; l<VITERBI_LANES ; ++l) {
+				soft[i][l] = (l<lanes) ? in[(first+l)*CONVOLUTION_CODE_LENGTH + i] : 0;
+			}
+		}
+
+		// The encoder starts from the null state
+		for (int s=0 ; s<CONVOLUTION_STATES ; ++s) {
+			for (int l=0 ; l<VITERBI_LANES ; ++l) {
+				metric[s][l] = s ? VITERBI_UNREACHABLE : 0;
+			}
+		}
+
+		for (int k=0 ; k<CONVOLUTION_SOURCE_LENGTH ; ++k) {
+
+			// Cost of every branch symbol given the received soft bits (up to a constant)
+			for (int l=0 ; l<VITERBI_LANES ; ++l) {
+				cost[0][l] =  soft[2*k][l] + soft[2*k+1][l];
+				cost[1][l] =  soft[2*k][l] - soft[2*k+1][l];
+				cost[2][l] = -soft[2*k][l] + soft[2*k+1][l];
+				cost[3][l] = -soft[2*k][l] - soft[2*k+1][l];
+			}
+
+			// Add-Compare-Select
+			for (int j=0 ; j<CONVOLUTION_STATES/2 ; ++j) {
+				const short* straight = cost[symbol[j]];
+				const short* crossed  = cost[3 ^ symbol[j]];
+				for (int l=0 ; l<VITERBI_LANES ; ++l) {
+					short a0 = metric[2*j][l] + straight[l], a1 = metric[2*j+1][l] + crossed[l];
+					short b0 = metric[2*j][l] + crossed[l],  b1 = metric[2*j+1][l] + straight[l];
+					decision[k][j][l]   = a1 < a0;
+					decision[k][j+8][l] = b1 < b0;
+					next[j][l]   = (a1 < a0) ? a1 : a0;
+					next[j+8][l] = (b1 < b0) ? b1 : b0;
+				}
+			}
+
+			// Metrics are kept relative to the null state, so that they never overflow
+			for (int s=0 ; s<CONVOLUTION_STATES ; ++s) {
+				for (int l=0 ; l<VITERBI_LANES ; ++l) {
+					metric[s][l] = next[s][l] - next[0][l];
+				}
+			}
+		}
+
+		// The additional zeroes bring the encoder back to the null state: trace back from there
+		for (unsigned int l=0 ; l<lanes ; ++l) {
+			byte* decoded = out + (first+l)*CONVOLUTION_SOURCE_LENGTH;
+			unsigned int state = 0;
+			for (int k=CONVOLUTION_SOURCE_LENGTH-1 ; k>=0 ; --k) {
+				decoded[k] = state >> 3;
+				state = ((state & 7) << 1) | decision[k][state][l];
+			}
+		}
+	}
+}
+
+
+
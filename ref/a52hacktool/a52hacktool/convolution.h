@@ -29,25 +29,58 @@
   * @brief Specification of second encoding & decoding phase: convolution
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #8
-  * @date 24/06/2011
+  * @version File Revision #11
+  * @date 19/10/2026
   * */
 
 #ifndef _CONVOLUTION_H_
 #define _CONVOLUTION_H_
 
 #include "const_code.h"
+#include "bitmatrix.h"
+
+
+
+
+//! Greatest soft-decision value: soft bits range from -SOFTBIT_MAX (surely 0) to SOFTBIT_MAX (surely 1), 0 meaning unknown
+#define SOFTBIT_MAX 127
+
+//! Soft-decision value of a hard-decided bit
+#define HARD_TO_SOFTBIT(bit) ((signed char)((bit) ? SOFTBIT_MAX : -SOFTBIT_MAX))
+
+//! Number of states of the convolution trellis (the encoder remembers the 4 previous source bits)
+#define CONVOLUTION_STATES 16
+
+//! Number of messages decoded simultaneously by reverseConvolutionViterbi() (one per SIMD lane)
+#define VITERBI_LANES 16
+
+//! Initial path metric of the states the encoder can't start from
+#define VITERBI_UNREACHABLE 0x2000
 
 
 
 
 /**
- * \fn void processConvolutionGMatrix(byte G[CONVOLUTION_SOURCE_LENGTH][CONVOLUTION_CODE_LENGTH])
+ * \fn void processConvolutionGMatrix(bitmatrix* G)
  * \brief Calculates the encoding matrix corresponding to the Convolution encoding step
  *
- * \param[out] G Convolution encoding matrix
+ * \param[out] G Convolution encoding matrix, CONVOLUTION_SOURCE_LENGTH x CONVOLUTION_CODE_LENGTH
+ */
+void processConvolutionGMatrix(bitmatrix* G);
+
+
+
+
+/**
+ * \fn void processPackedConvolution(const byte in[FIRE_CODE_LENGTH/8], byte out[CONVOLUTION_CODE_LENGTH/8])
+ * \brief Convolutes a Fire-encoded message on packed data, 8 source bits at a time (bit-exact with processConvolutionGMatrix())
+ *
+ * The 4 additional zeroes are appended by the function itself.
+ *
+ * \param[in]  in Data to convolute (8 bits per byte)
+ * \param[out] out Convoluted data (8 bits per byte)
  */
-void processConvolutionGMatrix(byte G[CONVOLUTION_SOURCE_LENGTH][CONVOLUTION_CODE_LENGTH]);
+void processPackedConvolution(const byte in[FIRE_CODE_LENGTH/8], byte out[CONVOLUTION_CODE_LENGTH/8]);
 
 
 
@@ -64,4 +97,19 @@ void reverseConvolution(byte in[CONVOLUTION_CODE_LENGTH], byte out[CONVOLUTION_S
 
 
 
+/**
+ * \fn void reverseConvolutionViterbi(const signed char in[], byte out[], unsigned int blocks)
+ * \brief Decodes a batch of previously convoluted messages with a soft-decision Viterbi decoder, correcting transmission errors
+ *
+ * Hard-decided data is decoded as well, once converted with HARD_TO_SOFTBIT().
+ *
+ * \param[in]  in Convoluted data to decode, CONVOLUTION_CODE_LENGTH soft bits per message
+ * \param[out] out Decoded data, CONVOLUTION_SOURCE_LENGTH bits per message (the last 4 being the additional zeroes)
+ * \param[in]  blocks Number of messages to decode
+ */
+void reverseConvolutionViterbi(const signed char in[], byte out[], unsigned int blocks);
+
+
+
+
 #endif
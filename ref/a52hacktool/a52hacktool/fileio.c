@@ -0,0 +1,413 @@
+/*============================================================================*
+ *                                                                            *
+ *                                   fileio.c                                 *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file fileio.c
+  * @brief Block I/O layer: mapped input files, large aligned output buffers and standard streams
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #1
+  * @date 19/10/2026
+  * */
+
+
+
+// open(), mmap(), fstat() and dup() are POSIX extensions of the C99 library
+#define _POSIX_C_SOURCE 200112L
+// Offsets and sizes are 64-bit even on 32-bit systems, for multi-GB traces
+#define _FILE_OFFSET_BITS 64
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "utils.h"
+
+#include "fileio.h"
+
+
+
+
+/**
+ * \fn int fileio_writeAll(int fd, const byte data[], size_t len)
+ * \brief Writes a whole chunk of data to a file descriptor, whatever the number of system calls needed
+ *
+ * \param[in] fd File descriptor
+ * \param[in] data Bytes to write
+ * \param[in] len Number of bytes to write
+ * \return 0 if every byte has been written, non-zero otherwise
+ */
+static int fileio_writeAll(int fd, const byte data[], size_t len) {
+	while (len) {
+		ssize_t written = write(fd, data, len);
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			return 1;
+		}
+		data += written;
+		len  -= written;
+	}
+	return 0;
+}
+
+
+
+
+/**
+ * \fn int fileio_flush(fileio* f)
+ * \brief Writes out the pending bytes of the output buffer
+ *
+ * \param[in, out] f Output file
+ * \return 0 if the buffer has been written, non-zero otherwise
+ */
+static int fileio_flush(fileio* f) {
+	if (f->bufferFill && fileio_writeAll(f->fd, f->buffer, f->bufferFill)) {
+		DEBUG("Error: unable to write to the destination file");
+		f->error = 1;
+	}
+	f->bufferFill = 0;
+	return f->error;
+}
+
+
+
+
+/**
+ * \fn int fileio_init(fileio* f, int fd, int owned, int output)
+ * \brief Initializes a handle: maps regular input files, allocates the output buffer
+ *
+ * \param[out] f Handle to initialize
+ * \param[in]  fd File descriptor
+ * \param[in]  owned Non-zero if the descriptor has to be closed with the handle
+ * \param[in]  output Non-zero for an output file
+ * \return 0 if the handle is usable, non-zero otherwise (the descriptor is then closed if owned)
+ */
+static int fileio_init(fileio* f, int fd, int owned, int output) {
+
+	memset(f, 0, sizeof(fileio));
+	f->fd     = fd;
+	f->owned  = owned;
+	f->output = output;
+
+	if (output) {
+		void* buffer;
+		if (posix_memalign(&buffer, FILEIO_ALIGNMENT, FILEIO_BUFFER_BYTES)) {
+			DEBUG("Error: unable to allocate the output buffer");
+			if (owned)
+				close(fd);
+			return 1;
+		}
+		f->buffer     = buffer;
+		f->bufferSize = FILEIO_BUFFER_BYTES;
+		return 0;
+	}
+
+	// Regular files are mapped as a whole (the mapping must start on a page boundary, so the current
+	// position becomes an offset inside it); anything else is streamed
+	struct stat st;
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode))
+		return 0;
+	off_t position = lseek(fd, 0, SEEK_CUR);
+	if (position < 0 || position >= st.st_size)
+		return 0;
+	f->size = st.st_size - position;
+
+	void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map != MAP_FAILED) {
+		posix_madvise(map, st.st_size, POSIX_MADV_SEQUENTIAL);
+		f->map       = map;
+		f->mapLength = st.st_size;
+		f->mapOffset = position;
+	}
+	return 0;
+}
+
+
+
+
+// Documentation in header file
+int fileio_openInput(fileio* f, const char* filename) {
+
+	if (strcmp(filename, FILEIO_STANDARD_STREAM) == 0)
+		return fileio_init(f, STDIN_FILENO, 0, 0);
+
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		DEBUG("Error: unable to open '%s' for reading", filename);
+		return 1;
+	}
+	return fileio_init(f, fd, 1, 0);
+}
+
+
+
+
+// Documentation in header file
+int fileio_openOutput(fileio* f, const char* filename) {
+
+	if (strcmp(filename, FILEIO_STANDARD_STREAM) == 0) {
+		// The data keep the original standard output, the messages go to the standard error stream
+		fflush(stdout);
+		int fd = dup(STDOUT_FILENO);
+		if (fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+			DEBUG("Error: unable to take over the standard output");
+			if (fd >= 0)
+				close(fd);
+			return 1;
+		}
+		return fileio_init(f, fd, 1, 1);
+	}
+
+	int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0) {
+		DEBUG("Error: unable to open '%s' for writing", filename);
+		return 1;
+	}
+	return fileio_init(f, fd, 1, 1);
+}
+
+
+
+
+// Documentation in header file
+int fileio_attach(fileio* f, int fd, int output) {
+	return fileio_init(f, fd, 0, output);
+}
+
+
+
+
+// Documentation in header file
+size_t fileio_read(fileio* f, const byte** data, size_t len) {
+
+	if (f->output || f->error)
+		return 0;
+
+	if (f->map) {
+		size_t available = MIN((unsigned long long)len, f->mapLength - f->mapOffset);
+		*data = f->map + f->mapOffset;
+		f->mapOffset += available;
+		f->position  += available;
+		return available;
+	}
+
+	// Streamed input: the buffer grows to the largest batch requested
+	if (f->bufferSize < len) {
+		void* buffer;
+		if (posix_memalign(&buffer, FILEIO_ALIGNMENT, MAX(len, (size_t)FILEIO_BUFFER_BYTES))) {
+			DEBUG("Error: unable to allocate the input buffer");
+			f->error = 1;
+			return 0;
+		}
+		free(f->buffer);
+		f->buffer     = buffer;
+		f->bufferSize = MAX(len, (size_t)FILEIO_BUFFER_BYTES);
+	}
+
+	// Pipes deliver data by pieces: the batch is completed unless the end of the stream is reached
+	size_t dataread = 0;
+	while (dataread < len) {
+		ssize_t n = read(f->fd, f->buffer + dataread, len - dataread);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			DEBUG("Error: unable to read from the source file");
+			f->error = 1;
+			break;
+		}
+		if (n == 0)
+			break;
+		dataread += n;
+	}
+
+	*data = f->buffer;
+	f->position += dataread;
+	return dataread;
+}
+
+
+
+
+// Documentation in header file
+int fileio_write(fileio* f, const byte data[], size_t len) {
+
+	if (!f->output || f->error)
+		return 1;
+
+	if (f->bufferFill + len > f->bufferSize && fileio_flush(f))
+		return 1;
+
+	// Chunks larger than the buffer are written directly
+	if (len >= f->bufferSize) {
+		if (fileio_writeAll(f->fd, data, len)) {
+			DEBUG("Error: unable to write to the destination file");
+			f->error = 1;
+			return 1;
+		}
+	} else {
+		memcpy(f->buffer + f->bufferFill, data, len);
+		f->bufferFill += len;
+	}
+
+	f->position += len;
+	return 0;
+}
+
+
+
+
+// Documentation in header file
+int fileio_close(fileio* f) {
+
+	if (f->output)
+		fileio_flush(f);
+	if (f->map)
+		munmap((void*)f->map, f->mapLength);
+	free(f->buffer);
+	if (f->owned && close(f->fd) && f->output) {
+		DEBUG("Error: unable to close the destination file");
+		f->error = 1;
+	}
+
+	f->map    = NULL;
+	f->buffer = NULL;
+	f->owned  = 0;
+	return f->error;
+}
+
+
+
+
+// Documentation in header file
+int fileio_test() {
+
+	int res = 0;
+
+	// Reference data, larger than the output buffer so that every write path is used
+	const size_t length = FILEIO_BUFFER_BYTES + FILEIO_BUFFER_BYTES/2 + 123;
+	byte* reference = malloc(length);
+	byte* check     = malloc(length);
+	FILE* file      = tmpfile();
+	if (!reference || !check || !file) {
+		DEBUG("Self-check aborted: unable to allocate test resources");
+		free(reference);
+		free(check);
+		if (file)
+			fclose(file);
+		return 1;
+	}
+	for (size_t k=0 ; k<length ; ++k)
+		reference[k] = rand() & 0xFF;
+
+
+	// Buffered writing, with small chunks and a chunk larger than the buffer
+	fileio out;
+	size_t written = 0;
+	res |= fileio_attach(&out, fileno(file), 1);
+	for (size_t chunk=1 ; !res && written + chunk <= FILEIO_BUFFER_BYTES/2 ; chunk = chunk*3 + 1) {
+		res |= fileio_write(&out, reference + written, chunk);
+		written += chunk;
+	}
+	res |= fileio_write(&out, reference + written, length - written);
+	res |= fileio_close(&out);
+
+	rewind(file);
+	if (res || fread(check, sizeof(byte), length, file) != length || memcmp(check, reference, length)) {
+		DEBUG("Self-check aborted: the written file differs from the reference data");
+		res = 1;
+	}
+
+
+	// Mapped reading, in batches that do not divide the file size
+	fileio in;
+	rewind(file);
+	if (!res && !fileio_attach(&in, fileno(file), 0)) {
+		const byte* data;
+		size_t offset = 0, dataread;
+		if (!in.map || in.size != length) {
+			DEBUG("Self-check aborted: the regular file has not been mapped");
+			res = 1;
+		}
+		while (!res && (dataread = fileio_read(&in, &data, 4095))) {
+			if (offset + dataread > length || memcmp(data, reference + offset, dataread)) {
+				DEBUG("Self-check aborted: the mapped file differs from the reference data");
+				res = 1;
+			}
+			offset += dataread;
+		}
+		if (fileio_close(&in) || offset != length) {
+			DEBUG("Self-check aborted: the mapped file has not been fully read");
+			res = 1;
+		}
+	} else {
+		res = 1;
+	}
+	fclose(file);
+
+
+	// Streamed reading, from a pipe (kept under the pipe capacity so that no other thread is needed)
+	int pipefd[2];
+	const size_t pipeLength = 50000;
+	if (!res && !pipe(pipefd)) {
+		res |= fileio_writeAll(pipefd[1], reference, pipeLength);
+		close(pipefd[1]);
+
+		const byte* data;
+		size_t offset = 0, dataread;
+		res |= fileio_attach(&in, pipefd[0], 0);
+		if (!res && (in.map || in.size)) {
+			DEBUG("Self-check aborted: the pipe has been handled as a regular file");
+			res = 1;
+		}
+		while (!res && (dataread = fileio_read(&in, &data, 777))) {
+			if (offset + dataread > pipeLength || memcmp(data, reference + offset, dataread)
+			 || (dataread < 777 && offset + dataread != pipeLength)) {
+				DEBUG("Self-check aborted: the streamed data differ from the reference data");
+				res = 1;
+			}
+			offset += dataread;
+		}
+		if (fileio_close(&in) || offset != pipeLength) {
+			DEBUG("Self-check aborted: the pipe has not been fully read");
+			res = 1;
+		}
+		close(pipefd[0]);
+	}
+
+	free(reference);
+	free(check);
+
+	if (!res)
+		DEBUG("Self-check succeeded: mapped, streamed and buffered I/O return the original data");
+
+	return res;
+}
@@ -0,0 +1,181 @@
+/*============================================================================*
+ *                                                                            *
+ *                                   fileio.h                                 *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file fileio.h
+  * @brief Block I/O layer: mapped input files, large aligned output buffers and standard streams
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #1
+  * @date 19/10/2026
+  * */
+
+
+
+#ifndef _FILEIO_H_
+#define _FILEIO_H_
+
+#include <stddef.h>
+
+#include "utils.h"
+
+
+// Input files are mapped in memory whenever possible, so that batches are handed out without any copy or system
+// call; pipes, terminals and unmappable files are read through a large buffer instead. Output data are gathered in
+// a large page-aligned buffer, written out with a single system call when it is full.
+
+//! File name designating the standard input (as a source) or the standard output (as a destination)
+#define FILEIO_STANDARD_STREAM "-"
+
+//! Size of the output buffer (and minimal size of the input buffer of streamed files), in bytes
+#define FILEIO_BUFFER_BYTES (1<<22)
+
+//! Alignment of the buffers, in bytes (a memory page)
+#define FILEIO_ALIGNMENT 4096
+
+
+
+
+/**
+ * \struct fileio
+ * \brief Input or output file handled by the I/O layer
+ */
+typedef struct {
+	int fd;                       //!< File descriptor
+	int owned;                    //!< Non-zero if the descriptor has been opened by the I/O layer (and is closed with it)
+	int output;                   //!< Non-zero for an output file
+	int error;                    //!< Non-zero once a read or write error occurred
+	const byte* map;              //!< Mapped input file (NULL if the input is streamed)
+	unsigned long long mapLength; //!< Length of the mapping, in bytes
+	unsigned long long mapOffset; //!< Offset of the next byte to hand out inside the mapping
+	unsigned long long size;      //!< Number of bytes available from the initial position (0 if unknown)
+	unsigned long long position;  //!< Number of bytes read or written so far
+	byte* buffer;                 //!< Aligned staging buffer (streamed input, or output)
+	size_t bufferSize;            //!< Size of the staging buffer, in bytes
+	size_t bufferFill;            //!< Number of pending bytes in the output buffer
+} fileio;
+
+
+
+
+/**
+ * \fn int fileio_openInput(fileio* f, const char* filename)
+ * \brief Opens a file for reading
+ *
+ * \param[out] f Handle to initialize
+ * \param[in]  filename Path of the file, or FILEIO_STANDARD_STREAM for the standard input
+ * \return 0 if the file has been opened, non-zero otherwise
+ */
+int fileio_openInput(fileio* f, const char* filename);
+
+
+
+
+/**
+ * \fn int fileio_openOutput(fileio* f, const char* filename)
+ * \brief Creates (or truncates) a file for writing
+ *
+ * When the data are written to the standard output, the messages of the tool (which use printf) are redirected
+ * to the standard error stream, so that they do not get mixed with the data.
+ *
+ * \param[out] f Handle to initialize
+ * \param[in]  filename Path of the file, or FILEIO_STANDARD_STREAM for the standard output
+ * \return 0 if the file has been opened, non-zero otherwise
+ */
+int fileio_openOutput(fileio* f, const char* filename);
+
+
+
+
+/**
+ * \fn int fileio_attach(fileio* f, int fd, int output)
+ * \brief Handles an already opened file descriptor, from its current position (the descriptor is not closed with f)
+ *
+ * \param[out] f Handle to initialize
+ * \param[in]  fd File descriptor
+ * \param[in]  output Non-zero if the descriptor is to be written to, zero if it is to be read from
+ * \return 0 if the descriptor can be used, non-zero otherwise
+ */
+int fileio_attach(fileio* f, int fd, int output);
+
+
+
+
+/**
+ * \fn size_t fileio_read(fileio* f, const byte** data, size_t len)
+ * \brief Hands out the next bytes of an input file, without copy if it is mapped
+ *
+ * Fewer than \a len bytes are only returned at the end of the file (or on error, see fileio::error).
+ * The data remain valid until the next call on \a f.
+ *
+ * \param[in, out] f Input file
+ * \param[out]     data Pointer to the bytes read
+ * \param[in]      len Number of bytes wanted
+ * \return Number of bytes read (0 at the end of the file)
+ */
+size_t fileio_read(fileio* f, const byte** data, size_t len);
+
+
+
+
+/**
+ * \fn int fileio_write(fileio* f, const byte data[], size_t len)
+ * \brief Appends bytes to an output file (through its buffer)
+ *
+ * \param[in, out] f Output file
+ * \param[in]      data Bytes to write
+ * \param[in]      len Number of bytes to write
+ * \return 0 if the bytes have been buffered or written, non-zero otherwise
+ */
+int fileio_write(fileio* f, const byte data[], size_t len);
+
+
+
+
+/**
+ * \fn int fileio_close(fileio* f)
+ * \brief Flushes an output file, unmaps an input file, and releases the resources of the handle
+ *
+ * \param[in, out] f File to close
+ * \return 0 if every byte has been read or written without error, non-zero otherwise
+ */
+int fileio_close(fileio* f);
+
+
+
+
+/**
+ * \fn int fileio_test()
+ * \brief Autotests the mapped and streamed reading paths and the buffered writing path
+ *
+ * \return 0 if the test is successfull, non-zero otherwise
+ */
+int fileio_test();
+
+
+
+
+#endif
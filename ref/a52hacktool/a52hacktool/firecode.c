@@ -29,14 +29,15 @@
   * @brief Implementation of first encoding phase: Fire code (CRC)
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #9
-  * @date 24/06/2011
+  * @version File Revision #12
+  * @date 19/10/2026
   * */
 
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "utils.h"
 #include "firecode.h"
@@ -54,12 +55,15 @@ char polynomial_mirrored[FIRE_POLYNOMIAL_LENGTH] = {1,0,0,1,0,0,0,0,0,0,0,0,0,0,
 
 
 // Documentation in header file
-void processFireGMatrix(byte G[FIRE_SOURCE_LENGTH][FIRE_CODE_LENGTH]) {
+void processFireGMatrix(bitmatrix* G) {
 
-	memset(G, 0, FIRE_SOURCE_LENGTH*FIRE_CODE_LENGTH*sizeof(byte));
+	bitmatrix_zero(G);
 
 	for (int i=0 ; i<FIRE_SOURCE_LENGTH ; ++i) {
-		memcpy(G[i]+i, polynomial_mirrored, 41*sizeof(byte));
+		for (int k=0 ; k<FIRE_POLYNOMIAL_LENGTH ; ++k) {
+			if (polynomial_mirrored[k])
+				BITMATRIX_SET(G, i, i+k, 1);
+		}
 	}
 
 	// We assume the standard form of the matrix (1 diag first):
@@ -68,13 +72,11 @@ void processFireGMatrix(byte G[FIRE_SOURCE_LENGTH][FIRE_CODE_LENGTH]) {
 	// 001xxxxx...
 	// 0001xxxx...
 	// ...........
-	// We now proceed a Gauss elimination
+	// We now proceed a Gauss elimination (row #col is null before column #col: whole rows can be added)
 	for (int col=0 ; col<FIRE_SOURCE_LENGTH ; ++col) {
 		for (int line=(col-1) ; line>=0 ; --line) {
-			if (G[line][col]) {
-				for (int c=col ; c<FIRE_CODE_LENGTH ; ++c)
-					G[line][c] ^= G[col][c];
-			}
+			if (BITMATRIX_GET(G, line, col))
+				bitmatrix_xorWords(BITMATRIX_ROW(G, line), BITMATRIX_ROW(G, col), G->stride);
 		}
 	}
 
@@ -84,15 +86,15 @@ void processFireGMatrix(byte G[FIRE_SOURCE_LENGTH][FIRE_CODE_LENGTH]) {
 
 
 // Documentation in header file
-void processFireHMatrix(byte H[FIRE_CRC_LENGTH][FIRE_CODE_LENGTH], byte G[FIRE_SOURCE_LENGTH][FIRE_CODE_LENGTH]) {
+void processFireHMatrix(bitmatrix* H, const bitmatrix* G) {
 
-	memset(H, 0, FIRE_CRC_LENGTH*FIRE_CODE_LENGTH*sizeof(byte));
+	bitmatrix_zero(H);
 
 	for (int i=0 ; i<FIRE_CRC_LENGTH ; ++i) {
 		for (int j=0; j<FIRE_SOURCE_LENGTH; ++j) {
-			H[i][j] = G[j][i+FIRE_SOURCE_LENGTH];
+			BITMATRIX_SET(H, i, j, BITMATRIX_GET(G, j, i+FIRE_SOURCE_LENGTH));
 		}
-		H[i][FIRE_SOURCE_LENGTH+i] = 1;
+		BITMATRIX_SET(H, i, FIRE_SOURCE_LENGTH+i, 1);
 	}
 
 }
@@ -100,30 +102,112 @@ void processFireHMatrix(byte H[FIRE_CRC_LENGTH][FIRE_CODE_LENGTH], byte G[FIRE_S
 
 
 
+//! CRC-40 remainders of every byte value (MSB-first), filled in once by fire_buildCRCTable()
+unsigned long long fire_crcTable[256];
+
+//! Ensures that the CRC table is computed exactly once
+pthread_once_t fire_crcTableOnce = PTHREAD_ONCE_INIT;
+
+
+
+
+/**
+ * \fn void fire_buildCRCTable()
+ * \brief Computes the CRC table (called once through pthread_once)
+ */
+void fire_buildCRCTable() {
+
+	for (int value=0 ; value<256 ; ++value) {
+		unsigned long long crc = (unsigned long long)value << (FIRE_CRC_LENGTH-8);
+		for (int b=0 ; b<8 ; ++b) {
+			crc = (crc & (1ULL << (FIRE_CRC_LENGTH-1))) ? (crc << 1) ^ FIRE_PACKED_POLYNOMIAL : (crc << 1);
+		}
+		fire_crcTable[value] = crc & ((1ULL << FIRE_CRC_LENGTH) - 1);
+	}
+}
+
+
+
+
+/**
+ * \fn unsigned long long fire_crc(const byte in[], int len)
+ * \brief Computes the CRC-40 of packed data, i.e. the remainder of in(D)×D^40 divided by the polynomial
+ *
+ * \param[in] in Data (8 bits per byte, first bit = highest degree)
+ * \param[in] len Length of the data (in bytes)
+ * \return CRC (FIRE_CRC_LENGTH lower bits, highest degree first)
+ */
+unsigned long long fire_crc(const byte in[], int len) {
+
+	pthread_once(&fire_crcTableOnce, fire_buildCRCTable);
+
+	unsigned long long crc = 0;
+	for (int i=0 ; i<len ; ++i) {
+		crc = ((crc << 8) & ((1ULL << FIRE_CRC_LENGTH) - 1)) ^ fire_crcTable[(crc >> (FIRE_CRC_LENGTH-8)) ^ in[i]];
+	}
+	return crc;
+}
+
+
+
+
 // Documentation in header file
-void reverseFire(byte in[FIRE_CODE_LENGTH], byte out[FIRE_SOURCE_LENGTH]){
+void processPackedFire(const byte in[FIRE_SOURCE_LENGTH/8], byte out[FIRE_CODE_LENGTH/8]) {
+
+	unsigned long long crc = fire_crc(in, FIRE_SOURCE_LENGTH/8);
+
+	memcpy(out, in, (FIRE_SOURCE_LENGTH/8)*sizeof(byte));
+	for (int i=0 ; i<FIRE_CRC_LENGTH/8 ; ++i) {
+		out[FIRE_SOURCE_LENGTH/8 + i] = (byte)(crc >> (FIRE_CRC_LENGTH - 8*(i+1)));
+	}
+}
 
-	memset(out, 0, FIRE_SOURCE_LENGTH*sizeof(byte));
 
-	byte G[FIRE_SOURCE_LENGTH][FIRE_CODE_LENGTH];
-	processFireGMatrix(G);
 
-	byte H[FIRE_CRC_LENGTH][FIRE_CODE_LENGTH];
-	processFireHMatrix(H, G);
 
-	// Matrix Multiplication (code decoding)
-	byte decoded[FIRE_SOURCE_LENGTH];
-	memset(decoded, 0, FIRE_SOURCE_LENGTH*sizeof(byte));
+// Documentation in header file
+FireStatus reverseFire(byte in[FIRE_CODE_LENGTH], byte out[FIRE_SOURCE_LENGTH]){
 
+	memcpy(out, in, FIRE_SOURCE_LENGTH*sizeof(byte));
+
+	// Syndrome: remainder of the received word, i.e. CRC of the source part XOR the received CRC
+	byte packed[FIRE_SOURCE_LENGTH/8];
+	BIT_VECTOR_TO_BYTE_VECTOR(in, packed, FIRE_SOURCE_LENGTH);
+	unsigned long long syndrome = fire_crc(packed, FIRE_SOURCE_LENGTH/8);
 	for (int i=0 ; i<FIRE_CRC_LENGTH ; ++i) {
-		for (int j=0 ; j<FIRE_CODE_LENGTH ; ++j) {
-			decoded[i] ^= in[j] & H[i][j];
-		}
-		// This prevented from having a non null syndrome, since non codewords make it return all 0s
-		if (decoded[i]) {
-			if(DEBUG_INFO) printf("Error checking CRC\n");
+		syndrome ^= (unsigned long long)(in[FIRE_SOURCE_LENGTH+i] & 1) << (FIRE_CRC_LENGTH-1-i);
+	}
+
+	if (!syndrome)
+		return FIRE_VALID;
+
+	// A burst B(D) ending at bit #(FIRE_CODE_LENGTH-1-shift) gives the syndrome D^shift × B(D): it is
+	// trapped when the syndrome, multiplied by D^-1 for each shift, fits in FIRE_CORRECTABLE_BURST bits
+	const unsigned long long polynomial = FIRE_PACKED_POLYNOMIAL | (1ULL << FIRE_CRC_LENGTH);
+	for (int shift=0 ; shift<FIRE_CODE_LENGTH ; ++shift) {
+
+		if (syndrome < (1ULL << FIRE_CORRECTABLE_BURST)) {
+
+			int length = 0;
+			while (syndrome >> length) ++length;
+			if (shift + length > FIRE_CODE_LENGTH)
+				break; // The burst would start before the message
+
+			for (int d=0 ; d<length ; ++d) {
+				int bit = FIRE_CODE_LENGTH-1 - shift - d;
+				if (bit < FIRE_SOURCE_LENGTH)
+					out[bit] ^= (syndrome >> d) & 1;
+			}
+			if(DEBUG_INFO) printf("Corrected a burst of %d errors ending at bit #%d\n", length, FIRE_CODE_LENGTH-1-shift);
+			return FIRE_CORRECTED;
 		}
+
+		// Multiplication by D^-1 (the polynomial being odd, D is invertible)
+		if (syndrome & 1)
+			syndrome ^= polynomial;
+		syndrome >>= 1;
 	}
-	if(DEBUG_INFO) DUMP_CHAR_VECTOR(decoded, FIRE_CRC_LENGTH, "decoding check (must be all 0)");
-	memcpy(out, in, FIRE_SOURCE_LENGTH*sizeof(byte));
+
+	if(DEBUG_INFO) printf("Error checking CRC\n");
+	return FIRE_UNCORRECTABLE;
 }
@@ -29,8 +29,8 @@
   * @brief Specification of first encoding phase: Fire code (CRC)
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #9
-  * @date 24/06/2011
+  * @version File Revision #12
+  * @date 19/10/2026
   * */
 
 
@@ -38,41 +38,72 @@
 #define _FIRECODE_H_
 
 #include "const_code.h"
+#include "bitmatrix.h"
 
 
 
 
 /**
- * \fn void processFireGMatrix(byte G[FIRE_SOURCE_LENGTH][FIRE_CODE_LENGTH])
+ * \enum FireStatus
+ * \brief Outcome of the Fire decoding of a message
+ */
+typedef enum {
+	FIRE_VALID,         //!< The CRC matches: no transmission error was detected
+	FIRE_CORRECTED,     //!< A burst of at most FIRE_CORRECTABLE_BURST errors was detected and corrected
+	FIRE_UNCORRECTABLE  //!< The errors can't be corrected: the message is returned as received
+} FireStatus;
+
+
+
+
+/**
+ * \fn void processFireGMatrix(bitmatrix* G)
  * \brief Calculates the encoding matrix corresponding to the Fire encoding step
  *
- * \param[out] G Fire encoding matrix
+ * \param[out] G Fire encoding matrix, FIRE_SOURCE_LENGTH x FIRE_CODE_LENGTH
  */
-void processFireGMatrix(byte G[FIRE_SOURCE_LENGTH][FIRE_CODE_LENGTH]);
+void processFireGMatrix(bitmatrix* G);
 
 
 
 
 /**
- * \fn void processFireHMatrix(byte H[FIRE_CRC_LENGTH][FIRE_CODE_LENGTH], byte G[FIRE_SOURCE_LENGTH][FIRE_CODE_LENGTH])
+ * \fn void processFireHMatrix(bitmatrix* H, const bitmatrix* G)
  * \brief Calculates the parity-check matrix H corresponding to the Fire encoding step from the Fire encoding matrix G
  *
- * \param[out] H Fire parity-check matrix
+ * \param[out] H Fire parity-check matrix, FIRE_CRC_LENGTH x FIRE_CODE_LENGTH
  * \param[in]  G Fire encoding matrix
  */
-void processFireHMatrix(byte H[FIRE_CRC_LENGTH][FIRE_CODE_LENGTH], byte G[FIRE_SOURCE_LENGTH][FIRE_CODE_LENGTH]);
+void processFireHMatrix(bitmatrix* H, const bitmatrix* G);
+
+
+
+
+/**
+ * \fn void processPackedFire(const byte in[FIRE_SOURCE_LENGTH/8], byte out[FIRE_CODE_LENGTH/8])
+ * \brief Fire-encodes a message on packed data, using a table-driven CRC-40 (bit-exact with processFireGMatrix())
+ *
+ * \param[in]  in Data to encode (8 bits per byte)
+ * \param[out] out Fire-encoded data (8 bits per byte): the source bits followed by the 40 CRC bits
+ */
+void processPackedFire(const byte in[FIRE_SOURCE_LENGTH/8], byte out[FIRE_CODE_LENGTH/8]);
 
 
 
 
 /**
- * \fn void reverseFire(byte in[FIRE_CODE_LENGTH], byte out[FIRE_SOURCE_LENGTH])
- * \brief Decodes a previously Fire-encoded message
+ * \fn FireStatus reverseFire(byte in[FIRE_CODE_LENGTH], byte out[FIRE_SOURCE_LENGTH])
+ * \brief Decodes a previously Fire-encoded message, correcting a burst of at most FIRE_CORRECTABLE_BURST errors
+ *
+ * The syndrome is computed with the same table-driven CRC-40 as processPackedFire(). A non-null syndrome is
+ * then multiplied by D^-1 (modulo the polynomial) until it fits in FIRE_CORRECTABLE_BURST bits, which
+ * traps the burst of errors and gives its position (error trapping decoding).
  *
  * \param[in]  in Fire-encoded data to decode
  * \param[out] out Decoded data
+ * \return Whether the message was valid, corrected or uncorrectable
  */
-void reverseFire(byte in[FIRE_CODE_LENGTH], byte out[FIRE_SOURCE_LENGTH]);
+FireStatus reverseFire(byte in[FIRE_CODE_LENGTH], byte out[FIRE_SOURCE_LENGTH]);
 
 
 
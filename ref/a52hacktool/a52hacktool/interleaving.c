@@ -29,14 +29,18 @@
   * @brief Implementation of third encoding & decoding phase: Interleaving
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #8
-  * @date 24/06/2011
+  * @version File Revision #12
+  * @date 19/10/2026
   * */
 
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
 
 #include "utils.h"
 #include "const_code.h"
@@ -45,10 +49,37 @@
 
 
 
-// Documentation in header file
-void processInterleavingGMatrix(byte G[INTERLEAVING_LENGTH][INTERLEAVING_LENGTH]) {
+// Burst layout: bit k of a block goes to burst k%4, at position 2*((49k)%57) + (k%8)/4. Splitting the block
+// into 8 streams of 57 bits (bit m of stream t being bit 8m+t of the block), stream t lands on the even
+// (t<4) or odd (t>=4) positions of burst t%4, bit m going to position (50m + 49t)%57 of these positions:
+// every stream undergoes the same permutation m -> 50m%57, followed by a rotation of (49t)%57.
+
+//! Mask of the 57 bits of a stream
+#define STREAM_MASK ((1ULL << INTERLEAVING_STREAM_LENGTH) - 1)
+
+//! Source bit of every interleaved bit, filled in once by interleaving_buildTables()
+unsigned short interleaving_permutation[INTERLEAVING_LENGTH];
+
+//! Permutation m -> 50m%57 of a stream, 8 bits at a time: [chunk][byte value] gives the permuted bits
+unsigned long long interleaving_scatter[8][256];
+
+//! Inverse permutation of a stream, 8 bits at a time
+unsigned long long interleaving_gather[8][256];
+
+//! Rotation applied to each stream after the permutation
+int interleaving_rotation[8];
+
+//! Ensures that the tables are computed exactly once
+pthread_once_t interleaving_tablesOnce = PTHREAD_ONCE_INIT;
+
+
 
-	memset(G, 0, INTERLEAVING_LENGTH*INTERLEAVING_LENGTH*sizeof(byte));
+
+/**
+ * \fn void interleaving_buildTables()
+ * \brief Computes the interleaving permutation and the burst engine tables (called once through pthread_once)
+ */
+void interleaving_buildTables() {
 
 	unsigned int B[8][114];
 	memset(B, 0, 8*114*sizeof(unsigned int));
@@ -60,35 +91,340 @@ void processInterleavingGMatrix(byte G[INTERLEAVING_LENGTH][INTERLEAVING_LENGTH]
 	int i=0;
 	for(int k=0; k<4; ++k){
 		for(int j=0; j<57; ++j){
-			G[B[k][2*j]][i] = 1;
-			i++;
-			G[B[k+4][2*j+1]][i] = 1;
-			i++;
+			interleaving_permutation[i++] = B[k][2*j];
+			interleaving_permutation[i++] = B[k+4][2*j+1];
+		}
+	}
+
+	memset(interleaving_scatter, 0, 8*256*sizeof(unsigned long long));
+	memset(interleaving_gather,  0, 8*256*sizeof(unsigned long long));
+	for (int chunk=0 ; chunk<8 ; ++chunk) {
+		for (int value=0 ; value<256 ; ++value) {
+			for (int b=0 ; b<8 && 8*chunk+b<INTERLEAVING_STREAM_LENGTH ; ++b) {
+				if ((value >> b) & 1) {
+					int m = 8*chunk + b;
+					int j = (50*m) % INTERLEAVING_STREAM_LENGTH;
+					interleaving_scatter[chunk][value] |= 1ULL << j;
+				}
+			}
+		}
+	}
+	for (int m=0 ; m<INTERLEAVING_STREAM_LENGTH ; ++m) {
+		int j = (50*m) % INTERLEAVING_STREAM_LENGTH;
+		for (int value=0 ; value<256 ; ++value) {
+			if ((value >> (j%8)) & 1)
+				interleaving_gather[j/8][value] |= 1ULL << m;
+		}
+	}
+
+	for (int t=0 ; t<8 ; ++t) {
+		interleaving_rotation[t] = (49*t) % INTERLEAVING_STREAM_LENGTH;
+	}
+}
+
+
+
+
+/**
+ * \fn unsigned long long interleaving_transpose8(unsigned long long x)
+ * \brief Transposes an 8×8 bit matrix: bit #(8r+c) and bit #(8c+r) are swapped
+ *
+ * \param[in] x Bit matrix (byte r being row r)
+ * \return Transposed bit matrix
+ */
+unsigned long long interleaving_transpose8(unsigned long long x) {
+	unsigned long long t;
+	t = (x ^ (x >>  7)) & 0x00AA00AA00AA00AAULL; x ^= t ^ (t <<  7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL; x ^= t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL; x ^= t ^ (t << 28);
+	return x;
+}
+
+
+
+
+/**
+ * \fn unsigned long long interleaving_spread(unsigned long long x)
+ * \brief Spreads the 32 lower bits of \a x over the even bits of the result (bit j goes to bit 2j)
+ *
+ * \param[in] x Bits to spread
+ * \return Spread bits
+ */
+unsigned long long interleaving_spread(unsigned long long x) {
+#if defined(__BMI2__)
+	return _pdep_u64(x, 0x5555555555555555ULL);
+#else
+	x &= 0x00000000FFFFFFFFULL;
+	x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+	x = (x | (x <<  8)) & 0x00FF00FF00FF00FFULL;
+	x = (x | (x <<  4)) & 0x0F0F0F0F0F0F0F0FULL;
+	x = (x | (x <<  2)) & 0x3333333333333333ULL;
+	x = (x | (x <<  1)) & 0x5555555555555555ULL;
+	return x;
+#endif
+}
+
+
+
+
+/**
+ * \fn unsigned long long interleaving_compress(unsigned long long x)
+ * \brief Gathers the even bits of \a x into the 32 lower bits of the result (bit 2j goes to bit j)
+ *
+ * \param[in] x Bits to compress
+ * \return Compressed bits
+ */
+unsigned long long interleaving_compress(unsigned long long x) {
+#if defined(__BMI2__)
+	return _pext_u64(x, 0x5555555555555555ULL);
+#else
+	x &= 0x5555555555555555ULL;
+	x = (x | (x >>  1)) & 0x3333333333333333ULL;
+	x = (x | (x >>  2)) & 0x0F0F0F0F0F0F0F0FULL;
+	x = (x | (x >>  4)) & 0x00FF00FF00FF00FFULL;
+	x = (x | (x >>  8)) & 0x0000FFFF0000FFFFULL;
+	x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+	return x;
+#endif
+}
+
+
+
+
+/**
+ * \fn unsigned long long interleaving_reverseBytes(unsigned long long x)
+ * \brief Reverses the order of the bits inside each byte of \a x (packed data is MSB first, bursts are handled LSB first)
+ *
+ * \param[in] x Bytes to process
+ * \return Bit-reversed bytes
+ */
+unsigned long long interleaving_reverseBytes(unsigned long long x) {
+	x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+	x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+	x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+	return x;
+}
+
+
+
+
+/**
+ * \fn void interleaving_toBursts(const byte in[INTERLEAVING_LENGTH/8], unsigned long long bursts[INTERLEAVING_BURSTS][2])
+ * \brief Interleaves a packed block into its bursts (bit p of a burst is bit p%64 of word p/64)
+ *
+ * \param[in]  in Data to interleave (8 bits per byte)
+ * \param[out] bursts Interleaved bursts
+ */
+void interleaving_toBursts(const byte in[INTERLEAVING_LENGTH/8], unsigned long long bursts[INTERLEAVING_BURSTS][2]) {
+
+	byte padded[64] = {0};
+	memcpy(padded, in, (INTERLEAVING_LENGTH/8)*sizeof(byte));
+
+	// Demultiplexing into the 8 streams 8 bytes at a time, each stream being permuted on the fly
+	unsigned long long streams[8] = {0};
+	for (int chunk=0 ; chunk<8 ; ++chunk) {
+		unsigned long long x = 0;
+		for (int i=0 ; i<8 ; ++i) {
+			x |= (unsigned long long)padded[8*chunk+i] << (8*i);
+		}
+		x = interleaving_transpose8(x);
+		for (int t=0 ; t<8 ; ++t) {
+			streams[t] |= interleaving_scatter[chunk][(x >> (8*(7-t))) & 0xFF];
 		}
 	}
 
+	// Streams t and t+4 fill the even and odd positions of burst t, once rotated
+	for (int t=0 ; t<8 ; ++t) {
+		int c = interleaving_rotation[t];
+		streams[t] = ((streams[t] << c) | (streams[t] >> (INTERLEAVING_STREAM_LENGTH - c))) & STREAM_MASK;
+	}
+	for (int r=0 ; r<INTERLEAVING_BURSTS ; ++r) {
+		bursts[r][0] = interleaving_spread(streams[r])       | (interleaving_spread(streams[r+4])       << 1);
+		bursts[r][1] = interleaving_spread(streams[r] >> 32) | (interleaving_spread(streams[r+4] >> 32) << 1);
+	}
+}
+
+
+
+
+/**
+ * \fn void interleaving_fromBursts(const unsigned long long bursts[INTERLEAVING_BURSTS][2], byte out[INTERLEAVING_LENGTH/8])
+ * \brief Deinterleaves bursts (bit p of a burst is bit p%64 of word p/64) into a packed block
+ *
+ * \param[in]  bursts Interleaved bursts
+ * \param[out] out Deinterleaved data (8 bits per byte)
+ */
+void interleaving_fromBursts(const unsigned long long bursts[INTERLEAVING_BURSTS][2], byte out[INTERLEAVING_LENGTH/8]) {
+
+	unsigned long long streams[8];
+	for (int r=0 ; r<INTERLEAVING_BURSTS ; ++r) {
+		streams[r]   = interleaving_compress(bursts[r][0])      | (interleaving_compress(bursts[r][1])      << 32);
+		streams[r+4] = interleaving_compress(bursts[r][0] >> 1) | (interleaving_compress(bursts[r][1] >> 1) << 32);
+	}
+	for (int t=0 ; t<8 ; ++t) {
+		int c = interleaving_rotation[t];
+		streams[t] = ((streams[t] >> c) | (streams[t] << (INTERLEAVING_STREAM_LENGTH - c))) & STREAM_MASK;
+	}
+
+	// Inverse permutation of the streams, then multiplexing 8 bytes at a time
+	for (int t=0 ; t<8 ; ++t) {
+		unsigned long long permuted = streams[t];
+		streams[t] = 0;
+		for (int chunk=0 ; chunk<8 ; ++chunk) {
+			streams[t] |= interleaving_gather[chunk][(permuted >> (8*chunk)) & 0xFF];
+		}
+	}
+	byte padded[64];
+	for (int chunk=0 ; chunk<8 ; ++chunk) {
+		unsigned long long x = 0;
+		for (int t=0 ; t<8 ; ++t) {
+			x |= ((streams[t] >> (8*chunk)) & 0xFF) << (8*(7-t));
+		}
+		x = interleaving_transpose8(x);
+		for (int i=0 ; i<8 ; ++i) {
+			padded[8*chunk+i] = (byte)(x >> (8*i));
+		}
+	}
+	memcpy(out, padded, (INTERLEAVING_LENGTH/8)*sizeof(byte));
 }
 
 
 
 
 // Documentation in header file
-void reverseInterleaving(byte in[INTERLEAVING_LENGTH], byte out[INTERLEAVING_LENGTH]) {
+void processInterleavingGMatrix(bitmatrix* G) {
 
-	memset(out, 0, CONVOLUTION_SOURCE_LENGTH*sizeof(byte));
+	pthread_once(&interleaving_tablesOnce, interleaving_buildTables);
 
-	unsigned int B[8][114];
-	memset(B, 0, 8*114*sizeof(unsigned int));
+	bitmatrix_zero(G);
 
-	for (int k=0 ; k<INTERLEAVING_LENGTH ; ++k) {
-		B[k%8][(2*((49*k)%57) + ((k%8)/4))] = k;
+	for (int i=0 ; i<INTERLEAVING_LENGTH ; ++i) {
+		BITMATRIX_SET(G, interleaving_permutation[i], i, 1);
 	}
 
-	int i=0;
-	for(int k=0; k<4; ++k){
-		for(int j=0; j<57; ++j){
-			out[B[k][2*j]] = in[i++];
-			out[B[k+4][2*j+1]] = in[i++];
+}
+
+
+
+
+// Documentation in header file
+void processPackedInterleaving(const byte in[INTERLEAVING_LENGTH/8], byte out[INTERLEAVING_LENGTH/8]) {
+
+	// The 4 bursts are consecutive in the interleaved block
+	byte bursts[INTERLEAVING_BURSTS*INTERLEAVING_BURST_BYTES];
+	interleaveBursts(in, bursts, 1);
+	joinBursts(bursts, out, 1);
+}
+
+
+
+
+// Documentation in header file
+void interleaveBursts(const byte blocks[], byte bursts[], unsigned int count) {
+
+	pthread_once(&interleaving_tablesOnce, interleaving_buildTables);
+
+	unsigned long long words[INTERLEAVING_BURSTS][2];
+	for (unsigned int b=0 ; b<count ; ++b) {
+
+		interleaving_toBursts(blocks + b*(INTERLEAVING_LENGTH/8), words);
+
+		byte* burst = bursts + b*INTERLEAVING_BURSTS*INTERLEAVING_BURST_BYTES;
+		for (int r=0 ; r<INTERLEAVING_BURSTS ; ++r, burst+=INTERLEAVING_BURST_BYTES) {
+			unsigned long long low = interleaving_reverseBytes(words[r][0]), high = interleaving_reverseBytes(words[r][1]);
+			for (int k=0 ; k<8 ; ++k) {
+				burst[k] = (byte)(low >> (8*k));
+			}
+			for (int k=8 ; k<INTERLEAVING_BURST_BYTES ; ++k) {
+				burst[k] = (byte)(high >> (8*(k-8)));
+			}
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+void deinterleaveBursts(const byte bursts[], byte blocks[], unsigned int count) {
+
+	pthread_once(&interleaving_tablesOnce, interleaving_buildTables);
+
+	unsigned long long words[INTERLEAVING_BURSTS][2];
+	for (unsigned int b=0 ; b<count ; ++b) {
+
+		const byte* burst = bursts + b*INTERLEAVING_BURSTS*INTERLEAVING_BURST_BYTES;
+		for (int r=0 ; r<INTERLEAVING_BURSTS ; ++r, burst+=INTERLEAVING_BURST_BYTES) {
+			unsigned long long low = 0, high = 0;
+			for (int k=0 ; k<8 ; ++k) {
+				low |= (unsigned long long)burst[k] << (8*k);
+			}
+			for (int k=8 ; k<INTERLEAVING_BURST_BYTES ; ++k) {
+				high |= (unsigned long long)burst[k] << (8*(k-8));
+			}
+			words[r][0] = interleaving_reverseBytes(low);
+			words[r][1] = interleaving_reverseBytes(high) & ((1ULL << (INTERLEAVING_BURST_LENGTH-64)) - 1); // Padding bits are ignored
 		}
+
+		interleaving_fromBursts(words, blocks + b*(INTERLEAVING_LENGTH/8));
+	}
+}
+
+
+
+
+// Documentation in header file
+void joinBursts(const byte bursts[], byte blocks[], unsigned int count) {
+
+	for (unsigned int b=0 ; b<count ; ++b) {
+
+		byte* out = blocks + b*(INTERLEAVING_LENGTH/8);
+		memset(out, 0, (INTERLEAVING_LENGTH/8)*sizeof(byte));
+
+		// Padding bits of the bursts are null: they can be ORed with the first bits of the next burst
+		for (int r=0 ; r<INTERLEAVING_BURSTS ; ++r) {
+			const byte* burst = bursts + (b*INTERLEAVING_BURSTS + r)*INTERLEAVING_BURST_BYTES;
+			int first = (r*INTERLEAVING_BURST_LENGTH) / 8, shift = (r*INTERLEAVING_BURST_LENGTH) % 8;
+			for (int k=0 ; k<INTERLEAVING_BURST_BYTES ; ++k) {
+				out[first+k] |= burst[k] >> shift;
+				if (shift && first+k+1 < INTERLEAVING_LENGTH/8)
+					out[first+k+1] |= (byte)(burst[k] << (8-shift));
+			}
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+void splitBursts(const byte blocks[], byte bursts[], unsigned int count) {
+
+	for (unsigned int b=0 ; b<count ; ++b) {
+
+		const byte* in = blocks + b*(INTERLEAVING_LENGTH/8);
+		for (int r=0 ; r<INTERLEAVING_BURSTS ; ++r) {
+			byte* burst = bursts + (b*INTERLEAVING_BURSTS + r)*INTERLEAVING_BURST_BYTES;
+			int first = (r*INTERLEAVING_BURST_LENGTH) / 8, shift = (r*INTERLEAVING_BURST_LENGTH) % 8;
+			for (int k=0 ; k<INTERLEAVING_BURST_BYTES ; ++k) {
+				burst[k] = (byte)(in[first+k] << shift);
+				if (shift && first+k+1 < INTERLEAVING_LENGTH/8)
+					burst[k] |= in[first+k+1] >> (8-shift);
+			}
+			burst[INTERLEAVING_BURST_BYTES-1] &= (byte)(0xFF << (8*INTERLEAVING_BURST_BYTES - INTERLEAVING_BURST_LENGTH));
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+void reverseInterleaving(byte in[INTERLEAVING_LENGTH], byte out[INTERLEAVING_LENGTH]) {
+
+	pthread_once(&interleaving_tablesOnce, interleaving_buildTables);
+
+	for (int i=0 ; i<INTERLEAVING_LENGTH ; ++i) {
+		out[interleaving_permutation[i]] = in[i];
 	}
 }
@@ -29,8 +29,8 @@
   * @brief Specification of third encoding & decoding phase: Interleaving
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #7
-  * @date 24/06/2011
+  * @version File Revision #11
+  * @date 19/10/2026
   * */
 
 
@@ -38,17 +38,82 @@
 #define _INTERLEAVING_H_
 
 #include "const_code.h"
+#include "bitmatrix.h"
 
 
 
 
 /**
- * \fn void processInterleavingGMatrix(byte G[INTERLEAVING_LENGTH][INTERLEAVING_LENGTH])
+ * \fn void processInterleavingGMatrix(bitmatrix* G)
  * \brief Calculates the encoding matrix corresponding to the Interleaving encoding step
  *
- * \param[out] G Interleaving encoding matrix
+ * \param[out] G Interleaving encoding matrix, INTERLEAVING_LENGTH x INTERLEAVING_LENGTH
  */
-void processInterleavingGMatrix(byte G[INTERLEAVING_LENGTH][INTERLEAVING_LENGTH]);
+void processInterleavingGMatrix(bitmatrix* G);
+
+
+
+
+/**
+ * \fn void processPackedInterleaving(const byte in[INTERLEAVING_LENGTH/8], byte out[INTERLEAVING_LENGTH/8])
+ * \brief Interleaves a message on packed data, using a precomputed permutation (bit-exact with processInterleavingGMatrix())
+ *
+ * \param[in]  in Data to interleave (8 bits per byte)
+ * \param[out] out Interleaved data (8 bits per byte)
+ */
+void processPackedInterleaving(const byte in[INTERLEAVING_LENGTH/8], byte out[INTERLEAVING_LENGTH/8]);
+
+
+
+
+/**
+ * \fn void interleaveBursts(const byte blocks[], byte bursts[], unsigned int count)
+ * \brief Interleaves a batch of packed blocks into packed bursts, using precomputed tables instead of a bit-by-bit permutation
+ *
+ * \param[in]  blocks Data to interleave, INTERLEAVING_LENGTH/8 bytes per block (8 bits per byte)
+ * \param[out] bursts Interleaved data, INTERLEAVING_BURSTS bursts of INTERLEAVING_BURST_BYTES bytes per block (8 bits per byte)
+ * \param[in]  count Number of blocks to process
+ */
+void interleaveBursts(const byte blocks[], byte bursts[], unsigned int count);
+
+
+
+
+/**
+ * \fn void deinterleaveBursts(const byte bursts[], byte blocks[], unsigned int count)
+ * \brief Rebuilds a batch of packed blocks from their packed bursts (reverse operation of interleaveBursts())
+ *
+ * \param[in]  bursts Interleaved data, INTERLEAVING_BURSTS bursts of INTERLEAVING_BURST_BYTES bytes per block (8 bits per byte)
+ * \param[out] blocks Deinterleaved data, INTERLEAVING_LENGTH/8 bytes per block (8 bits per byte)
+ * \param[in]  count Number of blocks to process
+ */
+void deinterleaveBursts(const byte bursts[], byte blocks[], unsigned int count);
+
+
+
+
+/**
+ * \fn void joinBursts(const byte bursts[], byte blocks[], unsigned int count)
+ * \brief Concatenates the bursts of a batch of blocks into packed interleaved blocks, as processPackedInterleaving() gives them
+ *
+ * \param[in]  bursts Interleaved data, INTERLEAVING_BURSTS bursts of INTERLEAVING_BURST_BYTES bytes per block (8 bits per byte)
+ * \param[out] blocks Interleaved data, INTERLEAVING_LENGTH/8 bytes per block (8 bits per byte)
+ * \param[in]  count Number of blocks to process
+ */
+void joinBursts(const byte bursts[], byte blocks[], unsigned int count);
+
+
+
+
+/**
+ * \fn void splitBursts(const byte blocks[], byte bursts[], unsigned int count)
+ * \brief Splits a batch of packed interleaved blocks into their bursts (reverse operation of joinBursts())
+ *
+ * \param[in]  blocks Interleaved data, INTERLEAVING_LENGTH/8 bytes per block (8 bits per byte)
+ * \param[out] bursts Interleaved data, INTERLEAVING_BURSTS bursts of INTERLEAVING_BURST_BYTES bytes per block (8 bits per byte)
+ * \param[in]  count Number of blocks to process
+ */
+void splitBursts(const byte blocks[], byte bursts[], unsigned int count);
 
 
 
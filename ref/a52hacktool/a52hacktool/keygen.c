@@ -29,8 +29,8 @@
   * @brief Implementation of A5/2 keystream generation.
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #10
-  * @date 24/06/2011
+  * @version File Revision #12
+  * @date 19/10/2026
   *
   * Here are located the methods used for simulating the behavior of the A5/2 keystream generator.
   * Four LFSRs are used...
@@ -181,6 +181,326 @@ void getKeystream(byte keystream[], const int len) {
 
 
 
+//@{
+//! Packed representation of the shift taps and capacity of each LFSR
+#define R1_PACKED_TAPS ((1u<<R1_SHIFTTAP_1) | (1u<<R1_SHIFTTAP_2) | (1u<<R1_SHIFTTAP_3) | (1u<<R1_SHIFTTAP_4))
+#define R2_PACKED_TAPS ((1u<<R2_SHIFTTAP_1) | (1u<<R2_SHIFTTAP_2))
+#define R3_PACKED_TAPS ((1u<<R3_SHIFTTAP_1) | (1u<<R3_SHIFTTAP_2) | (1u<<R3_SHIFTTAP_3) | (1u<<R3_SHIFTTAP_4))
+#define R4_PACKED_TAPS ((1u<<R4_SHIFTTAP_1) | (1u<<R4_SHIFTTAP_2))
+#define R1_PACKED_MASK ((1u<<R1_BITS)-1)
+#define R2_PACKED_MASK ((1u<<R2_BITS)-1)
+#define R3_PACKED_MASK ((1u<<R3_BITS)-1)
+#define R4_PACKED_MASK ((1u<<R4_BITS)-1)
+//@}
+
+//! Clocks a packed register \a reg, given its packed \a taps and \a mask
+#define PACKED_CLOCKREG(reg, taps, mask)                                                      \
+        ((reg) = (((reg) << 1) & (mask)) | (unsigned int)__builtin_parity((reg) & (taps)))
+
+//! Returns bit \a i of packed register \a reg
+#define PACKED_BIT(reg, i) (((reg) >> (i)) & 1)
+
+//! Majority of three bits (each of them must be 0 or 1)
+#define PACKED_MAJORITY(b1, b2, b3) (((b1) & (b2)) | ((b2) & (b3)) | ((b1) & (b3)))
+
+
+
+
+/**
+ * \fn void keygen_packedClockingUnit(keygen_packedState* state, int clockAll)
+ * \brief Performs register clocking according to the rules of the Clocking Unit, on a packed state
+ *
+ * \param[in, out] state LFSRs to clock
+ * \param[in]      clockAll When non-zero, bypass Clocking Unit decision: always clock (initialization phase)
+ */
+void keygen_packedClockingUnit(keygen_packedState* state, int clockAll) {
+
+	unsigned int c1  = PACKED_BIT(state->R4, R4_CLOCKTAP_R1);
+	unsigned int c2  = PACKED_BIT(state->R4, R4_CLOCKTAP_R2);
+	unsigned int c3  = PACKED_BIT(state->R4, R4_CLOCKTAP_R3);
+	unsigned int maj = PACKED_MAJORITY(c1, c2, c3);
+
+	// Clocking decisions are turned into masks: the data-dependent branches would mostly be mispredicted
+	unsigned int all = -(unsigned int)(clockAll != 0);
+	unsigned int m1  = all | -(maj ^ c1 ^ 1);
+	unsigned int m2  = all | -(maj ^ c2 ^ 1);
+	unsigned int m3  = all | -(maj ^ c3 ^ 1);
+
+	unsigned int R1 = state->R1, R2 = state->R2, R3 = state->R3;
+	PACKED_CLOCKREG(R1, R1_PACKED_TAPS, R1_PACKED_MASK);
+	PACKED_CLOCKREG(R2, R2_PACKED_TAPS, R2_PACKED_MASK);
+	PACKED_CLOCKREG(R3, R3_PACKED_TAPS, R3_PACKED_MASK);
+	state->R1 = (R1 & m1) | (state->R1 & ~m1);
+	state->R2 = (R2 & m2) | (state->R2 & ~m2);
+	state->R3 = (R3 & m3) | (state->R3 & ~m3);
+	PACKED_CLOCKREG(state->R4, R4_PACKED_TAPS, R4_PACKED_MASK);
+}
+
+
+
+
+/**
+ * \fn unsigned int keygen_packedOutBit(const keygen_packedState* state)
+ * \brief Returns the current out keystream bit of a packed state
+ *
+ * \param[in] state LFSRs state
+ */
+unsigned int keygen_packedOutBit(const keygen_packedState* state) {
+	unsigned int R1 = state->R1, R2 = state->R2, R3 = state->R3;
+	return PACKED_BIT(R1, R1_BITS-1) ^ PACKED_BIT(R2, R2_BITS-1) ^ PACKED_BIT(R3, R3_BITS-1)
+	     ^ PACKED_MAJORITY(PACKED_BIT(R1, R1_OUTTAP_1), 1 ^ PACKED_BIT(R1, R1_OUTTAP_2), PACKED_BIT(R1, R1_OUTTAP_3))
+	     ^ PACKED_MAJORITY(PACKED_BIT(R2, R2_OUTTAP_1), PACKED_BIT(R2, R2_OUTTAP_2), 1 ^ PACKED_BIT(R2, R2_OUTTAP_3))
+	     ^ PACKED_MAJORITY(1 ^ PACKED_BIT(R3, R3_OUTTAP_1), PACKED_BIT(R3, R3_OUTTAP_2), PACKED_BIT(R3, R3_OUTTAP_3));
+}
+
+
+
+
+// Documentation in header file
+void keygen_prepareFrameSchedule(const byte Kc[SECRETKEY_BITS], keygen_frameSchedule* schedule) {
+
+	keygen_packedState* state = &schedule->keyState;
+	memset(state, 0, sizeof(keygen_packedState));
+
+	for (int i=0 ; i<SECRETKEY_BITS ; ++i) {
+		keygen_packedClockingUnit(state, 1);
+		state->R1 ^= Kc[i] & 1;
+		state->R2 ^= Kc[i] & 1;
+		state->R3 ^= Kc[i] & 1;
+		state->R4 ^= Kc[i] & 1;
+	}
+	for (int i=0 ; i<FRAMEID_BITS ; ++i) {
+		keygen_packedClockingUnit(state, 1);
+	}
+
+	// Frame Id bit #i enters every register at cell #0, then gets clocked (FRAMEID_BITS-1-i) times
+	for (int i=0 ; i<FRAMEID_BITS ; ++i) {
+		keygen_packedState* bit = &schedule->frameBits[i];
+		bit->R1 = bit->R2 = bit->R3 = bit->R4 = 1;
+		for (int k=i+1 ; k<FRAMEID_BITS ; ++k) {
+			keygen_packedClockingUnit(bit, 1);
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+void keygen_frameSetup(const keygen_frameSchedule* schedule, const unsigned int count, keygen_packedState* state) {
+
+	*state = schedule->keyState;
+
+	for (int i=0 ; i<FRAMEID_BITS ; ++i) {
+		if ((count >> i) & 1) {
+			state->R1 ^= schedule->frameBits[i].R1;
+			state->R2 ^= schedule->frameBits[i].R2;
+			state->R3 ^= schedule->frameBits[i].R3;
+			state->R4 ^= schedule->frameBits[i].R4;
+		}
+	}
+
+	state->R1 |= 1u << R1_INITIAL_CONST_POS;
+	state->R2 |= 1u << R2_INITIAL_CONST_POS;
+	state->R3 |= 1u << R3_INITIAL_CONST_POS;
+	state->R4 |= 1u << R4_INITIAL_CONST_POS;
+
+	keygen_packedPreprocessing(state);
+}
+
+
+
+
+// Documentation in header file
+void keygen_packedPreprocessing(keygen_packedState* state) {
+
+	// First 99 cycles of pre-processing (output discarded)
+	for (int i=0 ; i<100 ; ++i) {
+		keygen_packedClockingUnit(state, 0);
+	}
+}
+
+
+
+
+// Documentation in header file
+void keygen_packedKeystream(keygen_packedState* state, byte keystream[], const int len) {
+
+	memset(keystream, 0, ((len+7)/8)*sizeof(byte));
+
+	for (int i=0 ; i<len ; ++i) {
+		keystream[i/8] |= keygen_packedOutBit(state) << (7-(i%8));
+		keygen_packedClockingUnit(state, 0);
+	}
+}
+
+
+
+
+// Documentation in header file
+void keygen_frameBursts(const keygen_frameSchedule* schedule, const unsigned int count, \
+                        byte downlink[BURST_KEYSTREAM_BYTES], byte uplink[BURST_KEYSTREAM_BYTES]) {
+
+	keygen_packedState state;
+	keygen_frameSetup(schedule, count, &state);
+	keygen_packedKeystream(&state, downlink, BURST_KEYSTREAM_BITS);
+	keygen_packedKeystream(&state, uplink,   BURST_KEYSTREAM_BITS);
+}
+
+
+
+
+//! Bitsliced register cell: bit #f belongs to frame #f
+typedef unsigned long long keygen_slice;
+
+/**
+ * \fn void keygen_slicedClockingUnit(keygen_slice R1[R1_BITS], keygen_slice R2[R2_BITS], keygen_slice R3[R3_BITS], keygen_slice R4[R4_BITS])
+ * \brief Performs register clocking according to the rules of the Clocking Unit, on bitsliced registers
+ *
+ * \param[in, out] R1 First LFSR
+ * \param[in, out] R2 Second LFSR
+ * \param[in, out] R3 Third LFSR
+ * \param[in, out] R4 Fourth LFSR
+ */
+void keygen_slicedClockingUnit(keygen_slice R1[R1_BITS], keygen_slice R2[R2_BITS], \
+                               keygen_slice R3[R3_BITS], keygen_slice R4[R4_BITS]) {
+
+	keygen_slice c1  = R4[R4_CLOCKTAP_R1];
+	keygen_slice c2  = R4[R4_CLOCKTAP_R2];
+	keygen_slice c3  = R4[R4_CLOCKTAP_R3];
+	keygen_slice maj = PACKED_MAJORITY(c1, c2, c3);
+
+	// Each mask selects the frames in which the register is clocked
+	keygen_slice m1 = ~(maj ^ c1);
+	keygen_slice m2 = ~(maj ^ c2);
+	keygen_slice m3 = ~(maj ^ c3);
+
+	keygen_slice carry;
+
+	carry = R1[R1_SHIFTTAP_1] ^ R1[R1_SHIFTTAP_2] ^ R1[R1_SHIFTTAP_3] ^ R1[R1_SHIFTTAP_4];
+	for (int i=R1_BITS-1 ; i>0 ; --i)
+		R1[i] ^= (R1[i] ^ R1[i-1]) & m1;
+	R1[0] ^= (R1[0] ^ carry) & m1;
+
+	carry = R2[R2_SHIFTTAP_1] ^ R2[R2_SHIFTTAP_2];
+	for (int i=R2_BITS-1 ; i>0 ; --i)
+		R2[i] ^= (R2[i] ^ R2[i-1]) & m2;
+	R2[0] ^= (R2[0] ^ carry) & m2;
+
+	carry = R3[R3_SHIFTTAP_1] ^ R3[R3_SHIFTTAP_2] ^ R3[R3_SHIFTTAP_3] ^ R3[R3_SHIFTTAP_4];
+	for (int i=R3_BITS-1 ; i>0 ; --i)
+		R3[i] ^= (R3[i] ^ R3[i-1]) & m3;
+	R3[0] ^= (R3[0] ^ carry) & m3;
+
+	carry = R4[R4_SHIFTTAP_1] ^ R4[R4_SHIFTTAP_2];
+	memmove(R4+1, R4, (R4_BITS-1)*sizeof(keygen_slice));
+	R4[0] = carry;
+}
+
+
+
+
+// Documentation in header file
+void keygen_slicedKeystream(const keygen_frameSchedule* schedule, const unsigned int counts[], const int frames, \
+                            const int skip, byte keystream[], const int len) {
+
+	keygen_slice R1[R1_BITS], R2[R2_BITS], R3[R3_BITS], R4[R4_BITS];
+	memset(R1, 0, R1_BITS*sizeof(keygen_slice));
+	memset(R2, 0, R2_BITS*sizeof(keygen_slice));
+	memset(R3, 0, R3_BITS*sizeof(keygen_slice));
+	memset(R4, 0, R4_BITS*sizeof(keygen_slice));
+
+	// Keysetup of each frame (before the discarded cycles), then dispatch into the slices
+	for (int f=0 ; f<frames ; ++f) {
+		keygen_packedState state = schedule->keyState;
+		for (int i=0 ; i<FRAMEID_BITS ; ++i) {
+			if ((counts[f] >> i) & 1) {
+				state.R1 ^= schedule->frameBits[i].R1;
+				state.R2 ^= schedule->frameBits[i].R2;
+				state.R3 ^= schedule->frameBits[i].R3;
+				state.R4 ^= schedule->frameBits[i].R4;
+			}
+		}
+		for (int i=0 ; i<R1_BITS ; ++i) R1[i] |= (keygen_slice)PACKED_BIT(state.R1, i) << f;
+		for (int i=0 ; i<R2_BITS ; ++i) R2[i] |= (keygen_slice)PACKED_BIT(state.R2, i) << f;
+		for (int i=0 ; i<R3_BITS ; ++i) R3[i] |= (keygen_slice)PACKED_BIT(state.R3, i) << f;
+		for (int i=0 ; i<R4_BITS ; ++i) R4[i] |= (keygen_slice)PACKED_BIT(state.R4, i) << f;
+	}
+	R1[R1_INITIAL_CONST_POS] = R2[R2_INITIAL_CONST_POS] = R3[R3_INITIAL_CONST_POS] = R4[R4_INITIAL_CONST_POS] = ~0ULL;
+
+	// First 99 cycles of pre-processing, then the skipped keystream bits (output discarded)
+	for (int i=0 ; i<100+skip ; ++i) {
+		keygen_slicedClockingUnit(R1, R2, R3, R4);
+	}
+
+	// Output bits are gathered per frame, 8 at a time
+	const int rowBytes = (len+7)/8;
+	memset(keystream, 0, frames*rowBytes*sizeof(byte));
+
+	keygen_slice out[8];
+	for (int i=0 ; i<len ; ++i) {
+
+		out[i%8] = R1[R1_BITS-1] ^ R2[R2_BITS-1] ^ R3[R3_BITS-1]
+		         ^ PACKED_MAJORITY(R1[R1_OUTTAP_1], ~R1[R1_OUTTAP_2], R1[R1_OUTTAP_3])
+		         ^ PACKED_MAJORITY(R2[R2_OUTTAP_1], R2[R2_OUTTAP_2], ~R2[R2_OUTTAP_3])
+		         ^ PACKED_MAJORITY(~R3[R3_OUTTAP_1], R3[R3_OUTTAP_2], R3[R3_OUTTAP_3]);
+		keygen_slicedClockingUnit(R1, R2, R3, R4);
+
+		if (i%8 == 7 || i == len-1) {
+			for (int f=0 ; f<frames ; ++f) {
+				byte b = 0;
+				for (int k=0 ; k<=i%8 ; ++k)
+					b |= ((out[k] >> f) & 1) << (7-k);
+				keystream[f*rowBytes + i/8] = b;
+			}
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+unsigned int keygen_frameIdToCount(const byte frameId[FRAMEID_BITS]) {
+	unsigned int count = 0;
+	for (int i=0 ; i<FRAMEID_BITS ; ++i)
+		count |= (unsigned int)(frameId[i] & 1) << i;
+	return count;
+}
+
+
+
+
+// Documentation in header file
+unsigned int keygen_frameNumberToCount(const unsigned int frameNumber) {
+	unsigned int fn = frameNumber % HYPERFRAME_LENGTH;
+	unsigned int T1 = fn / (26*51);
+	unsigned int T2 = fn % 26;
+	unsigned int T3 = fn % 51;
+	return (T1 << 11) | (T3 << 5) | T2;
+}
+
+
+
+
+// Documentation in header file
+int keygen_countToFrameNumber(const unsigned int count, unsigned int* frameNumber) {
+	unsigned int T1 = (count >> 11) & 0x7FF;
+	unsigned int T3 = (count >> 5)  & 0x3F;
+	unsigned int T2 =  count        & 0x1F;
+	if (T2 >= 26 || T3 >= 51)
+		return 1;
+	// Chinese remainder: the only offset in the multiframe such that offset%26 == T2 and offset%51 == T3
+	unsigned int offset = T2;
+	while (offset%51 != T3)
+		offset += 26;
+	*frameNumber = T1*26*51 + offset;
+	return 0;
+}
+
+
+
+
 // Documentation in header file
 int keygen_test() {
 
@@ -206,6 +526,53 @@ int keygen_test() {
 		}
 	}
 
+	// The packed generator must produce the same keystream, split into its downlink and uplink bursts
+	keygen_frameSchedule schedule;
+	keygen_prepareFrameSchedule(Kc, &schedule);
+	byte bursts[2][BURST_KEYSTREAM_BYTES];
+	keygen_frameBursts(&schedule, keygen_frameIdToCount(frameId), bursts[0], bursts[1]);
+	for (int i=0 ; i<228 ; ++i) {
+		if (GET_CHARARRAY_BIT(bursts[i/BURST_KEYSTREAM_BITS], i%BURST_KEYSTREAM_BITS) != verifiedKeystream[i]) {
+			DEBUG("Self-check aborted: a discrepancy was found comparing the packed keystream and the verified one");
+			return 1;
+		}
+	}
+
+	// ...on random keys and frames as well, frame numbers wrapping around through COUNT
+	unsigned int counts[KEYGEN_SLICED_FRAMES];
+	byte slicedKeystream[KEYGEN_SLICED_FRAMES][456/8];
+	for (int k=0 ; k<SECRETKEY_BITS ; ++k)
+		Kc[k] = rand() & 1;
+	keygen_prepareFrameSchedule(Kc, &schedule);
+	for (int f=0 ; f<KEYGEN_SLICED_FRAMES ; ++f)
+		counts[f] = keygen_frameNumberToCount(rand() % HYPERFRAME_LENGTH);
+	keygen_slicedKeystream(&schedule, counts, KEYGEN_SLICED_FRAMES, 0, slicedKeystream[0], 456);
+
+	for (int testcase=0 ; testcase<KEYGEN_SLICED_FRAMES ; ++testcase) {
+		unsigned int count = counts[testcase], frameNumber = 0;
+		if (keygen_countToFrameNumber(count, &frameNumber) || keygen_frameNumberToCount(frameNumber) != count) {
+			DEBUG("Self-check aborted: frame number #%u is not recovered from its COUNT value", frameNumber);
+			return 1;
+		}
+		for (int k=0 ; k<FRAMEID_BITS ; ++k)
+			frameId[k] = (count >> k) & 1;
+
+		byte packedKeystream[456/8];
+		byte referenceKeystream[456];
+		keygen_packedState state;
+		keygen_frameSetup(&schedule, keygen_frameIdToCount(frameId), &state);
+		keygen_packedKeystream(&state, packedKeystream, 456);
+		keysetup(Kc, frameId);
+		getKeystream(referenceKeystream, 456);
+		for (int i=0 ; i<456 ; ++i) {
+			if (GET_CHARARRAY_BIT(packedKeystream, i)           != referenceKeystream[i]
+			 || GET_CHARARRAY_BIT(slicedKeystream[testcase], i) != referenceKeystream[i]) {
+				DEBUG("Self-check aborted: the packed keystream differs from the reference one (frame #%u)", frameNumber);
+				return 1;
+			}
+		}
+	}
+
 	DEBUG("Self-check succeeded: the produced keystream matches the verified one");
 	return 0;
 }
@@ -29,14 +29,15 @@
   * @brief Specification of A5/2 keystream generation
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #6
-  * @date 24/06/2011
+  * @version File Revision #8
+  * @date 19/10/2026
   * */
 
 
 #ifndef _KEYGEN_H_
 #define _KEYGEN_H_
 
+#include "utils.h"
 #include "const_A52.h"
 
 
@@ -66,6 +67,163 @@ void getKeystream(byte keystream[], const int len);
 
 
 
+/**
+ * \struct keygen_packedState
+ * \brief Packed state of the four LFSRs (cell #i of a register is stored in bit #i of its integer)
+ */
+typedef struct {
+	unsigned int R1; //!< First LFSR
+	unsigned int R2; //!< Second LFSR
+	unsigned int R3; //!< Third LFSR
+	unsigned int R4; //!< Fourth LFSR
+} keygen_packedState;
+
+
+
+
+/**
+ * \struct keygen_frameSchedule
+ * \brief Frame-independent part of the keysetup, shared by all the frames ciphered with one secret key
+ *
+ * Until the constant bits are forced, the keysetup is linear: the LFSRs state is the state reached
+ * by loading the secret key and an all-zero frame Id, xored with the contribution of every frame Id
+ * bit set. Both parts are processed once, so that re-keying for a new frame only costs the final
+ * forcing and the 99 discarded cycles.
+ */
+typedef struct {
+	keygen_packedState keyState;                //!< LFSRs state after loading the secret key and a null frame Id
+	keygen_packedState frameBits[FRAMEID_BITS]; //!< Contribution of each frame Id bit to the LFSRs state
+} keygen_frameSchedule;
+
+
+
+
+/**
+ * \fn void keygen_prepareFrameSchedule(const byte Kc[SECRETKEY_BITS], keygen_frameSchedule* schedule)
+ * \brief Processes the frame-independent part of the keysetup for a given secret key
+ *
+ * \param[in]  Kc Secret Key
+ * \param[out] schedule Keysetup data shared by all frames
+ */
+void keygen_prepareFrameSchedule(const byte Kc[SECRETKEY_BITS], keygen_frameSchedule* schedule);
+
+
+
+
+/**
+ * \fn void keygen_frameSetup(const keygen_frameSchedule* schedule, const unsigned int count, keygen_packedState* state)
+ * \brief Finishes the keysetup for a given frame (equivalent to keysetup(), on a packed state)
+ *
+ * \param[in]  schedule Keysetup data shared by all frames
+ * \param[in]  count Frame Id as an integer (bit #i is the i-th frame Id bit loaded)
+ * \param[out] state LFSRs state ready to output keystream
+ */
+void keygen_frameSetup(const keygen_frameSchedule* schedule, const unsigned int count, keygen_packedState* state);
+
+
+
+
+/**
+ * \fn void keygen_packedPreprocessing(keygen_packedState* state)
+ * \brief Performs the pre-processing cycles whose output is discarded, last step of the keysetup
+ *
+ * The state loaded just before them (constant bits forced) is the one the equations of the dictionaries are written on.
+ *
+ * \param[in, out] state LFSRs state, left ready to output keystream
+ */
+void keygen_packedPreprocessing(keygen_packedState* state);
+
+
+
+
+/**
+ * \fn void keygen_packedKeystream(keygen_packedState* state, byte keystream[], const int len)
+ * \brief Generates the desired amount of keystream from a packed state (equivalent to getKeystream())
+ *
+ * \param[in, out] state LFSRs state, clocked once per generated bit
+ * \param[out]     keystream Keystream to be generated, 8 bits per byte (most significant bit first)
+ * \param[in]      len desired amount of keystream bits
+ */
+void keygen_packedKeystream(keygen_packedState* state, byte keystream[], const int len);
+
+
+
+
+/**
+ * \fn void keygen_frameBursts(const keygen_frameSchedule* schedule, const unsigned int count, byte downlink[BURST_KEYSTREAM_BYTES], byte uplink[BURST_KEYSTREAM_BYTES])
+ * \brief Generates the keystream of both bursts of a frame (downlink first, then uplink)
+ *
+ * \param[in]  schedule Keysetup data shared by all frames
+ * \param[in]  count Frame Id as an integer
+ * \param[out] downlink Keystream of the downlink burst (8 bits per byte)
+ * \param[out] uplink Keystream of the uplink burst (8 bits per byte)
+ */
+void keygen_frameBursts(const keygen_frameSchedule* schedule, const unsigned int count, \
+                        byte downlink[BURST_KEYSTREAM_BYTES], byte uplink[BURST_KEYSTREAM_BYTES]);
+
+
+
+
+//! Maximum number of frames processed at once by keygen_slicedKeystream() (one per bit of a slice)
+#define KEYGEN_SLICED_FRAMES 64
+
+/**
+ * \fn void keygen_slicedKeystream(const keygen_frameSchedule* schedule, const unsigned int counts[], const int frames, const int skip, byte keystream[], const int len)
+ * \brief Generates the keystream of up to KEYGEN_SLICED_FRAMES frames at once
+ *
+ * The frames are processed in bitsliced form: every LFSR cell is stored as a 64-bit integer whose
+ * bit #f belongs to frame #f, so that all frames are clocked together by a few bitwise operations.
+ *
+ * \param[in]  schedule Keysetup data shared by all frames
+ * \param[in]  counts Frame Ids (as integers) of the frames to process
+ * \param[in]  frames Number of frames to process (at most KEYGEN_SLICED_FRAMES)
+ * \param[in]  skip Number of keystream bits discarded at the beginning of every frame
+ * \param[out] keystream Keystream of every frame, (len+7)/8 bytes per frame (8 bits per byte)
+ * \param[in]  len Desired amount of keystream bits per frame (after the skipped ones)
+ */
+void keygen_slicedKeystream(const keygen_frameSchedule* schedule, const unsigned int counts[], const int frames, \
+                            const int skip, byte keystream[], const int len);
+
+
+
+
+/**
+ * \fn unsigned int keygen_frameIdToCount(const byte frameId[FRAMEID_BITS])
+ * \brief Translates a frame Id bit array into its integer representation (first loaded bit is bit #0)
+ *
+ * \param[in] frameId Frame Id
+ * \return Frame Id as an integer
+ */
+unsigned int keygen_frameIdToCount(const byte frameId[FRAMEID_BITS]);
+
+
+
+
+/**
+ * \fn unsigned int keygen_frameNumberToCount(const unsigned int frameNumber)
+ * \brief Processes the frame Id (COUNT = T1.T3.T2) loaded into the cipher for a given TDMA frame number
+ *
+ * \param[in] frameNumber TDMA frame number
+ * \return Frame Id as an integer
+ */
+unsigned int keygen_frameNumberToCount(const unsigned int frameNumber);
+
+
+
+
+/**
+ * \fn int keygen_countToFrameNumber(const unsigned int count, unsigned int* frameNumber)
+ * \brief Retrieves the TDMA frame number corresponding to a frame Id (COUNT = T1.T3.T2)
+ *
+ * \param[in]  count Frame Id as an integer
+ * \param[out] frameNumber TDMA frame number
+ * \return 0 if the frame Id is a valid COUNT value, non-zero otherwise
+ */
+int keygen_countToFrameNumber(const unsigned int count, unsigned int* frameNumber);
+
+
+
+
 /**
  * \fn int keygen_test()
  * \brief Autotests the key generation on a verified set
@@ -29,8 +29,8 @@
   * @brief Implementation of last attack phase on A5/2: keysetup reversal
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #8
-  * @date 24/06/2011
+  * @version File Revision #9
+  * @date 19/10/2026
   * */
 
 #include <stdlib.h>
@@ -38,75 +38,88 @@
 #include <string.h>
 
 #include "utils.h"
+#include "bitmatrix.h"
 
 #include "keysetup_reverse.h"
 
 
 
 
+// The content of the 4 LFSRs is expressed from the secret key bits: every register bit is a row of a packed
+// matrix, whose SECRETKEY_BITS first columns are the key bits, and whose last column is the constant "1".
+// Rows are ordered by register (R1 bits, then R2, R3 & R4 ones), so that the matrix directly becomes the
+// linear system to solve once the known register values are added to the constant column.
+
+//! First row of register R1
+#define KEYSETUP_REVERSE_R1 0
+//! First row of register R2
+#define KEYSETUP_REVERSE_R2 (KEYSETUP_REVERSE_R1+R1_BITS)
+//! First row of register R3
+#define KEYSETUP_REVERSE_R3 (KEYSETUP_REVERSE_R2+R2_BITS)
+//! First row of register R4
+#define KEYSETUP_REVERSE_R4 (KEYSETUP_REVERSE_R3+R3_BITS)
+
+//! Column of the constant "1"
+#define KEYSETUP_REVERSE_CONST SECRETKEY_BITS
+
+
+
+
 /**
- * \struct keysetup_reverse_LFSRSet_t
- * \brief Set of all LFSR's variables
+ * \fn void keysetup_reverse_clockRegister(bitmatrix* LFSRs, int first, int bits, int tap1, int tap2, int tap3, int tap4)
+ * \brief Clocks one register (its bits being rows #first to #first+bits-1)
  *
- * This structure establishes the correspondance between the LFSR values and the keystream unknowns.
- * The last index of the second dimension (+1) represents the constant "1".
- * Other indexes represent standard variables.
+ * \param[in, out] LFSRs Set of LFSR's variables
+ * \param[in]      first First row of the register
+ * \param[in]      bits Length of the register
+ * \param[in]      tap1 First feedback tap
+ * \param[in]      tap2 Second feedback tap
+ * \param[in]      tap3 Third feedback tap (-1 if unused)
+ * \param[in]      tap4 Fourth feedback tap (-1 if unused)
  */
-typedef struct {
-	byte R1[R1_BITS][SECRETKEY_BITS+1]; //!< R1 expressed from keystream unknowns
-	byte R2[R2_BITS][SECRETKEY_BITS+1]; //!< R2 expressed from keystream unknowns
-	byte R3[R3_BITS][SECRETKEY_BITS+1]; //!< R3 expressed from keystream unknowns
-	byte R4[R4_BITS][SECRETKEY_BITS+1]; //!< R4 expressed from keystream unknowns
-} keysetup_reverse_LFSRSet_t;
-
-//! Pointer to a set of LFSR's variables
-typedef keysetup_reverse_LFSRSet_t * keysetup_reverse_LFSRSet;
+void keysetup_reverse_clockRegister(bitmatrix* LFSRs, int first, int bits, int tap1, int tap2, int tap3, int tap4) {
+
+	bitword carry[BITMATRIX_STRIDE(SECRETKEY_BITS+1)];
+	memcpy(carry, BITMATRIX_ROW(LFSRs, first+tap1), LFSRs->stride*sizeof(bitword));
+	bitmatrix_xorWords(carry, BITMATRIX_ROW(LFSRs, first+tap2), LFSRs->stride);
+	if (tap3 >= 0)
+		bitmatrix_xorWords(carry, BITMATRIX_ROW(LFSRs, first+tap3), LFSRs->stride);
+	if (tap4 >= 0)
+		bitmatrix_xorWords(carry, BITMATRIX_ROW(LFSRs, first+tap4), LFSRs->stride);
+
+	memmove(BITMATRIX_ROW(LFSRs, first+1), BITMATRIX_ROW(LFSRs, first), (bits-1)*LFSRs->stride*sizeof(bitword));
+	memcpy(BITMATRIX_ROW(LFSRs, first), carry, LFSRs->stride*sizeof(bitword));
+}
 
 
 
 
 /**
- * \fn void keysetup_reverse_clockRegs(keysetup_reverse_LFSRSet LFSRs)
+ * \fn void keysetup_reverse_clockRegs(bitmatrix* LFSRs)
  * \brief Clock all registers (during the keysetup phase, the clocking unit is unused).
  *
- * \param[in, out] LFSRs Pointer to the set of LFSR's variables to clock
+ * \param[in, out] LFSRs Set of LFSR's variables to clock
  */
-void keysetup_reverse_clockRegs(keysetup_reverse_LFSRSet LFSRs) {
-
-	byte carry[SECRETKEY_BITS+1];
-
-	// R1
-	memset(carry, 0, (SECRETKEY_BITS+1)*sizeof(byte));
-	XOR_CHARARRAYS(carry, LFSRs->R1[13], SECRETKEY_BITS+1);
-	XOR_CHARARRAYS(carry, LFSRs->R1[16], SECRETKEY_BITS+1);
-	XOR_CHARARRAYS(carry, LFSRs->R1[17], SECRETKEY_BITS+1);
-	XOR_CHARARRAYS(carry, LFSRs->R1[18], SECRETKEY_BITS+1);
-	memmove(LFSRs->R1[1], LFSRs->R1[0], (R1_BITS-1)*(SECRETKEY_BITS+1)*sizeof(byte));
-	memcpy(LFSRs->R1[0], carry, (SECRETKEY_BITS+1)*sizeof(byte));
-
-	// R2
-	memset(carry, 0, (SECRETKEY_BITS+1)*sizeof(byte));
-	XOR_CHARARRAYS(carry, LFSRs->R2[20], SECRETKEY_BITS+1);
-	XOR_CHARARRAYS(carry, LFSRs->R2[21], SECRETKEY_BITS+1);
-	memmove(LFSRs->R2[1], LFSRs->R2[0], (R2_BITS-1)*(SECRETKEY_BITS+1)*sizeof(byte));
-	memcpy(LFSRs->R2[0], carry, (SECRETKEY_BITS+1)*sizeof(byte));
-
-	// R3
-	memset(carry, 0, (SECRETKEY_BITS+1)*sizeof(byte));
-	XOR_CHARARRAYS(carry, LFSRs->R3[ 7], SECRETKEY_BITS+1);
-	XOR_CHARARRAYS(carry, LFSRs->R3[20], SECRETKEY_BITS+1);
-	XOR_CHARARRAYS(carry, LFSRs->R3[21], SECRETKEY_BITS+1);
-	XOR_CHARARRAYS(carry, LFSRs->R3[22], SECRETKEY_BITS+1);
-	memmove(LFSRs->R3[1], LFSRs->R3[0], (R3_BITS-1)*(SECRETKEY_BITS+1)*sizeof(byte));
-	memcpy(LFSRs->R3[0], carry, (SECRETKEY_BITS+1)*sizeof(byte));
-
-	// R4
-	memset(carry, 0, (SECRETKEY_BITS+1)*sizeof(byte));
-	XOR_CHARARRAYS(carry, LFSRs->R4[11], SECRETKEY_BITS+1);
-	XOR_CHARARRAYS(carry, LFSRs->R4[16], SECRETKEY_BITS+1);
-	memmove(LFSRs->R4[1], LFSRs->R4[0], (R4_BITS-1)*(SECRETKEY_BITS+1)*sizeof(byte));
-	memcpy(LFSRs->R4[0], carry, (SECRETKEY_BITS+1)*sizeof(byte));
+void keysetup_reverse_clockRegs(bitmatrix* LFSRs) {
+	keysetup_reverse_clockRegister(LFSRs, KEYSETUP_REVERSE_R1, R1_BITS, 13, 16, 17, 18);
+	keysetup_reverse_clockRegister(LFSRs, KEYSETUP_REVERSE_R2, R2_BITS, 20, 21, -1, -1);
+	keysetup_reverse_clockRegister(LFSRs, KEYSETUP_REVERSE_R3, R3_BITS,  7, 20, 21, 22);
+	keysetup_reverse_clockRegister(LFSRs, KEYSETUP_REVERSE_R4, R4_BITS, 11, 16, -1, -1);
+}
+
+
+
 
+/**
+ * \fn void keysetup_reverse_setConstant(bitmatrix* LFSRs, int row)
+ * \brief Forces a register bit to the constant "1"
+ *
+ * \param[in, out] LFSRs Set of LFSR's variables
+ * \param[in]      row Row of the register bit
+ */
+void keysetup_reverse_setConstant(bitmatrix* LFSRs, int row) {
+	memset(BITMATRIX_ROW(LFSRs, row), 0, LFSRs->stride*sizeof(bitword));
+	BITMATRIX_FLIP(LFSRs, row, KEYSETUP_REVERSE_CONST);
 }
 
 
@@ -119,135 +132,76 @@ int reverseKeysetup(const byte R1[R1_BITS], const byte R2[R2_BITS], const byte R
 
 	memset(secretKey, 0, SECRETKEY_BITS*sizeof(byte));
 
-	keysetup_reverse_LFSRSet LFSRs = malloc(sizeof(keysetup_reverse_LFSRSet_t));
-	memset(LFSRs, 0, sizeof(keysetup_reverse_LFSRSet_t));
+	bitmatrix LFSRs;
+	if (bitmatrix_alloc(&LFSRs, REGS_BITS, SECRETKEY_BITS+1))
+		return 1;
+
+	const int firstRows[4] = {KEYSETUP_REVERSE_R1, KEYSETUP_REVERSE_R2, KEYSETUP_REVERSE_R3, KEYSETUP_REVERSE_R4};
 
 
 	// -------------------------------------------------------
 	// Keysetup steps mirroring using secret key variables...
 	// -------------------------------------------------------
 
-	byte Kc[SECRETKEY_BITS+1];
-
 	for (int i=0 ; i<SECRETKEY_BITS ; ++i) {
-		keysetup_reverse_clockRegs(LFSRs);
-		memset(Kc, 0, (SECRETKEY_BITS+1)*sizeof(char));
-		Kc[i] = 1;
-		XOR_CHARARRAYS(LFSRs->R1[0], Kc, SECRETKEY_BITS+1);
-		XOR_CHARARRAYS(LFSRs->R2[0], Kc, SECRETKEY_BITS+1);
-		XOR_CHARARRAYS(LFSRs->R3[0], Kc, SECRETKEY_BITS+1);
-		XOR_CHARARRAYS(LFSRs->R4[0], Kc, SECRETKEY_BITS+1);
+		keysetup_reverse_clockRegs(&LFSRs);
+		for (int r=0 ; r<4 ; ++r)
+			BITMATRIX_FLIP(&LFSRs, firstRows[r], i);
 	}
 
 	for (int i=0 ; i<FRAMEID_BITS ; ++i) {
-		keysetup_reverse_clockRegs(LFSRs);
+		keysetup_reverse_clockRegs(&LFSRs);
 		if (frameId[i] == 1) {
-			LFSRs->R1[0][SECRETKEY_BITS] ^= 1;
-			LFSRs->R2[0][SECRETKEY_BITS] ^= 1;
-			LFSRs->R3[0][SECRETKEY_BITS] ^= 1;
-			LFSRs->R4[0][SECRETKEY_BITS] ^= 1;
+			for (int r=0 ; r<4 ; ++r)
+				BITMATRIX_FLIP(&LFSRs, firstRows[r], KEYSETUP_REVERSE_CONST);
 		}
 	}
-	memset(LFSRs->R1[15], 0, (SECRETKEY_BITS+1)*sizeof(char));  LFSRs->R1[15][SECRETKEY_BITS] = 1;
-	memset(LFSRs->R2[16], 0, (SECRETKEY_BITS+1)*sizeof(char));  LFSRs->R2[16][SECRETKEY_BITS] = 1;
-	memset(LFSRs->R3[18], 0, (SECRETKEY_BITS+1)*sizeof(char));  LFSRs->R3[18][SECRETKEY_BITS] = 1;
-	memset(LFSRs->R4[10], 0, (SECRETKEY_BITS+1)*sizeof(char));  LFSRs->R4[10][SECRETKEY_BITS] = 1;
+	keysetup_reverse_setConstant(&LFSRs, KEYSETUP_REVERSE_R1+15);
+	keysetup_reverse_setConstant(&LFSRs, KEYSETUP_REVERSE_R2+16);
+	keysetup_reverse_setConstant(&LFSRs, KEYSETUP_REVERSE_R3+18);
+	keysetup_reverse_setConstant(&LFSRs, KEYSETUP_REVERSE_R4+10);
 
 
 	// -------------------------------------------------------
 	// Linear System Generation...
 	// -------------------------------------------------------
 
-	// Initial state of R1->R4 LFSRs is determined by the previous deciphering step (given as param)
-	byte regStatus[REGS_BITS];
-	memset(regStatus, 0, REGS_BITS*sizeof(byte));
-	memcpy(regStatus,                         R1, R1_BITS*sizeof(byte));
-	memcpy(regStatus+R1_BITS,                 R2, R2_BITS*sizeof(byte));
-	memcpy(regStatus+R1_BITS+R2_BITS,         R3, R3_BITS*sizeof(byte));
-	memcpy(regStatus+R1_BITS+R2_BITS+R3_BITS, R4, R4_BITS*sizeof(byte));
-
-	// Concatenate in a line the 4 matrices of equations into a single linear system,
-	// thus changing data representation [line/col]=>[col/line]
-	byte linearSystem[REGS_BITS][SECRETKEY_BITS];
-	memset(linearSystem, 0, (REGS_BITS)*SECRETKEY_BITS*sizeof(char));
+	// Initial state of R1->R4 LFSRs is determined by the previous deciphering step (given as param):
+	// it is xored with the constant column, which thus becomes the right-hand side of the system
+	// of 64 unknown quantities and 19+22+23+17 = 81 equations (4 of them are just 0=0, some others are dependant...)
 	for (int i=0 ; i<R1_BITS ; ++i)
-		memcpy(linearSystem[i], LFSRs->R1[i], SECRETKEY_BITS*sizeof(char));
+		if (R1[i]) BITMATRIX_FLIP(&LFSRs, KEYSETUP_REVERSE_R1+i, KEYSETUP_REVERSE_CONST);
 	for (int i=0 ; i<R2_BITS ; ++i)
-		memcpy(linearSystem[i+R1_BITS], LFSRs->R2[i], SECRETKEY_BITS*sizeof(char));
+		if (R2[i]) BITMATRIX_FLIP(&LFSRs, KEYSETUP_REVERSE_R2+i, KEYSETUP_REVERSE_CONST);
 	for (int i=0 ; i<R3_BITS ; ++i)
-		memcpy(linearSystem[i+R1_BITS+R2_BITS], LFSRs->R3[i], SECRETKEY_BITS*sizeof(char));
+		if (R3[i]) BITMATRIX_FLIP(&LFSRs, KEYSETUP_REVERSE_R3+i, KEYSETUP_REVERSE_CONST);
 	for (int i=0 ; i<R4_BITS ; ++i)
-		memcpy(linearSystem[i+R1_BITS+R2_BITS+R3_BITS], LFSRs->R4[i], SECRETKEY_BITS*sizeof(char));
+		if (R4[i]) BITMATRIX_FLIP(&LFSRs, KEYSETUP_REVERSE_R4+i, KEYSETUP_REVERSE_CONST);
+
 
 	// -------------------------------------------------------
 	// Construction step done. Now entering resolution...
 	// -------------------------------------------------------
 
-	// Detach last line (line representing ones), xor with provided result from previous decrypting
-	// step, and simply solve the system of 64 unknown quantities and 19+22+23+17 = 81 equations
-	// (4 of them are just 0=0, some others are dependant...)
-	for (int i=0 ; i<R1_BITS ; ++i)
-		regStatus[i] ^= LFSRs->R1[i][SECRETKEY_BITS];
-	for (int i=0 ; i<R2_BITS ; ++i)
-		regStatus[i+R1_BITS] ^= LFSRs->R2[i][SECRETKEY_BITS];
-	for (int i=0 ; i<R3_BITS ; ++i)
-		regStatus[i+R1_BITS+R2_BITS] ^= LFSRs->R3[i][SECRETKEY_BITS];
-	for (int i=0 ; i<R4_BITS ; ++i)
-		regStatus[i+R1_BITS+R2_BITS+R3_BITS] ^= LFSRs->R4[i][SECRETKEY_BITS];
-
-	// Gauss Elimination
-	byte headFactor = 0;
-	for (int col=0 ; col<SECRETKEY_BITS ; ++col) {
-		for (int line=col ; line<REGS_BITS ; ++line) {
-			// Pivot finding
-			headFactor = linearSystem[line][col];
-			if (headFactor) {
-				// Line Swap if necessary
-				if (line!=col) {
-					byte temp;
-					for (int c=0 ; c<SECRETKEY_BITS ; ++c) {
-						temp = linearSystem[col][c];
-						linearSystem[col][c]  = linearSystem[line][c];
-						linearSystem[line][c] = temp;
-					}
-					temp = regStatus[col];
-					regStatus[col] = regStatus[line];
-					regStatus[line] = temp;
-				}
-				// Elimination
-				for (int l=col+1 ; l<REGS_BITS ; ++l) {
-					if (linearSystem[l][col]) {
-						for (int c=col; c<SECRETKEY_BITS; ++c) {
-							linearSystem[l][c] ^= linearSystem[col][c];
-						}
-						regStatus[l] ^= regStatus[col];
-					}
-				}
-				break;
-			}
-		}
-		if (!headFactor) {
-			DEBUG("Error: Not a Cramer System, returning all 0");
-			free(LFSRs);
-			return 1;
-		}
-	}
+	bitword solution[BITMATRIX_WORDS(SECRETKEY_BITS)];
+	BitmatrixSolveStatus status = bitmatrix_solve(&LFSRs, solution);
+	bitmatrix_free(&LFSRs);
 
-	// Solution finding (starting from line #SECRETKEY_BITS, assuming we have a Cramer System)
-	for (int line=SECRETKEY_BITS-1 ; line>=0 ; --line) {
-		secretKey[line] = regStatus[line];
-		// propagate new result amongst above equations
-		for (int l=line-1 ; l>=0 ; --l) {
-			regStatus[l] ^= linearSystem[l][line] & secretKey[line];
-			linearSystem[l][line] = 0;
-		}
+	if (status == BITMATRIX_UNDERDETERMINED) {
+		DEBUG("Error: Not a Cramer System, returning all 0");
+		return 1;
+	}
+	if (status == BITMATRIX_INCONSISTENT) {
+		// The register values can't come out of any keysetup with this frame Id
+		return 1;
 	}
 
+
 	// -------------------------------------------------------
 	// Solution Found
 	// -------------------------------------------------------
 
-	free(LFSRs);
+	bitmatrix_unpackVector(solution, secretKey, SECRETKEY_BITS);
 	return 0;
 
 }
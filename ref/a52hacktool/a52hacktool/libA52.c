@@ -0,0 +1,405 @@
+/*============================================================================*
+ *                                                                            *
+ *                                   libA52.c                                 *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file libA52.c
+  * @brief Implementation of the embeddable A5/2 library
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #1
+  * @date 19/10/2026
+  * */
+
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "const_A52.h"
+#include "const_code.h"
+#include "code.h"
+#include "convolution.h"
+#include "cipher.h"
+#include "attack.h"
+#include "matrices_generation.h"
+
+#include "libA52.h"
+
+
+// The public constants and types mirror the internal ones: a mismatch makes the array size negative
+typedef char libA52_checkConstants[(A52_SECRETKEY_BITS == SECRETKEY_BITS && A52_FRAMEID_BITS == FRAMEID_BITS
+                                    && A52_SOURCEWORD_BITS == SOURCEWORD_LENGTH && A52_CODEWORD_BITS == CODEWORD_LENGTH
+                                    && A52_BLOCK_BYTES == CIPHER_BLOCK_BYTES && A52_MAX_MESSAGES == MAX_ENCRYPTED_MESSAGES
+                                    && (int)A52_DECODING_UNCORRECTABLE == (int)FIRE_UNCORRECTABLE) ? 1 : -1];
+
+
+
+
+//! Dictionary handle
+struct a52Dictionary {
+	attackDictionary dictionary; //!< Matrices, with the allocator of the handle
+};
+
+//! Solver handle
+struct a52Solver {
+	int threads;            //!< Number of workers of every attack
+	a52ThreadPool pool;     //!< Pool running the workers (NULL submit: a thread per worker)
+	attackAllocator memory; //!< Allocator of the handle and of the problems
+};
+
+//! Keystream handle
+struct a52Keystream {
+	cipherStreamArgs stream; //!< Stream parameters
+	attackAllocator memory;  //!< Allocator of the handle
+};
+
+//! Codec handle
+struct a52Codec {
+	attackAllocator memory; //!< Allocator of the handle
+};
+
+
+
+
+/**
+ * \fn attackAllocator libA52_allocator(const a52Allocator* allocator)
+ * \brief Converts an allocator of the caller
+ *
+ * \param[in] allocator Allocator of the caller (NULL for the standard one)
+ * \return Allocator for the attack module
+ */
+attackAllocator libA52_allocator(const a52Allocator* allocator) {
+	attackAllocator memory = {NULL, NULL, NULL};
+	if (allocator) {
+		memory.allocate = allocator->allocate;
+		memory.release  = allocator->release;
+		memory.context  = allocator->context;
+	}
+	return memory;
+}
+
+
+
+
+/**
+ * \fn void libA52_onResult(void* context, int job, const byte secretKey[SECRETKEY_BITS])
+ * \brief Records whether the key of a problem was found (attack result handler)
+ *
+ * \param[out] context Flags of the problems
+ * \param[in]  job Index of the problem
+ * \param[in]  secretKey Secret key, NULL if the problem is unsolved
+ */
+void libA52_onResult(void* context, int job, const byte secretKey[SECRETKEY_BITS]) {
+	((int*)context)[job] = (secretKey != NULL);
+}
+
+
+
+
+/**
+ * \fn A52Status libA52_loadDictionary(a52Dictionary** dictionary, const char* filename, int percent, int cached, A52DictionaryKind kind, int messages, const a52Allocator* allocator)
+ * \brief Creates a dictionary handle, see attack_loadDictionary()
+ *
+ * \param[out] dictionary Handle of the dictionary
+ * \param[in]  filename Path of the dictionary file (not read when \a percent is 0)
+ * \param[in]  percent Percentage of the matrices to store
+ * \param[in]  cached Number of generated matrices to keep
+ * \param[in]  kind Attack the matrices are made for, when \a percent is 0
+ * \param[in]  messages Number of chunks of cipher text, when \a percent is 0
+ * \param[in]  allocator Allocator of the caller (may be NULL)
+ * \return A52_OK if the dictionary is created, the reason of the failure otherwise
+ */
+A52Status libA52_loadDictionary(a52Dictionary** dictionary, const char* filename, int percent, int cached, \
+                                A52DictionaryKind kind, int messages, const a52Allocator* allocator) {
+
+	*dictionary = NULL;
+	if (cached < 0)
+		return A52_ERROR_ARGUMENT;
+
+	// The generation of the matrices needs the code matrices, allocated once for all
+	if (!code_getMatrices())
+		return A52_ERROR_MEMORY;
+
+	const attackAllocator memory = libA52_allocator(allocator);
+	a52Dictionary* handle = attack_allocate(&memory, sizeof(a52Dictionary));
+	if (!handle)
+		return A52_ERROR_MEMORY;
+
+	DictionaryKind internalKind = (kind == A52_DICTIONARY_KEYSTREAM) ? DICTIONARY_KEYSTREAM : DICTIONARY_CIPHERTEXT;
+	switch (attack_loadDictionary(&handle->dictionary, filename, percent, cached, internalKind, messages, &memory)) {
+		case ATTACK_OK:
+			*dictionary = handle;
+			return A52_OK;
+		case ATTACK_ERROR_IO:
+			attack_release(&memory, handle);
+			return A52_ERROR_IO;
+		case ATTACK_ERROR_FORMAT:
+			attack_release(&memory, handle);
+			return A52_ERROR_FORMAT;
+		default:
+			attack_release(&memory, handle);
+			return A52_ERROR_MEMORY;
+	}
+}
+
+
+
+
+// Documentation in header file
+A52Status a52_dictionaryOpen(a52Dictionary** dictionary, const char* filename, int percent, int cached, const a52Allocator* allocator) {
+
+	if (!dictionary || !filename || percent < 1 || percent > 100) {
+		if (dictionary)
+			*dictionary = NULL;
+		return A52_ERROR_ARGUMENT;
+	}
+	return libA52_loadDictionary(dictionary, filename, percent, cached, A52_DICTIONARY_CIPHERTEXT, NEEDED_ENCRYPTED_MESSAGES, allocator);
+}
+
+
+
+
+// Documentation in header file
+A52Status a52_dictionaryCreate(a52Dictionary** dictionary, A52DictionaryKind kind, int messages, int cached, const a52Allocator* allocator) {
+
+	if (!dictionary)
+		return A52_ERROR_ARGUMENT;
+	if (kind == A52_DICTIONARY_CIPHERTEXT && (messages < NEEDED_ENCRYPTED_MESSAGES || messages > MAX_ENCRYPTED_MESSAGES)) {
+		*dictionary = NULL;
+		return A52_ERROR_ARGUMENT;
+	}
+	return libA52_loadDictionary(dictionary, NULL, 0, cached, kind, messages, allocator);
+}
+
+
+
+
+// Documentation in header file
+int a52_dictionaryMessages(const a52Dictionary* dictionary) {
+	return dictionary->dictionary.messages;
+}
+
+
+
+
+// Documentation in header file
+A52DictionaryKind a52_dictionaryKind(const a52Dictionary* dictionary) {
+	return (dictionary->dictionary.kind == DICTIONARY_KEYSTREAM) ? A52_DICTIONARY_KEYSTREAM : A52_DICTIONARY_CIPHERTEXT;
+}
+
+
+
+
+// Documentation in header file
+void a52_dictionaryClose(a52Dictionary* dictionary) {
+
+	if (!dictionary)
+		return;
+	const attackAllocator memory = dictionary->dictionary.allocator;
+	attack_freeDictionary(&dictionary->dictionary);
+	attack_release(&memory, dictionary);
+}
+
+
+
+
+// Documentation in header file
+A52Status a52_solverCreate(a52Solver** solver, int threads, const a52ThreadPool* pool, const a52Allocator* allocator) {
+
+	if (!solver)
+		return A52_ERROR_ARGUMENT;
+	*solver = NULL;
+	if (threads < 0 || threads > ATTACK_MAX_THREADS || (pool && !pool->submit))
+		return A52_ERROR_ARGUMENT;
+
+	const attackAllocator memory = libA52_allocator(allocator);
+	a52Solver* handle = attack_allocate(&memory, sizeof(a52Solver));
+	if (!handle)
+		return A52_ERROR_MEMORY;
+
+	handle->threads = threads;
+	handle->memory  = memory;
+	if (pool) {
+		handle->pool = *pool;
+	} else {
+		handle->pool.submit = NULL;
+		handle->pool.pool   = NULL;
+	}
+	*solver = handle;
+	return A52_OK;
+}
+
+
+
+
+// Documentation in header file
+A52Status a52_solverAttack(a52Solver* solver, a52Dictionary* dictionary, const a52Problem problems[], int count, \
+                           unsigned char secretKeys[][A52_SECRETKEY_BITS], int found[]) {
+
+	if (!solver || !dictionary || count < 0 || (count && (!problems || !secretKeys)))
+		return A52_ERROR_ARGUMENT;
+	if (!count)
+		return A52_OK;
+
+	cipherTextArgs* ctArgs = attack_allocate(&solver->memory, (size_t)count*sizeof(cipherTextArgs));
+	if (!ctArgs)
+		return A52_ERROR_MEMORY;
+	for (int j=0 ; j<count ; ++j) {
+		memcpy(ctArgs[j].cipherText, problems[j].cipherText, sizeof(ctArgs[j].cipherText));
+		memcpy(ctArgs[j].frameId, problems[j].frameId, sizeof(ctArgs[j].frameId));
+	}
+
+	attackOptions options;
+	memset(&options, 0, sizeof(attackOptions));
+	options.threads = solver->threads;
+	options.submit  = solver->pool.submit;
+	options.pool    = solver->pool.pool;
+	if (found) {
+		options.onResult = libA52_onResult;
+		options.context  = found;
+	}
+
+	int unsolved = attack_run(&dictionary->dictionary, ctArgs, count, secretKeys, &options);
+	attack_release(&solver->memory, ctArgs);
+	return (unsolved < 0) ? A52_ERROR_THREAD : A52_OK;
+}
+
+
+
+
+// Documentation in header file
+void a52_solverDestroy(a52Solver* solver) {
+
+	if (!solver)
+		return;
+	const attackAllocator memory = solver->memory;
+	attack_release(&memory, solver);
+}
+
+
+
+
+// Documentation in header file
+A52Status a52_keystreamCreate(a52Keystream** keystream, const unsigned char secretKey[A52_SECRETKEY_BITS], \
+                              const unsigned char frameId[A52_FRAMEID_BITS], int perBurst, int uplink, const a52Allocator* allocator) {
+
+	if (!keystream)
+		return A52_ERROR_ARGUMENT;
+	*keystream = NULL;
+	if (!secretKey || !frameId)
+		return A52_ERROR_ARGUMENT;
+
+	const attackAllocator memory = libA52_allocator(allocator);
+	a52Keystream* handle = attack_allocate(&memory, sizeof(a52Keystream));
+	if (!handle)
+		return A52_ERROR_MEMORY;
+
+	handle->memory = memory;
+	if (cipher_initStream(&handle->stream, secretKey, frameId, perBurst ? CIPHER_PER_BURST : CIPHER_PER_BLOCK,
+	                      uplink ? CIPHER_UPLINK : CIPHER_DOWNLINK)) {
+		attack_release(&memory, handle);
+		return A52_ERROR_ARGUMENT;
+	}
+	*keystream = handle;
+	return A52_OK;
+}
+
+
+
+
+// Documentation in header file
+void a52_keystreamCipher(const a52Keystream* keystream, unsigned long long firstBlock, unsigned char data[], unsigned int blocks) {
+	cipherBlocks(&keystream->stream, firstBlock, data, blocks);
+}
+
+
+
+
+// Documentation in header file
+void a52_keystreamDestroy(a52Keystream* keystream) {
+
+	if (!keystream)
+		return;
+	const attackAllocator memory = keystream->memory;
+	attack_release(&memory, keystream);
+}
+
+
+
+
+// Documentation in header file
+A52Status a52_codecCreate(a52Codec** codec, const a52Allocator* allocator) {
+
+	if (!codec)
+		return A52_ERROR_ARGUMENT;
+
+	const attackAllocator memory = libA52_allocator(allocator);
+	*codec = attack_allocate(&memory, sizeof(a52Codec));
+	if (!*codec)
+		return A52_ERROR_MEMORY;
+	(*codec)->memory = memory;
+	return A52_OK;
+}
+
+
+
+
+// Documentation in header file
+void a52_codecEncode(const a52Codec* codec, const unsigned char sourcewords[], unsigned char codewords[], unsigned int blocks) {
+	processPackedEncoding(sourcewords, codewords, blocks);
+}
+
+
+
+
+// Documentation in header file
+void a52_codecDecode(const a52Codec* codec, const signed char codewords[], unsigned char sourcewords[], \
+                     A52DecodingStatus status[], unsigned int blocks) {
+
+	// FireStatus and A52DecodingStatus share their values, but not necessarily their size
+	FireStatus fireStatus[VITERBI_LANES];
+	for (unsigned int first=0 ; first<blocks ; first+=VITERBI_LANES) {
+		unsigned int count = (blocks-first < VITERBI_LANES) ? blocks-first : VITERBI_LANES;
+		processFullViterbiDecoding(codewords + (size_t)first*CODEWORD_LENGTH, sourcewords + (size_t)first*SOURCEWORD_LENGTH,
+		                           status ? fireStatus : NULL, count);
+		for (unsigned int b=0 ; status && b<count ; ++b) {
+			status[first+b] = (A52DecodingStatus)fireStatus[b];
+		}
+	}
+}
+
+
+
+
+// Documentation in header file
+void a52_codecDestroy(a52Codec* codec) {
+
+	if (!codec)
+		return;
+	const attackAllocator memory = codec->memory;
+	attack_release(&memory, codec);
+}
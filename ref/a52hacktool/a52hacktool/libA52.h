@@ -0,0 +1,377 @@
+/*============================================================================*
+ *                                                                            *
+ *                                   libA52.h                                 *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file libA52.h
+  * @brief Specification of the embeddable A5/2 library (libA52.a / libA52.so)
+  *
+  * Every object is reached through an opaque handle, created and destroyed by the caller: no global state
+  * is involved, except the code matrices, which are computed once and shared read-only. The functions
+  * report their failures through their return value and never terminate the process.
+  *
+  * This header is self-contained: it doesn't depend on the other headers of A52HackTool.
+  * Bits are given one per byte (0 or 1), unless stated otherwise.
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #2
+  * @date 19/10/2026
+  * */
+
+
+
+#ifndef _LIBA52_H_
+#define _LIBA52_H_
+
+#include <stddef.h>
+
+
+//! Marks the functions exported by libA52.so: its other symbols are hidden (built with -fvisibility=hidden)
+#if defined(__GNUC__)
+#define A52_API __attribute__((visibility("default")))
+#else
+#define A52_API
+#endif
+
+//! Length of the secret key Kc (in bits)
+#define A52_SECRETKEY_BITS 64
+
+//! Length of the Frame Id (COUNT, in bits)
+#define A52_FRAMEID_BITS 22
+
+//! Length of a message before coding (in bits)
+#define A52_SOURCEWORD_BITS 184
+
+//! Length of a coded message, and of a chunk of cipher text (in bits)
+#define A52_CODEWORD_BITS 456
+
+//! Size of a ciphered block (in bytes, 8 bits per byte): one coded message
+#define A52_BLOCK_BYTES (A52_CODEWORD_BITS/8)
+
+//! Greatest number of chunks of cipher text of a problem
+#define A52_MAX_MESSAGES 8
+
+//! Greatest soft-decision value: soft bits range from -A52_SOFTBIT_MAX (surely 0) to A52_SOFTBIT_MAX (surely 1)
+#define A52_SOFTBIT_MAX 127
+
+
+
+
+/**
+ * \enum A52Status
+ * \brief Outcome of a function of the library
+ */
+typedef enum {
+	A52_OK,             //!< Success
+	A52_ERROR_ARGUMENT, //!< Invalid parameter
+	A52_ERROR_MEMORY,   //!< Not enough memory
+	A52_ERROR_IO,       //!< A file cannot be opened or read
+	A52_ERROR_FORMAT,   //!< The file is not a dictionary
+	A52_ERROR_THREAD    //!< The workers couldn't be started
+} A52Status;
+
+
+/**
+ * \enum A52DictionaryKind
+ * \brief Attack a dictionary is made for
+ */
+typedef enum {
+	A52_DICTIONARY_CIPHERTEXT, //!< Ciphertext only: the problems give chunks of cipher text
+	A52_DICTIONARY_KEYSTREAM   //!< Known keystream: the problems give 2 chunks of keystream
+} A52DictionaryKind;
+
+
+/**
+ * \enum A52DecodingStatus
+ * \brief Outcome of the decoding of a message
+ */
+typedef enum {
+	A52_DECODING_VALID,        //!< The CRC matches: no transmission error was detected
+	A52_DECODING_CORRECTED,    //!< A burst of errors was detected and corrected
+	A52_DECODING_UNCORRECTABLE //!< The errors can't be corrected: the message is returned as received
+} A52DecodingStatus;
+
+
+
+
+/**
+ * \struct a52Allocator
+ * \brief Memory allocator of a handle (the standard allocator when the functions are NULL)
+ */
+typedef struct {
+	void* (*allocate)(void* context, size_t size); //!< Allocates a block, returns NULL on failure
+	void (*release)(void* context, void* block);    //!< Frees a block given by \a allocate
+	void* context;                                  //!< Data given to both functions
+} a52Allocator;
+
+
+/**
+ * \struct a52ThreadPool
+ * \brief Thread pool of the caller, running the workers of an attack
+ *
+ * Every worker submitted must run concurrently with the other ones: the pool needs at least as many threads as the solver has workers.
+ */
+typedef struct {
+	int (*submit)(void* pool, void (*task)(void* arg), void* arg); //!< Runs task(arg) on a thread of the pool, returns non-zero if it cannot
+	void* pool;                                                    //!< Pool given to \a submit
+} a52ThreadPool;
+
+
+/**
+ * \struct a52Problem
+ * \brief Problem of an attack: consecutive chunks of cipher text (or of keystream) and the Frame Id of the first one
+ */
+typedef struct {
+	unsigned char cipherText[A52_MAX_MESSAGES][A52_CODEWORD_BITS]; //!< Chunks of cipher text (as many as the dictionary is made for)
+	unsigned char frameId[A52_FRAMEID_BITS];                       //!< Frame Id
+} a52Problem;
+
+
+
+
+//! Resolution Matrices of the attack, stored in RAM or generated on demand
+typedef struct a52Dictionary a52Dictionary;
+
+//! Attack of problems with a dictionary, by a set of workers
+typedef struct a52Solver a52Solver;
+
+//! Frame-keyed A5/2 cipher of a stream
+typedef struct a52Keystream a52Keystream;
+
+//! Channel coding of the messages (Fire code, Convolution and Interleaving)
+typedef struct a52Codec a52Codec;
+
+
+
+
+/**
+ * \fn A52Status a52_dictionaryOpen(a52Dictionary** dictionary, const char* filename, int percent, int cached, const a52Allocator* allocator)
+ * \brief Loads a dictionary file, the matrices which are not stored being generated on demand
+ *
+ * \param[out] dictionary Handle of the dictionary
+ * \param[in]  filename Path of the dictionary file
+ * \param[in]  percent Percentage of the matrices to store (1 to 100)
+ * \param[in]  cached Number of generated matrices to keep for the next attacks
+ * \param[in]  allocator Allocator of the handle and of the matrices (NULL for the standard one)
+ * \return A52_OK if the dictionary is loaded, the reason of the failure otherwise
+ */
+A52_API A52Status a52_dictionaryOpen(a52Dictionary** dictionary, const char* filename, int percent, int cached, const a52Allocator* allocator);
+
+
+
+
+/**
+ * \fn A52Status a52_dictionaryCreate(a52Dictionary** dictionary, A52DictionaryKind kind, int messages, int cached, const a52Allocator* allocator)
+ * \brief Creates a dictionary without any file: every matrix is generated on demand
+ *
+ * \param[out] dictionary Handle of the dictionary
+ * \param[in]  kind Attack the matrices are made for
+ * \param[in]  messages Number of chunks of cipher text of the problems (3 to A52_MAX_MESSAGES, ignored for a known keystream)
+ * \param[in]  cached Number of generated matrices to keep for the next attacks
+ * \param[in]  allocator Allocator of the handle and of the matrices (NULL for the standard one)
+ * \return A52_OK if the dictionary is created, the reason of the failure otherwise
+ */
+A52_API A52Status a52_dictionaryCreate(a52Dictionary** dictionary, A52DictionaryKind kind, int messages, int cached, const a52Allocator* allocator);
+
+
+
+
+/**
+ * \fn int a52_dictionaryMessages(const a52Dictionary* dictionary)
+ * \brief Gives the number of chunks of cipher text (or of keystream) the problems must give
+ *
+ * \param[in] dictionary Dictionary
+ * \return Number of chunks
+ */
+A52_API int a52_dictionaryMessages(const a52Dictionary* dictionary);
+
+
+
+
+/**
+ * \fn A52DictionaryKind a52_dictionaryKind(const a52Dictionary* dictionary)
+ * \brief Gives the attack a dictionary is made for
+ *
+ * \param[in] dictionary Dictionary
+ * \return Kind of the dictionary
+ */
+A52_API A52DictionaryKind a52_dictionaryKind(const a52Dictionary* dictionary);
+
+
+
+
+/**
+ * \fn void a52_dictionaryClose(a52Dictionary* dictionary)
+ * \brief Frees a dictionary (no attack may be using it)
+ *
+ * \param[in] dictionary Dictionary (may be NULL)
+ */
+A52_API void a52_dictionaryClose(a52Dictionary* dictionary);
+
+
+
+
+/**
+ * \fn A52Status a52_solverCreate(a52Solver** solver, int threads, const a52ThreadPool* pool, const a52Allocator* allocator)
+ * \brief Creates a solver
+ *
+ * \param[out] solver Handle of the solver
+ * \param[in]  threads Number of workers of every attack (0 for the default one)
+ * \param[in]  pool Pool running the workers (NULL: a thread is created per worker)
+ * \param[in]  allocator Allocator of the handle and of the problems (NULL for the standard one)
+ * \return A52_OK if the solver is created, the reason of the failure otherwise
+ */
+A52_API A52Status a52_solverCreate(a52Solver** solver, int threads, const a52ThreadPool* pool, const a52Allocator* allocator);
+
+
+
+
+/**
+ * \fn A52Status a52_solverAttack(a52Solver* solver, a52Dictionary* dictionary, const a52Problem problems[], int count, unsigned char secretKeys[][A52_SECRETKEY_BITS], int found[])
+ * \brief Recovers the secret keys of a batch of problems
+ *
+ * A dictionary is attacked by one solver at a time; a solver may attack several dictionaries in turn.
+ *
+ * \param[in]      solver Solver
+ * \param[in, out] dictionary Dictionary (its cache receives the generated matrices)
+ * \param[in]      problems Problems to be solved
+ * \param[in]      count Number of problems
+ * \param[out]     secretKeys Secret key of every problem, all zeros for the unsolved ones
+ * \param[out]     found Whether the key of every problem was found (may be NULL)
+ * \return A52_OK if the attack went through (whether the keys were found or not), the reason of the failure otherwise
+ */
+A52_API A52Status a52_solverAttack(a52Solver* solver, a52Dictionary* dictionary, const a52Problem problems[], int count, \
+                                   unsigned char secretKeys[][A52_SECRETKEY_BITS], int found[]);
+
+
+
+
+/**
+ * \fn void a52_solverDestroy(a52Solver* solver)
+ * \brief Frees a solver
+ *
+ * \param[in] solver Solver (may be NULL)
+ */
+A52_API void a52_solverDestroy(a52Solver* solver);
+
+
+
+
+/**
+ * \fn A52Status a52_keystreamCreate(a52Keystream** keystream, const unsigned char secretKey[A52_SECRETKEY_BITS], const unsigned char frameId[A52_FRAMEID_BITS], int perBurst, int uplink, const a52Allocator* allocator)
+ * \brief Prepares the ciphering of a stream starting at a given frame
+ *
+ * \param[out] keystream Handle of the stream
+ * \param[in]  secretKey Secret key Kc
+ * \param[in]  frameId Frame Id (COUNT) of the first frame of the stream
+ * \param[in]  perBurst Zero for one frame per block, non-zero for one frame per 114-bit burst
+ * \param[in]  uplink With one frame per burst, non-zero for the uplink keystream (downlink otherwise)
+ * \param[in]  allocator Allocator of the handle (NULL for the standard one)
+ * \return A52_OK if the stream is prepared, A52_ERROR_ARGUMENT if the Frame Id is not a valid COUNT value
+ */
+A52_API A52Status a52_keystreamCreate(a52Keystream** keystream, const unsigned char secretKey[A52_SECRETKEY_BITS], \
+                                      const unsigned char frameId[A52_FRAMEID_BITS], int perBurst, int uplink, const a52Allocator* allocator);
+
+
+
+
+/**
+ * \fn void a52_keystreamCipher(const a52Keystream* keystream, unsigned long long firstBlock, unsigned char data[], unsigned int blocks)
+ * \brief Ciphers (or deciphers) in place consecutive blocks of the stream (several threads may share the handle)
+ *
+ * \param[in]      keystream Stream
+ * \param[in]      firstBlock Index of the first block inside the stream
+ * \param[in, out] data Blocks to process (A52_BLOCK_BYTES bytes each, 8 bits per byte)
+ * \param[in]      blocks Number of blocks
+ */
+A52_API void a52_keystreamCipher(const a52Keystream* keystream, unsigned long long firstBlock, unsigned char data[], unsigned int blocks);
+
+
+
+
+/**
+ * \fn void a52_keystreamDestroy(a52Keystream* keystream)
+ * \brief Frees a stream
+ *
+ * \param[in] keystream Stream (may be NULL)
+ */
+A52_API void a52_keystreamDestroy(a52Keystream* keystream);
+
+
+
+
+/**
+ * \fn A52Status a52_codecCreate(a52Codec** codec, const a52Allocator* allocator)
+ * \brief Creates a codec
+ *
+ * \param[out] codec Handle of the codec
+ * \param[in]  allocator Allocator of the handle (NULL for the standard one)
+ * \return A52_OK if the codec is created, A52_ERROR_MEMORY otherwise
+ */
+A52_API A52Status a52_codecCreate(a52Codec** codec, const a52Allocator* allocator);
+
+
+
+
+/**
+ * \fn void a52_codecEncode(const a52Codec* codec, const unsigned char sourcewords[], unsigned char codewords[], unsigned int blocks)
+ * \brief Encodes messages (several threads may share the handle)
+ *
+ * \param[in]  codec Codec
+ * \param[in]  sourcewords Messages, A52_SOURCEWORD_BITS/8 bytes each (8 bits per byte)
+ * \param[out] codewords Coded messages, A52_BLOCK_BYTES bytes each (8 bits per byte)
+ * \param[in]  blocks Number of messages
+ */
+A52_API void a52_codecEncode(const a52Codec* codec, const unsigned char sourcewords[], unsigned char codewords[], unsigned int blocks);
+
+
+
+
+/**
+ * \fn void a52_codecDecode(const a52Codec* codec, const signed char codewords[], unsigned char sourcewords[], A52DecodingStatus status[], unsigned int blocks)
+ * \brief Decodes messages, correcting transmission errors (several threads may share the handle)
+ *
+ * \param[in]  codec Codec
+ * \param[in]  codewords Coded messages, A52_CODEWORD_BITS soft bits each
+ * \param[out] sourcewords Messages, A52_SOURCEWORD_BITS bits each (one per byte)
+ * \param[out] status Outcome of the decoding of every message (may be NULL)
+ * \param[in]  blocks Number of messages
+ */
+A52_API void a52_codecDecode(const a52Codec* codec, const signed char codewords[], unsigned char sourcewords[], \
+                             A52DecodingStatus status[], unsigned int blocks);
+
+
+
+
+/**
+ * \fn void a52_codecDestroy(a52Codec* codec)
+ * \brief Frees a codec
+ *
+ * \param[in] codec Codec (may be NULL)
+ */
+A52_API void a52_codecDestroy(a52Codec* codec);
+
+
+#endif
@@ -0,0 +1,522 @@
+/*============================================================================*
+ *                                                                            *
+ *                                libA52_test.c                               *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file libA52_test.c
+  * @brief Autotest of the embeddable library, linked against libA52.a (see make libtest)
+  *
+  * Every public function is run through the API, with a counting allocator and a thread pool of the caller;
+  * the results are checked against the internal modules the library wraps.
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #1
+  * @date 19/10/2026
+  * */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "const_A52.h"
+#include "const_code.h"
+#include "utils.h"
+
+#include "code.h"
+#include "cipher.h"
+#include "keygen.h"
+#include "matrices_generation.h"
+
+#include "libA52.h"
+
+
+
+
+//! Seed of the pseudo-random inputs
+#define LIBTEST_SEED 0xA52
+
+//! Messages encoded and decoded by the codec test
+#define LIBTEST_CODEC_BLOCKS 40
+
+//! Blocks ciphered by the keystream test
+#define LIBTEST_CIPHER_BLOCKS 12
+
+//! Workers of the attack
+#define LIBTEST_THREADS 4
+
+//! Problems attacked at once
+#define LIBTEST_PROBLEMS 2
+
+//! Greatest dictionary index of the attacked keys: the matrices are generated on demand, the first ones only are needed
+#define LIBTEST_MAX_INDEX 48
+
+
+
+
+/**
+ * \struct libtestMemory
+ * \brief Context of the counting allocator
+ */
+typedef struct {
+	int blocks;      //!< Number of blocks in use (atomic updates)
+	int allocations; //!< Number of blocks ever given (atomic updates)
+} libtestMemory;
+
+
+/**
+ * \struct libtestPool
+ * \brief Context of the thread pool: a detached thread per task
+ */
+typedef struct {
+	int submitted;   //!< Number of tasks run (atomic updates)
+} libtestPool;
+
+
+/**
+ * \struct libtestTask
+ * \brief Task given to a thread of the pool
+ */
+typedef struct {
+	void (*task)(void* arg); //!< Function to run
+	void* arg;               //!< Argument of the function
+} libtestTask;
+
+
+
+
+/**
+ * \fn void* libtest_allocate(void* context, size_t size)
+ * \brief Counting allocator (a52Allocator)
+ *
+ * \param[in, out] context Allocator context (libtestMemory)
+ * \param[in]      size Size of the block
+ * \return Allocated block, NULL on failure
+ */
+void* libtest_allocate(void* context, size_t size) {
+	libtestMemory* memory = context;
+	void* block = malloc(size);
+	if (block) {
+		__atomic_fetch_add(&memory->blocks, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&memory->allocations, 1, __ATOMIC_RELAXED);
+	}
+	return block;
+}
+
+
+
+
+/**
+ * \fn void libtest_release(void* context, void* block)
+ * \brief Counting deallocator (a52Allocator)
+ *
+ * \param[in, out] context Allocator context (libtestMemory)
+ * \param[in]      block Block to free
+ */
+void libtest_release(void* context, void* block) {
+	libtestMemory* memory = context;
+	if (block)
+		__atomic_fetch_sub(&memory->blocks, 1, __ATOMIC_RELAXED);
+	free(block);
+}
+
+
+
+
+/**
+ * \fn void* libtest_runTask(void* data)
+ * \brief Thread of the pool
+ *
+ * \param[in] data Task to run (libtestTask, freed once run)
+ * \return NULL
+ */
+void* libtest_runTask(void* data) {
+	libtestTask task = *(libtestTask*)data;
+	free(data);
+	task.task(task.arg);
+	return NULL;
+}
+
+
+
+
+/**
+ * \fn int libtest_submit(void* pool, void (*task)(void* arg), void* arg)
+ * \brief Thread pool of the caller (a52ThreadPool)
+ *
+ * \param[in, out] pool Pool context (libtestPool)
+ * \param[in]      task Function to run
+ * \param[in]      arg Argument of the function
+ * \return 0 if the task has been started, non-zero otherwise
+ */
+int libtest_submit(void* pool, void (*task)(void* arg), void* arg) {
+
+	libtestTask* data = malloc(sizeof(libtestTask));
+	pthread_t thread;
+	if (!data)
+		return 1;
+	data->task = task;
+	data->arg  = arg;
+	if (pthread_create(&thread, NULL, libtest_runTask, data)) {
+		free(data);
+		return 1;
+	}
+	pthread_detach(thread);
+	__atomic_fetch_add(&((libtestPool*)pool)->submitted, 1, __ATOMIC_RELAXED);
+	return 0;
+}
+
+
+
+
+/**
+ * \fn void libtest_randomBits(byte bits[], int length)
+ * \brief Draws random bits (one per byte)
+ *
+ * \param[out] bits Random bits
+ * \param[in]  length Number of bits
+ */
+void libtest_randomBits(byte bits[], int length) {
+	for (int i=0 ; i<length ; ++i) {
+		bits[i] = rand() & 1;
+	}
+}
+
+
+
+
+/**
+ * \fn int libtest_index(const byte secretKey[SECRETKEY_BITS], const byte frameId[FRAMEID_BITS])
+ * \brief Gives the dictionary index of a key and a frame: the state of R4 after the keysetup, without its constant bit
+ *
+ * \param[in] secretKey Secret key
+ * \param[in] frameId Frame Id
+ * \return Dictionary index
+ */
+int libtest_index(const byte secretKey[SECRETKEY_BITS], const byte frameId[FRAMEID_BITS]) {
+
+	keygen_frameSchedule schedule;
+	keygen_prepareFrameSchedule(secretKey, &schedule);
+	unsigned int count = keygen_frameIdToCount(frameId);
+
+	unsigned int R4 = schedule.keyState.R4;
+	for (int i=0 ; i<FRAMEID_BITS ; ++i) {
+		if ((count >> i) & 1)
+			R4 ^= schedule.frameBits[i].R4;
+	}
+	int index = (R4 & ((1u << R4_INITIAL_CONST_POS) - 1)) | ((R4 >> (R4_INITIAL_CONST_POS+1)) << R4_INITIAL_CONST_POS);
+	return index & (TOTAL_MATRICES-1);
+}
+
+
+
+
+/**
+ * \fn int libtest_dictionary(const a52Allocator* allocator, libtestMemory* memory)
+ * \brief Creates, inspects and closes dictionaries, and checks that invalid ones are refused
+ *
+ * \param[in]      allocator Counting allocator
+ * \param[in, out] memory Allocator context
+ * \return 0 if the test is successfull, non-zero otherwise
+ */
+int libtest_dictionary(const a52Allocator* allocator, libtestMemory* memory) {
+
+	a52Dictionary* dictionary = NULL;
+	int res = 0;
+
+	for (int messages=NEEDED_ENCRYPTED_MESSAGES ; messages<=MAX_ENCRYPTED_MESSAGES && !res ; messages+=MAX_ENCRYPTED_MESSAGES-NEEDED_ENCRYPTED_MESSAGES) {
+		if (a52_dictionaryCreate(&dictionary, A52_DICTIONARY_CIPHERTEXT, messages, 2, allocator) != A52_OK
+		 || a52_dictionaryKind(dictionary) != A52_DICTIONARY_CIPHERTEXT || a52_dictionaryMessages(dictionary) != messages) {
+			DEBUG("Self-check aborted: a ciphertext dictionary for %d messages was not created as requested", messages);
+			res = 1;
+		}
+		a52_dictionaryClose(dictionary);
+	}
+
+	if (!res && (a52_dictionaryCreate(&dictionary, A52_DICTIONARY_KEYSTREAM, 0, 0, allocator) != A52_OK
+	          || a52_dictionaryKind(dictionary) != A52_DICTIONARY_KEYSTREAM || a52_dictionaryMessages(dictionary) != KEYSTREAM_MESSAGES)) {
+		DEBUG("Self-check aborted: a known-keystream dictionary was not created as requested");
+		res = 1;
+	}
+	a52_dictionaryClose(dictionary);
+
+	// Invalid parameters and missing files are reported, and leave no handle behind
+	if (!res && (a52_dictionaryCreate(&dictionary, A52_DICTIONARY_CIPHERTEXT, MAX_ENCRYPTED_MESSAGES+1, 0, allocator) != A52_ERROR_ARGUMENT
+	          || dictionary
+	          || a52_dictionaryOpen(&dictionary, "bin/missing-dictionary.bin", 100, 0, allocator) != A52_ERROR_IO
+	          || dictionary)) {
+		DEBUG("Self-check aborted: an invalid dictionary was not refused");
+		res = 1;
+	}
+
+	if (!res && (memory->blocks || !memory->allocations)) {
+		DEBUG("Self-check aborted: the dictionaries didn't go through the allocator, or left %d block(s) allocated", memory->blocks);
+		res = 1;
+	}
+	if (!res)
+		DEBUG("Self-check succeeded: the dictionaries are created and closed as requested");
+	return res;
+}
+
+
+
+
+/**
+ * \fn int libtest_keystream(const a52Allocator* allocator)
+ * \brief Ciphers blocks through the library, and compares them with the ones ciphered by cipherBlocks()
+ *
+ * \param[in] allocator Counting allocator
+ * \return 0 if the test is successfull, non-zero otherwise
+ */
+int libtest_keystream(const a52Allocator* allocator) {
+
+	byte secretKey[SECRETKEY_BITS], frameId[FRAMEID_BITS];
+	byte data[LIBTEST_CIPHER_BLOCKS*CIPHER_BLOCK_BYTES], expected[LIBTEST_CIPHER_BLOCKS*CIPHER_BLOCK_BYTES];
+
+	// Every framing, with a stream starting somewhere in the middle
+	for (int mode=0 ; mode<3 ; ++mode) {
+		int perBurst = (mode > 0), uplink = (mode == 2);
+
+		// The Frame Id must be a valid COUNT value: it is drawn as a frame number
+		unsigned int count = keygen_frameNumberToCount(rand() % HYPERFRAME_LENGTH);
+		libtest_randomBits(secretKey, SECRETKEY_BITS);
+		for (int i=0 ; i<FRAMEID_BITS ; ++i) {
+			frameId[i] = (count >> i) & 1;
+		}
+		for (int i=0 ; i<LIBTEST_CIPHER_BLOCKS*CIPHER_BLOCK_BYTES ; ++i) {
+			data[i] = expected[i] = rand() & 0xFF;
+		}
+
+		a52Keystream* keystream = NULL;
+		cipherStreamArgs stream;
+		if (a52_keystreamCreate(&keystream, secretKey, frameId, perBurst, uplink, allocator) != A52_OK
+		 || cipher_initStream(&stream, secretKey, frameId, perBurst ? CIPHER_PER_BURST : CIPHER_PER_BLOCK,
+		                      uplink ? CIPHER_UPLINK : CIPHER_DOWNLINK)) {
+			DEBUG("Self-check aborted: unable to prepare the stream (framing #%d)", mode);
+			a52_keystreamDestroy(keystream);
+			return 1;
+		}
+
+		a52_keystreamCipher(keystream, 5, data, LIBTEST_CIPHER_BLOCKS);
+		cipherBlocks(&stream, 5, expected, LIBTEST_CIPHER_BLOCKS);
+		a52_keystreamDestroy(keystream);
+
+		if (memcmp(data, expected, sizeof(data))) {
+			DEBUG("Self-check aborted: the library ciphers differently from cipherBlocks() (framing #%d)", mode);
+			return 1;
+		}
+	}
+
+	// T3 = 63 is out of range
+	a52Keystream* keystream = NULL;
+	memset(frameId, 1, FRAMEID_BITS);
+	if (a52_keystreamCreate(&keystream, secretKey, frameId, 0, 0, allocator) != A52_ERROR_ARGUMENT || keystream) {
+		DEBUG("Self-check aborted: an invalid Frame Id was not refused");
+		a52_keystreamDestroy(keystream);
+		return 1;
+	}
+	DEBUG("Self-check succeeded: the library ciphers as cipherBlocks() does");
+	return 0;
+}
+
+
+
+
+/**
+ * \fn int libtest_codec(const a52Allocator* allocator)
+ * \brief Encodes random messages through the library, then decodes them with transmission errors
+ *
+ * \param[in] allocator Counting allocator
+ * \return 0 if the test is successfull, non-zero otherwise
+ */
+int libtest_codec(const a52Allocator* allocator) {
+
+	byte sourcewords[LIBTEST_CODEC_BLOCKS*(SOURCEWORD_LENGTH/8)];
+	byte codewords[LIBTEST_CODEC_BLOCKS*(CODEWORD_LENGTH/8)], expected[LIBTEST_CODEC_BLOCKS*(CODEWORD_LENGTH/8)];
+	signed char softBits[LIBTEST_CODEC_BLOCKS*CODEWORD_LENGTH];
+	byte decoded[LIBTEST_CODEC_BLOCKS*SOURCEWORD_LENGTH];
+	A52DecodingStatus status[LIBTEST_CODEC_BLOCKS];
+
+	for (int i=0 ; i<LIBTEST_CODEC_BLOCKS*(SOURCEWORD_LENGTH/8) ; ++i) {
+		sourcewords[i] = rand() & 0xFF;
+	}
+
+	a52Codec* codec = NULL;
+	if (a52_codecCreate(&codec, allocator) != A52_OK) {
+		DEBUG("Self-check aborted: unable to create the codec");
+		return 1;
+	}
+	a52_codecEncode(codec, sourcewords, codewords, LIBTEST_CODEC_BLOCKS);
+	processPackedEncoding(sourcewords, expected, LIBTEST_CODEC_BLOCKS);
+
+	// A few bits of every message are flipped, or erased (unknown soft value)
+	for (int i=0 ; i<LIBTEST_CODEC_BLOCKS*CODEWORD_LENGTH ; ++i) {
+		softBits[i] = GET_CHARARRAY_BIT(codewords, i) ? A52_SOFTBIT_MAX : -A52_SOFTBIT_MAX;
+	}
+	for (int b=0 ; b<LIBTEST_CODEC_BLOCKS ; ++b) {
+		for (int e=0 ; e<3 ; ++e) {
+			int i = b*CODEWORD_LENGTH + rand() % CODEWORD_LENGTH;
+			softBits[i] = (e == 0) ? 0 : -softBits[i];
+		}
+	}
+	a52_codecDecode(codec, softBits, decoded, status, LIBTEST_CODEC_BLOCKS);
+	a52_codecDestroy(codec);
+
+	if (memcmp(codewords, expected, sizeof(codewords))) {
+		DEBUG("Self-check aborted: the library encodes differently from processPackedEncoding()");
+		return 1;
+	}
+	for (int b=0 ; b<LIBTEST_CODEC_BLOCKS ; ++b) {
+		for (int i=0 ; i<SOURCEWORD_LENGTH ; ++i) {
+			if (decoded[b*SOURCEWORD_LENGTH + i] != GET_CHARARRAY_BIT(sourcewords + b*(SOURCEWORD_LENGTH/8), i)
+			 || status[b] == A52_DECODING_UNCORRECTABLE) {
+				DEBUG("Self-check aborted: the library didn't decode the noisy message #%d", b);
+				return 1;
+			}
+		}
+	}
+	DEBUG("Self-check succeeded: the noisy messages are decoded back");
+	return 0;
+}
+
+
+
+
+/**
+ * \fn int libtest_solver(const a52Allocator* allocator, libtestMemory* memory)
+ * \brief Recovers secret keys through the library, the workers running on a thread pool of the caller
+ *
+ * The known-keystream dictionary is generated on demand, and the keys are drawn so that their matrices
+ * come first: the attack is over as soon as they are found.
+ *
+ * \param[in]      allocator Counting allocator
+ * \param[in, out] memory Allocator context
+ * \return 0 if the test is successfull, non-zero otherwise
+ */
+int libtest_solver(const a52Allocator* allocator, libtestMemory* memory) {
+
+	libtestPool poolData = {0};
+	const a52ThreadPool pool = {libtest_submit, &poolData};
+
+	a52Problem problems[LIBTEST_PROBLEMS];
+	byte secretKeys[LIBTEST_PROBLEMS][SECRETKEY_BITS];
+	unsigned char recovered[LIBTEST_PROBLEMS][A52_SECRETKEY_BITS];
+	int found[LIBTEST_PROBLEMS];
+
+	memset(problems, 0, sizeof(problems));
+	for (int p=0 ; p<LIBTEST_PROBLEMS ; ++p) {
+		do {
+			libtest_randomBits(secretKeys[p], SECRETKEY_BITS);
+			libtest_randomBits(problems[p].frameId, FRAMEID_BITS);
+		} while (libtest_index(secretKeys[p], problems[p].frameId) > LIBTEST_MAX_INDEX);
+
+		byte keystream[KEYSTREAM_MESSAGES*CODEWORD_LENGTH];
+		keysetup(secretKeys[p], problems[p].frameId);
+		getKeystream(keystream, KEYSTREAM_MESSAGES*CODEWORD_LENGTH);
+		for (int m=0 ; m<KEYSTREAM_MESSAGES ; ++m) {
+			memcpy(problems[p].cipherText[m], keystream + m*CODEWORD_LENGTH, CODEWORD_LENGTH);
+		}
+	}
+
+	a52Dictionary* dictionary = NULL;
+	a52Solver* solver = NULL;
+	if (a52_dictionaryCreate(&dictionary, A52_DICTIONARY_KEYSTREAM, 0, 0, allocator) != A52_OK
+	 || a52_solverCreate(&solver, LIBTEST_THREADS, &pool, allocator) != A52_OK) {
+		DEBUG("Self-check aborted: unable to create the dictionary or the solver");
+		a52_dictionaryClose(dictionary);
+		return 1;
+	}
+
+	const int allocations = memory->allocations;
+	A52Status status = a52_solverAttack(solver, dictionary, problems, LIBTEST_PROBLEMS, recovered, found);
+	a52_solverDestroy(solver);
+	a52_dictionaryClose(dictionary);
+
+	int res = 0;
+	if (status != A52_OK) {
+		DEBUG("Self-check aborted: the attack failed (status %d)", status);
+		res = 1;
+	}
+	for (int p=0 ; p<LIBTEST_PROBLEMS && !res ; ++p) {
+		if (!found[p] || memcmp(recovered[p], secretKeys[p], SECRETKEY_BITS)) {
+			DEBUG("Self-check aborted: the secret key of problem #%d was not recovered", p);
+			res = 1;
+		}
+	}
+	if (!res && poolData.submitted != LIBTEST_THREADS) {
+		DEBUG("Self-check aborted: %d worker(s) ran on the pool instead of %d", poolData.submitted, LIBTEST_THREADS);
+		res = 1;
+	}
+	if (!res && (memory->allocations == allocations || memory->blocks)) {
+		DEBUG("Self-check aborted: the attack didn't go through the allocator, or left %d block(s) allocated", memory->blocks);
+		res = 1;
+	}
+	if (!res)
+		DEBUG("Self-check succeeded: the secret keys are recovered by the workers of the pool");
+	return res;
+}
+
+
+
+
+/**
+ * \fn int main()
+ * \brief Autotest entry point
+ *
+ * \return 0 if every test is successfull, non-zero otherwise
+ */
+int main() {
+
+	libtestMemory memory = {0, 0};
+	const a52Allocator allocator = {libtest_allocate, libtest_release, &memory};
+
+	srand(LIBTEST_SEED);
+
+	int total_tests=0, cumulative_res=0;
+
+	printf("======= STARTING LIBA52 AUTOTESTS =======\n");
+
+	printf("\n---- Testing Dictionaries...\n");
+	++total_tests;   cumulative_res += libtest_dictionary(&allocator, &memory);
+
+	printf("\n---- Testing Keystream...\n");
+	++total_tests;   cumulative_res += libtest_keystream(&allocator);
+
+	printf("\n---- Testing Codec...\n");
+	++total_tests;   cumulative_res += libtest_codec(&allocator);
+
+	printf("\n---- Testing Solver...\n");
+	++total_tests;   cumulative_res += libtest_solver(&allocator, &memory);
+
+	if (memory.blocks) {
+		DEBUG("Error: %d block(s) left allocated by the library", memory.blocks);
+		++cumulative_res;
+	}
+
+	printf("\n  %d tests out of %d succeeded\n", total_tests-cumulative_res, total_tests);
+
+	return cumulative_res != 0;
+}
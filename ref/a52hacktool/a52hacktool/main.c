@@ -29,8 +29,8 @@
   * @brief Command-line interface for program operation
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #21
-  * @date 01/12/2011
+  * @version File Revision #45
+  * @date 19/10/2026
   * */
 
 /*! \mainpage A52HackTool Documentation
@@ -62,12 +62,18 @@
 
 #include "const_code.h"
 #include "utils.h"
+#include "bitmatrix.h"
 
 #include "code.h"
 #include "keygen.h"
+#include "cipher.h"
 #include "attack.h"
+#include "progress.h"
+#include "fileio.h"
+#include "pipeline.h"
 #include "matrices_generation.h"
 #include "keysetup_reverse.h"
+#include "tune.h"
 
 
 
@@ -85,12 +91,55 @@ typedef enum {
 	OP_ENCRYPT,    //!< Perform Encryption
 	OP_ATTACK,     //!< Perform Attack
 	OP_PRECOMPUTE, //!< Generate Resolution Matrices
+	OP_VERIFY,     //!< Verify the dictionary
+	OP_TUNE,       //!< Tune the kernels and the numbers of threads to this processor
 	OP_AUTOTEST    //!< Launch Autotest
 } OperationParam;
 
 
 
 
+/**
+ * \enum DecoderParam
+ * \brief CLI Decoder
+ *
+ * Gathers all possible ways of decoding a message.
+ */
+typedef enum {
+	DECODER_ALGEBRAIC,    //!< Algebraic inverse of every encoding step (no error correction)
+	DECODER_VITERBI_HARD, //!< Viterbi decoder on hard-decided bits (456 bits per message)
+	DECODER_VITERBI_SOFT  //!< Viterbi decoder on soft bits (1 signed byte per bit, 456 bytes per message)
+} DecoderParam;
+
+
+
+
+/**
+ * \struct decodingContext
+ * \brief Data shared by the decoding workers
+ */
+typedef struct {
+	DecoderParam decoder;                               //!< Decoder in use
+	const cipherStreamArgs* cipher;                     //!< Stream to decipher before decoding, NULL if the data is plain
+	unsigned int fireStatusCount[FIRE_UNCORRECTABLE+1]; //!< Number of messages per Fire decoding outcome (atomic updates)
+} decodingContext;
+
+
+//! Error code of the pipeline processing: the batch does not contain a whole number of messages
+#define PARTIAL_MESSAGE 1
+
+//! Number of blocks going through both the codec and the cipher before the next ones (one bitsliced keystream group)
+#define FUSED_CHUNK_BLOCKS KEYGEN_SLICED_FRAMES
+
+//! Dictionary of the attack, written by --PRECOMPUTE
+#define DICTIONARY_FILE "bin/matrices.bin"
+
+//! Tuning profile of this processor, written by --TUNE
+#define TUNE_FILE "bin/tune.profile"
+
+
+
+
 /**
  * \fn void displayHelp()
  * \brief Displays the program banner and help about possible CLI commands
@@ -117,15 +166,225 @@ void displayHelp() {
 	printf(" - encode  a message :  --ENCODE  -s [source] -d [destination]\n");
 	printf(" - encrypt a message :  --ENCRYPT -s [source] -d [destination] -k [secretkey] -f [frameId]\n");
 	printf(" - decrypt a message :  --DECRYPT -s [source] -d [destination] -k [secretkey] -f [frameId]\n");
+	printf("     re-keying every frame:  [...] -m [block|burst] (-l [downlink|uplink])\n");
 	printf(" - decode  a message :  --DECODE  -s [source] -d [destination]\n");
+	printf("     correcting errors:      [...] -v [hard|soft]\n");
+	printf(" - encode & encrypt  :  --ENCODE  [...] -k [secretkey] -f [frameId] -m [block|burst] (-l [...])\n");
+	printf(" - decrypt & decode  :  --DECODE  [...] -k [secretkey] -f [frameId] -m [block|burst] (-l [...])\n");
 	printf(" - precompute data   :  --PRECOMPUTE\n");
+	printf("     more ciphered blocks:   [...] -n [messages]  (3 to %d, blocks needed by the attack)\n", MAX_ENCRYPTED_MESSAGES);
+	printf("     known-keystream attack: [...] -c [ciphertext|keystream]  (keystream: --ATTACK on %d keystream blocks)\n", KEYSTREAM_MESSAGES);
+	printf(" - verify dictionary :  --VERIFY  (checksums of every block, written by --PRECOMPUTE)\n");
+	printf("     sampled equations:      [...] -r [percent]  (matrices checked against fresh keystream, default %d%%)\n", VERIFY_DEFAULT_PERCENT);
 	printf(" - perfom attack     :  --ATTACK  -s [source] -f [frameId]\n");
+	printf("     batch of records:       --ATTACK  -s [records] -b  (frameId on 3 bytes + n blocks each)\n");
+	printf("     exporting telemetry:    [...] -x [statsfile(.json)]  (also written on SIGUSR1)\n");
+	printf("     partial dictionary:     [...] -r [percent]  (other matrices generated; -r 0: no dictionary, -c and -n apply)\n");
+	printf("     journal of the attack:  [...] -j [journal] (--resume)  (resuming skips the indices already tried)\n");
+	printf(" - tune to this CPU  :  --TUNE  (profile " TUNE_FILE ", used by the other operations on this CPU)\n");
 	printf(" - launch autotest   :  --AUTOTEST\n");
+	printf(" - standard streams  :  [...] -s - (standard input)  -d - (standard output)\n");
+	printf(" - worker threads    :  [...] -t [threads]  (--ENCODE, --DECODE, re-keyed --ENCRYPT, --VERIFY)\n");
+	printf(" - report progress   :  [...] -p [progressfile]  (JSON, all operations but --ATTACK)\n");
 	printf("\n");
 
 }
 
 
+
+
+/**
+ * \fn void printAttackResult(void* context, int job, const byte secretKey[SECRETKEY_BITS])
+ * \brief Batch attack result handler: displays the outcome of a record as soon as it is known
+ *
+ * \param[in] context Unused
+ * \param[in] job Index of the record
+ * \param[in] secretKey Deciphered secret key, NULL if the attack failed
+ */
+void printAttackResult(void* context, int job, const byte secretKey[SECRETKEY_BITS]) {
+
+	if (!secretKey) {
+		printf("Record #%d: Attack Failed.\n", job);
+	} else {
+		printf("Record #%d: Secret Key Found: ", job);
+		for (int i=0 ; i<SECRETKEY_BITS ; ++i) {
+			printf("%d", secretKey[i]);
+		}
+		printf("\n");
+	}
+	fflush(stdout);
+}
+
+
+
+
+/**
+ * \fn int encodeBatch(void* context, void* scratch, unsigned long long offset, const byte input[], size_t length, byte output[], size_t* produced)
+ * \brief Pipeline processing of --ENCODE: encodes a batch of messages, the last one being padded with zeroes
+ *
+ * When the stream is ciphered as well, every chunk of FUSED_CHUNK_BLOCKS messages is encrypted right after
+ * being encoded, while still in cache.
+ *
+ * \param[in]  context Stream to encrypt after encoding, NULL to only encode
+ * \param[in]  scratch Copy of the last batch, CODE_BATCH_BLOCKS*SOURCEWORD_LENGTH/8 bytes
+ * \param[in]  offset Position of the batch in the source, in bytes
+ * \param[in]  input Messages to encode, SOURCEWORD_LENGTH/8 bytes each
+ * \param[in]  length Length of the batch, in bytes
+ * \param[out] output Encoded messages, CODEWORD_LENGTH/8 bytes each
+ * \param[out] produced Number of bytes produced
+ * \return 0
+ */
+int encodeBatch(void* context, void* scratch, unsigned long long offset,
+                const byte input[], size_t length, byte output[], size_t* produced) {
+
+	// Padding of 0 for the last message (copied, since the source may be mapped read-only)
+	int blocks = (length + SOURCEWORD_LENGTH/8 - 1) / (SOURCEWORD_LENGTH/8);
+	if (length % (SOURCEWORD_LENGTH/8)) {
+		memcpy(scratch, input, length);
+		memset((byte*)scratch + length, 0, blocks*(SOURCEWORD_LENGTH/8) - length);
+		input = scratch;
+	}
+
+	const cipherStreamArgs* cipher = context;
+	if (!cipher) {
+		processPackedEncoding(input, output, blocks);
+	} else {
+		unsigned long long firstBlock = offset / (SOURCEWORD_LENGTH/8);
+		for (int b=0 ; b<blocks ; b+=FUSED_CHUNK_BLOCKS) {
+			int chunk = MIN(FUSED_CHUNK_BLOCKS, blocks-b);
+			processPackedEncoding(input + b*(SOURCEWORD_LENGTH/8), output + b*(CODEWORD_LENGTH/8), chunk);
+			cipherBlocks(cipher, firstBlock+b, output + b*(CODEWORD_LENGTH/8), chunk);
+		}
+	}
+	*produced = blocks*(CODEWORD_LENGTH/8);
+	return 0;
+}
+
+
+
+
+/**
+ * \fn int decodeBatch(void* context, void* scratch, unsigned long long offset, const byte input[], size_t length, byte output[], size_t* produced)
+ * \brief Pipeline processing of --DECODE with the algebraic decoder: decodes a batch of messages
+ *
+ * \param[in]  context Decoding context (see decodingContext)
+ * \param[in]  scratch Unused
+ * \param[in]  offset Position of the batch in the source, in bytes
+ * \param[in]  input Messages to decode, CODEWORD_LENGTH/8 bytes each
+ * \param[in]  length Length of the batch, in bytes
+ * \param[out] output Decoded messages, SOURCEWORD_LENGTH/8 bytes each
+ * \param[out] produced Number of bytes produced (the whole messages before an incomplete one are still decoded)
+ * \return 0 on success, PARTIAL_MESSAGE if the batch ends with an incomplete message
+ */
+int decodeBatch(void* context, void* scratch, unsigned long long offset,
+                const byte input[], size_t length, byte output[], size_t* produced) {
+
+	decodingContext* decoding = context;
+	unsigned int fireStatusCount[FIRE_UNCORRECTABLE+1] = {0};
+
+	FireStatus status[FUSED_CHUNK_BLOCKS];
+	byte plain[FUSED_CHUNK_BLOCKS*(CODEWORD_LENGTH/8)];
+	size_t blocks = length / (CODEWORD_LENGTH/8);
+	for (size_t b=0 ; b<blocks ; b+=FUSED_CHUNK_BLOCKS) {
+
+		// Ciphered messages are deciphered a chunk at a time, right before being decoded
+		size_t chunk = MIN(FUSED_CHUNK_BLOCKS, blocks-b);
+		const byte* messages = input + b*(CODEWORD_LENGTH/8);
+		if (decoding->cipher) {
+			memcpy(plain, messages, chunk*(CODEWORD_LENGTH/8));
+			cipherBlocks(decoding->cipher, offset/(CODEWORD_LENGTH/8) + b, plain, chunk);
+			messages = plain;
+		}
+
+		processPackedDecoding(messages, output + b*(SOURCEWORD_LENGTH/8), status, chunk);
+		for (size_t m=0 ; m<chunk ; ++m) {
+			++fireStatusCount[status[m]];
+		}
+	}
+
+	for (int i=0 ; i<=FIRE_UNCORRECTABLE ; ++i)
+		__atomic_fetch_add(&decoding->fireStatusCount[i], fireStatusCount[i], __ATOMIC_RELAXED);
+	*produced = blocks*(SOURCEWORD_LENGTH/8);
+	return (length % (CODEWORD_LENGTH/8)) ? PARTIAL_MESSAGE : 0;
+}
+
+
+
+
+/**
+ * \fn int viterbiDecodeBatch(void* context, void* scratch, unsigned long long offset, const byte input[], size_t length, byte output[], size_t* produced)
+ * \brief Pipeline processing of --DECODE with a Viterbi decoder: decodes a batch of messages
+ *
+ * \param[in]  context Decoding context (see decodingContext)
+ * \param[in]  scratch Fire decoding outcomes, soft bits and decoded bits of the batch (the last two for soft bits only)
+ * \param[in]  offset Position of the batch in the source, in bytes
+ * \param[in]  input Messages to decode, CODEWORD_LENGTH soft bits or CODEWORD_LENGTH/8 bytes of hard bits each
+ * \param[in]  length Length of the batch, in bytes
+ * \param[out] output Decoded messages, SOURCEWORD_LENGTH/8 bytes each
+ * \param[out] produced Number of bytes produced (the whole messages before an incomplete one are still decoded)
+ * \return 0 on success, PARTIAL_MESSAGE if the batch ends with an incomplete message
+ */
+int viterbiDecodeBatch(void* context, void* scratch, unsigned long long offset,
+                       const byte input[], size_t length, byte output[], size_t* produced) {
+
+	decodingContext* decoding = context;
+	unsigned int fireStatusCount[FIRE_UNCORRECTABLE+1] = {0};
+
+	// Soft bits take one byte each, hard-decided bits are packed
+	const size_t codewordBytes = (decoding->decoder == DECODER_VITERBI_SOFT) ? CODEWORD_LENGTH : CODEWORD_LENGTH/8;
+
+	FireStatus*  status  = scratch;
+	signed char* soft    = (signed char*)(status + CODE_BATCH_BLOCKS);
+	byte*        decoded = (byte*)(soft + CODE_BATCH_BLOCKS*CODEWORD_LENGTH);
+
+	int blocks = length / codewordBytes;
+	if (decoding->decoder == DECODER_VITERBI_SOFT && !decoding->cipher) {
+		processFullViterbiDecoding((const signed char*)input, decoded, status, blocks);
+	} else {
+		byte packed[FUSED_CHUNK_BLOCKS*(CODEWORD_LENGTH/8)];
+		for (int b=0 ; b<blocks ; b+=FUSED_CHUNK_BLOCKS) {
+
+			// Ciphered messages are deciphered a chunk at a time, right before being decoded:
+			// hard bits are XORed with the keystream, soft bits change sign wherever the keystream bit is set
+			int chunk = MIN(FUSED_CHUNK_BLOCKS, blocks-b);
+			const byte* bits = input + b*codewordBytes;
+
+			if (decoding->decoder == DECODER_VITERBI_SOFT) {
+				signed char* chunkSoft = soft + b*CODEWORD_LENGTH;
+				memset(packed, 0, chunk*(CODEWORD_LENGTH/8));
+				cipherBlocks(decoding->cipher, offset/codewordBytes + b, packed, chunk);
+				for (int i=0 ; i<chunk*CODEWORD_LENGTH ; ++i) {
+					signed char bit = MAX((signed char)bits[i], -SOFTBIT_MAX);
+					chunkSoft[i] = GET_CHARARRAY_BIT(packed, i) ? -bit : bit;
+				}
+				continue;
+			}
+
+			// Hard bits stay packed until they are deinterleaved
+			if (decoding->cipher) {
+				memcpy(packed, bits, chunk*(CODEWORD_LENGTH/8));
+				cipherBlocks(decoding->cipher, offset/codewordBytes + b, packed, chunk);
+				bits = packed;
+			}
+			processPackedViterbiDecoding(bits, output + b*(SOURCEWORD_LENGTH/8), status + b, chunk);
+		}
+		if (decoding->decoder == DECODER_VITERBI_SOFT)
+			processFullViterbiDecoding(soft, decoded, status, blocks);
+	}
+
+	for (int b=0 ; b<blocks ; ++b) {
+		++fireStatusCount[status[b]];
+		if (decoding->decoder == DECODER_VITERBI_SOFT)
+			BIT_VECTOR_TO_BYTE_VECTOR(decoded + b*SOURCEWORD_LENGTH, output + b*(SOURCEWORD_LENGTH/8), SOURCEWORD_LENGTH);
+	}
+
+	for (int i=0 ; i<=FIRE_UNCORRECTABLE ; ++i)
+		__atomic_fetch_add(&decoding->fireStatusCount[i], fireStatusCount[i], __ATOMIC_RELAXED);
+	*produced = blocks*(SOURCEWORD_LENGTH/8);
+	return (length % codewordBytes) ? PARTIAL_MESSAGE : 0;
+}
+
+
 /**
  * \fn int main(int argc, char* argv[])
  * \brief Program entry point
@@ -140,6 +399,9 @@ int main(int argc, char* argv[]) {
 
 	char param_sourcefile[255] = "";
 	char param_destfile[255]   = "";
+	char param_statsfile[255]  = "";
+	char param_journalfile[255] = "";
+	char param_progressfile[255] = "";
 
 	byte param_secretKey[SECRETKEY_BITS];
 	memset(param_secretKey, 0, SECRETKEY_BITS);
@@ -148,6 +410,26 @@ int main(int argc, char* argv[]) {
 
 	OperationParam param_operation = OP_NONE;
 
+	int           param_framed  = 0;
+	CipherFraming param_framing = CIPHER_PER_BLOCK;
+	CipherLink    param_link    = CIPHER_DOWNLINK;
+
+	DecoderParam  param_decoder = DECODER_ALGEBRAIC;
+
+	int param_threads = 0;
+
+	int param_batch = 0;
+
+	int param_messages = 0;
+
+	int            param_dictionarySet = 0;
+	DictionaryKind param_dictionary    = DICTIONARY_CIPHERTEXT;
+
+	int param_storedSet = 0;
+	int param_stored    = 100;
+
+	int param_resume = 0;
+
 	int argi = 1;
 
 	#define _UNIQUE_OPERATION_TEST(opcode)                                                         \
@@ -180,6 +462,14 @@ int main(int argc, char* argv[]) {
 
 			_UNIQUE_OPERATION_TEST(OP_PRECOMPUTE);
 
+		} else if (strcmp(argv[argi],"--VERIFY")==0) {
+
+			_UNIQUE_OPERATION_TEST(OP_VERIFY);
+
+		} else if (strcmp(argv[argi],"--TUNE")==0) {
+
+			_UNIQUE_OPERATION_TEST(OP_TUNE);
+
 		} else if (strcmp(argv[argi],"--AUTOTEST")==0) {
 
 			_UNIQUE_OPERATION_TEST(OP_AUTOTEST);
@@ -202,6 +492,24 @@ int main(int argc, char* argv[]) {
 			}
 			++argi;
 
+		} else if (strcmp(argv[argi],"-x")==0) {
+
+			if ((argi+1) >= argc){
+				printf("Invalid '-x' parameter\n"); return 1;
+			} else {
+				strncpy(param_statsfile, argv[argi+1], 254);
+			}
+			++argi;
+
+		} else if (strcmp(argv[argi],"-p")==0) {
+
+			if ((argi+1) >= argc){
+				printf("Invalid '-p' parameter\n"); return 1;
+			} else {
+				strncpy(param_progressfile, argv[argi+1], 254);
+			}
+			++argi;
+
 		} else if (strcmp(argv[argi],"-k")==0) {
 
 			if ((argi+1) >= argc
@@ -218,6 +526,95 @@ int main(int argc, char* argv[]) {
 			}
 			++argi;
 
+		} else if (strcmp(argv[argi],"-m")==0) {
+
+			if ((argi+1) < argc && strcmp(argv[argi+1],"block")==0) {
+				param_framing = CIPHER_PER_BLOCK;
+			} else if ((argi+1) < argc && strcmp(argv[argi+1],"burst")==0) {
+				param_framing = CIPHER_PER_BURST;
+			} else {
+				printf("Invalid '-m' parameter\n"); return 1;
+			}
+			param_framed = 1;
+			++argi;
+
+		} else if (strcmp(argv[argi],"-l")==0) {
+
+			if ((argi+1) < argc && strcmp(argv[argi+1],"downlink")==0) {
+				param_link = CIPHER_DOWNLINK;
+			} else if ((argi+1) < argc && strcmp(argv[argi+1],"uplink")==0) {
+				param_link = CIPHER_UPLINK;
+			} else {
+				printf("Invalid '-l' parameter\n"); return 1;
+			}
+			++argi;
+
+		} else if (strcmp(argv[argi],"-v")==0) {
+
+			if ((argi+1) < argc && strcmp(argv[argi+1],"hard")==0) {
+				param_decoder = DECODER_VITERBI_HARD;
+			} else if ((argi+1) < argc && strcmp(argv[argi+1],"soft")==0) {
+				param_decoder = DECODER_VITERBI_SOFT;
+			} else {
+				printf("Invalid '-v' parameter\n"); return 1;
+			}
+			++argi;
+
+		} else if (strcmp(argv[argi],"-t")==0) {
+
+			if ((argi+1) >= argc
+			|| (param_threads = atoi(argv[argi+1])) < 1 || param_threads > PIPELINE_MAX_THREADS) {
+				printf("Invalid '-t' parameter (1 to %d threads)\n", PIPELINE_MAX_THREADS); return 1;
+			}
+			++argi;
+
+		} else if (strcmp(argv[argi],"-b")==0) {
+
+			param_batch = 1;
+
+		} else if (strcmp(argv[argi],"-c")==0) {
+
+			if ((argi+1) < argc && strcmp(argv[argi+1],"ciphertext")==0) {
+				param_dictionary = DICTIONARY_CIPHERTEXT;
+			} else if ((argi+1) < argc && strcmp(argv[argi+1],"keystream")==0) {
+				param_dictionary = DICTIONARY_KEYSTREAM;
+			} else {
+				printf("Invalid '-c' parameter\n"); return 1;
+			}
+			param_dictionarySet = 1;
+			++argi;
+
+		} else if (strcmp(argv[argi],"-n")==0) {
+
+			if ((argi+1) >= argc
+			|| (param_messages = atoi(argv[argi+1])) < NEEDED_ENCRYPTED_MESSAGES || param_messages > MAX_ENCRYPTED_MESSAGES) {
+				printf("Invalid '-n' parameter (%d to %d messages)\n", NEEDED_ENCRYPTED_MESSAGES, MAX_ENCRYPTED_MESSAGES); return 1;
+			}
+			++argi;
+
+		} else if (strcmp(argv[argi],"-j")==0) {
+
+			if ((argi+1) >= argc){
+				printf("Invalid '-j' parameter\n"); return 1;
+			} else {
+				strncpy(param_journalfile, argv[argi+1], sizeof(param_journalfile)-1);
+				param_journalfile[sizeof(param_journalfile)-1] = '\0';
+			}
+			++argi;
+
+		} else if (strcmp(argv[argi],"--resume")==0) {
+
+			param_resume = 1;
+
+		} else if (strcmp(argv[argi],"-r")==0) {
+
+			if ((argi+1) >= argc || (param_stored = atoi(argv[argi+1])) < 0 || param_stored > 100
+			|| (param_stored == 0 && strcmp(argv[argi+1],"0")!=0)) {
+				printf("Invalid '-r' parameter (0 to 100%% of the dictionary)\n"); return 1;
+			}
+			param_storedSet = 1;
+			++argi;
+
 		} else if (strcmp(argv[argi],"-h")==0
 		       ||  strcmp(argv[argi],"--help")==0) {
 
@@ -245,32 +642,123 @@ int main(int argc, char* argv[]) {
 				printf("Invalid destination file\n"); return 1;
 			}
 		case OP_ATTACK:
-			if (strcmp(param_sourcefile, "")==0 || !fileExists(param_sourcefile)) {
+			if (strcmp(param_sourcefile, "")==0
+			|| (strcmp(param_sourcefile, FILEIO_STANDARD_STREAM)!=0 && !fileExists(param_sourcefile))) {
 				printf("Invalid source file\n"); return 1;
 			}
 
 		default:;
 	}
 
+	if (param_framed && param_operation != OP_ENCRYPT && param_operation != OP_ENCODE && param_operation != OP_DECODE) {
+		printf("Error: '-m' parameter is only relevant to encryption, encoding and decoding\n"); return 1;
+	}
+
+	if (param_decoder != DECODER_ALGEBRAIC && param_operation != OP_DECODE) {
+		printf("Error: '-v' parameter is only relevant to decoding\n"); return 1;
+	}
+
+	if (param_batch && param_operation != OP_ATTACK) {
+		printf("Error: '-b' parameter is only relevant to attack\n"); return 1;
+	}
+
+	if (param_storedSet && param_operation != OP_ATTACK && param_operation != OP_VERIFY) {
+		printf("Error: '-r' parameter is only relevant to attack and verification\n"); return 1;
+	}
+
+	// Without any stored matrix, the attack is given the shape of the problems instead of the dictionary
+	const int param_noDictionary = (param_operation == OP_ATTACK && param_stored == 0);
+	if (param_messages && param_operation != OP_PRECOMPUTE && !param_noDictionary) {
+		printf("Error: '-n' parameter is only relevant to precomputation and to attack with '-r 0'\n"); return 1;
+	}
+	if (param_dictionarySet && param_operation != OP_PRECOMPUTE && !param_noDictionary) {
+		printf("Error: '-c' parameter is only relevant to precomputation and to attack with '-r 0'\n"); return 1;
+	}
+	if (param_messages && param_dictionary == DICTIONARY_KEYSTREAM) {
+		printf("Error: '-n' parameter is not relevant to known-keystream dictionaries\n"); return 1;
+	}
+	if (!param_messages) {
+		param_messages = NEEDED_ENCRYPTED_MESSAGES;
+	}
+
+	if (strcmp(param_statsfile, "")!=0 && param_operation != OP_ATTACK) {
+		printf("Error: '-x' parameter is only relevant to attack\n"); return 1;
+	}
+	if (strcmp(param_journalfile, "")!=0 && param_operation != OP_ATTACK) {
+		printf("Error: '-j' parameter is only relevant to attack\n"); return 1;
+	}
+	if (param_resume && strcmp(param_journalfile, "")==0) {
+		printf("Error: '--resume' needs the journal of the attack to resume ('-j')\n"); return 1;
+	}
+
+	if (param_threads && param_operation != OP_ENCODE && param_operation != OP_DECODE && param_operation != OP_VERIFY
+	 && !(param_operation == OP_ENCRYPT && param_framed)) {
+		printf("Error: '-t' parameter is only relevant to encoding, decoding, re-keyed encryption and verification\n"); return 1;
+	}
+
+	// Profile written by --TUNE on this processor, if any: block widths and numbers of threads of the operations
+	// (a foreign profile is silently ignored, since the data may be written to the standard output)
+	tuneProfile profile;
+	tune_defaults(&profile);
+	if (param_operation != OP_TUNE && param_operation != OP_AUTOTEST && fileExists(TUNE_FILE)
+	 && tune_load(TUNE_FILE, &profile) == 0) {
+		tune_apply(&profile);
+	}
+	if (!param_threads) {
+		param_threads = profile.codecThreads;
+	}
+
+	if (strcmp(param_progressfile, "")!=0) {
+		if (param_operation == OP_ATTACK || param_operation == OP_AUTOTEST) {
+			printf("Error: '-p' parameter is not relevant to attack and autotest\n"); return 1;
+		}
+		progress_setReportFile(param_progressfile);
+	}
+
 	// Dictionary validity check
-	if (((param_operation==OP_ATTACK) || (param_operation==OP_AUTOTEST)) && (!fileExists("bin/matrices.bin"))) {
-		printf("Unable to locate dictionary 'bin/matrices.bin'.\nPlease launch the program with --PRECOMPUTE option before attacking.\n");
+	if (((param_operation==OP_ATTACK && !param_noDictionary) || (param_operation==OP_AUTOTEST) || (param_operation==OP_VERIFY))
+	 && (!fileExists(DICTIONARY_FILE))) {
+		printf("Unable to locate dictionary '" DICTIONARY_FILE "'.\nPlease launch the program with --PRECOMPUTE option before attacking.\n");
 		return 1;
 	}
 
-	// Secret Key and Frame Id
-	switch (param_operation) {
-		case OP_ENCRYPT:
-			printf("Using Secret Key: ");
-			for (int i=0 ; i<SECRETKEY_BITS ; ++i)
-				printf("%d", param_secretKey[i]);
-			printf("\n");
-		case OP_ATTACK:
-			printf("Using Frame Id: ");
-			for (int i=0 ; i<FRAMEID_BITS ; ++i)
-				printf("%d", param_frameId[i]);
-			printf("\n");
-		default:;
+	// Shared code matrices, relied upon by the coding, the attack and the generation of the dictionary
+	if (!code_getMatrices()) {
+		printf("Error: unable to allocate the code matrices\n");
+		return 1;
+	}
+
+	// Source and destination files, opened before any other message is displayed
+	// (when the data are written to the standard output, the messages go to the standard error stream)
+	fileio sourcefile, destfile;
+	if (param_operation == OP_ENCODE || param_operation == OP_DECODE || param_operation == OP_ENCRYPT
+	 || param_operation == OP_ATTACK) {
+		if (fileio_openInput(&sourcefile, param_sourcefile)) {
+			printf("Unable to open file [rb] '%s'\n", param_sourcefile);
+			return 1;
+		}
+	}
+	if (param_operation == OP_ENCODE || param_operation == OP_DECODE || param_operation == OP_ENCRYPT) {
+		if (fileio_openOutput(&destfile, param_destfile)) {
+			printf("Unable to open file [wb] '%s'\n", param_destfile);
+			return 1;
+		}
+	}
+
+	// Secret Key and Frame Id (encoding and decoding are fused with the cipher when re-keying every frame)
+	int keyed = (param_operation == OP_ENCRYPT)
+	         || ((param_operation == OP_ENCODE || param_operation == OP_DECODE) && param_framed);
+	if (keyed) {
+		printf("Using Secret Key: ");
+		for (int i=0 ; i<SECRETKEY_BITS ; ++i)
+			printf("%d", param_secretKey[i]);
+		printf("\n");
+	}
+	if ((keyed || param_operation == OP_ATTACK) && !param_batch) { // In batch mode, the Frame Ids are part of the records
+		printf("Using Frame Id: ");
+		for (int i=0 ; i<FRAMEID_BITS ; ++i)
+			printf("%d", param_frameId[i]);
+		printf("\n");
 	}
 
 
@@ -280,28 +768,12 @@ int main(int argc, char* argv[]) {
 	// ========================================================================================== //
 
 
-	byte G[SOURCEWORD_LENGTH][CODEWORD_LENGTH];
-
-	FILE* sourcefile;
-	FILE* destfile;
-
-	unsigned int filesize = 0;
-	unsigned int step     = 0;
 
+	// The processing loops only update the counter, the progress is displayed by the reporter thread
+	progressTracker progress;
 
-	byte sourceword_BitBuffer[SOURCEWORD_LENGTH];
-	byte sourceword_ByteBuffer[SOURCEWORD_LENGTH/8];
-	byte codeword_BitBuffer[CODEWORD_LENGTH];
-	byte codeword_ByteBuffer[CODEWORD_LENGTH/8];
-	memset(sourceword_BitBuffer,  0, SOURCEWORD_LENGTH);
-	memset(sourceword_ByteBuffer, 0, SOURCEWORD_LENGTH/8);
-	memset(codeword_BitBuffer,    0, CODEWORD_LENGTH);
-	memset(codeword_ByteBuffer,   0, CODEWORD_LENGTH/8);
 
-
-	byte encrword_BitBuffer[CODEWORD_LENGTH];
 	byte encrword_ByteBuffer[CODEWORD_LENGTH/8];
-	memset(encrword_BitBuffer,  0, CODEWORD_LENGTH);
 	memset(encrword_ByteBuffer, 0, CODEWORD_LENGTH/8);
 
 
@@ -312,27 +784,27 @@ int main(int argc, char* argv[]) {
 
 
 	cipherTextArgs ctArgs;
+	cipherStreamArgs csArgs;
 
 
-	int dataread = 0;
-
+	// Data are read in batches of blocks, straight from the mapped source file whenever possible
+	const byte* data;
+	size_t dataread = 0;
 
 
-    #define _LOAD_SOURCE                                                                               \
-        sourcefile = fopen(param_sourcefile, "rb");                                                    \
-        if (!sourcefile) {                                                                             \
-            printf("Unable to open file [rb] '%s'\n", param_sourcefile);                               \
-            return 1;                                                                                  \
-        }                                                                                              \
-        fseek(sourcefile, 0, SEEK_END); filesize = ftell(sourcefile); fseek(sourcefile, 0, SEEK_SET);
-
 
-    #define _LOAD_DEST                                                                                 \
-        destfile = fopen(param_destfile, "wb");                                                        \
-        if (!destfile) {                                                                               \
-            printf("Unable to open file [wb] '%s'\n", param_destfile);                                 \
+    #define _CLOSE_FILES                                                                               \
+        if (fileio_close(&destfile) | fileio_close(&sourcefile)) {                                     \
+            CLEARLINE; printf("Error: Unable to read or write the processed data                       \n"); \
             return 1;                                                                                  \
         }
+    //! On failure, the files are still closed, so that the blocks processed so far reach the destination
+    #define _ABORT_FILES                                                                               \
+        do {                                                                                           \
+            fileio_close(&destfile);                                                                   \
+            fileio_close(&sourcefile);                                                                 \
+            return 1;                                                                                  \
+        } while (0)
 
 
 	switch (param_operation) {
@@ -341,35 +813,29 @@ int main(int argc, char* argv[]) {
 
 			printf("Initialization... ");
 
-			_LOAD_SOURCE
-			_LOAD_DEST
-
-			processFullEncodingGMatrix(G);
-
-			dataread = 0;
-			memset(sourceword_ByteBuffer, 0, SOURCEWORD_LENGTH/8);
-			while ((dataread = fread(sourceword_ByteBuffer, sizeof(byte), SOURCEWORD_LENGTH/8, sourcefile))) {
-
-				CLEARLINE; printf("Encoding message... "); PROGRESSBAR_NOLF( (step+=dataread)*100/filesize );
-
-				if (dataread < SOURCEWORD_LENGTH/8) {
-					for (int k=(SOURCEWORD_LENGTH/8)-1 ; k>=dataread ; --k) {
-						sourceword_ByteBuffer[k] = 0; // Padding of 0
-					}
+			pipelineCodec encoder = {"Encoding message", CODE_BATCH_BLOCKS*(SOURCEWORD_LENGTH/8), CODE_BATCH_BLOCKS*(CODEWORD_LENGTH/8),
+			                         CODE_BATCH_BLOCKS*(SOURCEWORD_LENGTH/8), NULL, encodeBatch};
+			if (param_framed) {
+				if (cipher_initStream(&csArgs, param_secretKey, param_frameId, param_framing, param_link)) {
+					CLEARLINE; printf("Error: The frame Id is not a valid COUNT value (T1.T3.T2)                      \n");
+					_ABORT_FILES;
 				}
+				encoder.label   = "Encoding & encrypting";
+				encoder.context = &csArgs;
+			}
 
-				BYTE_VECTOR_TO_BIT_VECTOR(sourceword_ByteBuffer, sourceword_BitBuffer, SOURCEWORD_LENGTH);
-				BINPRODUCT_VECTOR_MATRIX(sourceword_BitBuffer, G, codeword_BitBuffer, SOURCEWORD_LENGTH, CODEWORD_LENGTH);
-				BIT_VECTOR_TO_BYTE_VECTOR(codeword_BitBuffer, codeword_ByteBuffer, CODEWORD_LENGTH);
-
-				fwrite(codeword_ByteBuffer, sizeof(byte), CODEWORD_LENGTH/8, destfile);
-				memset(sourceword_ByteBuffer, 0, SOURCEWORD_LENGTH/8);
+			if (pipeline_run(&encoder, &sourcefile, &destfile, param_threads)) {
+				CLEARLINE; printf("Error: Unable to read or write the processed data                       \n");
+				_ABORT_FILES;
 			}
 
-			fclose(destfile);
-			fclose(sourcefile);
+			_CLOSE_FILES
 
-			CLEARLINE; printf("File successfully encoded                                                       \n");
+			if (param_framed) {
+				CLEARLINE; printf("File successfully encoded and encrypted                                         \n");
+			} else {
+				CLEARLINE; printf("File successfully encoded                                                       \n");
+			}
 			return 0;
 			break;
 
@@ -379,33 +845,38 @@ int main(int argc, char* argv[]) {
 
 			printf("Initialization... ");
 
-			_LOAD_SOURCE
-			_LOAD_DEST
-
-			dataread = 0;
-			memset(codeword_ByteBuffer, 0, CODEWORD_LENGTH/8);
-			while ((dataread = fread(codeword_ByteBuffer, sizeof(byte), CODEWORD_LENGTH/8, sourcefile))) {
+			// Soft bits take one byte each, hard-decided bits are packed
+			const int codewordBytes = (param_decoder == DECODER_VITERBI_SOFT) ? CODEWORD_LENGTH : CODEWORD_LENGTH/8;
 
-				CLEARLINE; printf("Decoding message... "); PROGRESSBAR_NOLF( (step+=dataread)*100/filesize );
-
-				if (dataread < CODEWORD_LENGTH/8) {
-					CLEARLINE; printf("The file size isn't a multiple of 456bits: Unable to decode                     \n");
-					return 1;
+			decodingContext decoding = {param_decoder, NULL, {0}};
+			pipelineCodec decoder = {"Decoding message", CODE_BATCH_BLOCKS*codewordBytes, CODE_BATCH_BLOCKS*(SOURCEWORD_LENGTH/8),
+			                         0, &decoding, decodeBatch};
+			if (param_framed) {
+				if (cipher_initStream(&csArgs, param_secretKey, param_frameId, param_framing, param_link)) {
+					CLEARLINE; printf("Error: The frame Id is not a valid COUNT value (T1.T3.T2)                      \n");
+					_ABORT_FILES;
 				}
-
-				BYTE_VECTOR_TO_BIT_VECTOR(codeword_ByteBuffer, codeword_BitBuffer, CODEWORD_LENGTH);
-				processFullDecoding(codeword_BitBuffer, sourceword_BitBuffer);
-				BIT_VECTOR_TO_BYTE_VECTOR(sourceword_BitBuffer, sourceword_ByteBuffer, SOURCEWORD_LENGTH);
-
-				fwrite(sourceword_ByteBuffer, sizeof(byte), SOURCEWORD_LENGTH/8, destfile);
-				memset(codeword_ByteBuffer, 0, CODEWORD_LENGTH/8);
+				decoder.label   = "Decrypting & decoding";
+				decoding.cipher = &csArgs;
+			}
+			if (param_decoder != DECODER_ALGEBRAIC) {
+				decoder.scratch = CODE_BATCH_BLOCKS*(sizeof(FireStatus) + CODEWORD_LENGTH + SOURCEWORD_LENGTH);
+				decoder.process = viterbiDecodeBatch;
 			}
 
-			fclose(destfile);
-			fclose(sourcefile);
+			int outcome = pipeline_run(&decoder, &sourcefile, &destfile, param_threads);
+			if (outcome == PARTIAL_MESSAGE) {
+				CLEARLINE; printf("The file size isn't a multiple of 456bits: Unable to decode                     \n");
+				_ABORT_FILES;
+			} else if (outcome) {
+				CLEARLINE; printf("Error: Unable to read or write the processed data                       \n");
+				_ABORT_FILES;
+			}
 
+			_CLOSE_FILES
 
-			CLEARLINE; printf("File successfully decoded                                                       \n");
+			CLEARLINE; printf("File successfully decoded (%u corrected, %u uncorrectable messages)              \n", \
+			                  decoding.fireStatusCount[FIRE_CORRECTED], decoding.fireStatusCount[FIRE_UNCORRECTABLE]);
 			return 0;
 			break;
 
@@ -415,32 +886,50 @@ int main(int argc, char* argv[]) {
 
 			printf("Initialization... ");
 
-			_LOAD_SOURCE
-			_LOAD_DEST
+			if (param_framed) {
+
+				// The frame Id is advanced (and the cipher re-keyed) for every block or burst
+				if (cipher_initStream(&csArgs, param_secretKey, param_frameId, param_framing, param_link)) {
+					CLEARLINE; printf("Error: The frame Id is not a valid COUNT value (T1.T3.T2)                      \n");
+					return 1;
+				}
+				if (cipherStream(&csArgs, &sourcefile, &destfile, param_threads)) {
+					_ABORT_FILES;
+				}
+
+				_CLOSE_FILES
+
+				CLEARLINE; printf("File successfully encrypted/decrypted                                           \n");
+				return 0;
+			}
 
 			keysetup(param_secretKey, param_frameId);
 
-			dataread = 0;
-			memset(encrword_ByteBuffer, 0, CODEWORD_LENGTH/8);
-			while ((dataread = fread(encrword_ByteBuffer, sizeof(byte), CODEWORD_LENGTH/8, sourcefile))) {
+			progress_start(&progress, "Applying cipher", "B", sourcefile.size, 1);
 
-				CLEARLINE; printf("Applying cipher... "); PROGRESSBAR_NOLF( (step+=dataread)*100/filesize );
+			while ((dataread = fileio_read(&sourcefile, &data, CODE_BATCH_BLOCKS*(CODEWORD_LENGTH/8)))) {
 
-				if (dataread < CODEWORD_LENGTH/8) {
+				if (dataread % (CODEWORD_LENGTH/8)) {
+					progress_stop(&progress);
 					CLEARLINE; printf("Error: The file size isn't a multiple of 456bits: Unable to process             \n");
-					return 1;
+					_ABORT_FILES;
 				}
 
-				getKeystream(keystream_BitBuffer, CODEWORD_LENGTH);
-				BIT_VECTOR_TO_BYTE_VECTOR(keystream_BitBuffer, keystream_ByteBuffer, CODEWORD_LENGTH);
-				XOR_CHARARRAYS(encrword_ByteBuffer, keystream_ByteBuffer, CODEWORD_LENGTH/8);
+				for (size_t b=0 ; b<dataread/(CODEWORD_LENGTH/8) ; ++b) {
+					memcpy(encrword_ByteBuffer, data + b*(CODEWORD_LENGTH/8), CODEWORD_LENGTH/8);
+					getKeystream(keystream_BitBuffer, CODEWORD_LENGTH);
+					BIT_VECTOR_TO_BYTE_VECTOR(keystream_BitBuffer, keystream_ByteBuffer, CODEWORD_LENGTH);
+					XOR_CHARARRAYS(encrword_ByteBuffer, keystream_ByteBuffer, CODEWORD_LENGTH/8);
 
-				fwrite(encrword_ByteBuffer, sizeof(byte), CODEWORD_LENGTH/8, destfile);
-				memset(encrword_ByteBuffer, 0, CODEWORD_LENGTH/8);
+					fileio_write(&destfile, encrword_ByteBuffer, CODEWORD_LENGTH/8);
+				}
+
+				progress_add(&progress, 0, dataread);
 			}
 
-			fclose(destfile);
-			fclose(sourcefile);
+			progress_stop(&progress);
+
+			_CLOSE_FILES
 
 			CLEARLINE; printf("File successfully encrypted/decrypted                                           \n");
 			return 0;
@@ -451,38 +940,112 @@ int main(int argc, char* argv[]) {
 
 			printf("Initialization... ");
 
-			_LOAD_SOURCE
+			// The dictionary tells how many blocks of cipher text every problem is made of (unless
+			// no matrix is stored: they are then all generated on demand, as given by '-c' and '-n')
+			int messages = param_messages;
+			if (initializePartialRAM(DICTIONARY_FILE, param_stored, ATTACK_CACHED_MATRICES, param_dictionary, &messages)) {
+				printf("Error: Unable to load the dictionary\n");
+				fileio_close(&sourcefile); return 1;
+			}
 
+			// The journal is opened once the problems are read, right before the attack
+			attackJournal journalData;
+			attackJournal* journal = strcmp(param_journalfile, "") ? &journalData : NULL;
+
+			if (param_batch) {
+
+				// Every record is unpacked before the attack, in a single pass over the mapped source
+				// whenever possible (streams are read ATTACK_BATCH_JOBS records at a time)
+				cipherTextArgs* jobs = NULL;
+				int count = 0, capacity = 0;
+				size_t chunk = sourcefile.map ? MAX(sourcefile.size, 1ULL) : ATTACK_BATCH_JOBS*ATTACK_RECORD_BYTES(messages);
+				while ((dataread = fileio_read(&sourcefile, &data, chunk))) {
+
+					if (count + (int)(dataread/ATTACK_RECORD_BYTES(messages)) > capacity) {
+						capacity = MAX(2*capacity, count + (int)(dataread/ATTACK_RECORD_BYTES(messages)));
+						cipherTextArgs* grown = realloc(jobs, capacity*sizeof(cipherTextArgs));
+						if (!grown) {
+							printf("Error: unable to allocate the attack records\n");
+							free(jobs); fileio_close(&sourcefile); freeRAM(); return 1;
+						}
+						jobs = grown;
+					}
 
-			dataread = 0;
+					int records = attack_parseRecords(data, dataread, messages, jobs + count);
+					if (records < 0) {
+						printf("Error: The source file isn't made of whole records (%d bytes each)\n", (int)ATTACK_RECORD_BYTES(messages));
+						free(jobs); fileio_close(&sourcefile); freeRAM(); return 1;
+					}
+					count += records;
+				}
 
-			dataread += fread(encrword_ByteBuffer, sizeof(byte), CODEWORD_LENGTH/8, sourcefile);
-			BYTE_VECTOR_TO_BIT_VECTOR(encrword_ByteBuffer, ctArgs.cipherText1, CODEWORD_LENGTH);
+				if (fileio_close(&sourcefile) || !count) {
+					printf("Error: Unable to read attack records from the source file\n");
+					free(jobs); freeRAM(); return 1;
+				}
 
-			dataread += fread(encrword_ByteBuffer, sizeof(byte), CODEWORD_LENGTH/8, sourcefile);
-			BYTE_VECTOR_TO_BIT_VECTOR(encrword_ByteBuffer, ctArgs.cipherText2, CODEWORD_LENGTH);
+				byte (*secretKeys)[SECRETKEY_BITS] = malloc(count*sizeof(*secretKeys));
+				if (!secretKeys) {
+					printf("Error: unable to allocate the attack results\n");
+					free(jobs); freeRAM(); return 1;
+				}
 
-			dataread += fread(encrword_ByteBuffer, sizeof(byte), CODEWORD_LENGTH/8, sourcefile);
-			BYTE_VECTOR_TO_BIT_VECTOR(encrword_ByteBuffer, ctArgs.cipherText3, CODEWORD_LENGTH);
+				if (journal && attack_openJournal(journal, param_journalfile, param_resume)) {
+					printf("Error: Unable to open the journal '%s'\n", param_journalfile);
+					free(secretKeys); free(jobs); freeRAM(); return 1;
+				}
 
-			fclose(sourcefile);
+				// The results are displayed as soon as they are known
+				int unsolved = attack_batch(jobs, count, secretKeys, printAttackResult, NULL, \
+				                            strcmp(param_statsfile, "") ? param_statsfile : NULL, journal);
+				if (journal && attack_closeJournal(journal)) {
+					printf("Error: Unable to write the journal '%s'\n", param_journalfile);
+				}
+				freeRAM();
+				free(secretKeys);
+				free(jobs);
 
-			if (dataread != 3*CODEWORD_LENGTH/8) {
-				printf("Error: Source file too small to attack\n"); return 1;
+				if (unsolved < 0) {
+					printf("Attack Failed.\n");
+					return 1;
+				}
+				printf("Secret Keys Found: %d/%d\n", count-unsolved, count);
+				return unsolved != 0;
+			}
+
+			dataread = fileio_read(&sourcefile, &data, messages*CODEWORD_LENGTH/8);
+			if (dataread == (size_t)messages*CODEWORD_LENGTH/8) {
+				for (int m=0 ; m<messages ; ++m) {
+					BYTE_VECTOR_TO_BIT_VECTOR(data + m*CODEWORD_LENGTH/8, ctArgs.cipherText[m], CODEWORD_LENGTH);
+				}
+			}
+
+			fileio_close(&sourcefile);
+
+			if (dataread != (size_t)messages*CODEWORD_LENGTH/8) {
+				printf("Error: Source file too small to attack (%d blocks needed)\n", messages);
+				freeRAM(); return 1;
 			}
 
 			memcpy(ctArgs.frameId, param_frameId, FRAMEID_BITS);
 
 
+			if (journal && attack_openJournal(journal, param_journalfile, param_resume)) {
+				printf("Error: Unable to open the journal '%s'\n", param_journalfile);
+				freeRAM(); return 1;
+			}
+
 			byte decipheredSecretKey[SECRETKEY_BITS];
 
-			initializeRAM("bin/matrices.bin");
-			if (attack(&ctArgs, decipheredSecretKey)) {
+			int failed = attack(&ctArgs, decipheredSecretKey, strcmp(param_statsfile, "") ? param_statsfile : NULL, journal);
+			if (journal && attack_closeJournal(journal)) {
+				printf("Error: Unable to write the journal '%s'\n", param_journalfile);
+			}
+			freeRAM();
+			if (failed) {
 				printf("Attack Failed.\n");
-				freeRAM();
 				return 1;
 			}
-			freeRAM();
 
 			printf("Secret Key Found:\n");
 			for (int i=0 ; i<SECRETKEY_BITS ; ++i) {
@@ -497,7 +1060,38 @@ int main(int argc, char* argv[]) {
 		case OP_PRECOMPUTE: // --------------------------------------------------------------------
 
 			mkdir("bin", S_IRWXU | S_IRGRP | S_IROTH);
-			return exportAllMatrices("bin/matrices.bin");
+			return exportAllMatrices(DICTIONARY_FILE, param_dictionary, param_messages, profile.precomputeThreads);
+			break;
+
+
+		case OP_VERIFY: // ------------------------------------------------------------------------
+
+			printf("Verifying dictionary '" DICTIONARY_FILE "'...\n");
+			if (verifyDictionary(DICTIONARY_FILE, param_storedSet ? param_stored : VERIFY_DEFAULT_PERCENT, param_threads)) {
+				printf("Dictionary NOT verified: if it is corrupted, please launch the program with --PRECOMPUTE option again.\n");
+				return 1;
+			}
+			printf("Dictionary verified.\n");
+			return 0;
+			break;
+
+
+		case OP_TUNE: // --------------------------------------------------------------------------
+
+			printf("Tuning the kernels and the numbers of threads to this processor...\n\n");
+			if (tune_run(&profile)) {
+				printf("Error: Tuning failed\n");
+				return 1;
+			}
+			mkdir("bin", S_IRWXU | S_IRGRP | S_IROTH);
+			if (tune_save(TUNE_FILE, &profile)) {
+				printf("Error: Unable to write the profile '" TUNE_FILE "'\n");
+				return 1;
+			}
+			printf("\nProfile written to '" TUNE_FILE "': blocks of %u bits (elimination) and %u bits (product), "
+			       "%d attack, %d precomputation and %d codec threads\n", profile.bitmatrix.echelonBits,
+			       profile.bitmatrix.multiplyBits, profile.attackThreads, profile.precomputeThreads, profile.codecThreads);
+			return 0;
 			break;
 
 
@@ -508,12 +1102,27 @@ int main(int argc, char* argv[]) {
 
 			printf("======= STARTING AUTOTESTS =======\n");
 
+			printf("\n---- Testing Packed Matrices...\n");
+			++total_tests;   cumulative_res += bitmatrix_test();
+
 			printf("\n---- Testing Encoding and Decoding...\n");
 			++total_tests;   cumulative_res += code_test();
 
 			printf("\n---- Testing Keygen...\n");
 			++total_tests;   cumulative_res += keygen_test();
 
+			printf("\n---- Testing Block I/O...\n");
+			++total_tests;   cumulative_res += fileio_test();
+
+			printf("\n---- Testing Block Pipeline...\n");
+			++total_tests;   cumulative_res += pipeline_test();
+
+			printf("\n---- Testing Tuning Profiles...\n");
+			++total_tests;   cumulative_res += tune_test();
+
+			printf("\n---- Testing Frame-Keyed Cipher...\n");
+			++total_tests;   cumulative_res += cipher_test();
+
 			printf("\n---- Testing Keysetup Reverse...\n");
 			++total_tests;   cumulative_res += keysetup_reverse_test();
 
@@ -521,7 +1130,7 @@ int main(int argc, char* argv[]) {
 			++total_tests;   cumulative_res += matrices_generation_test();
 
 			printf("\n---- Testing Attack...\n");
-			++total_tests;   cumulative_res += attack_test();
+			++total_tests;   cumulative_res += attack_test(DICTIONARY_FILE);
 
 
 			printf("\n\n\n======= TEST REPORT =======\n");
@@ -29,22 +29,46 @@
   * @brief Implementation of first attack phase: matrices dictionary generation
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #30
-  * @date 01/12/2011
+  * @version File Revision #42
+  * @date 19/10/2026
   * */
 
 
+// fileno() and fstat() are POSIX extensions of the C99 library
+#define _POSIX_C_SOURCE 200112L
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <pthread.h>
 #include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include "utils.h"
+#include "bitmatrix.h"
 
 #include "matrices_generation.h"
 #include "code.h"
 #include "keygen.h"
+#include "progress.h"
+
+// Every resolution matrix row is stored on whole bytes in the dictionary file
+#if REGS_TOTAL_VARS % 8
+#error "REGS_TOTAL_VARS must be a multiple of 8"
+#endif
+
+//! Offset basis of the FNV-1a hash the checksums are based on
+#define DICTIONARY_CHECKSUM_START 14695981039346656037ULL
+
+//! Prime of the FNV-1a hash the checksums are based on
+#define DICTIONARY_CHECKSUM_PRIME 1099511628211ULL
+
+//! Number of consecutive matrices read at once when the checksums are verified
+#define VERIFY_READ_MATRICES 16
+
+//! Maximum number of corrupted blocks, then of wrong matrices, listed by the verification
+#define VERIFY_MAX_LISTED 16
 
 /**
  * \struct GenerationArgs
@@ -54,9 +78,40 @@
  * along with the file name to write the generated data subset to.
  */
 struct GenerationArgs {
-	int lowindex;       //!< Index to start the generation form (inclusive)
-	int highindex;      //!< Last index to be processed (exclusive)
-	char filename[255]; //!< Path of the file to write the generated data to
+	int lowindex;              //!< Index to start the generation form (inclusive)
+	int highindex;             //!< Last index to be processed (exclusive)
+	DictionaryKind kind;       //!< Attack the matrices are made for
+	int messages;              //!< Number of ciphered messages the matrices are made for
+	char filename[255];        //!< Path of the file to write the generated data to
+	progressTracker* progress; //!< Progress of the whole generation
+	int thread;                //!< Index of the thread in the progress tracker
+};
+
+
+/**
+ * \struct VerificationArgs
+ * \brief Set of arguments related to a thread in a multithreaded verification context
+ *
+ * VerificationArgs contains the blocks whose checksum is verified and the sampled matrices whose equations are
+ * checked by the thread, along with the outcome of each of them.
+ */
+struct VerificationArgs {
+	const char* filename;                //!< Path of the dictionary
+	off_t offset;                        //!< Position of the first matrix in the dictionary file
+	DictionaryKind kind;                 //!< Attack the matrices are made for
+	int messages;                        //!< Number of ciphered messages the matrices are made for
+	int lowblock;                        //!< First block whose checksum is verified (inclusive)
+	int highblock;                       //!< Last block whose checksum is verified (exclusive)
+	const unsigned long long* checksums; //!< Checksum of every block
+	byte* badBlocks;                     //!< Set for every block whose checksum differs
+	const int* samples;                  //!< Indices of the sampled matrices, in increasing order
+	int lowsample;                       //!< First sample checked (inclusive)
+	int highsample;                      //!< Last sample checked (exclusive)
+	byte* badSamples;                    //!< Set for every sample whose equations don't hold
+	unsigned int seed;                   //!< Seed of the random states of the LFSRs
+	progressTracker* progress;           //!< Progress of the whole verification
+	int thread;                          //!< Index of the thread in the progress tracker
+	int failed;                          //!< Set if the dictionary couldn't be read
 };
 
 
@@ -348,16 +403,15 @@ void matrices_generation_getOutBit(byte R1[R1_BITS][1+R1_SIMPLE_VARS], \
 
 
 /**
- * \fn void matrices_generation_processKeystreamEqns(const byte initialR4[], byte keystream[][REGS_TOTAL_VARS], const int len)
+ * \fn void matrices_generation_processKeystreamEqns(const byte initialR4[], bitmatrix* keystream)
  * \brief Generates the desired amount of keystream dependancy equations (skipping first 99cycles) considering one initial R4 state
  *
  * \param[in]  initialR4 Inferred initial value of the fourth LFSR
- * \param[out] keystream Keystream dependancy equations to be generated
- * \param[in]  len Desired amount of keystream dependancy equations
+ * \param[out] keystream Keystream dependancy equations to be generated, one per row (REGS_TOTAL_VARS columns)
  */
-void matrices_generation_processKeystreamEqns(const byte initialR4[], byte keystream[][REGS_TOTAL_VARS], const int len) {
+void matrices_generation_processKeystreamEqns(const byte initialR4[], bitmatrix* keystream) {
 
-	memset(keystream, 0, len*REGS_TOTAL_VARS*sizeof(byte));
+	bitmatrix_zero(keystream);
 
 	// For registers R1 R2 & R3, the first index (0) represents the constant "1"
 	byte R1[R1_BITS][1+R1_SIMPLE_VARS];
@@ -396,10 +450,10 @@ void matrices_generation_processKeystreamEqns(const byte initialR4[], byte keyst
 	// Next cycles: output placed in keystream
 	byte tmp[REGS_TOTAL_VARS];
 
-	for (int i=0 ; i<len ; ++i) {
+	for (unsigned int i=0 ; i<keystream->rows ; ++i) {
 
 		matrices_generation_getOutBit(R1, R2, R3, tmp); // bit export
-		memcpy(keystream[i], tmp, REGS_TOTAL_VARS*sizeof(byte));
+		bitmatrix_packVector(tmp, BITMATRIX_ROW(keystream, i), REGS_TOTAL_VARS);
 
 		matrices_generation_clockingUnit(R1, R2, R3, R4, 0);
 	}
@@ -438,7 +492,7 @@ int matrices_generation_getRealVariableIndex(unsigned int Reg, unsigned int inde
 
 
 /**
- * \fn byte matrices_generation_solveEquation(byte eqn[], byte R1[], byte R2[], byte R3[])
+ * \fn byte matrices_generation_solveEquation(const bitword eqn[], byte R1[], byte R2[], byte R3[])
  * \brief Returns the result of the evaluation of an expression with the given values of initial variables (for test purpose)
  *
  * \param[in] eqn Considered expression
@@ -447,47 +501,47 @@ int matrices_generation_getRealVariableIndex(unsigned int Reg, unsigned int inde
  * \param[in] R3 Contents of the third LFSR
  * \return Value of the expression described by eqn, after substituting LFSR values for variables
  */
-byte matrices_generation_solveEquation(byte eqn[], byte R1[], byte R2[], byte R3[]) {
+byte matrices_generation_solveEquation(const bitword eqn[], byte R1[], byte R2[], byte R3[]) {
 
 	byte res = 0;
 
 	// Processing single vars
 	for (int i=0 ; i<R1_SIMPLE_VARS ; ++i) {
-		if (eqn[i])
+		if (BITVECTOR_GET(eqn, i))
 			res ^= R1[matrices_generation_getRealVariableIndex(1,i)] & 1;
 	}
 	for (int i=0 ; i<R2_SIMPLE_VARS ; ++i) {
-		if (eqn[i+R1_SIMPLE_VARS])
+		if (BITVECTOR_GET(eqn, i+R1_SIMPLE_VARS))
 			res ^= R2[matrices_generation_getRealVariableIndex(2,i)] & 1;
 	}
 	for (int i=0 ; i<R3_SIMPLE_VARS ; ++i) {
-		if (eqn[i+R1_SIMPLE_VARS+R2_SIMPLE_VARS])
+		if (BITVECTOR_GET(eqn, i+R1_SIMPLE_VARS+R2_SIMPLE_VARS))
 			res ^= R3[matrices_generation_getRealVariableIndex(3,i)] & 1;
 	}
 
 	// Processing terminal "1" constant
-	if (eqn[REGS_TOTAL_VARS-1])
+	if (BITVECTOR_GET(eqn, REGS_TOTAL_VARS-1))
 		res ^= 1;
 
 	// Processing double vars
 	int i=REGS_SIMPLE_VARS; // iterator for convenience
 	for (int v1=0 ; v1<R1_SIMPLE_VARS ; ++v1) {
 		for (int v2=v1+1 ; v2<R1_SIMPLE_VARS ; ++v2) {
-			if (eqn[i])
+			if (BITVECTOR_GET(eqn, i))
 				res ^= (R1[matrices_generation_getRealVariableIndex(1,v1)] & R1[matrices_generation_getRealVariableIndex(1,v2)]) & 1;
 			++i;
 		}
 	}
 	for (int v1=0 ; v1<R2_SIMPLE_VARS ; ++v1) {
 		for (int v2=v1+1 ; v2<R2_SIMPLE_VARS ; ++v2) {
-			if (eqn[i])
+			if (BITVECTOR_GET(eqn, i))
 				res ^= (R2[matrices_generation_getRealVariableIndex(2,v1)] & R2[matrices_generation_getRealVariableIndex(2,v2)]) & 1;
 			++i;
 		}
 	}
 	for (int v1=0 ; v1<R3_SIMPLE_VARS ; ++v1) {
 		for (int v2=v1+1 ; v2<R3_SIMPLE_VARS ; ++v2) {
-			if (eqn[i])
+			if (BITVECTOR_GET(eqn, i))
 				res ^= (R3[matrices_generation_getRealVariableIndex(3,v1)] & R3[matrices_generation_getRealVariableIndex(3,v2)]) & 1;
 			++i;
 		}
@@ -513,18 +567,120 @@ void getR4fromIndex(const int index, byte R4[R4_BITS]) {
 
 
 /**
- * \fn int matrices_generation_exportMatrices(const char* filename, const int lowindex, const int highindex)
+ * \fn void matrices_generation_buildMatrix(const int index, bitmatrix* keystreamEqns, bitmatrix* HS, byte buffer[])
+ * \brief Processes the Resolution Matrix of a given index, using caller-provided work matrices
+ *
+ * The number of ciphered messages is given by the size of the work matrices.
+ *
+ * \param[in]  index Index of the matrix in [0..TOTAL_MATRICES-1]
+ * \param[out] keystreamEqns Work matrix, EQN_SYSTEM_SIZE(messages) × REGS_TOTAL_VARS
+ * \param[out] HS Work matrix, messages*SYNDROME_LENGTH × REGS_TOTAL_VARS
+ * \param[out] buffer Resolution Matrix, in its file representation
+ */
+void matrices_generation_buildMatrix(const int index, bitmatrix* keystreamEqns, bitmatrix* HS, byte buffer[]) {
+
+	// Code Matrix & Parity-Check Matrix needed to process Resolution Matrices
+	const codeMatrices* code = code_getMatrices();
+
+	// Since the (R4_INITIAL_CONST_POS)-th bit in R4 is constant value "1" whatever happens,
+	// the (R4_BITS-1) other bits of R4 are taken from the index, each value generating 1 matrix
+	byte R4[R4_BITS];
+	getR4fromIndex(index, R4);
+
+	matrices_generation_processKeystreamEqns(R4, keystreamEqns);
+
+	// We process HS via local sub-products of H with parts of keystreamEqns
+	for (unsigned int i=0 ; i<HS->rows/SYNDROME_LENGTH ; ++i) {
+		bitmatrix eqns, hs;
+		bitmatrix_view(keystreamEqns, i*CODEWORD_LENGTH, CODEWORD_LENGTH, &eqns);
+		bitmatrix_view(HS, i*SYNDROME_LENGTH, SYNDROME_LENGTH, &hs);
+		bitmatrix_multiply(&code->H, &eqns, &hs);
+	}
+
+	// File representation (REGS_TOTAL_VARS being a multiple of 8, rows are simply concatenated)
+	bitmatrix_toBytes(HS, buffer);
+}
+
+
+
+
+// Documentation in header file
+int generateMatrix(const int index, int messages, byte buffer[]) {
+
+	if (!code_getMatrices())
+		return 1;
+
+	bitmatrix keystreamEqns, HS;
+	if (bitmatrix_alloc(&keystreamEqns, EQN_SYSTEM_SIZE(messages), REGS_TOTAL_VARS))
+		return 1;
+	if (bitmatrix_alloc(&HS, messages*SYNDROME_LENGTH, REGS_TOTAL_VARS)) {
+		bitmatrix_free(&keystreamEqns);
+		return 1;
+	}
+
+	matrices_generation_buildMatrix(index, &keystreamEqns, &HS, buffer);
+
+	bitmatrix_free(&keystreamEqns);
+	bitmatrix_free(&HS);
+	return 0;
+}
+
+
+
+
+/**
+ * \fn void matrices_generation_buildKeystreamMatrix(const int index, bitmatrix* keystreamEqns, byte buffer[])
+ * \brief Processes the keystream equations of a given index, using a caller-provided work matrix
+ *
+ * \param[in]  index Index of the matrix in [0..TOTAL_MATRICES-1]
+ * \param[out] keystreamEqns Work matrix, KEYSTREAM_EQUATIONS × REGS_TOTAL_VARS
+ * \param[out] buffer Keystream equations, in their file representation
+ */
+void matrices_generation_buildKeystreamMatrix(const int index, bitmatrix* keystreamEqns, byte buffer[]) {
+
+	byte R4[R4_BITS];
+	getR4fromIndex(index, R4);
+
+	// The known keystream is directly the right-hand side of these equations: no syndrome is needed
+	matrices_generation_processKeystreamEqns(R4, keystreamEqns);
+	bitmatrix_toBytes(keystreamEqns, buffer);
+}
+
+
+
+
+// Documentation in header file
+int generateKeystreamMatrix(const int index, byte buffer[]) {
+
+	bitmatrix keystreamEqns;
+	if (bitmatrix_alloc(&keystreamEqns, KEYSTREAM_EQUATIONS, REGS_TOTAL_VARS))
+		return 1;
+
+	matrices_generation_buildKeystreamMatrix(index, &keystreamEqns, buffer);
+
+	bitmatrix_free(&keystreamEqns);
+	return 0;
+}
+
+
+
+
+/**
+ * \fn int matrices_generation_exportMatrices(const char* filename, const int lowindex, const int highindex, DictionaryKind kind, int messages, progressTracker* progress, int thread)
  * \brief Thread generation method
  *
  * \param[in] filename Path of the file to write the generated data to
  * \param[in] lowindex Index to start the generation form (inclusive)
  * \param[in] highindex Last index to be processed (exclusive)
+ * \param[in] kind Attack the matrices are made for
+ * \param[in] messages Number of ciphered messages the matrices are made for
+ * \param[in, out] progress Progress of the whole generation (may be NULL)
+ * \param[in] thread Index of the calling thread in the progress tracker
  * \return Number of generated matrices
  */
-int matrices_generation_exportMatrices(const char* filename, const int lowindex, const int highindex) {
+int matrices_generation_exportMatrices(const char* filename, const int lowindex, const int highindex, DictionaryKind kind,
+                                       int messages, progressTracker* progress, int thread) {
 
-    printf("File name: %d", lowindex);
-    
 	FILE* destfile = fopen(filename, "w+");
     
 	if (!destfile) {
@@ -532,75 +688,45 @@ int matrices_generation_exportMatrices(const char* filename, const int lowindex,
         return 0;
     }
 
-	// Code Matrix & Parity-Check Matrix needed to process Resolution Matrices
-	byte G[SOURCEWORD_LENGTH][CODEWORD_LENGTH];
-	processFullEncodingGMatrix(G);
-	byte H[SYNDROME_LENGTH][CODEWORD_LENGTH];
-	processFullEncodingHMatrix(G, H);
-
-	// Since the (R4_INITIAL_CONST_POS)-th bit in R4 is constant value "1" whatever happens,
-	// we are going to use an incremential vector of (R4_BITS-1) bits that will be merged with
-	// the constant to generate the 2^(R4_BITS-1) initialization vectors, each generating 1 matrix
-
-	byte R4[R4_BITS];
-	memset(R4, 0, (R4_BITS)*sizeof(byte));
-	R4[R4_INITIAL_CONST_POS] = 1; // This element will never be modified
-
 	// Set of keystream equations obtained from register initial state
-	byte keystreamEqns[EQN_SYSTEM_SIZE][REGS_TOTAL_VARS];
-	// Resolution matrix
-	byte HS[NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH][REGS_TOTAL_VARS];
-
-	// The way we traverse all possible values for R4 have no importance. We chose the faster way,
-	// which consists of using some mirrored version of i to fill the variable bits of R4.
+	bitmatrix keystreamEqns;
+	// Resolution matrix (unused by known-keystream dictionaries)
+	bitmatrix HS = {0};
+	unsigned int equations = (kind == DICTIONARY_KEYSTREAM) ? KEYSTREAM_EQUATIONS : EQN_SYSTEM_SIZE(messages);
+	if (bitmatrix_alloc(&keystreamEqns, equations, REGS_TOTAL_VARS)) {
+		fclose(destfile);
+		return 0;
+	}
+	if (kind == DICTIONARY_CIPHERTEXT && bitmatrix_alloc(&HS, messages*SYNDROME_LENGTH, REGS_TOTAL_VARS)) {
+		bitmatrix_free(&keystreamEqns);
+		fclose(destfile);
+		return 0;
+	}
 
+	const size_t size = DICTIONARY_MATRIX_BYTES(kind, messages);
 	for (int i=lowindex ; i<highindex ; ++i) {
 
-		if (i%128==0) {
-			printf("Thread #%d:  \tGenerating matrix #%d \t", lowindex/THREAD_CHUNKSIZE, i);
-			PROGRESSBAR((i-lowindex)*100/(highindex-lowindex));
+		byte buffer[size];
+		if (kind == DICTIONARY_KEYSTREAM) {
+			matrices_generation_buildKeystreamMatrix(i, &keystreamEqns, buffer);
+		} else {
+			matrices_generation_buildMatrix(i, &keystreamEqns, &HS, buffer);
 		}
-
-		// R4 Setting
-		for (int k=0 ; k < R4_INITIAL_CONST_POS ; ++k)
-			R4[k] = (i>>k)&1;
-		// R4[R4_INITIAL_CONST_POS] is already set to 1
-		for (int k=R4_INITIAL_CONST_POS ; k < (R4_BITS-1) ; ++k)
-			R4[k+1] = (i>>k)&1;
-
-		matrices_generation_processKeystreamEqns(R4, keystreamEqns, EQN_SYSTEM_SIZE);
-
-		// We process HS via local sub-products of H with parts of keystreamEqns
-		for (int i=0 ; i<NEEDED_ENCRYPTED_MESSAGES ; ++i) {
-			BINPRODUCT_MATRIX_MATRIX(H, keystreamEqns+i*CODEWORD_LENGTH, HS+i*SYNDROME_LENGTH, SYNDROME_LENGTH, REGS_TOTAL_VARS, CODEWORD_LENGTH);
-		}
-
-		// Export to file
-		byte buffer[BUFFER_SIZE];
-		memset(buffer, 0, BUFFER_SIZE);
-		for (int k=0 ; k<BUFFER_SIZE ; ++k) {
-			buffer[k] = ((HS[0][8*k  ]&1) << 7)
-			          | ((HS[0][8*k+1]&1) << 6)
-			          | ((HS[0][8*k+2]&1) << 5)
-			          | ((HS[0][8*k+3]&1) << 4)
-			          | ((HS[0][8*k+4]&1) << 3)
-			          | ((HS[0][8*k+5]&1) << 2)
-			          | ((HS[0][8*k+6]&1) << 1)
-			          | ((HS[0][8*k+7]&1)     );
-		}
-		if (fwrite(buffer, sizeof(byte), BUFFER_SIZE, destfile) != BUFFER_SIZE) {
+		if (fwrite(buffer, sizeof(byte), size, destfile) != size) {
 			DEBUG("Error: couldn't write out matrix #%d to file", i);
+			bitmatrix_free(&keystreamEqns);
+			bitmatrix_free(&HS);
+			fclose(destfile);
 			return (i-lowindex);
 		}
 
-
+		progress_add(progress, thread, 1);
 	}
 
+	bitmatrix_free(&keystreamEqns);
+	bitmatrix_free(&HS);
 	fclose(destfile);
 
-	printf("Thread #%d:  \tAll Matrices Generated [%d-%d] \t", lowindex/THREAD_CHUNKSIZE, lowindex, highindex);
-	PROGRESSBAR(100);
-
 	return (highindex-lowindex);
 
 }
@@ -619,7 +745,8 @@ void* matrices_generation_launchExport(void* data) {
 	
     struct GenerationArgs *args = data;
     
-	matrices_generation_exportMatrices(args->filename, args->lowindex, args->highindex);
+	matrices_generation_exportMatrices(args->filename, args->lowindex, args->highindex, args->kind, args->messages,
+	                                   args->progress, args->thread);
 	return NULL;
 }
 
@@ -627,34 +754,364 @@ void* matrices_generation_launchExport(void* data) {
 
 
 // Documentation in header file
-int exportAllMatrices(const char* filename) {
+int readDictionaryHeader(FILE* file, DictionaryKind* kind, int* messages) {
+
+	struct stat info;
+	if (fstat(fileno(file), &info)) {
+		DEBUG("Error: unable to get the size of the dictionary");
+		return 1;
+	}
+
+	byte header[DICTIONARY_HEADER_BYTES];
+	size_t headerRead = fread(header, sizeof(byte), DICTIONARY_HEADER_BYTES, file);
+	int ciphertext = (headerRead == DICTIONARY_HEADER_BYTES) && !memcmp(header, DICTIONARY_MAGIC, sizeof(DICTIONARY_MAGIC));
+	int keystream  = (headerRead == DICTIONARY_HEADER_BYTES) && !memcmp(header, DICTIONARY_KEYSTREAM_MAGIC, sizeof(DICTIONARY_KEYSTREAM_MAGIC));
+	if (ciphertext || keystream) {
+
+		*kind = keystream ? DICTIONARY_KEYSTREAM : DICTIONARY_CIPHERTEXT;
+		*messages = ((unsigned int)header[8] << 24) | (header[9] << 16) | (header[10] << 8) | header[11];
+		unsigned int matrices = ((unsigned int)header[12] << 24) | (header[13] << 16) | (header[14] << 8) | header[15];
+		int supported = keystream ? (*messages == KEYSTREAM_MESSAGES)
+		                          : (*messages >= NEEDED_ENCRYPTED_MESSAGES && *messages <= MAX_ENCRYPTED_MESSAGES);
+		if (!supported || matrices != TOTAL_MATRICES) {
+			DEBUG("Error: unsupported dictionary (%d messages, %u matrices)", *messages, matrices);
+			return 1;
+		}
+		if ((unsigned long long)info.st_size != DICTIONARY_HEADER_BYTES + (unsigned long long)TOTAL_MATRICES*DICTIONARY_MATRIX_BYTES(*kind, *messages)) {
+			DEBUG("Error: the dictionary is truncated");
+			return 1;
+		}
+		return 0;
+	}
+
+	// Dictionary without header, made for NEEDED_ENCRYPTED_MESSAGES messages
+	*kind = DICTIONARY_CIPHERTEXT;
+	*messages = NEEDED_ENCRYPTED_MESSAGES;
+	if ((unsigned long long)info.st_size != (unsigned long long)TOTAL_MATRICES*BUFFER_SIZE(NEEDED_ENCRYPTED_MESSAGES)) {
+		DEBUG("Error: the file isn't a dictionary");
+		return 1;
+	}
+	rewind(file);
+	return 0;
+}
+
+
+
+
+/**
+ * \fn int matrices_generation_writeHeader(FILE* file, DictionaryKind kind, int messages)
+ * \brief Writes the header of a dictionary file
+ *
+ * \param[in, out] file Dictionary, opened for writing
+ * \param[in]      kind Attack the dictionary is made for
+ * \param[in]      messages Number of ciphered messages (or of known keystream blocks) the dictionary is made for
+ * \return 0 if the header has been written, non-zero otherwise
+ */
+int matrices_generation_writeHeader(FILE* file, DictionaryKind kind, int messages) {
+
+	byte header[DICTIONARY_HEADER_BYTES];
+	memcpy(header, (kind == DICTIONARY_KEYSTREAM) ? DICTIONARY_KEYSTREAM_MAGIC : DICTIONARY_MAGIC, sizeof(DICTIONARY_MAGIC));
+	for (int k=0 ; k<4 ; ++k) {
+		header[8+k]  = (messages       >> (24-8*k)) & 0xFF;
+		header[12+k] = (TOTAL_MATRICES >> (24-8*k)) & 0xFF;
+	}
+	return fwrite(header, sizeof(byte), DICTIONARY_HEADER_BYTES, file) != DICTIONARY_HEADER_BYTES;
+}
+
+
+
+
+/**
+ * \fn unsigned long long matrices_generation_checksum(unsigned long long checksum, const byte matrix[], size_t size)
+ * \brief Adds a matrix to the checksum of its block
+ *
+ * The matrix is hashed 64 bits at a time on four independent FNV-1a lanes, so that the checksums are processed
+ * faster than the dictionary is read; the hash of the matrix is then added to the checksum (FNV-1a as well).
+ *
+ * \param[in] checksum Checksum of the previous matrices of the block (DICTIONARY_CHECKSUM_START for the first one)
+ * \param[in] matrix Matrix, as stored in the dictionary
+ * \param[in] size Size of the matrix, in bytes
+ * \return Checksum of the block up to this matrix
+ */
+unsigned long long matrices_generation_checksum(unsigned long long checksum, const byte matrix[], size_t size) {
+
+	unsigned long long lanes[4] = {DICTIONARY_CHECKSUM_START, DICTIONARY_CHECKSUM_START+1,
+	                               DICTIONARY_CHECKSUM_START+2, DICTIONARY_CHECKSUM_START+3};
+	size_t k = 0;
+	for ( ; k+sizeof(lanes) <= size ; k+=sizeof(lanes)) {
+		for (int l=0 ; l<4 ; ++l) {
+			unsigned long long word;
+			memcpy(&word, matrix+k+l*sizeof(word), sizeof(word));
+			lanes[l] = (lanes[l] ^ word) * DICTIONARY_CHECKSUM_PRIME;
+		}
+	}
+
+	unsigned long long hash = DICTIONARY_CHECKSUM_START;
+	for (int l=0 ; l<4 ; ++l)
+		hash = (hash ^ lanes[l]) * DICTIONARY_CHECKSUM_PRIME;
+	for ( ; k<size ; ++k)
+		hash = (hash ^ matrix[k]) * DICTIONARY_CHECKSUM_PRIME;
+
+	return (checksum ^ hash) * DICTIONARY_CHECKSUM_PRIME;
+}
+
+
+
+
+/**
+ * \fn int matrices_generation_readChecksums(const char* filename, DictionaryKind kind, int messages, unsigned long long checksums[DICTIONARY_CHECKSUM_BLOCKS])
+ * \brief Reads the checksums file of a dictionary
+ *
+ * \param[in]  filename Path of the checksums file
+ * \param[in]  kind Attack the dictionary is made for
+ * \param[in]  messages Number of ciphered messages (or of known keystream blocks) the dictionary is made for
+ * \param[out] checksums Checksum of every block
+ * \return 0 if the file gives every checksum of such a dictionary, non-zero otherwise
+ */
+int matrices_generation_readChecksums(const char* filename, DictionaryKind kind, int messages,
+                                      unsigned long long checksums[DICTIONARY_CHECKSUM_BLOCKS]) {
+
+	FILE* file = fopen(filename, "r");
+	if (!file)
+		return 1;
+
+	char magic[16], kindName[16];
+	int fileMessages, matrices, block;
+	int res = fscanf(file, "%15s %15s %d %d %d", magic, kindName, &fileMessages, &matrices, &block) != 5
+	       || strcmp(magic, DICTIONARY_CHECKSUMS_MAGIC)
+	       || strcmp(kindName, (kind == DICTIONARY_KEYSTREAM) ? "keystream" : "ciphertext")
+	       || fileMessages != messages || matrices != TOTAL_MATRICES || block != DICTIONARY_CHECKSUM_BLOCK;
+	for (int b=0 ; b<DICTIONARY_CHECKSUM_BLOCKS && !res ; ++b) {
+		res = fscanf(file, "%llx", &checksums[b]) != 1;
+	}
+
+	fclose(file);
+	return res;
+}
+
+
+
+
+/**
+ * \fn unsigned int matrices_generation_randomRegister(byte R[], int bits, int constPos, unsigned int* seed)
+ * \brief Fills a register with random bits, but for its bit forced to "1" by the keysetup
+ *
+ * \param[out]     R Contents of the register
+ * \param[in]      bits Length of the register
+ * \param[in]      constPos Position of the bit forced to "1"
+ * \param[in, out] seed State of the random generator
+ * \return Contents of the register, packed (bit #i is cell #i)
+ */
+unsigned int matrices_generation_randomRegister(byte R[], int bits, int constPos, unsigned int* seed) {
+
+	unsigned int packed = 0;
+	for (int i=0 ; i<bits ; ++i) {
+		R[i] = (i == constPos) ? 1 : (rand_r(seed) & 1);
+		packed |= (unsigned int)R[i] << i;
+	}
+	return packed;
+}
+
+
+
+
+/**
+ * \fn int matrices_generation_checkMatrix(const byte matrix[], bitmatrix* M, DictionaryKind kind, int messages, int index, unsigned int* seed)
+ * \brief Checks a stored matrix against the keystream of a random state of the LFSRs, R4 being the one the index designates
+ *
+ * \param[in]      matrix Matrix, as stored in the dictionary
+ * \param[in, out] M Work matrix, DICTIONARY_ROWS(kind, messages) × REGS_TOTAL_VARS
+ * \param[in]      kind Attack the dictionary is made for
+ * \param[in]      messages Number of ciphered messages (or of known keystream blocks) the dictionary is made for
+ * \param[in]      index Index of the matrix
+ * \param[in, out] seed State of the random generator
+ * \return 0 if every equation holds, non-zero otherwise
+ */
+int matrices_generation_checkMatrix(const byte matrix[], bitmatrix* M, DictionaryKind kind, int messages, int index,
+                                    unsigned int* seed) {
+
+	// State of the LFSRs once loaded by the keysetup (constant bits forced), on which the equations are written
+	byte R1[R1_BITS], R2[R2_BITS], R3[R3_BITS], R4[R4_BITS];
+	keygen_packedState state;
+	state.R1 = matrices_generation_randomRegister(R1, R1_BITS, R1_INITIAL_CONST_POS, seed);
+	state.R2 = matrices_generation_randomRegister(R2, R2_BITS, R2_INITIAL_CONST_POS, seed);
+	state.R3 = matrices_generation_randomRegister(R3, R3_BITS, R3_INITIAL_CONST_POS, seed);
+	getR4fromIndex(index, R4);
+	state.R4 = 0;
+	for (int i=0 ; i<R4_BITS ; ++i)
+		state.R4 |= (unsigned int)R4[i] << i;
+
+	// Keystream produced from this state
+	const int bits = (kind == DICTIONARY_KEYSTREAM) ? KEYSTREAM_EQUATIONS : messages*CODEWORD_LENGTH;
+	byte packedKeystream[MAX_ENCRYPTED_MESSAGES*CODEWORD_LENGTH/8], keystream[MAX_ENCRYPTED_MESSAGES*CODEWORD_LENGTH];
+	keygen_packedPreprocessing(&state);
+	keygen_packedKeystream(&state, packedKeystream, bits);
+	BYTE_VECTOR_TO_BIT_VECTOR(packedKeystream, keystream, bits);
+
+	// Value of every variable, as the value of the equation made of this variable alone
+	bitword variables[BITMATRIX_WORDS(REGS_TOTAL_VARS)], unit[BITMATRIX_WORDS(REGS_TOTAL_VARS)];
+	memset(variables, 0, sizeof(variables));
+	memset(unit, 0, sizeof(unit));
+	for (int j=0 ; j<REGS_TOTAL_VARS ; ++j) {
+		BITVECTOR_SET(unit, j, 1);
+		BITVECTOR_SET(variables, j, matrices_generation_solveEquation(unit, R1, R2, R3));
+		BITVECTOR_SET(unit, j, 0);
+	}
+
+	bitword values[BITMATRIX_WORDS(DICTIONARY_ROWS(DICTIONARY_CIPHERTEXT, MAX_ENCRYPTED_MESSAGES))];
+	bitmatrix_fromBytes(M, matrix);
+	bitmatrix_multiplyVector(M, variables, values);
+
+	// Known keystream: the equations give the keystream itself
+	if (kind == DICTIONARY_KEYSTREAM) {
+		for (int i=0 ; i<KEYSTREAM_EQUATIONS ; ++i) {
+			if (BITVECTOR_GET(values, i) != keystream[i])
+				return 1;
+		}
+		return 0;
+	}
+
+	// Resolution Matrix: the equations give the syndrome of the keystream of every message
+	const codeMatrices* code = code_getMatrices();
+	for (int m=0 ; m<messages ; ++m) {
+		bitword packed[BITMATRIX_WORDS(CODEWORD_LENGTH)], syndrome[BITMATRIX_WORDS(SYNDROME_LENGTH)];
+		bitmatrix_packVector(keystream + m*CODEWORD_LENGTH, packed, CODEWORD_LENGTH);
+		bitmatrix_multiplyVector(&code->H, packed, syndrome);
+		for (int i=0 ; i<SYNDROME_LENGTH ; ++i) {
+			if (BITVECTOR_GET(values, m*SYNDROME_LENGTH + i) != BITVECTOR_GET(syndrome, i))
+				return 1;
+		}
+	}
+	return 0;
+}
+
+
+
+
+/**
+ * \fn void* matrices_generation_launchVerification(void* data)
+ * \brief Verification thread: verifies the checksums of its blocks, then checks its sampled matrices
+ *
+ * \param[in, out] data Pointer to the thread's arguments
+ * \return NULL
+ */
+void* matrices_generation_launchVerification(void* data) {
+
+	struct VerificationArgs* args = data;
+	const size_t size = DICTIONARY_MATRIX_BYTES(args->kind, args->messages);
+
+	FILE* file = fopen(args->filename, "rb");
+	byte* buffer = malloc(VERIFY_READ_MATRICES*size);
+	bitmatrix M = {0};
+	args->failed = !file || !buffer || bitmatrix_alloc(&M, DICTIONARY_ROWS(args->kind, args->messages), REGS_TOTAL_VARS);
+
+	// The blocks of the thread are contiguous: they are read sequentially
+	if (!args->failed && args->lowblock < args->highblock)
+		args->failed = fseeko(file, args->offset + (off_t)args->lowblock*DICTIONARY_CHECKSUM_BLOCK*size, SEEK_SET) != 0;
+	for (int b=args->lowblock ; b<args->highblock && !args->failed ; ++b) {
+
+		unsigned long long checksum = DICTIONARY_CHECKSUM_START;
+		const int end = MIN((b+1)*DICTIONARY_CHECKSUM_BLOCK, TOTAL_MATRICES);
+		for (int k=b*DICTIONARY_CHECKSUM_BLOCK ; k<end && !args->failed ; k+=VERIFY_READ_MATRICES) {
+			const int count = MIN(VERIFY_READ_MATRICES, end-k);
+			args->failed = fread(buffer, size, count, file) != (size_t)count;
+			for (int j=0 ; j<count && !args->failed ; ++j) {
+				checksum = matrices_generation_checksum(checksum, buffer + j*size, size);
+			}
+			progress_add(args->progress, args->thread, count);
+		}
+		args->badBlocks[b] = (checksum != args->checksums[b]);
+	}
+
+	// The sampled matrices are read in increasing order
+	for (int s=args->lowsample ; s<args->highsample && !args->failed ; ++s) {
+		const int index = args->samples[s];
+		args->failed = fseeko(file, args->offset + (off_t)index*size, SEEK_SET) || fread(buffer, size, 1, file) != 1;
+		if (!args->failed)
+			args->badSamples[s] = matrices_generation_checkMatrix(buffer, &M, args->kind, args->messages, index, &args->seed);
+		progress_add(args->progress, args->thread, 1);
+	}
+
+	bitmatrix_free(&M);
+	free(buffer);
+	if (file)
+		fclose(file);
+	return NULL;
+}
+
+
+
+
+/**
+ * \fn int matrices_generation_compareIndices(const void* a, const void* b)
+ * \brief Orders indices of matrices for qsort()
+ *
+ * \param[in] a First index
+ * \param[in] b Second index
+ * \return Negative, zero or positive as \a a is lower, equal or greater than \a b
+ */
+int matrices_generation_compareIndices(const void* a, const void* b) {
+	int ia = *(const int*)a;
+	int ib = *(const int*)b;
+	return (ia > ib) - (ia < ib);
+}
+
+
+
+
+// Documentation in header file
+int exportAllMatrices(const char* filename, DictionaryKind kind, int messages, int threads) {
+
+	if (kind == DICTIONARY_KEYSTREAM) {
+		messages = KEYSTREAM_MESSAGES;
+	} else if (messages < NEEDED_ENCRYPTED_MESSAGES || messages > MAX_ENCRYPTED_MESSAGES) {
+		DEBUG("Error: dictionaries are made for %d to %d messages", NEEDED_ENCRYPTED_MESSAGES, MAX_ENCRYPTED_MESSAGES);
+		return 1;
+	}
+	if (kind == DICTIONARY_CIPHERTEXT && !code_getMatrices())
+		return 1;
+	threads = MIN(threads > 0 ? threads : PROCESSING_THREADS, MATRICES_GENERATION_MAX_THREADS);
 
 	time_t datetime = time(NULL);
 	struct tm *local = localtime(&datetime);
 	DEBUG("Matrices Generation started on %s", asctime(local));
 
-	pthread_t *t = malloc(PROCESSING_THREADS*sizeof(pthread_t));
-	struct GenerationArgs args[PROCESSING_THREADS];
+	pthread_t t[MATRICES_GENERATION_MAX_THREADS];
+	struct GenerationArgs args[MATRICES_GENERATION_MAX_THREADS];
+
+	// Workers only update their counters, the progress is displayed by the reporter thread
+	progressTracker progress;
+	progress_start(&progress, "Precomputing", "matrices", TOTAL_MATRICES, threads);
 
 	// Thread & Arguments Creation
-	for (int i=0 ; i<PROCESSING_THREADS ; ++i) {
+	int started;
+	for (started=0 ; started<threads ; ++started) {
 
+		int i = started;
 		sprintf(args[i].filename, "bin/tmp0x%08X.bin", i);
-		args[i].lowindex  =   i   * THREAD_CHUNKSIZE;
-		args[i].highindex = (i+1) * THREAD_CHUNKSIZE;
+		args[i].lowindex  = (int)((long long)  i   * TOTAL_MATRICES / threads);
+		args[i].highindex = (int)((long long)(i+1) * TOTAL_MATRICES / threads);
+		args[i].kind      = kind;
+		args[i].messages  = messages;
+		args[i].progress  = &progress;
+		args[i].thread    = i;
 
 		if (pthread_create(&t[i], NULL, matrices_generation_launchExport, &args[i])) {
-			DEBUG("Unable to create thread #%d\nKilling process.", i);
-			exit(1);
+			DEBUG("Unable to create thread #%d, giving up the generation", i);
+			break;
 		}
 	}
 
 
 	// Thread Joining
-	for (int i=0 ; i<PROCESSING_THREADS ; ++i) {
+	for (int i=0 ; i<started ; ++i) {
 		pthread_join(t[i], NULL);
 	}
-	free(t);
+
+	progress_stop(&progress);
+	if (started < threads)
+		return 1;
+	CLEARLINE; printf("All Matrices Generated                                                          \n");
 
 
 	// Files Merging
@@ -663,33 +1120,79 @@ int exportAllMatrices(const char* filename) {
 	DEBUG("Starting Merge on %s", asctime(local));
 
 	FILE* destfile = fopen(filename, "wb");
-	for (int i=0 ; i<PROCESSING_THREADS ; ++i) {
+	if (!destfile || matrices_generation_writeHeader(destfile, kind, messages)) {
+		DEBUG("Error: couldn't write out the header of the destination file");
+		if (destfile)
+			fclose(destfile);
+		return 1;
+	}
+
+	// The checksums of the blocks are processed along the way
+	char sumsname[300];
+	snprintf(sumsname, sizeof(sumsname), "%s" DICTIONARY_CHECKSUMS_SUFFIX, filename);
+	FILE* sumsfile = fopen(sumsname, "w");
+	if (!sumsfile || fprintf(sumsfile, DICTIONARY_CHECKSUMS_MAGIC " %s %d %d %d\n", (kind == DICTIONARY_KEYSTREAM) ? "keystream" : "ciphertext",
+	                         messages, TOTAL_MATRICES, DICTIONARY_CHECKSUM_BLOCK) < 0) {
+		DEBUG("Error: couldn't write out the checksums file '%s'", sumsname);
+		if (sumsfile)
+			fclose(sumsfile);
+		fclose(destfile);
+		return 1;
+	}
+	unsigned long long checksum = DICTIONARY_CHECKSUM_START;
+
+	// On failure, the loops are left with every file closed (the remaining temporary files are kept)
+	int res = 0;
+	for (int i=0 ; i<threads && !res ; ++i) {
 
 		FILE* sourcefile = fopen(args[i].filename, "rb");
+		if (!sourcefile) {
+			DEBUG("Error: Unable to open file %s", args[i].filename);
+			res = 1;
+			break;
+		}
 
-		byte buffer[BUFFER_SIZE];
-		for (int k=0 ; k<THREAD_CHUNKSIZE ; k++) {
+		const size_t size = DICTIONARY_MATRIX_BYTES(kind, messages);
+		byte buffer[size];
+		for (int k=args[i].lowindex ; k<args[i].highindex ; k++) {
 
-			memset(buffer, 0, BUFFER_SIZE);
-			if (fread(buffer, sizeof(byte), BUFFER_SIZE, sourcefile) != BUFFER_SIZE) {
+			memset(buffer, 0, size);
+			if (fread(buffer, sizeof(byte), size, sourcefile) != size) {
 				DEBUG("Error: Unable to read matrix #%d in file %s", k, args[i].filename);
-				return 1;
+				res = 1;
+				break;
 			}
-			if (fwrite(buffer, sizeof(byte), BUFFER_SIZE, destfile) != BUFFER_SIZE) {
+			if (fwrite(buffer, sizeof(byte), size, destfile) != size) {
 				DEBUG("Error: couldn't write out matrix #%d to destination file", k);
-				return 1;
+				res = 1;
+				break;
+			}
+
+			checksum = matrices_generation_checksum(checksum, buffer, size);
+			if (k % DICTIONARY_CHECKSUM_BLOCK == DICTIONARY_CHECKSUM_BLOCK-1 || k == TOTAL_MATRICES-1) {
+				fprintf(sumsfile, "%016llx\n", checksum);
+				checksum = DICTIONARY_CHECKSUM_START;
 			}
 
 		}
 
 		fclose(sourcefile);
 
-		if (remove(args[i].filename)) {
+		if (!res && remove(args[i].filename)) {
 			DEBUG("Warning: file '%s' couldn't be deleted. Please remove it manually.", args[i].filename);
 		}
 
 	}
-	fclose(destfile);
+	if (fclose(destfile) && !res) {
+		DEBUG("Error: couldn't write out the destination file");
+		res = 1;
+	}
+	if (fclose(sumsfile) && !res) {
+		DEBUG("Error: couldn't write out the checksums file '%s'", sumsname);
+		res = 1;
+	}
+	if (res)
+		return 1;
 
 	datetime = time(NULL);
 	local = localtime(&datetime);
@@ -701,6 +1204,134 @@ int exportAllMatrices(const char* filename) {
 
 
 
+// Documentation in header file
+int verifyDictionary(const char* filename, int percent, int threads) {
+
+	DictionaryKind kind;
+	int messages;
+	FILE* file = fopen(filename, "rb");
+	if (!file) {
+		DEBUG("Error: unable to open the dictionary '%s'", filename);
+		return 1;
+	}
+	if (readDictionaryHeader(file, &kind, &messages)) {
+		fclose(file);
+		return 1;
+	}
+	const off_t offset = ftello(file);
+	fclose(file);
+	if (kind == DICTIONARY_CIPHERTEXT && !code_getMatrices())
+		return 1;
+	threads = MIN(threads > 0 ? threads : PROCESSING_THREADS, MATRICES_GENERATION_MAX_THREADS);
+	percent = MIN(MAX(percent, 0), 100);
+
+	// Checksums of the blocks, written along with the dictionary
+	char sumsname[300];
+	snprintf(sumsname, sizeof(sumsname), "%s" DICTIONARY_CHECKSUMS_SUFFIX, filename);
+	unsigned long long checksums[DICTIONARY_CHECKSUM_BLOCKS];
+	const int blocks = matrices_generation_readChecksums(sumsname, kind, messages, checksums) ? 0 : DICTIONARY_CHECKSUM_BLOCKS;
+	if (!blocks)
+		DEBUG("Warning: no valid checksums file '%s', the blocks won't be verified", sumsname);
+
+	// Matrices checked against fresh keystream: every one of them, or a random sample (in increasing order)
+	const int samples = (percent == 100) ? TOTAL_MATRICES : MAX((int)((long long)TOTAL_MATRICES*percent/100), percent > 0);
+	if (!blocks && !samples) {
+		DEBUG("Error: nothing to verify without checksums nor sampled matrices");
+		return 1;
+	}
+	int* indices = malloc(TOTAL_MATRICES*sizeof(int));
+	byte* badBlocks  = calloc(DICTIONARY_CHECKSUM_BLOCKS, sizeof(byte));
+	byte* badSamples = calloc(MAX(samples, 1), sizeof(byte));
+	if (!indices || !badBlocks || !badSamples) {
+		DEBUG("Error: unable to allocate the verification data");
+		free(indices);
+		free(badBlocks);
+		free(badSamples);
+		return 1;
+	}
+	srand(time(NULL));
+	for (int i=0 ; i<TOTAL_MATRICES ; ++i)
+		indices[i] = i;
+	for (int s=0 ; s<samples && samples<TOTAL_MATRICES ; ++s) {
+		int j = s + (int)(((unsigned long long)rand() * RAND_MAX + rand()) % (TOTAL_MATRICES-s));
+		int index = indices[j];
+		indices[j] = indices[s];
+		indices[s] = index;
+	}
+	qsort(indices, samples, sizeof(int), matrices_generation_compareIndices);
+
+	pthread_t t[MATRICES_GENERATION_MAX_THREADS];
+	struct VerificationArgs args[MATRICES_GENERATION_MAX_THREADS];
+
+	// One tracker covers both passes: the checksummed matrices, then the sampled ones
+	progressTracker progress;
+	progress_start(&progress, "Verifying", "matrices", (unsigned long long)blocks*DICTIONARY_CHECKSUM_BLOCK + samples, threads);
+
+	int started;
+	for (started=0 ; started<threads ; ++started) {
+
+		int i = started;
+		args[i].filename   = filename;
+		args[i].offset     = offset;
+		args[i].kind       = kind;
+		args[i].messages   = messages;
+		args[i].lowblock   =   i   * blocks / threads;
+		args[i].highblock  = (i+1) * blocks / threads;
+		args[i].checksums  = checksums;
+		args[i].badBlocks  = badBlocks;
+		args[i].samples    = indices;
+		args[i].lowsample  = (int)((long long)  i   * samples / threads);
+		args[i].highsample = (int)((long long)(i+1) * samples / threads);
+		args[i].badSamples = badSamples;
+		args[i].seed       = rand();
+		args[i].progress   = &progress;
+		args[i].thread     = i;
+
+		if (pthread_create(&t[i], NULL, matrices_generation_launchVerification, &args[i])) {
+			DEBUG("Unable to create thread #%d, giving up the verification", i);
+			break;
+		}
+	}
+
+	int failed = (started < threads);
+	for (int i=0 ; i<started ; ++i) {
+		pthread_join(t[i], NULL);
+		failed |= args[i].failed;
+	}
+	progress_stop(&progress);
+	CLEARLINE; printf("Dictionary Read                                                                 \n");
+
+
+	// Report
+	int corruptedBlocks = 0, wrongMatrices = 0;
+	for (int b=0 ; b<blocks && !failed ; ++b) {
+		if (badBlocks[b] && ++corruptedBlocks <= VERIFY_MAX_LISTED) {
+			printf("Block #%d (matrices #%d to #%d): checksum mismatch\n", b, b*DICTIONARY_CHECKSUM_BLOCK,
+			       MIN((b+1)*DICTIONARY_CHECKSUM_BLOCK, TOTAL_MATRICES)-1);
+		}
+	}
+	for (int s=0 ; s<samples && !failed ; ++s) {
+		if (badSamples[s] && ++wrongMatrices <= VERIFY_MAX_LISTED) {
+			printf("Matrix #%d: the equations don't hold for the keystream\n", indices[s]);
+		}
+	}
+	free(indices);
+	free(badBlocks);
+	free(badSamples);
+
+	if (failed) {
+		DEBUG("Error: the dictionary couldn't be read");
+		return 1;
+	}
+	if (blocks)
+		printf("Checksums: %d block(s) of %d matrices verified, %d corrupted\n", blocks, DICTIONARY_CHECKSUM_BLOCK, corruptedBlocks);
+	printf("Equations: %d matrice(s) checked against fresh keystream, %d wrong\n", samples, wrongMatrices);
+	return corruptedBlocks || wrongMatrices;
+}
+
+
+
+
 // Documentation in header file
 int matrices_generation_test() {
 
@@ -715,8 +1346,9 @@ int matrices_generation_test() {
 	// Original value of R4 after keysetup (without the 99 discarded cycles)
 	byte initialR4[R4_BITS] = {1,1,1,1,0,1,1,1,0,1,1,0,0,0,0,0,0};
 	// From it, we generate equations on the bits of R1, R2 & R3
-	byte keystreamEqns[228][REGS_TOTAL_VARS];
-	matrices_generation_processKeystreamEqns(initialR4, keystreamEqns, 228);
+	bitmatrix keystreamEqns;
+	bitmatrix_alloc(&keystreamEqns, 228, REGS_TOTAL_VARS);
+	matrices_generation_processKeystreamEqns(initialR4, &keystreamEqns);
 
 	// Original keystream given by A5/2 cipher
 	byte keystream[228];
@@ -726,12 +1358,55 @@ int matrices_generation_test() {
 
 	// We check that each equation we found coincide with the original data
 	for (int i=0 ; i<228 ; ++i) {
-		byte tmp = matrices_generation_solveEquation(keystreamEqns[i], R1, R2, R3);
+		byte tmp = matrices_generation_solveEquation(BITMATRIX_ROW(&keystreamEqns, i), R1, R2, R3);
 		if (keystream[i] != tmp) {
 			DEBUG("Self-check aborted: a discrepancy was found in the equations.");
+			bitmatrix_free(&keystreamEqns);
 			return 1;
 		}
 	}
+	bitmatrix_free(&keystreamEqns);
+
+	// The keystream equations of a known-keystream dictionary must determine every unknown
+	int index = 0;
+	for (int k=0 ; k<R4_BITS-1 ; ++k)
+		index |= initialR4[(k<R4_INITIAL_CONST_POS) ? k : k+1] << k;
+	byte buffer[KEYSTREAM_BUFFER_SIZE];
+	bitmatrix keystreamMatrix;
+	if (generateKeystreamMatrix(index, buffer) || bitmatrix_alloc(&keystreamMatrix, KEYSTREAM_EQUATIONS, REGS_TOTAL_VARS)) {
+		DEBUG("Self-check aborted: unable to generate the keystream equations.");
+		return 1;
+	}
+	bitmatrix_fromBytes(&keystreamMatrix, buffer);
+	unsigned int rank = bitmatrix_echelon(&keystreamMatrix, REGS_TOTAL_VARS-1, 0, NULL);
+	if (rank != REGS_TOTAL_VARS-1) {
+		DEBUG("Self-check aborted: the keystream equations only determine %u unknowns.", rank);
+		bitmatrix_free(&keystreamMatrix);
+		return 1;
+	}
+
+	// The verification of a dictionary accepts freshly generated matrices, and rejects a matrix whose equation
+	// has its constant term flipped (which changes its value whatever the state of the LFSRs)
+	byte resolution[BUFFER_SIZE(NEEDED_ENCRYPTED_MESSAGES)];
+	bitmatrix resolutionMatrix;
+	if (generateMatrix(index, NEEDED_ENCRYPTED_MESSAGES, resolution)
+	 || bitmatrix_alloc(&resolutionMatrix, DICTIONARY_ROWS(DICTIONARY_CIPHERTEXT, NEEDED_ENCRYPTED_MESSAGES), REGS_TOTAL_VARS)) {
+		DEBUG("Self-check aborted: unable to generate the Resolution Matrix.");
+		bitmatrix_free(&keystreamMatrix);
+		return 1;
+	}
+	unsigned int seed = 1;
+	int accepted = !matrices_generation_checkMatrix(buffer, &keystreamMatrix, DICTIONARY_KEYSTREAM, KEYSTREAM_MESSAGES, index, &seed)
+	            && !matrices_generation_checkMatrix(resolution, &resolutionMatrix, DICTIONARY_CIPHERTEXT, NEEDED_ENCRYPTED_MESSAGES, index, &seed);
+	BITMATRIX_FLIP(&resolutionMatrix, SYNDROME_LENGTH+5, REGS_TOTAL_VARS-1);
+	bitmatrix_toBytes(&resolutionMatrix, resolution);
+	int rejected = matrices_generation_checkMatrix(resolution, &resolutionMatrix, DICTIONARY_CIPHERTEXT, NEEDED_ENCRYPTED_MESSAGES, index, &seed);
+	bitmatrix_free(&keystreamMatrix);
+	bitmatrix_free(&resolutionMatrix);
+	if (!accepted || !rejected) {
+		DEBUG("Self-check aborted: the verification of the dictionaries %s.", accepted ? "accepts a wrong matrix" : "rejects a right matrix");
+		return 1;
+	}
 
 	DEBUG("Self-check succeeded: the equations are all right");
 	return 0;
@@ -29,28 +29,97 @@
   * @brief Specification of first attack phase: matrices dictionary generation
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #13
-  * @date 24/06/2011
+  * @version File Revision #18
+  * @date 19/10/2026
   * */
 
 
 #ifndef _MATRICES_GENERATION_H_
 #define _MATRICES_GENERATION_H_
 
+#include <stdio.h>
+
 #include "const_A52.h"
 #include "const_code.h"
 
 
 // Decryption related constants
 
-//! Number of ciphered messages needed to proceed to decryption
+//! Number of ciphered messages needed to proceed to decryption (fewest messages of a dictionary, and default)
 #define NEEDED_ENCRYPTED_MESSAGES 3
 
-//! Number of equations to generate
-#define EQN_SYSTEM_SIZE (NEEDED_ENCRYPTED_MESSAGES*CODEWORD_LENGTH)
+//! Most ciphered messages a dictionary can be generated for
+#define MAX_ENCRYPTED_MESSAGES 8
+
+//! Number of equations to generate for a dictionary of \a messages ciphered messages
+#define EQN_SYSTEM_SIZE(messages) ((messages)*CODEWORD_LENGTH)
+
+//! Buffer size corresponding to the generated equations, for a dictionary of \a messages ciphered messages
+#define BUFFER_SIZE(messages)     ((size_t)(messages)*SYNDROME_LENGTH*REGS_TOTAL_VARS/8)
+
+//! Number of known keystream blocks needed by a known-keystream attack
+#define KEYSTREAM_MESSAGES 2
+
+//! Number of keystream equations of a known-keystream dictionary: the REGS_TOTAL_VARS-1 unknowns are all
+//! determined well before, the remaining equations reject the wrong indices (KEYSTREAM_MESSAGES blocks needed)
+#define KEYSTREAM_EQUATIONS 720
+
+//! Buffer size corresponding to the keystream equations of a known-keystream dictionary
+#define KEYSTREAM_BUFFER_SIZE     ((size_t)KEYSTREAM_EQUATIONS*REGS_TOTAL_VARS/8)
+
+
+// Dictionary file: a header, then the TOTAL_MATRICES Resolution Matrices, index after index.
+// Dictionaries exported before the header was introduced are recognized by their size (NEEDED_ENCRYPTED_MESSAGES).
+
+//! Identifier at the beginning of a ciphertext-only dictionary file (8 bytes, null byte included)
+#define DICTIONARY_MAGIC "A52DICT"
+
+//! Identifier at the beginning of a known-keystream dictionary file (8 bytes, null byte included)
+#define DICTIONARY_KEYSTREAM_MAGIC "A52KEYS"
+
+//! Size of the header of a dictionary file: DICTIONARY_MAGIC, the number of ciphered messages and the number of
+//! matrices (4 bytes each, big-endian)
+#define DICTIONARY_HEADER_BYTES 16
+
+//! Number of rows of the matrices of a dictionary
+#define DICTIONARY_ROWS(kind, messages) ((kind)==DICTIONARY_KEYSTREAM ? KEYSTREAM_EQUATIONS : (messages)*SYNDROME_LENGTH)
+
+//! Size of the matrices of a dictionary, as stored in the file
+#define DICTIONARY_MATRIX_BYTES(kind, messages) ((kind)==DICTIONARY_KEYSTREAM ? KEYSTREAM_BUFFER_SIZE : BUFFER_SIZE(messages))
+
+//! Maximum number of threads generating a dictionary
+#define MATRICES_GENERATION_MAX_THREADS 64
 
-//! Buffer size corresponding to the generated equations
-#define BUFFER_SIZE     (NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH*REGS_TOTAL_VARS/8)
+
+// Checksums file, written along with a dictionary: a DICTIONARY_CHECKSUMS_MAGIC line giving the kind of the dictionary,
+// its number of messages, of matrices and of matrices per block, then the checksum of every block (hexadecimal).
+
+//! Suffix appended to the path of a dictionary to get the path of its checksums file
+#define DICTIONARY_CHECKSUMS_SUFFIX ".sum"
+
+//! Identifier at the beginning of a checksums file
+#define DICTIONARY_CHECKSUMS_MAGIC "A52SUMS"
+
+//! Number of consecutive matrices covered by a checksum
+#define DICTIONARY_CHECKSUM_BLOCK 1024
+
+//! Number of checksums of a dictionary
+#define DICTIONARY_CHECKSUM_BLOCKS ((TOTAL_MATRICES+DICTIONARY_CHECKSUM_BLOCK-1)/DICTIONARY_CHECKSUM_BLOCK)
+
+//! Default percentage of the matrices checked against fresh keystream by verifyDictionary()
+#define VERIFY_DEFAULT_PERCENT 1
+
+
+
+
+/**
+ * \enum DictionaryKind
+ * \brief Attack a dictionary is made for
+ */
+typedef enum {
+	DICTIONARY_CIPHERTEXT, //!< Ciphertext only: syndromes of the keystream equations (Resolution Matrices)
+	DICTIONARY_KEYSTREAM   //!< Known keystream: the keystream equations themselves
+} DictionaryKind;
 
 
 
@@ -68,13 +137,76 @@ void getR4fromIndex(const int index, byte R4[R4_BITS]);
 
 
 /**
- * \fn int exportAllMatrices(const char* filename)
- * \brief Exports all Resolution Matrices into the specified file
+ * \fn int generateMatrix(const int index, int messages, byte buffer[])
+ * \brief Processes the Resolution Matrix of a given index, as stored in the exported file
+ *
+ * \param[in]  index Index of the matrix in [0..TOTAL_MATRICES-1]
+ * \param[in]  messages Number of ciphered messages the matrix is made for
+ * \param[out] buffer Resolution Matrix (BUFFER_SIZE(messages) bytes, one row after the other, 8 bits per byte)
+ * \return 0 if the generation is successfull, non-zero otherwise
+ */
+int generateMatrix(const int index, int messages, byte buffer[]);
+
+
+
+
+/**
+ * \fn int generateKeystreamMatrix(const int index, byte buffer[])
+ * \brief Processes the keystream equations of a given index, as stored in a known-keystream dictionary
+ *
+ * \param[in]  index Index of the matrix in [0..TOTAL_MATRICES-1]
+ * \param[out] buffer Keystream equations (KEYSTREAM_BUFFER_SIZE bytes, one row after the other, 8 bits per byte)
+ * \return 0 if the generation is successfull, non-zero otherwise
+ */
+int generateKeystreamMatrix(const int index, byte buffer[]);
+
+
+
+
+/**
+ * \fn int readDictionaryHeader(FILE* file, DictionaryKind* kind, int* messages)
+ * \brief Reads the header of a dictionary file, which is left positioned on its first matrix
+ *
+ * \param[in, out] file Dictionary, opened for reading
+ * \param[out]     kind Attack the dictionary is made for
+ * \param[out]     messages Number of ciphered messages (or of known keystream blocks) the dictionary is made for
+ * \return 0 if the file is a valid dictionary, non-zero otherwise
+ */
+int readDictionaryHeader(FILE* file, DictionaryKind* kind, int* messages);
+
+
+
+
+/**
+ * \fn int exportAllMatrices(const char* filename, DictionaryKind kind, int messages, int threads)
+ * \brief Exports all Resolution Matrices (or keystream equations) into the specified file, along with its checksums file
  *
  * \param[in] filename Path of the file to export to
+ * \param[in] kind Attack the dictionary is made for
+ * \param[in] messages Number of ciphered messages the dictionary is made for
+ *             (NEEDED_ENCRYPTED_MESSAGES to MAX_ENCRYPTED_MESSAGES, ignored for a known-keystream dictionary)
+ * \param[in] threads Number of generating threads (0 for PROCESSING_THREADS, at most MATRICES_GENERATION_MAX_THREADS)
  * \return 0 if the export is successfull, non-zero otherwise
  */
-int exportAllMatrices(const char* filename);
+int exportAllMatrices(const char* filename, DictionaryKind kind, int messages, int threads);
+
+
+
+
+/**
+ * \fn int verifyDictionary(const char* filename, int percent, int threads)
+ * \brief Checks a dictionary: the checksum of every block, and the equations of a random sample of matrices
+ *
+ * The blocks are read sequentially by every thread, and their checksums compared to the checksums file (skipped if
+ * missing). The sampled matrices must hold for the keystream of random states of the LFSRs, as loaded by the
+ * keysetup of any key and frame, R4 being the one the index designates.
+ *
+ * \param[in] filename Path of the dictionary
+ * \param[in] percent Percentage of the matrices checked against fresh keystream (100 for all of them)
+ * \param[in] threads Number of threads (0 for PROCESSING_THREADS, at most MATRICES_GENERATION_MAX_THREADS)
+ * \return 0 if the dictionary is valid, non-zero if it is corrupted or cannot be read
+ */
+int verifyDictionary(const char* filename, int percent, int threads);
 
 
 
@@ -0,0 +1,497 @@
+/*============================================================================*
+ *                                                                            *
+ *                                  pipeline.c                                *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file pipeline.c
+  * @brief Multithreaded block pipeline: reader, pool of workers and in-order writer
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #1
+  * @date 19/10/2026
+  * */
+
+
+
+// sysconf() and pipe() are POSIX extensions of the C99 library
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "utils.h"
+
+#include "pipeline.h"
+#include "progress.h"
+
+
+
+
+/**
+ * \enum PipelineSlotState
+ * \brief Stage reached by the batch stored in a ring slot
+ */
+typedef enum {
+	PIPELINE_SLOT_FREE,      //!< Available to the reader
+	PIPELINE_SLOT_READ,      //!< Waiting for a worker (or being processed)
+	PIPELINE_SLOT_PROCESSED  //!< Waiting for the writer
+} PipelineSlotState;
+
+
+/**
+ * \struct pipelineSlot
+ * \brief Ring slot: one batch along with its processed data
+ */
+typedef struct {
+	PipelineSlotState state;   //!< Stage of the batch
+	const byte* input;         //!< Batch to process (inside the mapped source, or copied to inputBuffer)
+	byte* inputBuffer;         //!< Copy of the batch, when the source is streamed
+	byte* output;              //!< Processed data
+	size_t length;             //!< Length of the batch, in bytes
+	size_t produced;           //!< Length of the processed data, in bytes
+	unsigned long long offset; //!< Position of the batch in the source, in bytes
+	int status;                //!< Outcome of the processing (see pipelineCodec::process)
+} pipelineSlot;
+
+
+/**
+ * \struct pipeline
+ * \brief Shared state of the reader, the workers and the writer
+ *
+ * Batches are numbered in the source order: batch #n is stored in slot #(n % slotCount). The reader runs at most
+ * slotCount batches ahead of the writer, workers take the batches in order, and the writer waits for the next one.
+ */
+typedef struct {
+	const pipelineCodec* codec;   //!< Processing to apply
+	fileio* source;               //!< File to read the batches from
+	pipelineSlot* slots;          //!< Ring of batches
+	int slotCount;                //!< Number of slots
+	unsigned long long read;      //!< Number of batches read
+	unsigned long long taken;     //!< Number of batches handed to the workers
+	unsigned long long written;   //!< Number of batches written
+	int sourceEnd;                //!< Set once the whole source has been read
+	int abort;                    //!< Set when the writer stops on an error
+	pthread_mutex_t lock;         //!< Protects the counters, flags and slot states
+	pthread_cond_t changed;       //!< Broadcast on every change of the above
+	progressTracker progress;     //!< Progress of the workers
+} pipeline;
+
+
+/**
+ * \struct pipelineWorkerArgs
+ * \brief Set of arguments related to a worker thread
+ */
+typedef struct {
+	pipeline* p;   //!< Shared state
+	void* scratch; //!< Private scratch buffer
+	int worker;    //!< Index of the worker
+} pipelineWorkerArgs;
+
+
+
+
+// Documentation in header file
+int pipeline_defaultThreads() {
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	return (int)MAX(1, MIN(processors, PIPELINE_MAX_THREADS));
+}
+
+
+
+
+/**
+ * \fn void* pipeline_launchReader(void* data)
+ * \brief Reader thread: cuts the source into batches as long as the ring has free slots
+ *
+ * \param[in] data Pointer to the pipeline
+ * \return NULL
+ */
+void* pipeline_launchReader(void* data) {
+
+	pipeline* p = data;
+	unsigned long long offset = 0;
+
+	pthread_mutex_lock(&p->lock);
+	while (1) {
+
+		while (!p->abort && p->read - p->written >= (unsigned long long)p->slotCount)
+			pthread_cond_wait(&p->changed, &p->lock);
+		if (p->abort)
+			break;
+		pipelineSlot* slot = &p->slots[p->read % p->slotCount];
+		pthread_mutex_unlock(&p->lock);
+
+		// Mapped data remain valid until the end, streamed data are overwritten by the next read
+		const byte* input;
+		size_t length = fileio_read(p->source, &input, p->codec->inputBatch);
+		if (length && !p->source->map) {
+			memcpy(slot->inputBuffer, input, length);
+			input = slot->inputBuffer;
+		}
+
+		pthread_mutex_lock(&p->lock);
+		if (!length) {
+			p->sourceEnd = 1;
+			pthread_cond_broadcast(&p->changed);
+			break;
+		}
+		slot->input  = input;
+		slot->length = length;
+		slot->offset = offset;
+		slot->state  = PIPELINE_SLOT_READ;
+		offset += length;
+		++p->read;
+		pthread_cond_broadcast(&p->changed);
+	}
+	pthread_mutex_unlock(&p->lock);
+
+	return NULL;
+}
+
+
+
+
+/**
+ * \fn void* pipeline_launchWorker(void* data)
+ * \brief Worker thread: processes the batches in the order they have been read, until the source is exhausted
+ *
+ * \param[in] data Pointer to the worker's arguments
+ * \return NULL
+ */
+void* pipeline_launchWorker(void* data) {
+
+	pipelineWorkerArgs* args = data;
+	pipeline* p = args->p;
+
+	pthread_mutex_lock(&p->lock);
+	while (1) {
+
+		while (!p->abort && p->taken == p->read && !p->sourceEnd)
+			pthread_cond_wait(&p->changed, &p->lock);
+		if (p->abort || p->taken == p->read)
+			break;
+		pipelineSlot* slot = &p->slots[p->taken++ % p->slotCount];
+		pthread_mutex_unlock(&p->lock);
+
+		slot->produced = 0;
+		slot->status   = p->codec->process(p->codec->context, args->scratch, slot->offset,
+		                                   slot->input, slot->length, slot->output, &slot->produced);
+		progress_add(&p->progress, args->worker, slot->length);
+
+		pthread_mutex_lock(&p->lock);
+		slot->state = PIPELINE_SLOT_PROCESSED;
+		pthread_cond_broadcast(&p->changed);
+	}
+	pthread_mutex_unlock(&p->lock);
+
+	return NULL;
+}
+
+
+
+
+/**
+ * \fn void pipeline_freeSlots(pipelineSlot* slots, int count)
+ * \brief Releases the buffers of the ring
+ *
+ * \param[in] slots Ring of batches
+ * \param[in] count Number of slots
+ */
+static void pipeline_freeSlots(pipelineSlot* slots, int count) {
+	for (int i=0 ; i<count ; ++i) {
+		free(slots[i].inputBuffer);
+		free(slots[i].output);
+	}
+	free(slots);
+}
+
+
+
+
+// Documentation in header file
+int pipeline_run(const pipelineCodec* codec, fileio* source, fileio* dest, int threads) {
+
+	threads = MAX(1, MIN(threads, PIPELINE_MAX_THREADS));
+
+	pipeline p;
+	memset(&p, 0, sizeof(pipeline));
+	p.codec     = codec;
+	p.source    = source;
+	p.slotCount = PIPELINE_SLOTS_PER_WORKER*threads;
+
+	// Ring and scratch buffers (input buffers are only needed when the source is streamed)
+	p.slots = calloc(p.slotCount, sizeof(pipelineSlot));
+	void* scratch = calloc(threads, MAX(codec->scratch, (size_t)1));
+	int allocated = (p.slots != NULL) && (scratch != NULL);
+	for (int i=0 ; allocated && i<p.slotCount ; ++i) {
+		p.slots[i].output = malloc(codec->outputBatch);
+		allocated = (p.slots[i].output != NULL);
+		if (allocated && !source->map) {
+			p.slots[i].inputBuffer = malloc(codec->inputBatch);
+			allocated = (p.slots[i].inputBuffer != NULL);
+		}
+	}
+	if (!allocated) {
+		DEBUG("Error: unable to allocate the pipeline buffers");
+		if (p.slots)
+			pipeline_freeSlots(p.slots, p.slotCount);
+		free(scratch);
+		return PIPELINE_IO_ERROR;
+	}
+
+	pthread_mutex_init(&p.lock, NULL);
+	pthread_cond_init(&p.changed, NULL);
+	progress_start(&p.progress, codec->label, "B", source->size, threads);
+
+
+	// Reader & Workers Creation (a worker that cannot be created is simply missing from the pool)
+	pthread_t reader;
+	pthread_t workers[PIPELINE_MAX_THREADS];
+	pipelineWorkerArgs args[PIPELINE_MAX_THREADS];
+	int created = 0;
+
+	if (pthread_create(&reader, NULL, pipeline_launchReader, &p)) {
+		DEBUG("Unable to create the reader thread");
+		progress_stop(&p.progress);
+		pthread_cond_destroy(&p.changed);
+		pthread_mutex_destroy(&p.lock);
+		pipeline_freeSlots(p.slots, p.slotCount);
+		free(scratch);
+		return PIPELINE_IO_ERROR;
+	}
+	for (int i=0 ; i<threads ; ++i) {
+		args[created].p       = &p;
+		args[created].scratch = (byte*)scratch + (size_t)i*MAX(codec->scratch, (size_t)1);
+		args[created].worker  = i;
+		if (pthread_create(&workers[created], NULL, pipeline_launchWorker, &args[created])) {
+			DEBUG("Unable to create worker #%d", i);
+			continue;
+		}
+		++created;
+	}
+
+
+	// Writer: the batches are written out in the source order
+	int res = created ? 0 : PIPELINE_IO_ERROR;
+
+	pthread_mutex_lock(&p.lock);
+	while (!res) {
+
+		pipelineSlot* slot = &p.slots[p.written % p.slotCount];
+		while (!(p.written < p.read && slot->state == PIPELINE_SLOT_PROCESSED) && !(p.sourceEnd && p.written == p.read))
+			pthread_cond_wait(&p.changed, &p.lock);
+		if (p.written == p.read)
+			break;
+		pthread_mutex_unlock(&p.lock);
+
+		if (fileio_write(dest, slot->output, slot->produced)) {
+			res = PIPELINE_IO_ERROR;
+		} else {
+			res = slot->status;
+		}
+
+		pthread_mutex_lock(&p.lock);
+		slot->state = PIPELINE_SLOT_FREE;
+		++p.written;
+		pthread_cond_broadcast(&p.changed);
+	}
+	if (res) {
+		p.abort = 1;
+		pthread_cond_broadcast(&p.changed);
+	}
+	pthread_mutex_unlock(&p.lock);
+
+
+	// Thread Joining
+	pthread_join(reader, NULL);
+	for (int i=0 ; i<created ; ++i) {
+		pthread_join(workers[i], NULL);
+	}
+
+	progress_stop(&p.progress);
+	pthread_cond_destroy(&p.changed);
+	pthread_mutex_destroy(&p.lock);
+	pipeline_freeSlots(p.slots, p.slotCount);
+	free(scratch);
+
+	if (!res && source->error)
+		res = PIPELINE_IO_ERROR;
+	return res;
+}
+
+
+
+
+//! Size of the batches of the autotest, in bytes
+#define PIPELINE_TEST_BATCH 1000
+
+//! Length of the autotest stream, in bytes (kept under the capacity of a pipe, and not a multiple of the batch size)
+#define PIPELINE_TEST_LENGTH 50021
+
+
+/**
+ * \fn int pipeline_testProcess(void* context, void* scratch, unsigned long long offset, const byte input[], size_t length, byte output[], size_t* produced)
+ * \brief Autotest processing: position-dependent transformation, batch marker, uneven processing time
+ *
+ * \param[in]  context Offset of the batch to reject (with error code 7), or NULL
+ * \param[in]  scratch Unused
+ * \param[in]  offset Position of the batch in the source
+ * \param[in]  input Batch to process
+ * \param[in]  length Length of the batch
+ * \param[out] output Processed data (length+1 bytes)
+ * \param[out] produced Number of bytes produced
+ * \return 0, or 7 for the rejected batch
+ */
+static int pipeline_testProcess(void* context, void* scratch, unsigned long long offset,
+                                const byte input[], size_t length, byte output[], size_t* produced) {
+
+	if (context && offset == *(unsigned long long*)context)
+		return 7;
+
+	// Some batches take longer, so that the workers complete them out of order
+	volatile unsigned int spin = 0;
+	for (unsigned int i=0 ; i<(offset/PIPELINE_TEST_BATCH % 5)*200000 ; ++i)
+		++spin;
+
+	for (size_t i=0 ; i<length ; ++i)
+		output[i] = input[i] ^ (byte)(offset + i);
+	output[length] = (byte)(offset / PIPELINE_TEST_BATCH);
+	*produced = length + 1;
+	return 0;
+}
+
+
+
+
+/**
+ * \fn int pipeline_testRun(const byte stream[], const byte expected[], size_t expectedLength, int threads, int piped, unsigned long long* rejected)
+ * \brief Runs the autotest processing on a stream and checks the result
+ *
+ * \param[in] stream Source data (PIPELINE_TEST_LENGTH bytes)
+ * \param[in] expected Expected output
+ * \param[in] expectedLength Length of the expected output
+ * \param[in] threads Number of workers
+ * \param[in] piped Non-zero to read the source from a pipe, zero to read it from a (mapped) file
+ * \param[in] rejected Offset of the batch to reject, or NULL
+ * \return 0 if the output (and the error code, if any) are right, non-zero otherwise
+ */
+static int pipeline_testRun(const byte stream[], const byte expected[], size_t expectedLength,
+                            int threads, int piped, unsigned long long* rejected) {
+
+	pipelineCodec codec = {"Testing pipeline", PIPELINE_TEST_BATCH, PIPELINE_TEST_BATCH+1, 0, rejected, pipeline_testProcess};
+
+	FILE* destfile = tmpfile();
+	FILE* sourcefile = piped ? NULL : tmpfile();
+	int pipefd[2] = {-1, -1};
+	if (!destfile || (!piped && !sourcefile) || (piped && pipe(pipefd))) {
+		DEBUG("Self-check aborted: unable to allocate test resources");
+		return 1;
+	}
+
+	int res = 0;
+	fileio source, dest;
+	if (piped) {
+		res |= (write(pipefd[1], stream, PIPELINE_TEST_LENGTH) != PIPELINE_TEST_LENGTH);
+		close(pipefd[1]);
+		res |= fileio_attach(&source, pipefd[0], 0);
+	} else {
+		res |= (fwrite(stream, sizeof(byte), PIPELINE_TEST_LENGTH, sourcefile) != PIPELINE_TEST_LENGTH);
+		fflush(sourcefile);
+		rewind(sourcefile);
+		res |= fileio_attach(&source, fileno(sourcefile), 0);
+	}
+	res |= fileio_attach(&dest, fileno(destfile), 1);
+
+	int outcome = res ? 0 : pipeline_run(&codec, &source, &dest, threads);
+	res |= fileio_close(&dest) | fileio_close(&source);
+	if (res || outcome != (rejected ? 7 : 0)) {
+		DEBUG("Self-check aborted: unexpected pipeline outcome %d with %d worker(s)", outcome, threads);
+		res = 1;
+	}
+
+	// Output (up to the rejected batch, if any)
+	byte* output = malloc(expectedLength+1);
+	rewind(destfile);
+	if (!res && (!output || fread(output, sizeof(byte), expectedLength+1, destfile) != expectedLength
+	                     || memcmp(output, expected, expectedLength))) {
+		DEBUG("Self-check aborted: the pipeline output differs from the serial one with %d worker(s)", threads);
+		res = 1;
+	}
+
+	free(output);
+	fclose(destfile);
+	if (sourcefile)
+		fclose(sourcefile);
+	if (piped)
+		close(pipefd[0]);
+	return res;
+}
+
+
+
+
+// Documentation in header file
+int pipeline_test() {
+
+	byte* stream   = malloc(PIPELINE_TEST_LENGTH);
+	byte* expected = malloc(PIPELINE_TEST_LENGTH + PIPELINE_TEST_LENGTH/PIPELINE_TEST_BATCH + 1);
+	if (!stream || !expected) {
+		DEBUG("Self-check aborted: unable to allocate test resources");
+		free(stream);
+		free(expected);
+		return 1;
+	}
+	for (int k=0 ; k<PIPELINE_TEST_LENGTH ; ++k)
+		stream[k] = rand() & 0xFF;
+
+	// Serial reference
+	size_t expectedLength = 0, produced;
+	for (unsigned long long offset=0 ; offset<PIPELINE_TEST_LENGTH ; offset+=PIPELINE_TEST_BATCH) {
+		pipeline_testProcess(NULL, NULL, offset, stream+offset, MIN(PIPELINE_TEST_BATCH, PIPELINE_TEST_LENGTH-offset),
+		                     expected+expectedLength, &produced);
+		expectedLength += produced;
+	}
+
+	int res = 0;
+	const int threads[] = {1, 3, 8};
+	for (int t=0 ; t<3 ; ++t) {
+		res |= pipeline_testRun(stream, expected, expectedLength, threads[t], 0, NULL);
+		res |= pipeline_testRun(stream, expected, expectedLength, threads[t], 1, NULL);
+	}
+
+	// An error stops the pipeline right after the previous batches have been written
+	unsigned long long rejected = 17*PIPELINE_TEST_BATCH;
+	res |= pipeline_testRun(stream, expected, 17*(PIPELINE_TEST_BATCH+1), 4, 0, &rejected);
+
+	free(stream);
+	free(expected);
+
+	if (!res)
+		DEBUG("Self-check succeeded: the batches are written once and in order, whatever the number of workers");
+	return res;
+}
@@ -0,0 +1,132 @@
+/*============================================================================*
+ *                                                                            *
+ *                                  pipeline.h                                *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file pipeline.h
+  * @brief Multithreaded block pipeline: reader, pool of workers and in-order writer
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #1
+  * @date 19/10/2026
+  * */
+
+
+
+#ifndef _PIPELINE_H_
+#define _PIPELINE_H_
+
+#include <stddef.h>
+
+#include "utils.h"
+#include "fileio.h"
+
+
+// A reader thread cuts the source into batches and stores them in a bounded ring of slots, a pool of workers
+// processes the batches in any order, and the calling thread writes the results out in the original order.
+// Since every batch is processed independently, the output is the same whatever the number of workers.
+
+//! Number of ring slots per worker: enough to keep every worker busy while the writer drains the ring
+#define PIPELINE_SLOTS_PER_WORKER 2
+
+//! Maximum number of workers
+#define PIPELINE_MAX_THREADS 64
+
+//! Returned by pipeline_run() when the source cannot be read or the destination cannot be written
+#define PIPELINE_IO_ERROR (-1)
+
+
+
+
+/**
+ * \struct pipelineCodec
+ * \brief Processing applied by the pipeline to every batch
+ */
+typedef struct {
+	const char* label;  //!< Description of the operation, for progress display
+	size_t inputBatch;  //!< Number of bytes read per batch (whole blocks)
+	size_t outputBatch; //!< Maximum number of bytes produced per batch
+	size_t scratch;     //!< Size of the private scratch buffer of every worker, in bytes (may be 0)
+	void* context;      //!< Data shared by all the batches (updates must be atomic)
+
+	/**
+	 * Processes one batch (called concurrently by the workers)
+	 *
+	 * \param[in]  context Shared data (see pipelineCodec::context)
+	 * \param[in]  scratch Private buffer of the calling worker
+	 * \param[in]  offset Position of the batch in the source, in bytes
+	 * \param[in]  input Batch to process (inputBatch bytes, less for the last one)
+	 * \param[in]  length Length of the batch, in bytes
+	 * \param[out] output Processed data (at most outputBatch bytes)
+	 * \param[out] produced Number of bytes produced
+	 * \return 0 on success, a positive error code otherwise: the pipeline then stops once the previous batches and
+	 *         the \a produced bytes of this one are written
+	 */
+	int (*process)(void* context, void* scratch, unsigned long long offset,
+	               const byte input[], size_t length, byte output[], size_t* produced);
+} pipelineCodec;
+
+
+
+
+/**
+ * \fn int pipeline_defaultThreads()
+ * \brief Number of workers used when none is specified: one per online processor
+ *
+ * \return Number of workers, between 1 and PIPELINE_MAX_THREADS
+ */
+int pipeline_defaultThreads();
+
+
+
+
+/**
+ * \fn int pipeline_run(const pipelineCodec* codec, fileio* source, fileio* dest, int threads)
+ * \brief Processes a whole source file batch by batch, and writes the results in order
+ *
+ * \param[in]      codec Processing to apply
+ * \param[in, out] source File to read the batches from
+ * \param[in, out] dest File to write the processed batches to
+ * \param[in]      threads Number of workers (between 1 and PIPELINE_MAX_THREADS)
+ * \return 0 if the whole file has been processed, the error code of the first failing batch,
+ *         or PIPELINE_IO_ERROR if the files cannot be read or written
+ */
+int pipeline_run(const pipelineCodec* codec, fileio* source, fileio* dest, int threads);
+
+
+
+
+/**
+ * \fn int pipeline_test()
+ * \brief Autotests the pipeline: every batch must be written once, in order, whatever the number of workers
+ *
+ * \return 0 if the test is successfull, non-zero otherwise
+ */
+int pipeline_test();
+
+
+
+
+#endif
@@ -0,0 +1,267 @@
+/*============================================================================*
+ *                                                                            *
+ *                                  progress.c                                *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file progress.c
+  * @brief Lock-free progress reporting of long-running operations
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #2
+  * @date 19/10/2026
+  * */
+
+
+
+// clock_gettime() and pthread_condattr_setclock() are POSIX extensions of the C99 library
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "utils.h"
+
+#include "progress.h"
+
+
+
+//! Path of the machine-readable progress file (empty if disabled)
+static char progress_reportFile[255] = "";
+
+
+
+
+// Documentation in header file
+void progress_setReportFile(const char* filename) {
+	progress_reportFile[0] = '\0';
+	if (filename) {
+		strncpy(progress_reportFile, filename, sizeof(progress_reportFile)-1);
+		progress_reportFile[sizeof(progress_reportFile)-1] = '\0';
+	}
+}
+
+
+
+
+/**
+ * \fn void progress_formatDuration(char* s, size_t len, double seconds)
+ * \brief Formats a duration as h:mm:ss ("-:--:--" if it is unknown)
+ *
+ * \param[out] s Output string
+ * \param[in]  len Size of the output string
+ * \param[in]  seconds Duration to format, negative if unknown
+ */
+static void progress_formatDuration(char* s, size_t len, double seconds) {
+	if (seconds < 0) {
+		snprintf(s, len, "-:--:--");
+	} else {
+		unsigned long long t = seconds + 0.5;
+		snprintf(s, len, "%llu:%02llu:%02llu", t/3600, (t/60)%60, t%60);
+	}
+}
+
+
+
+
+/**
+ * \fn void progress_report(progressTracker* p, int finished)
+ * \brief Samples the counters of a tracker, displays its progress line and rewrites the progress file
+ *
+ * \param[in] p Tracker to sample
+ * \param[in] finished Non-zero for the final report (written to the file only)
+ */
+static void progress_report(progressTracker* p, int finished) {
+
+	unsigned long long done[PROGRESS_MAX_THREADS];
+	unsigned long long total = 0;
+	for (int t=0 ; t<p->threads ; ++t) {
+		done[t] = __atomic_load_n(&p->counters[t].done, __ATOMIC_RELAXED);
+		total += done[t];
+	}
+
+	double elapsed = monotonicTime() - p->startTime;
+	double rate    = (elapsed > 0) ? total/elapsed : 0.0;
+	double eta     = (p->total && rate > 0) ? (total < p->total ? (p->total-total)/rate : 0.0) : -1.0;
+	unsigned int percent = p->total ? (unsigned int)(MIN(total, p->total)*100/p->total) : 0;
+
+
+	// Console line: label, bar, rate, ETA, and the progress of every worker (each owning an equal share)
+	if (!finished) {
+		static const char* prefixes[] = {"", "k", "M", "G", "T"};
+		double scaledRate = rate;
+		int prefix = 0;
+		while (scaledRate >= 1000 && prefix < 4) {
+			scaledRate /= 1000;
+			++prefix;
+		}
+
+		char etaString[32];
+		progress_formatDuration(etaString, sizeof(etaString), eta);
+
+		char line[256];
+		int len = MIN(snprintf(line, 128, "%s... [", p->label), 127);
+		for (unsigned int i=0 ; i<20 ; ++i)
+			line[len++] = (i < percent*20/100) ? '=' : '-';
+		len += snprintf(line+len, sizeof(line)-len, "] %u%% %.1f %s%s/s ETA %s",
+		                percent, scaledRate, prefixes[prefix], p->unit, etaString);
+
+		// Progress of the workers: all of them if they fit on the line, the slowest and fastest ones otherwise
+		if (p->threads > 1 && p->total && len < 79) {
+			unsigned long long share = (p->total + p->threads-1) / p->threads;
+			unsigned long long low = 100, high = 0;
+			char workers[256];
+			int wlen = snprintf(workers, sizeof(workers), " [");
+			for (int t=0 ; t<p->threads && wlen<(int)sizeof(workers) ; ++t) {
+				unsigned long long workerPercent = MIN(done[t], share)*100/share;
+				low  = MIN(low,  workerPercent);
+				high = MAX(high, workerPercent);
+				wlen += snprintf(workers+wlen, sizeof(workers)-wlen, "%s%llu", t ? " " : "", workerPercent);
+			}
+			if (wlen + 1 > 79 - len)
+				wlen = snprintf(workers, sizeof(workers), " [%llu-%llu%%", low, high);
+			if (wlen + 1 <= 79 - len)
+				snprintf(line+len, sizeof(line)-len, "%s]", workers);
+		}
+
+		// The line is padded (or truncated) to the width erased by CLEARLINE
+		CLEARLINE; printf("%-79.79s", line);
+		fflush(stdout);
+	}
+
+
+	// Machine-readable progress, replaced atomically
+	if (progress_reportFile[0]) {
+		char tmpname[sizeof(progress_reportFile)+4];
+		snprintf(tmpname, sizeof(tmpname), "%s.tmp", progress_reportFile);
+		FILE* out = fopen(tmpname, "w");
+		if (!out)
+			return;
+		fprintf(out, "{\n  \"label\": \"%s\",\n  \"unit\": \"%s\",\n  \"done\": %llu,\n  \"total\": %llu,\n",
+		        p->label, p->unit, total, p->total);
+		fprintf(out, "  \"percent\": %u,\n  \"elapsed_seconds\": %.3f,\n  \"rate\": %.3f,\n  \"eta_seconds\": %.3f,\n",
+		        percent, elapsed, rate, eta);
+		fprintf(out, "  \"finished\": %s,\n  \"threads\": [", finished ? "true" : "false");
+		for (int t=0 ; t<p->threads ; ++t)
+			fprintf(out, "%s%llu", t ? ", " : "", done[t]);
+		fprintf(out, "]\n}\n");
+		if (fclose(out) || rename(tmpname, progress_reportFile)) {
+			remove(tmpname);
+		}
+	}
+}
+
+
+
+
+/**
+ * \fn void* progress_launchReporter(void* data)
+ * \brief Reporter thread: samples the tracker every PROGRESS_INTERVAL_MS milliseconds until it is stopped
+ *
+ * \param[in] data Pointer to the tracker
+ * \return NULL
+ */
+void* progress_launchReporter(void* data) {
+
+	progressTracker* p = data;
+
+	pthread_mutex_lock(&p->lock);
+	while (!p->stop) {
+
+		struct timespec deadline;
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		deadline.tv_sec  += PROGRESS_INTERVAL_MS/1000;
+		deadline.tv_nsec += (PROGRESS_INTERVAL_MS%1000)*1000000L;
+		if (deadline.tv_nsec >= 1000000000L) {
+			deadline.tv_nsec -= 1000000000L;
+			++deadline.tv_sec;
+		}
+		while (!p->stop && pthread_cond_timedwait(&p->wakeup, &p->lock, &deadline) == 0);
+
+		if (!p->stop) {
+			pthread_mutex_unlock(&p->lock);
+			progress_report(p, 0);
+			pthread_mutex_lock(&p->lock);
+		}
+	}
+	pthread_mutex_unlock(&p->lock);
+
+	return NULL;
+}
+
+
+
+
+// Documentation in header file
+int progress_start(progressTracker* p, const char* label, const char* unit, unsigned long long total, int threads) {
+
+	memset(p->counters, 0, sizeof(p->counters));
+	p->label     = label;
+	p->unit      = unit;
+	p->total     = total;
+	p->threads   = MAX(1, MIN(threads, PROGRESS_MAX_THREADS));
+	p->startTime = monotonicTime();
+	p->running   = 0;
+	p->stop      = 0;
+
+	// The reporter waits on the monotonic clock, so that its period is not affected by clock adjustments
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_mutex_init(&p->lock, NULL);
+	pthread_cond_init(&p->wakeup, &attr);
+	pthread_condattr_destroy(&attr);
+
+	if (pthread_create(&p->reporter, NULL, progress_launchReporter, p)) {
+		DEBUG("Unable to create the progress reporter thread: progress will not be displayed");
+		return 1;
+	}
+	p->running = 1;
+	return 0;
+}
+
+
+
+
+// Documentation in header file
+void progress_stop(progressTracker* p) {
+
+	if (!p)
+		return;
+
+	if (p->running) {
+		pthread_mutex_lock(&p->lock);
+		p->stop = 1;
+		pthread_cond_signal(&p->wakeup);
+		pthread_mutex_unlock(&p->lock);
+		pthread_join(p->reporter, NULL);
+		p->running = 0;
+	}
+	pthread_mutex_destroy(&p->lock);
+	pthread_cond_destroy(&p->wakeup);
+
+	progress_report(p, 1);
+}
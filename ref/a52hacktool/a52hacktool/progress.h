@@ -0,0 +1,151 @@
+/*============================================================================*
+ *                                                                            *
+ *                                  progress.h                                *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file progress.h
+  * @brief Lock-free progress reporting of long-running operations
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #1
+  * @date 19/10/2026
+  * */
+
+
+
+#ifndef _PROGRESS_H_
+#define _PROGRESS_H_
+
+#include <pthread.h>
+
+
+// Workers only add their processed units to their own counter (relaxed atomic increment, no lock and no output).
+// A single reporter thread samples the counters on a timer, displays the rate, the ETA and the progress of every
+// thread on one console line, and optionally rewrites a JSON progress file for external job monitors.
+
+//! Maximum number of worker threads followed by a tracker
+#define PROGRESS_MAX_THREADS 64
+
+//! Sampling period of the reporter thread, in milliseconds
+#define PROGRESS_INTERVAL_MS 500
+
+//! Size of a cache line: the counter of each worker is aligned on it, so that no line is shared
+#define PROGRESS_CACHELINE_BYTES 64
+
+
+
+
+/**
+ * \struct progressCounter
+ * \brief Units processed by one worker, alone on its cache line
+ */
+typedef struct {
+	unsigned long long done; //!< Number of units processed (only updated through progress_add())
+} __attribute__((aligned(PROGRESS_CACHELINE_BYTES))) progressCounter;
+
+
+/**
+ * \struct progressTracker
+ * \brief Progress of an operation shared amongst several workers, along with its reporter thread
+ */
+typedef struct {
+	progressCounter counters[PROGRESS_MAX_THREADS]; //!< Per-worker counters
+	const char* label;                              //!< Description of the operation, displayed before the bar
+	const char* unit;                               //!< Name of the processed units
+	unsigned long long total;                       //!< Total number of units to process (0 if unknown)
+	int threads;                                    //!< Number of workers
+	double startTime;                               //!< Monotonic time of progress_start(), in seconds
+	int running;                                    //!< Non-zero while the reporter thread is alive
+	int stop;                                       //!< Set by progress_stop() (protected by lock)
+	pthread_t reporter;                             //!< Reporter thread
+	pthread_mutex_t lock;                           //!< Protects stop
+	pthread_cond_t wakeup;                          //!< Signaled by progress_stop()
+} progressTracker;
+
+
+
+
+/**
+ * \fn void progress_setReportFile(const char* filename)
+ * \brief Sets the file the reporter threads write the machine-readable progress to
+ *
+ * The file is rewritten atomically (through a temporary file) on every sample, and a last time with
+ * "finished": true when the operation ends.
+ *
+ * \param[in] filename Path of the JSON progress file, NULL to disable it
+ */
+void progress_setReportFile(const char* filename);
+
+
+
+
+/**
+ * \fn int progress_start(progressTracker* p, const char* label, const char* unit, unsigned long long total, int threads)
+ * \brief Resets the counters of a tracker and launches its reporter thread
+ *
+ * If the reporter thread cannot be created, the counters remain usable and nothing is reported.
+ *
+ * \param[out] p Tracker to start
+ * \param[in]  label Description of the operation (must remain valid until progress_stop())
+ * \param[in]  unit Name of the processed units (must remain valid until progress_stop())
+ * \param[in]  total Total number of units to process (0 if unknown)
+ * \param[in]  threads Number of workers, at most PROGRESS_MAX_THREADS
+ * \return 0 if the reporter thread is running, non-zero otherwise
+ */
+int progress_start(progressTracker* p, const char* label, const char* unit, unsigned long long total, int threads);
+
+
+
+
+/**
+ * \fn void progress_add(progressTracker* p, int thread, unsigned long long units)
+ * \brief Accounts for units processed by a worker (a relaxed atomic increment: it can be called from hot loops)
+ *
+ * \param[in, out] p Tracker of the operation (may be NULL, in which case nothing is done)
+ * \param[in]      thread Index of the worker, from 0 to threads-1
+ * \param[in]      units Number of units just processed
+ */
+static inline void progress_add(progressTracker* p, int thread, unsigned long long units) {
+	if (p)
+		__atomic_fetch_add(&p->counters[thread].done, units, __ATOMIC_RELAXED);
+}
+
+
+
+
+/**
+ * \fn void progress_stop(progressTracker* p)
+ * \brief Stops the reporter thread of a tracker and writes the final progress file
+ *
+ * Nothing is displayed: the caller overwrites the progress line with its own outcome message.
+ *
+ * \param[in, out] p Tracker to stop (may be NULL)
+ */
+void progress_stop(progressTracker* p);
+
+
+
+
+#endif
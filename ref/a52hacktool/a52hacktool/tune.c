@@ -0,0 +1,640 @@
+/*============================================================================*
+ *                                                                            *
+ *                                    tune.c                                  *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file tune.c
+  * @brief Per-processor tuning of the block widths and of the numbers of threads
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #3
+  * @date 19/10/2026
+  * */
+
+
+
+// sysconf() and ftruncate() are POSIX extensions of the C99 library
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "const_A52.h"
+#include "const_code.h"
+#include "utils.h"
+#include "bitmatrix.h"
+#include "code.h"
+#include "attack.h"
+#include "pipeline.h"
+#include "matrices_generation.h"
+
+#include "tune.h"
+
+
+
+//! Number of messages decoded by a unit of the codec benchmark
+#define TUNE_CODE_BLOCKS 64
+
+//! Keys of a profile, in the order they are written
+static const char* tune_keys[] = {"processors", "kernel", "echelon_bits", "multiply_bits",
+                                  "attack_threads", "precompute_threads", "codec_threads"};
+
+//! Number of keys of a profile
+#define TUNE_KEYS ((int)(sizeof(tune_keys)/sizeof(tune_keys[0])))
+
+
+
+
+/**
+ * \struct tuneData
+ * \brief Read-only data shared by the benchmarks
+ */
+typedef struct {
+	bitmatrix system;     //!< Random system shaped like a Resolution Matrix along with the right-hand sides of a batch
+	bitmatrix keystream;  //!< Random keystream equations of one message, CODEWORD_LENGTH × REGS_TOTAL_VARS
+	byte* codewords;      //!< Encoded random messages, CODEWORD_LENGTH/8 bytes each
+} tuneData;
+
+
+/**
+ * \typedef tuneKernel
+ * \brief Benchmarked operation, run \a units times on the shared data
+ *
+ * \return 0 if the operation could be run, non-zero otherwise
+ */
+typedef int (*tuneKernel)(const tuneData* data, unsigned int units);
+
+
+/**
+ * \struct tuneWorkerArgs
+ * \brief Set of arguments related to a benchmark thread
+ */
+typedef struct {
+	tuneKernel kernel;      //!< Operation to run
+	const tuneData* data;   //!< Shared data
+	unsigned int units;     //!< Number of runs
+	int failed;             //!< Outcome of the kernel
+} tuneWorkerArgs;
+
+
+
+
+/**
+ * \fn int tune_echelon(const tuneData* data, unsigned int units)
+ * \brief Gauss elimination of a Resolution Matrix, the heart of the attack
+ *
+ * \param[in] data Shared data
+ * \param[in] units Number of eliminations
+ * \return 0 if the eliminations could be run, non-zero otherwise
+ */
+int tune_echelon(const tuneData* data, unsigned int units) {
+
+	bitmatrix M;
+	if (bitmatrix_alloc(&M, data->system.rows, data->system.cols))
+		return 1;
+	for (unsigned int u=0 ; u<units ; ++u) {
+		bitmatrix_copy(&M, &data->system);
+		bitmatrix_echelon(&M, REGS_TOTAL_VARS-1, 0, NULL);
+	}
+	bitmatrix_free(&M);
+	return 0;
+}
+
+
+
+
+/**
+ * \fn int tune_multiply(const tuneData* data, unsigned int units)
+ * \brief Product of the parity-check matrix with the keystream equations of a message, as done by the precomputation
+ *
+ * \param[in] data Shared data
+ * \param[in] units Number of products
+ * \return 0 if the products could be run, non-zero otherwise
+ */
+int tune_multiply(const tuneData* data, unsigned int units) {
+
+	const codeMatrices* code = code_getMatrices();
+	bitmatrix HS;
+	if (!code || bitmatrix_alloc(&HS, SYNDROME_LENGTH, REGS_TOTAL_VARS))
+		return 1;
+	for (unsigned int u=0 ; u<units ; ++u) {
+		bitmatrix_multiply(&code->H, &data->keystream, &HS);
+	}
+	bitmatrix_free(&HS);
+	return 0;
+}
+
+
+
+
+/**
+ * \fn int tune_generate(const tuneData* data, unsigned int units)
+ * \brief Generation of Resolution Matrices, as done by the precomputation
+ *
+ * \param[in] data Unused
+ * \param[in] units Number of matrices
+ * \return 0 if the matrices could be generated, non-zero otherwise
+ */
+int tune_generate(const tuneData* data, unsigned int units) {
+
+	byte* buffer = malloc(BUFFER_SIZE(NEEDED_ENCRYPTED_MESSAGES));
+	int res = !buffer;
+	for (unsigned int u=0 ; u<units && !res ; ++u) {
+		res = generateMatrix((int)((u * 7919ULL) % TOTAL_MATRICES), NEEDED_ENCRYPTED_MESSAGES, buffer);
+	}
+	free(buffer);
+	return res;
+}
+
+
+
+
+/**
+ * \fn int tune_decode(const tuneData* data, unsigned int units)
+ * \brief Decoding of TUNE_CODE_BLOCKS messages, as done by the codec workers
+ *
+ * \param[in] data Shared data
+ * \param[in] units Number of batches of messages
+ * \return 0
+ */
+int tune_decode(const tuneData* data, unsigned int units) {
+
+	byte sourcewords[TUNE_CODE_BLOCKS*SOURCEWORD_LENGTH/8];
+	for (unsigned int u=0 ; u<units ; ++u) {
+		processPackedDecoding(data->codewords, sourcewords, NULL, TUNE_CODE_BLOCKS);
+	}
+	return 0;
+}
+
+
+
+
+/**
+ * \fn void* tune_launchWorker(void* data)
+ * \brief Benchmark thread
+ *
+ * \param[in, out] data Pointer to the arguments of the thread (tuneWorkerArgs)
+ * \return NULL
+ */
+void* tune_launchWorker(void* data) {
+	tuneWorkerArgs* args = data;
+	args->failed = args->kernel(args->data, args->units);
+	return NULL;
+}
+
+
+
+
+/**
+ * \fn double tune_throughput(tuneKernel kernel, const tuneData* data, unsigned int units, int threads)
+ * \brief Runs an operation on several threads at once
+ *
+ * \param[in] kernel Operation to run
+ * \param[in] data Shared data
+ * \param[in] units Number of runs of every thread
+ * \param[in] threads Number of threads (at most TUNE_MAX_THREADS)
+ * \return Number of runs per second, 0 if the operation could not be run
+ */
+double tune_throughput(tuneKernel kernel, const tuneData* data, unsigned int units, int threads) {
+
+	pthread_t t[TUNE_MAX_THREADS];
+	tuneWorkerArgs args[TUNE_MAX_THREADS];
+
+	double start = monotonicTime();
+	int started, failed = 0;
+	for (started=0 ; started<threads ; ++started) {
+		args[started] = (tuneWorkerArgs){kernel, data, units, 0};
+		if (pthread_create(&t[started], NULL, tune_launchWorker, &args[started]))
+			break;
+	}
+	for (int i=0 ; i<started ; ++i) {
+		pthread_join(t[i], NULL);
+		failed |= args[i].failed;
+	}
+	double elapsed = monotonicTime() - start;
+
+	if (failed || started < threads || elapsed <= 0)
+		return 0;
+	return (double)units * threads / elapsed;
+}
+
+
+
+
+/**
+ * \fn unsigned int tune_calibrate(tuneKernel kernel, const tuneData* data)
+ * \brief Finds how many runs of an operation last at least TUNE_SAMPLE_SECONDS on one thread
+ *
+ * \param[in] kernel Operation to run
+ * \param[in] data Shared data
+ * \return Number of runs, 0 if the operation could not be run
+ */
+unsigned int tune_calibrate(tuneKernel kernel, const tuneData* data) {
+
+	for (unsigned int units=1 ; units < (1U<<30) ; units *= 2) {
+		double rate = tune_throughput(kernel, data, units, 1);
+		if (rate <= 0)
+			return 0;
+		if (units / rate >= TUNE_SAMPLE_SECONDS)
+			return units;
+	}
+	return 0;
+}
+
+
+
+
+/**
+ * \fn unsigned int tune_width(tuneKernel kernel, const tuneData* data, bitmatrixTuning* tuning, unsigned int* bits, const char* label)
+ * \brief Finds the fastest block width of a table-driven kernel
+ *
+ * The widths are tried from BITMATRIX_MAX_BLOCK_BITS down, and a narrower one must be TUNE_MIN_GAIN faster.
+ *
+ * \param[in]      kernel Operation to run
+ * \param[in]      data Shared data
+ * \param[in, out] tuning Block widths to try the operation with
+ * \param[in, out] bits Width to vary, within \a tuning (left to the fastest one)
+ * \param[in]      label Name of the kernel, displayed along with the durations
+ * \return 0 if the operation could be run, non-zero otherwise
+ */
+int tune_width(tuneKernel kernel, const tuneData* data, bitmatrixTuning* tuning, unsigned int* bits, const char* label) {
+
+	*bits = BITMATRIX_MAX_BLOCK_BITS;
+	bitmatrix_setTuning(tuning);
+	unsigned int units = tune_calibrate(kernel, data);
+	if (!units)
+		return 1;
+
+	unsigned int best = 0;
+	double bestTime = 0;
+	for (unsigned int width=BITMATRIX_MAX_BLOCK_BITS ; width>=1 ; width/=2) {
+
+		*bits = width;
+		bitmatrix_setTuning(tuning);
+		double time = 0;
+		for (int s=0 ; s<TUNE_SAMPLES ; ++s) {
+			double rate = tune_throughput(kernel, data, units, 1);
+			if (rate <= 0)
+				return 1;
+			if (s == 0 || 1/rate < time)
+				time = 1/rate;
+		}
+		printf("  %-24s blocks of %u bits: %10.3f us\n", label, width, time*1e6);
+
+		if (!best || time * TUNE_MIN_GAIN < bestTime) {
+			best = width;
+			bestTime = time;
+		}
+	}
+
+	*bits = best;
+	bitmatrix_setTuning(tuning);
+	return 0;
+}
+
+
+
+
+/**
+ * \fn int tune_threads(tuneKernel kernel, const tuneData* data, int processors, int maxThreads, const char* label)
+ * \brief Finds the number of threads giving the best throughput of an operation
+ *
+ * Powers of two and the number of processors are tried, up to twice this number. More threads must give a
+ * TUNE_MIN_GAIN higher throughput than the best fewer ones.
+ *
+ * \param[in] kernel Operation to run
+ * \param[in] data Shared data
+ * \param[in] processors Number of online processors
+ * \param[in] maxThreads Maximum number of threads of the operation
+ * \param[in] label Name of the operation, displayed along with the throughputs
+ * \return Best number of threads, 0 if the operation could not be run
+ */
+int tune_threads(tuneKernel kernel, const tuneData* data, int processors, int maxThreads, const char* label) {
+
+	unsigned int units = tune_calibrate(kernel, data);
+	if (!units)
+		return 0;
+
+	const int limit = MIN(2*processors, MIN(maxThreads, TUNE_MAX_THREADS));
+	int best = 0;
+	double bestRate = 0;
+	for (int threads=1 ; threads<=limit ; threads = (threads < processors && 2*threads > processors) ? processors : 2*threads) {
+
+		double rate = tune_throughput(kernel, data, units, threads);
+		if (rate <= 0)
+			return 0;
+		printf("  %-24s %2d thread(s): %10.1f runs/s\n", label, threads, rate);
+
+		if (!best || rate > bestRate * TUNE_MIN_GAIN) {
+			best = threads;
+			bestRate = rate;
+		}
+	}
+	return best;
+}
+
+
+
+
+/**
+ * \fn int tune_write(FILE* file, const tuneProfile* profile)
+ * \brief Writes a profile out, one "key value" line per setting
+ *
+ * \param[in, out] file Destination
+ * \param[in]      profile Profile to write
+ * \return 0 if the profile has been written, non-zero otherwise
+ */
+int tune_write(FILE* file, const tuneProfile* profile) {
+
+	fprintf(file, "# A52HackTool tuning profile, written by --TUNE\n");
+	fprintf(file, "%s %d\n", tune_keys[0], profile->processors);
+	fprintf(file, "%s %s\n", tune_keys[1], profile->kernel);
+	fprintf(file, "%s %u\n", tune_keys[2], profile->bitmatrix.echelonBits);
+	fprintf(file, "%s %u\n", tune_keys[3], profile->bitmatrix.multiplyBits);
+	fprintf(file, "%s %d\n", tune_keys[4], profile->attackThreads);
+	fprintf(file, "%s %d\n", tune_keys[5], profile->precomputeThreads);
+	fprintf(file, "%s %d\n", tune_keys[6], profile->codecThreads);
+	return ferror(file);
+}
+
+
+
+
+/**
+ * \fn int tune_read(FILE* file, tuneProfile* profile)
+ * \brief Reads a profile: every key must be given once, with a value in range
+ *
+ * \param[in, out] file Source
+ * \param[out]     profile Profile read
+ * \return 0 if the profile is valid, non-zero otherwise
+ */
+int tune_read(FILE* file, tuneProfile* profile) {
+
+	char line[128], key[32], value[32];
+	int found = 0;
+
+	while (fgets(line, sizeof(line), file)) {
+
+		if (line[0] == '#' || line[0] == '\n')
+			continue;
+		if (sscanf(line, "%31s %31s", key, value) != 2)
+			return 1;
+
+		int k;
+		for (k=0 ; k<TUNE_KEYS && strcmp(key, tune_keys[k]) ; ++k);
+		if (k == TUNE_KEYS || (found & (1<<k)))
+			return 1;
+		found |= 1<<k;
+
+		int number = atoi(value);
+		switch (k) {
+			case 0: profile->processors        = number; break;
+			case 1:
+				if (strlen(value) >= sizeof(profile->kernel))
+					return 1;
+				strcpy(profile->kernel, value);
+				break;
+			case 2: profile->bitmatrix.echelonBits  = number; break;
+			case 3: profile->bitmatrix.multiplyBits = number; break;
+			case 4: profile->attackThreads     = number; break;
+			case 5: profile->precomputeThreads = number; break;
+			case 6: profile->codecThreads      = number; break;
+		}
+		if (k != 1 && number < 1)
+			return 1;
+	}
+
+	// Block widths are powers of two (see bitmatrix_setTuning())
+	const unsigned int echelonBits = profile->bitmatrix.echelonBits, multiplyBits = profile->bitmatrix.multiplyBits;
+	return found != (1<<TUNE_KEYS)-1
+	    || echelonBits  > BITMATRIX_MAX_BLOCK_BITS || (echelonBits  & (echelonBits-1))
+	    || multiplyBits > BITMATRIX_MAX_BLOCK_BITS || (multiplyBits & (multiplyBits-1))
+	    || profile->attackThreads     > ATTACK_MAX_THREADS
+	    || profile->precomputeThreads > MATRICES_GENERATION_MAX_THREADS
+	    || profile->codecThreads      > PIPELINE_MAX_THREADS;
+}
+
+
+
+
+/**
+ * \fn int tune_matchesHost(const tuneProfile* profile)
+ * \brief Tells whether a profile has been made on this processor by this build
+ *
+ * \param[in] profile Profile to check
+ * \return Non-zero if the profile applies to this host
+ */
+int tune_matchesHost(const tuneProfile* profile) {
+	return profile->processors == (int)sysconf(_SC_NPROCESSORS_ONLN)
+	    && strcmp(profile->kernel, bitmatrix_kernel()) == 0;
+}
+
+
+
+
+// Documentation in header file
+void tune_defaults(tuneProfile* profile) {
+
+	profile->processors = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	snprintf(profile->kernel, sizeof(profile->kernel), "%s", bitmatrix_kernel());
+	profile->bitmatrix.echelonBits  = BITMATRIX_MAX_BLOCK_BITS;
+	profile->bitmatrix.multiplyBits = BITMATRIX_MAX_BLOCK_BITS;
+	profile->attackThreads     = PROCESSING_THREADS;
+	profile->precomputeThreads = PROCESSING_THREADS;
+	profile->codecThreads      = pipeline_defaultThreads();
+}
+
+
+
+
+// Documentation in header file
+int tune_run(tuneProfile* profile) {
+
+	tune_defaults(profile);
+	const int processors = MAX(1, profile->processors);
+
+	bitmatrixTuning previous;
+	bitmatrix_getTuning(&previous);
+
+	// Shared data, built before any timing
+	tuneData data;
+	data.system.block    = NULL;
+	data.keystream.block = NULL;
+	data.codewords = malloc(TUNE_CODE_BLOCKS*CODEWORD_LENGTH/8);
+	byte* sourcewords = malloc(TUNE_CODE_BLOCKS*SOURCEWORD_LENGTH/8);
+	if (!data.codewords || !sourcewords || !code_getMatrices()
+	 || bitmatrix_alloc(&data.system, NEEDED_ENCRYPTED_MESSAGES*SYNDROME_LENGTH, REGS_TOTAL_VARS+BITMATRIX_WORD_BITS)
+	 || bitmatrix_alloc(&data.keystream, CODEWORD_LENGTH, REGS_TOTAL_VARS)) {
+		DEBUG("Error: unable to allocate the benchmark data");
+		bitmatrix_free(&data.system);
+		free(data.codewords);
+		free(sourcewords);
+		return 1;
+	}
+	bitmatrix_random(&data.system);
+	bitmatrix_random(&data.keystream);
+	for (unsigned int i=0 ; i<TUNE_CODE_BLOCKS*SOURCEWORD_LENGTH/8 ; ++i) {
+		sourcewords[i] = rand() & 0xFF;
+	}
+	processPackedEncoding(sourcewords, data.codewords, TUNE_CODE_BLOCKS);
+	free(sourcewords);
+
+
+	// Block widths, the other one being left to its default value
+	bitmatrixTuning tuning = {BITMATRIX_MAX_BLOCK_BITS, BITMATRIX_MAX_BLOCK_BITS};
+	printf("Block widths of the %s kernels:\n", profile->kernel);
+	int res = tune_width(tune_echelon, &data, &tuning, &tuning.echelonBits, "Gauss elimination")
+	   || tune_width(tune_multiply, &data, &tuning, &tuning.multiplyBits, "Matrix product");
+	profile->bitmatrix = tuning;
+
+	// Numbers of threads, with the chosen widths
+	if (!res) {
+		printf("Threads (%d online processor(s)):\n", processors);
+		profile->attackThreads     = tune_threads(tune_echelon,  &data, processors, ATTACK_MAX_THREADS, "Attack");
+		profile->precomputeThreads = tune_threads(tune_generate, &data, processors, MATRICES_GENERATION_MAX_THREADS, "Precomputation");
+		profile->codecThreads      = tune_threads(tune_decode,   &data, processors, PIPELINE_MAX_THREADS, "Decoding");
+		res = !profile->attackThreads || !profile->precomputeThreads || !profile->codecThreads;
+	}
+	if (res)
+		DEBUG("Error: a benchmark could not be run");
+
+	bitmatrix_setTuning(&previous);
+	bitmatrix_free(&data.system);
+	bitmatrix_free(&data.keystream);
+	free(data.codewords);
+	return res;
+}
+
+
+
+
+// Documentation in header file
+int tune_save(const char* filename, const tuneProfile* profile) {
+
+	FILE* file = fopen(filename, "w");
+	if (!file)
+		return 1;
+	int res = tune_write(file, profile);
+	return fclose(file) | res;
+}
+
+
+
+
+// Documentation in header file
+int tune_load(const char* filename, tuneProfile* profile) {
+
+	FILE* file = fopen(filename, "r");
+	if (!file)
+		return 1;
+	tuneProfile loaded;
+	int res = tune_read(file, &loaded) || !tune_matchesHost(&loaded);
+	fclose(file);
+
+	if (!res)
+		*profile = loaded;
+	return res;
+}
+
+
+
+
+// Documentation in header file
+int tune_apply(const tuneProfile* profile) {
+
+	if (bitmatrix_setTuning(&profile->bitmatrix))
+		return 1;
+	attack_setThreads(profile->attackThreads);
+	return 0;
+}
+
+
+
+
+// Documentation in header file
+int tune_test() {
+
+	int res = 0;
+	FILE* file = tmpfile();
+	if (!file) {
+		DEBUG("Self-check aborted: unable to allocate test resources");
+		return 1;
+	}
+
+	// Roundtrip of a profile of this host
+	tuneProfile profile, check;
+	tune_defaults(&profile);
+	profile.bitmatrix.echelonBits = 2;
+	profile.attackThreads = 3;
+	memset(&check, 0, sizeof(check));
+	if (tune_write(file, &profile) || (rewind(file), tune_read(file, &check)) || !tune_matchesHost(&check)
+	 || memcmp(&check.bitmatrix, &profile.bitmatrix, sizeof(bitmatrixTuning))
+	 || check.attackThreads != 3 || check.precomputeThreads != profile.precomputeThreads
+	 || check.codecThreads != profile.codecThreads) {
+		DEBUG("Self-check aborted: the profile read differs from the profile written");
+		res = 1;
+	}
+
+	// Profile of another build, and profiles with a missing key or a value out of range
+	snprintf(check.kernel, sizeof(check.kernel), "other");
+	if (tune_matchesHost(&check)) {
+		DEBUG("Self-check aborted: a profile made by another build has been accepted");
+		res = 1;
+	}
+	const char* invalid[] = {"processors 1\nkernel none\n",
+	                         "processors 1\nkernel none\nechelon_bits 8\nmultiply_bits 3\n"
+	                         "attack_threads 1\nprecompute_threads 1\ncodec_threads 1\n",
+	                         "processors 1\nkernel none\nechelon_bits 8\nmultiply_bits 8\n"
+	                         "attack_threads 0\nprecompute_threads 1\ncodec_threads 1\n"};
+	for (unsigned int i=0 ; i<sizeof(invalid)/sizeof(invalid[0]) ; ++i) {
+		rewind(file);
+		if (ftruncate(fileno(file), 0) || fputs(invalid[i], file) == EOF || fflush(file))
+			res = 1;
+		rewind(file);
+		if (!tune_read(file, &check)) {
+			DEBUG("Self-check aborted: invalid profile #%u has been accepted", i);
+			res = 1;
+		}
+	}
+	fclose(file);
+
+	// Block widths applied, then restored
+	bitmatrixTuning previous, applied;
+	bitmatrix_getTuning(&previous);
+	res |= tune_apply(&profile);
+	bitmatrix_getTuning(&applied);
+	res |= applied.echelonBits != 2;
+	attack_setThreads(0);
+	bitmatrix_setTuning(&previous);
+
+	if (!res)
+		DEBUG("Self-check succeeded: profiles are written, read back, checked and applied");
+
+	return res;
+}
@@ -0,0 +1,156 @@
+/*============================================================================*
+ *                                                                            *
+ *                                    tune.h                                  *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * Part of A52HackTool                                                        *
+ *                                                                            *
+ * Copyright © 2011   -   Nicolas Paglieri   &   Olivier Benjamin             *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Contact Information:  nicolas.paglieri [at] ensimag.fr                     *
+ *                       olivier.benjamin [at] ensimag.fr                     *
+ *                                                                            *
+ *============================================================================*
+ *                                                                            *
+ * This file may be used under the terms of the GNU General Public License    *
+ * version 3 as published by the Free Software Foundation.                    *
+ * See <http://www.gnu.org/licenses/> or GPL.txt included in the packaging of *
+ * this file.                                                                 *
+ *                                                                            *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE    *
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  *
+ *                                                                            *
+ *============================================================================*/
+
+ /**
+  * @file tune.h
+  * @brief Per-processor tuning of the block widths and of the numbers of threads
+  *
+  * @author Nicolas Paglieri  &  Olivier Benjamin
+  * @version File Revision #1
+  * @date 19/10/2026
+  * */
+
+
+
+#ifndef _TUNE_H_
+#define _TUNE_H_
+
+#include "bitmatrix.h"
+
+
+// The instruction set of the row operations is chosen when the tool is built: the profile only records it, and a
+// profile made on another processor or by another build is ignored. What is tuned at run time is the width of the
+// blocks of the table-driven kernels, and the number of threads which scales best on every parallel operation.
+
+//! Maximum number of threads tried for an operation
+#define TUNE_MAX_THREADS 64
+
+//! Minimum duration of a timed sample, in seconds
+#define TUNE_SAMPLE_SECONDS 0.2
+
+//! Number of timed samples of each block width (the shortest one is kept)
+#define TUNE_SAMPLES 3
+
+//! Gain needed to prefer more threads, or another block width than the current best one (5%)
+#define TUNE_MIN_GAIN 1.05
+
+
+
+
+/**
+ * \struct tuneProfile
+ * \brief Settings found the fastest on a processor
+ */
+typedef struct {
+	int processors;             //!< Number of online processors when the profile was made
+	char kernel[16];            //!< Instruction set of the row operations (see bitmatrix_kernel())
+	bitmatrixTuning bitmatrix;  //!< Block widths of the table-driven kernels
+	int attackThreads;          //!< Number of attack workers
+	int precomputeThreads;      //!< Number of threads generating the dictionary
+	int codecThreads;           //!< Number of encoding and decoding workers
+} tuneProfile;
+
+
+
+
+/**
+ * \fn void tune_defaults(tuneProfile* profile)
+ * \brief Gives the settings used without a profile, on this processor
+ *
+ * \param[out] profile Default block widths, PROCESSING_THREADS for the attack and the precomputation,
+ *                     one codec worker per online processor
+ */
+void tune_defaults(tuneProfile* profile);
+
+
+
+
+/**
+ * \fn int tune_run(tuneProfile* profile)
+ * \brief Microbenchmarks every block width and number of threads on this processor
+ *
+ * The block widths in use are left unchanged. Takes a few seconds per operation.
+ *
+ * \param[out] profile Fastest settings
+ * \return 0 if the benchmarks could be run, non-zero otherwise
+ */
+int tune_run(tuneProfile* profile);
+
+
+
+
+/**
+ * \fn int tune_save(const char* filename, const tuneProfile* profile)
+ * \brief Writes a profile out, one "key value" line per setting
+ *
+ * \param[in] filename Path of the profile
+ * \param[in] profile Profile to write
+ * \return 0 if the profile has been written, non-zero otherwise
+ */
+int tune_save(const char* filename, const tuneProfile* profile);
+
+
+
+
+/**
+ * \fn int tune_load(const char* filename, tuneProfile* profile)
+ * \brief Reads a profile, which must have been made on this processor by this build
+ *
+ * \param[in]  filename Path of the profile
+ * \param[out] profile Profile read (left unchanged if it cannot be used)
+ * \return 0 if the profile can be used, non-zero if it is missing, invalid or made on another processor
+ */
+int tune_load(const char* filename, tuneProfile* profile);
+
+
+
+
+/**
+ * \fn int tune_apply(const tuneProfile* profile)
+ * \brief Sets the block widths and the number of attack workers of a profile (before any thread is started)
+ *
+ * The numbers of precomputation and codec threads are given to the operations by the caller.
+ *
+ * \param[in] profile Profile to apply
+ * \return 0 if the profile has been applied, non-zero if its block widths are invalid (nothing is then changed)
+ */
+int tune_apply(const tuneProfile* profile);
+
+
+
+
+/**
+ * \fn int tune_test()
+ * \brief Autotests the writing and reading of the profiles, and the rejection of the foreign ones
+ *
+ * \return 0 if the test is successfull, non-zero otherwise
+ */
+int tune_test();
+
+
+
+
+#endif
@@ -29,10 +29,13 @@
   * @brief Utilitary tools
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #6
-  * @date 24/06/2011
+  * @version File Revision #7
+  * @date 19/10/2026
   * */
 
+// clock_gettime() is a POSIX extension of the C99 library
+#define _POSIX_C_SOURCE 200112L
+
 #include <stdio.h>
 #include <string.h>
 #include <sys/time.h>
@@ -94,3 +97,13 @@ long long timeval_diff(struct timeval *difference, struct timeval *end_time, str
 	return 1000000LL * difference->tv_sec + difference->tv_usec;
 
 }
+
+
+
+
+// Documentation in header file
+double monotonicTime() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec*1e-9;
+}
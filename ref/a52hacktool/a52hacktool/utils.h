@@ -29,8 +29,8 @@
   * @brief Utilitary tools & Macros
   *
   * @author Nicolas Paglieri  &  Olivier Benjamin
-  * @version File Revision #20
-  * @date 24/06/2011
+  * @version File Revision #22
+  * @date 19/10/2026
   * */
 
 
@@ -79,6 +79,15 @@ int fileExists(const char * filename);
 long long timeval_diff(struct timeval *difference, struct timeval *end_time, struct timeval *start_time);
 
 
+/**
+ * \fn double monotonicTime()
+ * \brief Reads the monotonic clock, which is not affected by changes of the system time
+ *
+ * \return Current time, in seconds
+ */
+double monotonicTime();
+
+
 
 //! Debug Flag. Set to non-zero to activate debug info display
 #define DEBUG_INFO 0
@@ -192,67 +201,6 @@ long long timeval_diff(struct timeval *difference, struct timeval *end_time, str
     while (0)
 
 
-//! Initializes Matrix \a I to Identity matrix of size \a size
-#define CHAR_IDENTITY(I, size)                                                                \
-    do {                                                                                      \
-        unsigned int __size__ = (size);                                                       \
-        memset((I), 0, __size__*__size__*sizeof(char));                                       \
-        for(unsigned int __i__=0 ; __i__<__size__ ; ++__i__){                                 \
-            (I)[__i__][__i__]=1;                                                              \
-        }                                                                                     \
-     } while(0)
-
-
-/** \brief Processes the result of binary char matrix multiplication (\a M1 × \a M2) into \a PROD.
- * \a PROD_lines represent the result line size, \a PROD_cols represent the result col size,
- * \a depth represent the common dimension of \a M1 and \a M2. */
-#define BINPRODUCT_MATRIX_MATRIX(M1, M2, PROD, PROD_lines, PROD_cols, depth)                 \
-        do {                                                                                 \
-            unsigned int __PROD_lines__ = (PROD_lines);                                      \
-            unsigned int __PROD_cols__ = (PROD_cols);                                        \
-            unsigned int __depth__ = (depth);                                                \
-            memset((PROD), 0, __PROD_lines__*__PROD_cols__*sizeof(byte));                    \
-            for (unsigned int __line__=0 ; __line__<__PROD_lines__ ; ++__line__) {           \
-                for (unsigned int __col__=0 ; __col__<__PROD_cols__ ; ++__col__) {           \
-                    for (unsigned int __i__=0 ; __i__<__depth__ ; ++__i__) {                 \
-                        (PROD)[__line__][__col__] ^= ((M1)[__line__][__i__])                 \
-                                                 & ((M2)[__i__][__col__])  & 1;              \
-                    }                                                                        \
-                }                                                                            \
-            }                                                                                \
-        } while (0)
-
-
-/** \brief Processes the result of binary char matrix vector multiplication (\a M × \a V) into \a PROD.
- * \a M_lines represent the matrix line size, \a M_cols represent the matrix col size */
-#define BINPRODUCT_MATRIX_VECTOR(M, V, PROD, M_lines, M_cols)                                \
-        do {                                                                                 \
-            unsigned int __M_lines__ = (M_lines);                                            \
-            unsigned int __M_cols__ = (M_cols);                                              \
-            memset((PROD), 0, __M_lines__*sizeof(byte));                                     \
-            for (unsigned int __line__=0 ; __line__<__M_lines__ ; ++__line__) {              \
-                for (unsigned int __i__=0 ; __i__<__M_cols__ ; ++__i__) {                    \
-                    (PROD)[__line__] ^= ((M)[__line__][__i__]) & ((V)[__i__]) & 1;           \
-                }                                                                            \
-            }                                                                                \
-        } while (0)
-
-
-/** \brief Processes the result of binary char vector matrix multiplication (\a V × \a M) into \a PROD.
- * \a M_lines represent the matrix line size, \a M_cols represent the matrix col size */
-#define BINPRODUCT_VECTOR_MATRIX(V, M, PROD, M_lines, M_cols)                                \
-        do {                                                                                 \
-            unsigned int __M_lines__ = (M_lines);                                            \
-            unsigned int __M_cols__ = (M_cols);                                              \
-            memset((PROD), 0, __M_cols__*sizeof(byte));                                      \
-            for (unsigned int __col__=0 ; __col__<__M_cols__ ; ++__col__) {                  \
-                for (unsigned int __i__=0 ; __i__<__M_lines__ ; ++__i__) {                   \
-                    (PROD)[__col__] ^= ((M)[__i__][__col__]) & ((V)[__i__]) & 1;             \
-                }                                                                            \
-            }                                                                                \
-        } while (0)
-
-
 //(CHAR_V_size+31)/32 ensures that the size is right even if CHAR_V_size is not a multiple of 32
 //! Translates a sparse-byte representation (1bit per byte) into a full-integer one (32bit per int)
 #define CHAR_VECTOR_TO_INT_VECTOR(CHAR_V, INT_V, CHAR_V_size)                                \